@@ -21,6 +21,6 @@
 #include "Ipc.h"
 
 const char*				kIpcMsgHello		= "IHEL%1i";
-const char*				kIpcMsgLogLine		= "ILOG%s";
+const char*				kIpcMsgLogBatch		= "ILGB%4i%4i%s";
 const char*				kIpcMsgCommand		= "ICMD%s%1i";
 const char*				kIpcMsgShutdown		= "ISDN";
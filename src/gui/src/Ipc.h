@@ -25,7 +25,7 @@
 
 enum qIpcMessageType {
 	kIpcHello,
-	kIpcLogLine,
+	kIpcLogBatch,
 	kIpcCommand,
 	kIpcShutdown,
 };
@@ -37,6 +37,6 @@ enum qIpcClientType {
 };
 
 extern const char*		kIpcMsgHello;
-extern const char*		kIpcMsgLogLine;
+extern const char*		kIpcMsgLogBatch;
 extern const char*		kIpcMsgCommand;
 extern const char*		kIpcMsgShutdown;
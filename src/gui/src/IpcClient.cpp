@@ -34,7 +34,8 @@ m_Enabled(false)
 	connect(m_Socket, SIGNAL(error(QAbstractSocket::SocketError)), this, SLOT(error(QAbstractSocket::SocketError)));
 
 	m_Reader = new IpcReader(m_Socket);
-	connect(m_Reader, SIGNAL(readLogLine(const QString&)), this, SLOT(handleReadLogLine(const QString&)));
+	connect(m_Reader, SIGNAL(readLogRecord(const IpcLogRecord&)), this, SLOT(handleReadLogRecord(const IpcLogRecord&)));
+	connect(m_Reader, SIGNAL(readLogDropped(int)), this, SLOT(handleReadLogDropped(int)));
 }
 
 IpcClient::~IpcClient()
@@ -119,9 +120,14 @@ void IpcClient::sendCommand(const QString& command, ElevateMode const elevate)
 	stream.writeRawData(elevateBuf, 1);
 }
 
-void IpcClient::handleReadLogLine(const QString& text)
+void IpcClient::handleReadLogRecord(const IpcLogRecord& record)
 {
-	readLogLine(text);
+	readLogRecord(record);
+}
+
+void IpcClient::handleReadLogDropped(int count)
+{
+	readLogDropped(count);
 }
 
 // TODO: qt must have a built in way of converting int to bytes.
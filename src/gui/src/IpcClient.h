@@ -22,9 +22,9 @@
 #include <QAbstractSocket>
 
 #include "ElevateMode.h"
+#include "IpcReader.h"
 
 class QTcpSocket;
-class IpcReader;
 
 class IpcClient : public QObject
 {
@@ -48,10 +48,12 @@ private:
 private slots:
 	void connected();
 	void error(QAbstractSocket::SocketError error);
-	void handleReadLogLine(const QString& text);
+	void handleReadLogRecord(const IpcLogRecord& record);
+	void handleReadLogDropped(int count);
 
 signals:
-	void readLogLine(const QString& text);
+	void readLogRecord(const IpcLogRecord& record);
+	void readLogDropped(int count);
 	void infoMessage(const QString& text);
 	void errorMessage(const QString& text);
 
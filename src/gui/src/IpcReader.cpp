@@ -23,8 +23,14 @@
 #include <QMutex>
 #include <QByteArray>
 
+// each record is the level plus one, the time, the thread id, the line,
+// then the file and the message each preceded by their size
+static const int kLogRecordFixedSize = 1 + 8 + 4 + 4 + 4 + 4;
+
 IpcReader::IpcReader(QTcpSocket* socket) :
-m_Socket(socket)
+m_Socket(socket),
+m_LogSequenceValid(false),
+m_LogSequence(0)
 {
 }
 
@@ -55,19 +61,9 @@ void IpcReader::read()
 		codeBuf[4] = 0;
 		std::cout << "ipc read: " << codeBuf << std::endl;
 
-		if (memcmp(codeBuf, kIpcMsgLogLine, 4) == 0) {
-			std::cout << "reading log line" << std::endl;
-
-			char lenBuf[4];
-			readStream(lenBuf, 4);
-			int len = bytesToInt(lenBuf, 4);
-
-			char* data = new char[len];
-			readStream(data, len);
-			QString line = QString::fromUtf8(data, len);
-			delete[] data;
-
-			readLogLine(line);
+		if (memcmp(codeBuf, kIpcMsgLogBatch, 4) == 0) {
+			std::cout << "reading log batch" << std::endl;
+			readLogBatch();
 		}
 		else {
 			std::cerr << "aborting, message invalid" << std::endl;
@@ -78,6 +74,70 @@ void IpcReader::read()
 	std::cout << "read done" << std::endl;
 }
 
+void IpcReader::readLogBatch()
+{
+	char buf[4];
+	readStream(buf, 4);
+	quint32 sequence = bytesToInt(buf, 4);
+	readStream(buf, 4);
+	int dropped = bytesToInt(buf, 4);
+	readStream(buf, 4);
+	int len = bytesToInt(buf, 4);
+
+	QByteArray data(len, 0);
+	readStream(data.data(), len);
+
+	if (m_LogSequenceValid && sequence != m_LogSequence + 1) {
+		std::cerr << "log batches missing before " << sequence << std::endl;
+	}
+	m_LogSequence = sequence;
+	m_LogSequenceValid = true;
+
+	if (dropped != 0) {
+		readLogDropped(dropped);
+	}
+	readLogRecords(data);
+}
+
+void IpcReader::readLogRecords(const QByteArray& data)
+{
+	const char* p = data.constData();
+	int remaining = data.size();
+	while (remaining >= kLogRecordFixedSize) {
+		IpcLogRecord record;
+		record.m_Level = bytesToInt(p, 1) - 1;
+		record.m_Time =
+			(static_cast<quint64>(static_cast<quint32>(bytesToInt(p + 1, 4))) << 32) |
+			static_cast<quint32>(bytesToInt(p + 5, 4));
+		record.m_ThreadId = bytesToInt(p + 9, 4);
+		record.m_Line = bytesToInt(p + 13, 4);
+		p += 17;
+		remaining -= 17;
+
+		int fileLen = bytesToInt(p, 4);
+		if (fileLen < 0 || fileLen > remaining - 8) {
+			break;
+		}
+		record.m_File = QString::fromUtf8(p + 4, fileLen);
+		p += 4 + fileLen;
+		remaining -= 4 + fileLen;
+
+		int messageLen = bytesToInt(p, 4);
+		if (messageLen < 0 || messageLen > remaining - 4) {
+			break;
+		}
+		record.m_Message = QString::fromUtf8(p + 4, messageLen);
+		p += 4 + messageLen;
+		remaining -= 4 + messageLen;
+
+		readLogRecord(record);
+	}
+
+	if (remaining != 0) {
+		std::cerr << "log batch malformed" << std::endl;
+	}
+}
+
 bool IpcReader::readStream(char* buffer, int length)
 {
 	std::cout << "reading stream" << std::endl;
@@ -20,9 +20,24 @@
 
 #include <QObject>
 #include <QMutex>
+#include <QString>
 
 class QTcpSocket;
 
+// a log record from a kIpcMsgLogBatch message
+class IpcLogRecord
+{
+public:
+	// the ELevel of the record; -1 for text that's already formatted
+	int m_Level;
+	// seconds since the epoch
+	quint64 m_Time;
+	quint32 m_ThreadId;
+	QString m_File;
+	int m_Line;
+	QString m_Message;
+};
+
 class IpcReader : public QObject
 {
 	Q_OBJECT;
@@ -34,11 +49,14 @@ public:
 	void stop();
 
 signals:
-	void readLogLine(const QString& text);
+	void readLogRecord(const IpcLogRecord& record);
+	void readLogDropped(int count);
 
 private:
 	bool readStream(char* buffer, int length);
 	int bytesToInt(const char* buffer, int size);
+	void readLogBatch();
+	void readLogRecords(const QByteArray& data);
 
 private slots:
 	void read();
@@ -46,4 +64,6 @@ private slots:
 private:
 	QTcpSocket* m_Socket;
 	QMutex m_Mutex;
+	bool m_LogSequenceValid;
+	quint32 m_LogSequence;
 };
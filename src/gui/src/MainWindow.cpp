@@ -66,6 +66,24 @@
 
 static const char guiConfigName[] = "gui.ini";
 
+// names of the log levels in ipc log records
+static const char* logLevelNames[] =
+{
+	"FATAL",
+	"ERROR",
+	"WARNING",
+	"NOTE",
+	"INFO",
+	"DEBUG",
+	"DEBUG1",
+	"DEBUG2",
+	"DEBUG3",
+	"DEBUG4",
+	"DEBUG5"
+};
+
+static const int kLogLevelNameCount = sizeof(logLevelNames) / sizeof(logLevelNames[0]);
+
 static const QString serverConfigFilter(QObject::tr("Synergy Configurations (*.conf);;All files (*.*)"));
 
 #if defined(Q_OS_MAC)
@@ -125,7 +143,8 @@ MainWindow::MainWindow(QSettings& settings, AppConfig& appConfig) :
 
 #if defined(Q_OS_WIN)
 	// ipc must always be enabled, so that we can disable command when switching to desktop mode.
-	connect(&m_IpcClient, SIGNAL(readLogLine(const QString&)), this, SLOT(appendLogRaw(const QString&)));
+	connect(&m_IpcClient, SIGNAL(readLogRecord(const IpcLogRecord&)), this, SLOT(appendLogRecord(const IpcLogRecord&)));
+	connect(&m_IpcClient, SIGNAL(readLogDropped(int)), this, SLOT(appendLogDropped(int)));
 	connect(&m_IpcClient, SIGNAL(errorMessage(const QString&)), this, SLOT(appendLogError(const QString&)));
 	connect(&m_IpcClient, SIGNAL(infoMessage(const QString&)), this, SLOT(appendLogInfo(const QString&)));
 	m_IpcClient.connectToHost();
@@ -413,6 +432,37 @@ void MainWindow::appendLogRaw(const QString& text)
 	}
 }
 
+void MainWindow::appendLogRecord(const IpcLogRecord& record)
+{
+	// already formatted, e.g. the output of the synergy process
+	if (record.m_Level < 0) {
+		appendLogRaw(record.m_Message);
+		return;
+	}
+
+	// the gui's log levels start at ERROR
+	if (record.m_Level > appConfig().logLevel() + 1 ||
+		record.m_Level >= kLogLevelNameCount) {
+		return;
+	}
+
+	QDateTime time = QDateTime::fromTime_t(static_cast<uint>(record.m_Time));
+	m_pLogOutput->append(QString("[%1] %2: %3")
+		.arg(time.toString(Qt::ISODate))
+		.arg(logLevelNames[record.m_Level])
+		.arg(record.m_Message));
+	if (!record.m_File.isEmpty()) {
+		m_pLogOutput->append(QString("\t%1,%2").arg(record.m_File).arg(record.m_Line));
+	}
+
+	updateFromLogLine(record.m_Message);
+}
+
+void MainWindow::appendLogDropped(int count)
+{
+	appendLogRaw(getTimeStamp() + QString(" WARNING: %1 log lines dropped").arg(count));
+}
+
 void MainWindow::updateFromLogLine(const QString &line)
 {
 	// TODO: this code makes Andrew cry
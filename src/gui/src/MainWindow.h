@@ -117,6 +117,8 @@ public slots:
 		void appendLogInfo(const QString& text);
 		void appendLogDebug(const QString& text);
 		void appendLogError(const QString& text);
+		void appendLogRecord(const IpcLogRecord& record);
+		void appendLogDropped(int count);
 		void startSynergy();
 
 	protected slots:
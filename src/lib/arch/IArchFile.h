@@ -20,6 +20,7 @@
 
 #include "common/IInterface.h"
 #include "common/stdstring.h"
+#include "common/stdvector.h"
 #include "base/String.h"
 
 //! Interface for architecture dependent file system operations
@@ -63,6 +64,22 @@ public:
 	//! Get's the Synergy server's config file path
 	std::string getConfigFilePath();
 
+	//! Get directory entries
+	/*!
+	Fills \c entries with the names of the entries in directory
+	\c path, other than "." and "..".  Returns false, leaving
+	\c entries empty, if \c path isn't a readable directory.
+	*/
+	virtual bool		getDirectoryEntries(const std::string& path,
+							std::vector<std::string>& entries) = 0;
+
+	//! Create directory
+	/*!
+	Creates directory \c path if it doesn't exist.  Its parent must
+	exist.  Returns true iff the directory exists afterwards.
+	*/
+	virtual bool		createDirectory(const std::string& path) = 0;
+
 	//@}
 	//! Set the user's profile directory
 	/*
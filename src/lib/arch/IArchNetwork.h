@@ -19,6 +19,7 @@
 #pragma once
 
 #include "common/IInterface.h"
+#include "common/basic_types.h"
 #include "common/stdstring.h"
 
 class ArchThreadImpl;
@@ -101,6 +102,21 @@ public:
 		unsigned short	m_revents;
 	};
 
+	//! Most buffers in one \c writeSocketBuffers()
+	enum {
+		kMAXWRITEBUFFERS = 16
+	};
+
+	//! A piece of the data for \c writeSocketBuffers()
+	class WriteBuffer {
+	public:
+		//! The bytes to write
+		const void*		m_data;
+
+		//! The number of bytes
+		size_t			m_size;
+	};
+
 	//! @name manipulators
 	//@{
 
@@ -215,6 +231,30 @@ public:
 	virtual size_t		writeSocket(ArchSocket s,
 							const void* buf, size_t len) = 0;
 
+	//! Write gathered data to socket
+	/*!
+	Write the \c num buffers in \c bufs, at most kMAXWRITEBUFFERS, to
+	socket \c s as if by one writeSocket() of all their bytes in order
+	and return the number of bytes written.  This sends small pieces
+	of data from different places in one packet without first copying
+	them together.  The number of bytes can be less than the total for
+	the same reasons as writeSocket().
+	*/
+	virtual size_t		writeSocketBuffers(ArchSocket s,
+							const WriteBuffer* bufs, int num) = 0;
+
+	//! Write file data to socket
+	/*!
+	Write up to \c len bytes of the file open as descriptor \c fd,
+	starting at \c offset, to socket \c s and return the number of
+	bytes written.  The data goes from the file to the socket without
+	being copied through a user buffer.  Returns 0 if the socket's
+	buffers are full.  Throws XArchNetworkIO if the file ends first and
+	XArchNetworkSupport if the platform can't send straight from a file.
+	*/
+	virtual size_t		writeSocketFromFile(ArchSocket s, int fd,
+							UInt64 offset, size_t len) = 0;
+
 	//! Check error on socket
 	/*!
 	If the socket \c s is in an error state then throws an appropriate
@@ -22,6 +22,9 @@
 #include <unistd.h>
 #include <pwd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <errno.h>
 #include <cstring>
 
 //
@@ -115,3 +118,37 @@ ArchFileUnix::setConfigDirectory(const String& s)
 {
 	m_configDirectory = s;
 }
+
+bool
+ArchFileUnix::getDirectoryEntries(const std::string& path,
+				std::vector<std::string>& entries)
+{
+	entries.clear();
+
+	DIR* dir = opendir(path.c_str());
+	if (dir == NULL) {
+		return false;
+	}
+
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL) {
+		if (strcmp(entry->d_name, ".") != 0 &&
+			strcmp(entry->d_name, "..") != 0) {
+			entries.push_back(entry->d_name);
+		}
+	}
+	closedir(dir);
+	return true;
+}
+
+bool
+ArchFileUnix::createDirectory(const std::string& path)
+{
+	if (mkdir(path.c_str(), 0777) == 0) {
+		return true;
+	}
+
+	struct stat info;
+	return (errno == EEXIST && stat(path.c_str(), &info) == 0 &&
+			S_ISDIR(info.st_mode));
+}
@@ -35,6 +35,9 @@ public:
 	virtual std::string	getLogDirectory();
 	virtual std::string	getConfigDirectory();
 	virtual void		setConfigDirectory(const String& s);
+	virtual bool		getDirectoryEntries(const std::string& path,
+							std::vector<std::string>& entries);
+	virtual bool		createDirectory(const std::string& path);
 
 private:
 	String				m_configDirectory;
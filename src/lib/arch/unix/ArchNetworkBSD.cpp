@@ -32,6 +32,10 @@
 #endif
 #include <arpa/inet.h>
 #include <fcntl.h>
+#include <sys/uio.h>
+#if HAVE_SYS_SENDFILE_H
+#	include <sys/sendfile.h>
+#endif
 #include <errno.h>
 #include <string.h>
 
@@ -538,6 +542,57 @@ ArchNetworkBSD::writeSocket(ArchSocket s, const void* buf, size_t len)
 	return n;
 }
 
+size_t
+ArchNetworkBSD::writeSocketBuffers(ArchSocket s,
+				const WriteBuffer* bufs, int num)
+{
+	assert(s != NULL);
+	assert(num >= 0 && num <= kMAXWRITEBUFFERS);
+
+	struct iovec iov[kMAXWRITEBUFFERS];
+	for (int i = 0; i < num; ++i) {
+		iov[i].iov_base = const_cast<void*>(bufs[i].m_data);
+		iov[i].iov_len  = bufs[i].m_size;
+	}
+
+	ssize_t n = writev(s->m_fd, iov, num);
+	if (n == -1) {
+		if (errno == EINTR || errno == EAGAIN) {
+			return 0;
+		}
+		throwError(errno);
+	}
+	return n;
+}
+
+size_t
+ArchNetworkBSD::writeSocketFromFile(ArchSocket s, int fd,
+				UInt64 offset, size_t len)
+{
+	assert(s != NULL);
+
+#if HAVE_SYS_SENDFILE_H
+	off_t fileOffset = static_cast<off_t>(offset);
+	ssize_t n = sendfile(s->m_fd, fd, &fileOffset, len);
+	if (n == -1) {
+		if (errno == EINTR || errno == EAGAIN) {
+			return 0;
+		}
+		throwError(errno);
+	}
+	if (n == 0 && len > 0) {
+		// the file ended before the data the caller promised
+		throwError(EIO);
+	}
+	return n;
+#else
+	(void)fd;
+	(void)offset;
+	(void)len;
+	throw XArchNetworkSupport("sendfile is not available");
+#endif
+}
+
 void
 ArchNetworkBSD::throwErrorOnSocket(ArchSocket s)
 {
@@ -76,6 +76,10 @@ public:
 	virtual size_t		readSocket(ArchSocket s, void* buf, size_t len);
 	virtual size_t		writeSocket(ArchSocket s,
 							const void* buf, size_t len);
+	virtual size_t		writeSocketBuffers(ArchSocket s,
+							const WriteBuffer* bufs, int num);
+	virtual size_t		writeSocketFromFile(ArchSocket s, int fd,
+							UInt64 offset, size_t len);
 	virtual void		throwErrorOnSocket(ArchSocket);
 	virtual bool		setNoDelayOnSocket(ArchSocket, bool noDelay);
 	virtual bool		setReuseAddrOnSocket(ArchSocket, bool reuse);
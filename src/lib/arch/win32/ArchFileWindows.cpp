@@ -106,3 +106,44 @@ ArchFileWindows::setConfigDirectory(const String& s)
 {
 	m_configDirectory = s;
 }
+
+bool
+ArchFileWindows::getDirectoryEntries(const std::string& path,
+				std::vector<std::string>& entries)
+{
+	entries.clear();
+
+	DWORD attributes = GetFileAttributesA(path.c_str());
+	if (attributes == INVALID_FILE_ATTRIBUTES ||
+		(attributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+		return false;
+	}
+
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((path + "\\*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE) {
+		// an empty directory still has "." and ".."
+		return false;
+	}
+
+	do {
+		if (strcmp(data.cFileName, ".") != 0 &&
+			strcmp(data.cFileName, "..") != 0) {
+			entries.push_back(data.cFileName);
+		}
+	} while (FindNextFileA(find, &data));
+	FindClose(find);
+	return true;
+}
+
+bool
+ArchFileWindows::createDirectory(const std::string& path)
+{
+	if (CreateDirectoryA(path.c_str(), NULL)) {
+		return true;
+	}
+
+	DWORD attributes = GetFileAttributesA(path.c_str());
+	return (attributes != INVALID_FILE_ATTRIBUTES &&
+			(attributes & FILE_ATTRIBUTE_DIRECTORY) != 0);
+}
@@ -576,6 +576,32 @@ ArchNetworkWinsock::writeSocket(ArchSocket s, const void* buf, size_t len)
 	return static_cast<size_t>(n);
 }
 
+size_t
+ArchNetworkWinsock::writeSocketBuffers(ArchSocket s,
+				const WriteBuffer* bufs, int num)
+{
+	assert(s != NULL);
+	assert(num >= 0 && num <= kMAXWRITEBUFFERS);
+
+	// send the buffers in turn, stopping at the first that doesn't
+	// go out whole
+	size_t total = 0;
+	for (int i = 0; i < num; ++i) {
+		size_t n = writeSocket(s, bufs[i].m_data, bufs[i].m_size);
+		total += n;
+		if (n < bufs[i].m_size) {
+			break;
+		}
+	}
+	return total;
+}
+
+size_t
+ArchNetworkWinsock::writeSocketFromFile(ArchSocket, int, UInt64, size_t)
+{
+	throw XArchNetworkSupport("sending from a file is not supported");
+}
+
 void
 ArchNetworkWinsock::throwErrorOnSocket(ArchSocket s)
 {
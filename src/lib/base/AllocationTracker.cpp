@@ -0,0 +1,400 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/AllocationTracker.h"
+
+#if SYNERGY_TRACK_ALLOCATIONS
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if SYSAPI_UNIX
+#include <cxxabi.h>
+#include <dlfcn.h>
+#endif
+
+#if defined(__GLIBC__)
+extern "C" {
+void*					__libc_malloc(size_t);
+void*					__libc_calloc(size_t, size_t);
+void*					__libc_realloc(void*, size_t);
+void*					__libc_memalign(size_t, size_t);
+void					__libc_free(void*);
+}
+#endif
+
+namespace {
+
+// the table can't grow because growing would allocate.  call sites
+// beyond the table are only counted in the totals.
+const size_t			kMaxCallSites = 8192;
+
+class CallSiteEntry {
+public:
+	std::atomic<void*>	m_address;
+	std::atomic<UInt64>	m_count;
+	std::atomic<UInt64>	m_bytes;
+};
+
+// zero initialized before anything can allocate
+CallSiteEntry			s_callSites[kMaxCallSites];
+std::atomic<UInt64>		s_numAllocations;
+std::atomic<UInt64>		s_numBytes;
+std::atomic<UInt64>		s_numFrees;
+thread_local UInt64		s_threadAllocations;
+
+void
+allocated(void* address, size_t size)
+{
+	s_numAllocations.fetch_add(1, std::memory_order_relaxed);
+	s_numBytes.fetch_add(size, std::memory_order_relaxed);
+	++s_threadAllocations;
+
+	// open addressing, claiming an empty entry with compare and swap
+	size_t hash = reinterpret_cast<size_t>(address);
+	hash ^= hash >> 13;
+	hash *= 0x9e3779b97f4a7c15ull;
+	for (size_t i = 0; i < kMaxCallSites; ++i) {
+		CallSiteEntry& entry = s_callSites[(hash + i) % kMaxCallSites];
+		void* current = entry.m_address.load(std::memory_order_relaxed);
+		if (current == NULL) {
+			if (entry.m_address.compare_exchange_strong(current, address)) {
+				current = address;
+			}
+		}
+		if (current == address) {
+			entry.m_count.fetch_add(1, std::memory_order_relaxed);
+			entry.m_bytes.fetch_add(size, std::memory_order_relaxed);
+			return;
+		}
+	}
+}
+
+void
+freed(void* p)
+{
+	if (p != NULL) {
+		s_numFrees.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+#if defined(__GLIBC__)
+inline void*			rawMalloc(size_t size) { return __libc_malloc(size); }
+inline void				rawFree(void* p) { __libc_free(p); }
+#else
+inline void*			rawMalloc(size_t size) { return ::malloc(size); }
+inline void				rawFree(void* p) { ::free(p); }
+#endif
+
+bool
+compareCallSites(const AllocationTracker::CallSite& a,
+				const AllocationTracker::CallSite& b)
+{
+	return a.m_count > b.m_count;
+}
+
+String
+getCallSiteName(void* address)
+{
+#if SYSAPI_UNIX
+	Dl_info info;
+	if (dladdr(address, &info) != 0) {
+		size_t offset;
+		String name;
+		if (info.dli_sname != NULL) {
+			int status;
+			char* demangled = abi::__cxa_demangle(info.dli_sname,
+							NULL, NULL, &status);
+			name   = (demangled != NULL) ? demangled : info.dli_sname;
+			offset = static_cast<char*>(address) -
+							static_cast<char*>(info.dli_saddr);
+			free(demangled);
+		}
+		else {
+			name   = (info.dli_fname != NULL) ? info.dli_fname : "?";
+			offset = static_cast<char*>(address) -
+							static_cast<char*>(info.dli_fbase);
+		}
+		return synergy::string::sprintf("%s+0x%x", name.c_str(),
+							static_cast<unsigned int>(offset));
+	}
+#endif
+	return synergy::string::sprintf("%p", address);
+}
+
+}
+
+//
+// replaced allocation functions
+//
+
+void*
+operator new(size_t size)
+{
+	allocated(__builtin_return_address(0), size);
+	void* p = rawMalloc(size != 0 ? size : 1);
+	if (p == NULL) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void*
+operator new[](size_t size)
+{
+	allocated(__builtin_return_address(0), size);
+	void* p = rawMalloc(size != 0 ? size : 1);
+	if (p == NULL) {
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void*
+operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	allocated(__builtin_return_address(0), size);
+	return rawMalloc(size != 0 ? size : 1);
+}
+
+void*
+operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	allocated(__builtin_return_address(0), size);
+	return rawMalloc(size != 0 ? size : 1);
+}
+
+void
+operator delete(void* p) noexcept
+{
+	freed(p);
+	rawFree(p);
+}
+
+void
+operator delete[](void* p) noexcept
+{
+	freed(p);
+	rawFree(p);
+}
+
+void
+operator delete(void* p, size_t) noexcept
+{
+	freed(p);
+	rawFree(p);
+}
+
+void
+operator delete[](void* p, size_t) noexcept
+{
+	freed(p);
+	rawFree(p);
+}
+
+void
+operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	freed(p);
+	rawFree(p);
+}
+
+void
+operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	freed(p);
+	rawFree(p);
+}
+
+#if defined(__GLIBC__)
+// the C allocation functions are only replaced where the real ones
+// can still be reached, which glibc allows through __libc_*
+
+extern "C" void*
+malloc(size_t size)
+{
+	allocated(__builtin_return_address(0), size);
+	return __libc_malloc(size);
+}
+
+extern "C" void*
+calloc(size_t n, size_t size)
+{
+	allocated(__builtin_return_address(0), n * size);
+	return __libc_calloc(n, size);
+}
+
+extern "C" void*
+realloc(void* p, size_t size)
+{
+	// counted as a new allocation that frees the old one
+	allocated(__builtin_return_address(0), size);
+	freed(p);
+	return __libc_realloc(p, size);
+}
+
+extern "C" void*
+memalign(size_t alignment, size_t size)
+{
+	allocated(__builtin_return_address(0), size);
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" void*
+aligned_alloc(size_t alignment, size_t size)
+{
+	allocated(__builtin_return_address(0), size);
+	return __libc_memalign(alignment, size);
+}
+
+extern "C" int
+posix_memalign(void** p, size_t alignment, size_t size)
+{
+	allocated(__builtin_return_address(0), size);
+	*p = __libc_memalign(alignment, size);
+	return (*p != NULL) ? 0 : ENOMEM;
+}
+
+extern "C" void
+free(void* p)
+{
+	freed(p);
+	__libc_free(p);
+}
+#endif
+
+//
+// AllocationTracker
+//
+
+bool
+AllocationTracker::isEnabled()
+{
+	return true;
+}
+
+UInt64
+AllocationTracker::getNumAllocations()
+{
+	return s_numAllocations.load(std::memory_order_relaxed);
+}
+
+UInt64
+AllocationTracker::getNumBytes()
+{
+	return s_numBytes.load(std::memory_order_relaxed);
+}
+
+UInt64
+AllocationTracker::getNumLive()
+{
+	return getNumAllocations() - s_numFrees.load(std::memory_order_relaxed);
+}
+
+UInt64
+AllocationTracker::getThreadAllocations()
+{
+	return s_threadAllocations;
+}
+
+void
+AllocationTracker::getCallSites(CallSiteList& callSites)
+{
+	callSites.clear();
+	for (size_t i = 0; i < kMaxCallSites; ++i) {
+		CallSite callSite;
+		callSite.m_address = s_callSites[i].m_address.load();
+		callSite.m_count   = s_callSites[i].m_count.load();
+		callSite.m_bytes   = s_callSites[i].m_bytes.load();
+		if (callSite.m_address != NULL && callSite.m_count != 0) {
+			callSites.push_back(callSite);
+		}
+	}
+	std::sort(callSites.begin(), callSites.end(), &compareCallSites);
+}
+
+String
+AllocationTracker::format(size_t maxCallSites)
+{
+	CallSiteList callSites;
+	getCallSites(callSites);
+
+	String result = synergy::string::sprintf(
+							"allocations: %llu (%llu bytes), live: %llu\n"
+							"%12s %14s  call site\n",
+							getNumAllocations(), getNumBytes(), getNumLive(),
+							"count", "bytes");
+	for (size_t i = 0; i < callSites.size() && i < maxCallSites; ++i) {
+		result += synergy::string::sprintf("%12llu %14llu  %s\n",
+							callSites[i].m_count, callSites[i].m_bytes,
+							getCallSiteName(callSites[i].m_address).c_str());
+	}
+	return result;
+}
+
+#else // !SYNERGY_TRACK_ALLOCATIONS
+
+//
+// AllocationTracker
+//
+
+bool
+AllocationTracker::isEnabled()
+{
+	return false;
+}
+
+UInt64
+AllocationTracker::getNumAllocations()
+{
+	return 0;
+}
+
+UInt64
+AllocationTracker::getNumBytes()
+{
+	return 0;
+}
+
+UInt64
+AllocationTracker::getNumLive()
+{
+	return 0;
+}
+
+UInt64
+AllocationTracker::getThreadAllocations()
+{
+	return 0;
+}
+
+void
+AllocationTracker::getCallSites(CallSiteList& callSites)
+{
+	callSites.clear();
+}
+
+String
+AllocationTracker::format(size_t)
+{
+	return "allocations aren't tracked, build with SYNERGY_TRACK_ALLOCATIONS\n";
+}
+
+#endif
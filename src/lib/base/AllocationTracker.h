@@ -0,0 +1,95 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "common/stdvector.h"
+
+//! Heap allocation counters
+/*!
+When synergy is built with SYNERGY_TRACK_ALLOCATIONS the global
+operator new and delete, and on glibc malloc and friends, are replaced
+by versions that count every allocation and the call site it was made
+from.  This is for debug builds: it slows every allocation down.  It
+lets tests check that a hot path doesn't allocate at all, and lets a
+running synergy report where it allocates (see App, which logs the
+report on SIGUSR2).
+
+Without SYNERGY_TRACK_ALLOCATIONS every count is zero.
+*/
+class AllocationTracker {
+public:
+	//! Allocations made from one place
+	class CallSite {
+	public:
+		//! Return address of the allocation function
+		void*			m_address;
+		UInt64			m_count;
+		UInt64			m_bytes;
+	};
+	typedef std::vector<CallSite> CallSiteList;
+
+	//! @name accessors
+	//@{
+
+	//! Test if allocations are counted
+	static bool			isEnabled();
+
+	//! Get number of allocations
+	/*!
+	Returns the number of allocations made by all threads so far.
+	*/
+	static UInt64		getNumAllocations();
+
+	//! Get number of bytes allocated
+	/*!
+	Returns the number of bytes asked for by all allocations so far.
+	*/
+	static UInt64		getNumBytes();
+
+	//! Get number of live allocations
+	/*!
+	Returns the number of allocations that haven't been freed.
+	*/
+	static UInt64		getNumLive();
+
+	//! Get number of allocations on this thread
+	/*!
+	Returns the number of allocations made by the calling thread so
+	far.  Tests take the difference over the code they check, which
+	other threads can't disturb.
+	*/
+	static UInt64		getThreadAllocations();
+
+	//! Get call sites
+	/*!
+	Sets \c callSites to the places allocations were made from, the
+	one with the most allocations first.
+	*/
+	static void			getCallSites(CallSiteList& callSites);
+
+	//! Format report
+	/*!
+	Returns the totals and the \c maxCallSites call sites with the most
+	allocations, with the function each is in if it can be found.
+	*/
+	static String		format(size_t maxCallSites = 40);
+
+	//@}
+};
@@ -26,6 +26,7 @@
 #include "base/IEventJob.h"
 #include "base/EventTypes.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
 #include "base/XBase.h"
 
 EVENT_TYPE_ACCESSOR(Client)
@@ -49,6 +50,9 @@ EVENT_TYPE_ACCESSOR(IScreen)
 EVENT_TYPE_ACCESSOR(Clipboard)
 EVENT_TYPE_ACCESSOR(File)
 
+static const char*		kDispatchedName = "synergy_events_dispatched_total";
+static const char*		kDispatchedHelp = "Events dispatched to their handlers.";
+
 // interrupt handler.  this just adds a quit event to the queue.
 static
 void
@@ -90,6 +94,19 @@ EventQueue::EventQueue() :
 	m_readyCondVar(new CondVar<bool>(m_readyMutex, false))
 {
 	m_mutex = ARCH->newMutex();
+
+	Metrics& metrics = Metrics::getInstance();
+	for (UInt32 i = 0; i < kMaxCountedTypes; ++i) {
+		m_dispatched[i] = NULL;
+	}
+	countType(Event::kQuit, "quit");
+	countType(Event::kSystem, "system");
+	countType(Event::kTimer, "timer");
+	m_dispatchedOther = metrics.getCounter(kDispatchedName, kDispatchedHelp,
+							Metrics::label("type", "other"));
+	m_depth = metrics.getGauge("synergy_event_queue_depth",
+							"Events waiting in the event queue.");
+
 	ARCH->setSignalHandler(Arch::kINTERRUPT, &interrupt, this);
 	ARCH->setSignalHandler(Arch::kTERMINATE, &interrupt, this);
 	m_buffer = new SimpleEventQueueBuffer;
@@ -140,6 +157,7 @@ EventQueue::registerTypeOnce(Event::Type& type, const char* name)
 		m_typeMap.insert(std::make_pair(m_nextType, name));
 		m_nameMap.insert(std::make_pair(name, m_nextType));
 		LOG((CLOG_DEBUG1 "registered event type %s as %d", name, m_nextType));
+		countType(m_nextType, name);
 		type = m_nextType++;
 	}
 	return type;
@@ -191,6 +209,7 @@ EventQueue::adoptBuffer(IEventQueueBuffer* buffer)
 		Event::deleteData(i->second);
 	}
 	m_events.clear();
+	m_depth->set(0);
 	m_oldEventIDs.clear();
 
 	// use new buffer
@@ -250,6 +269,7 @@ retry:
 		{
 			ArchMutexLock lock(m_mutex);
 			event = removeEvent(dataID);
+			m_depth->set(static_cast<SInt64>(m_events.size()));
 			return true;
 		}
 
@@ -262,8 +282,16 @@ retry:
 bool
 EventQueue::dispatchEvent(const Event& event)
 {
+	Event::Type type = event.getType();
+	if (type < kMaxCountedTypes && m_dispatched[type] != NULL) {
+		m_dispatched[type]->add();
+	}
+	else {
+		m_dispatchedOther->add();
+	}
+
 	void* target   = event.getTarget();
-	IEventJob* job = getHandler(event.getType(), target);
+	IEventJob* job = getHandler(type, target);
 	if (job == NULL) {
 		job = getHandler(Event::kUnknown, target);
 	}
@@ -307,6 +335,7 @@ EventQueue::addEventToBuffer(const Event& event)
 	
 	// store the event's data locally
 	UInt32 eventID = saveEvent(event);
+	m_depth->set(static_cast<SInt64>(m_events.size()));
 	
 	// add it
 	if (!m_buffer->addEvent(eventID)) {
@@ -485,6 +514,16 @@ EventQueue::removeEvent(UInt32 eventID)
 	return event;
 }
 
+void
+EventQueue::countType(Event::Type type, const char* name)
+{
+	if (type < kMaxCountedTypes) {
+		m_dispatched[type] = Metrics::getInstance().getCounter(
+							kDispatchedName, kDispatchedHelp,
+							Metrics::label("type", name));
+	}
+}
+
 bool
 EventQueue::hasTimerExpired(Event& event)
 {
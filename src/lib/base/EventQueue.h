@@ -30,6 +30,8 @@
 #include <queue>
 
 class Mutex;
+class MetricCounter;
+class MetricGauge;
 
 //! Event queue
 /*!
@@ -72,6 +74,7 @@ private:
 	bool				hasTimerExpired(Event& event);
 	double				getNextTimerTimeout() const;
 	void				addEventToBuffer(const Event& event);
+	void				countType(Event::Type type, const char* name);
 	
 private:
 	class Timer {
@@ -111,6 +114,12 @@ private:
 	typedef std::map<Event::Type, IEventJob*> TypeHandlerTable;
 	typedef std::map<void*, TypeHandlerTable> HandlerTable;
 
+	enum {
+		// event types counted separately when dispatched.  the rest
+		// are counted together.
+		kMaxCountedTypes = 256
+	};
+
 	int					m_systemTarget;
 	ArchMutex			m_mutex;
 
@@ -135,6 +144,11 @@ private:
 	// event handlers
 	HandlerTable		m_handlers;
 
+	// metrics
+	MetricCounter*		m_dispatched[kMaxCountedTypes];
+	MetricCounter*		m_dispatchedOther;
+	MetricGauge*		m_depth;
+
 public:
 	//
 	// Event type providers.
@@ -192,7 +192,7 @@ REGISTER_EVENT(IpcServer, messageReceived)
 
 REGISTER_EVENT(Clipboard, clipboardGrabbed)
 REGISTER_EVENT(Clipboard, clipboardChanged)
-REGISTER_EVENT(Clipboard, clipboardSending)
+REGISTER_EVENT(Clipboard, clipboardFormatsRequested)
 
 //
 // File
@@ -201,3 +201,4 @@ REGISTER_EVENT(Clipboard, clipboardSending)
 REGISTER_EVENT(File, fileChunkSending)
 REGISTER_EVENT(File, fileRecieveCompleted)
 REGISTER_EVENT(File, keepAlive)
+REGISTER_EVENT(File, fileTransferProgress)
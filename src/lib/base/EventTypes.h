@@ -690,7 +690,7 @@ public:
 	ClipboardEvents() :
 		m_clipboardGrabbed(Event::kUnknown),
 		m_clipboardChanged(Event::kUnknown),
-		m_clipboardSending(Event::kUnknown) { }
+		m_clipboardFormatsRequested(Event::kUnknown) { }
 
 	//! @name accessors
 	//@{
@@ -711,19 +711,21 @@ public:
 	*/
 	Event::Type		clipboardChanged();
 
-	//! Clipboard sending event type
+	//! Get clipboard formats requested event type
 	/*!
-	Returns the clipboard sending event type. This is used to send 
-	clipboard chunks.
+	Returns the clipboard formats requested event type.  This is sent
+	when a program asks for clipboard formats that were promised with
+	IPlatformScreen::promiseClipboard() and whose data hasn't been
+	given yet.  The data is a pointer to a IScreen::ClipboardFormatInfo.
 	*/
-	Event::Type		clipboardSending();
+	Event::Type		clipboardFormatsRequested();
 
 	//@}
 
 private:
 	Event::Type		m_clipboardGrabbed;
 	Event::Type		m_clipboardChanged;
-	Event::Type		m_clipboardSending;
+	Event::Type		m_clipboardFormatsRequested;
 };
 
 class FileEvents : public EventTypes {
@@ -731,7 +733,8 @@ public:
 	FileEvents() :
 		m_fileChunkSending(Event::kUnknown),
 		m_fileRecieveCompleted(Event::kUnknown),
-		m_keepAlive(Event::kUnknown) { }
+		m_keepAlive(Event::kUnknown),
+		m_fileTransferProgress(Event::kUnknown) { }
 
 	//! @name accessors
 	//@{
@@ -745,10 +748,18 @@ public:
 	//! Send a keep alive
 	Event::Type		keepAlive();
 
+	//! Queued file transfer progress
+	/*!
+	Sent when part of a queued file has been sent.  The data is a
+	FileTransferQueue::ProgressInfo*.
+	*/
+	Event::Type		fileTransferProgress();
+
 	//@}
 
 private:
 	Event::Type		m_fileChunkSending;
 	Event::Type		m_fileRecieveCompleted;
 	Event::Type		m_keepAlive;
+	Event::Type		m_fileTransferProgress;
 };
@@ -22,6 +22,31 @@
 #include "base/ELevel.h"
 #include "common/IInterface.h"
 
+#include <ctime>
+
+//! Log record
+/*!
+A log message as passed to outputters:  the formatted text and the
+parts it was made from, for outputters that would rather not parse
+the text.
+*/
+class LogRecord {
+public:
+	//! Priority
+	ELevel				m_level;
+	//! Time the message was logged
+	time_t				m_time;
+	//! Source file, or NULL if the build doesn't log it
+	const char*			m_file;
+	//! Source line
+	int					m_line;
+	//! The message without the prefix or source;  not null terminated
+	const char*			m_message;
+	size_t				m_messageSize;
+	//! The formatted message
+	const char*			m_text;
+};
+
 //! Outputter interface
 /*!
 Type of outputter interface.  The logger performs all output through
@@ -65,5 +90,16 @@ public:
 	*/
 	virtual bool		write(ELevel level, const char* message) = 0;
 
+	//! Write a log record
+	/*!
+	Writes \c record to a log.  The logger calls this rather than
+	\c write() so an outputter can use the parts of the message;  by
+	default it writes the formatted text.  Returns as \c write().
+	*/
+	virtual bool		writeRecord(const LogRecord& record)
+	{
+		return write(record.m_level, record.m_text);
+	}
+
 	//@}
 };
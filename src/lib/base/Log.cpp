@@ -22,7 +22,9 @@
 #include "base/String.h"
 #include "base/log_outputters.h"
 #include "common/Version.h"
+#include "common/stdvector.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <iostream>
@@ -46,6 +48,9 @@ static const char*		g_priority[] = {
 // number of priorities
 static const int g_numPriority = (int)(sizeof(g_priority) / sizeof(g_priority[0]));
 
+// size a thread's format buffer starts with
+static const size_t		kLogBufferSize = 1024;
+
 // the default priority
 #ifndef NDEBUG
 static const int		g_defaultMaxPriority = kDEBUG;
@@ -53,6 +58,48 @@ static const int		g_defaultMaxPriority = kDEBUG;
 static const int		g_defaultMaxPriority = kINFO;
 #endif
 
+//
+// LogBuffer
+//
+
+// a thread's format buffer and the timestamp of the last second it
+// printed in, so print neither allocates nor calls localtime per message
+class LogBuffer {
+public:
+	LogBuffer() :
+		m_data(kLogBufferSize),
+		m_time(-1),
+		m_timestampSize(0) { }
+
+	std::vector<char>	m_data;
+	time_t				m_time;
+	size_t				m_timestampSize;
+	char				m_timestamp[32];
+};
+
+static size_t
+formatPrefix(LogBuffer& buffer, int priority, time_t t)
+{
+	if (t != buffer.m_time) {
+		struct tm* tm = localtime(&t);
+		buffer.m_timestampSize = sprintf(buffer.m_timestamp,
+							"[%04i-%02i-%02iT%02i:%02i:%02i] ",
+							tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
+							tm->tm_hour, tm->tm_min, tm->tm_sec);
+		buffer.m_time = t;
+	}
+
+	// the buffer is always much bigger than the prefix
+	char* data = &buffer.m_data[0];
+	memcpy(data, buffer.m_timestamp, buffer.m_timestampSize);
+	size_t size = buffer.m_timestampSize;
+	size_t nameSize = strlen(g_priority[priority]);
+	memcpy(data + size, g_priority[priority], nameSize);
+	size += nameSize;
+	memcpy(data + size, ": ", 2);
+	return size + 2;
+}
+
 //
 // Log
 //
@@ -68,7 +115,6 @@ Log::Log()
 
 	// other initalization
 	m_maxPriority = g_defaultMaxPriority;
-	m_maxNewlineLength = 0;
 	insert(new ConsoleLogOutputter);
 
 	s_log = this;
@@ -116,97 +162,63 @@ Log::getFilterName(int level) const
 }
 
 void
-Log::print(const char* file, int line, const char* fmt, ...)
+Log::print(int priority, const char* file, int line, const char* fmt, ...)
 {
-	// check if fmt begins with a priority argument
-	ELevel priority = kINFO;
-	if ((strlen(fmt) > 2) && (fmt[0] == '%' && fmt[1] == 'z')) {
-
-		// 060 in octal is 0 (48 in decimal), so subtracting this converts ascii
-		// number it a true number. we could use atoi instead, but this is how
-		// it was done originally.
-		priority = (ELevel)(fmt[2] - '\060');
-
-		// move the pointer on past the debug priority char
-		fmt += 3;
-	}
-
 	// done if below priority threshold
 	if (priority > getFilter()) {
 		return;
 	}
 
-	// compute prefix padding length
-	char stack[1024];
+	// each thread formats into its own buffer, which only grows
+	static thread_local LogBuffer s_buffer;
+	std::vector<char>& buffer = s_buffer.m_data;
 
-	// compute suffix padding length
-	int sPad = m_maxNewlineLength;
+	LogRecord record;
+	record.m_level = static_cast<ELevel>(priority);
+	record.m_time  = time(NULL);
+	record.m_file  = NULL;
+	record.m_line  = 0;
 
-	// print to buffer, leaving space for a newline at the end and prefix
-	// at the beginning.
-	char* buffer = stack;
-	int len			= (int)(sizeof(stack) / sizeof(stack[0]));
+	// print the prefix to the buffer.  do not prefix time and file for
+	// kPRINT (CLOG_PRINT)
+	size_t size = 0;
+	if (priority != kPRINT) {
+		size = formatPrefix(s_buffer, priority, record.m_time);
+	}
+	size_t prefixSize = size;
+
+	// print the message after the prefix, growing the buffer if it
+	// wasn't big enough
 	while (true) {
-		// try printing into the buffer
+		int space = static_cast<int>(buffer.size() - size);
 		va_list args;
 		va_start(args, fmt);
-		int n = ARCH->vsnprintf(buffer, len	- sPad, fmt, args);
+		int n = ARCH->vsnprintf(&buffer[size], space, fmt, args);
 		va_end(args);
 
-		// if the buffer wasn't big enough then make it bigger and try again
-		if (n < 0 || n > (int)len) {
-			if (buffer != stack) {
-				delete[] buffer;
-			}
-			len	 *= 2;
-			buffer = new char[len];
-		}
-
-		// if the buffer was big enough then continue
-		else {
+		if (n >= 0 && n < space) {
+			size += n;
 			break;
 		}
+		buffer.resize((n >= 0) ? size + n + 1 : buffer.size() * 2);
 	}
 
-	// print the prefix to the buffer.	leave space for priority label.
-	// do not prefix time and file for kPRINT (CLOG_PRINT)
-	if (priority != kPRINT) {
-
-		struct tm *tm;
-		char timestamp[50];
-		time_t t;
-		time(&t);
-		tm = localtime(&t);
-		sprintf(timestamp, "%04i-%02i-%02iT%02i:%02i:%02i", tm->tm_year + 1900, tm->tm_mon+1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec);
-
-		// square brackets, spaces, comma and null terminator take about 10
-		size_t size = 10;
-		size += strlen(timestamp);
-		size += strlen(g_priority[priority]);
-		size += strlen(buffer);
-#ifndef NDEBUG
-		size += strlen(file);
-		// assume there is no file contains over 100k lines of code
-		size += 6;
-#endif
-		char* message = new char[size];
+	record.m_messageSize = size - prefixSize;
 
 #ifndef NDEBUG
-		sprintf(message, "[%s] %s: %s\n\t%s,%d", timestamp, g_priority[priority], buffer, file, line);
-#else
-		sprintf(message, "[%s] %s: %s", timestamp, g_priority[priority], buffer);
-#endif
-
-		output(priority, message);
-		delete[] message;
-	} else {
-		output(priority, buffer);
+	if (priority != kPRINT && file != NULL) {
+		// newline, tab, comma, line number and null terminator
+		buffer.resize(std::max(buffer.size(), size + strlen(file) + 16));
+		sprintf(&buffer[size], "\n\t%s,%d", file, line);
+		record.m_file = file;
+		record.m_line = line;
 	}
+#endif
 
-	// clean up
-	if (buffer != stack) {
-		delete[] buffer;
-	}
+	// the buffer doesn't move once the message is printed
+	record.m_message = &buffer[prefixSize];
+	record.m_text    = &buffer[0];
+	output(record);
 }
 
 void
@@ -271,23 +283,20 @@ Log::setFilter(const char* maxPriority)
 void
 Log::setFilter(int maxPriority)
 {
-	ArchMutexLock lock(m_mutex);
-	m_maxPriority = maxPriority;
+	m_maxPriority.store(maxPriority, std::memory_order_relaxed);
 }
 
 int
 Log::getFilter() const
 {
-	ArchMutexLock lock(m_mutex);
-	return m_maxPriority;
+	return m_maxPriority.load(std::memory_order_relaxed);
 }
 
 void
-Log::output(ELevel priority, char* msg)
+Log::output(const LogRecord& record)
 {
-	assert(priority >= -1 && priority < g_numPriority);
-	assert(msg != NULL);
-	if (!msg) return;
+	assert(record.m_level >= -1 && record.m_level < g_numPriority);
+	assert(record.m_text != NULL);
 
 	ArchMutexLock lock(m_mutex);
 
@@ -296,13 +305,13 @@ Log::output(ELevel priority, char* msg)
 	for (i = m_alwaysOutputters.begin(); i != m_alwaysOutputters.end(); ++i) {
 
 		// write to outputter
-		(*i)->write(priority, msg);
+		(*i)->writeRecord(record);
 	}
 
 	for (i = m_outputters.begin(); i != m_outputters.end(); ++i) {
 
 		// write to outputter and break out of loop if it returns false
-		if (!(*i)->write(priority, msg)) {
+		if (!(*i)->writeRecord(record)) {
 			break;
 		}
 	}
@@ -23,12 +23,14 @@
 #include "common/common.h"
 #include "common/stdlist.h"
 
+#include <atomic>
 #include <stdarg.h>
 
 #define CLOG (Log::getInstance())
 #define BYE "\nTry `%s --help' for more information."
 
 class ILogOutputter;
+class LogRecord;
 class Thread;
 
 //! Logging facility
@@ -100,16 +102,26 @@ public:
 
 	//! Print a log message
 	/*!
-	Print a log message using the printf-like \c format and arguments
-	preceded by the filename and line number.  If \c file is NULL then
-	neither the file nor the line are printed.
+	Print a log message of \c priority using the printf-like \c format
+	and arguments preceded by the filename and line number.  If \c file
+	is NULL then neither the file nor the line are printed.
 	*/
-	void				print(const char* file, int line,
+	void				print(int priority, const char* file, int line,
 							const char* format, ...);
 
 	//! Get the minimum priority level.
 	int					getFilter() const;
 
+	//! Check the filter
+	/*!
+	Returns true if messages of \c priority pass the filter.  This
+	doesn't lock, so LOG() calls it before evaluating its arguments.
+	*/
+	static bool			isEnabled(int priority)
+	{
+		return priority <= s_log->m_maxPriority.load(std::memory_order_relaxed);
+	}
+
 	//! Get the filter name of the current filter level.
 	const char*			getFilterName() const;
 
@@ -125,7 +137,7 @@ public:
 	//@}
 
 private:
-	void				output(ELevel priority, char* msg);
+	void				output(const LogRecord& record);
 
 private:
 	typedef std::list<ILogOutputter*> OutputterList;
@@ -135,8 +147,7 @@ private:
 	ArchMutex			m_mutex;
 	OutputterList		m_outputters;
 	OutputterList		m_alwaysOutputters;
-	int					m_maxNewlineLength;
-	int					m_maxPriority;
+	std::atomic<int>	m_maxPriority;
 };
 
 /*!
@@ -152,10 +163,13 @@ replaced by one of enumerants in \c Log::ELevel without the leading
 \c k.  For example, \c CLOG_INFO.  The special \c CLOG_PRINT level will
 not be filtered and is never prefixed by the filename and line number.
 
+The arguments are only evaluated if the priority passes the filter, so
+a filtered message costs a compare.  Messages with a lower priority
+than \c LOG_MAX_LEVEL are compiled out.
+
 If \c NOLOGGING is defined during the build then this macro expands to
 nothing.  If \c NDEBUG is defined during the build then it expands to a
-call to Log::print.  Otherwise it expands to a call to Log::printt,
-which includes the filename and line number.
+call to Log::print without the filename and line number.
 */
 
 /*!
@@ -178,34 +192,51 @@ to a call to Log::print that prints the filename and line number,
 otherwise it expands to a call that doesn't.
 */
 
+/*!
+\def LOG_MAX_LEVEL
+The lowest priority that is compiled in.  LOG() calls with a lower
+priority compile to nothing.  Set by the LOG_MAX_LEVEL CMake option.
+*/
+#if !defined(LOG_MAX_LEVEL)
+#define LOG_MAX_LEVEL	::kDEBUG5
+#endif
+
 #if defined(NOLOGGING)
 #define LOG(_a1)
 #define LOGC(_a1, _a2)
 #define CLOG_TRACE
-#elif defined(NDEBUG)
-#define LOG(_a1)		CLOG->print _a1
-#define LOGC(_a1, _a2)	if (_a1) CLOG->print _a2
-#define CLOG_TRACE		NULL, 0,
 #else
-#define LOG(_a1)		CLOG->print _a1
-#define LOGC(_a1, _a2)	if (_a1) CLOG->print _a2
-#define CLOG_TRACE		__FILE__, __LINE__,
+#define LOG(_a1)		LOG_PRINT _a1
+#define LOGC(_a1, _a2)	if (_a1) LOG(_a2)
+#if defined(NDEBUG)
+#define CLOG_TRACE		NULL, 0
+#else
+#define CLOG_TRACE		__FILE__, __LINE__
+#endif
 #endif
 
-// the CLOG_* defines are line and file plus %z and an octal number (060=0, 
-// 071=9), but the limitation is that once we run out of numbers at either 
-// end, then we resort to using non-numerical chars. this still works (since 
-// to deduce the number we subtract octal \060, so '/' is -1, and ':' is 10
-
-#define CLOG_PRINT		CLOG_TRACE "%z\057" // char is '/'
-#define CLOG_CRIT		CLOG_TRACE "%z\060" // char is '0'
-#define CLOG_ERR		CLOG_TRACE "%z\061"
-#define CLOG_WARN		CLOG_TRACE "%z\062"
-#define CLOG_NOTE		CLOG_TRACE "%z\063"
-#define CLOG_INFO		CLOG_TRACE "%z\064"
-#define CLOG_DEBUG		CLOG_TRACE "%z\065"
-#define CLOG_DEBUG1		CLOG_TRACE "%z\066"
-#define CLOG_DEBUG2		CLOG_TRACE "%z\067"
-#define CLOG_DEBUG3		CLOG_TRACE "%z\070"
-#define CLOG_DEBUG4		CLOG_TRACE "%z\071" // char is '9'
-#define CLOG_DEBUG5		CLOG_TRACE "%z\072" // char is ':'
+// LOG() expands its argument before passing it to LOG_PRINT, so the
+// CLOG_* priority, file and line become separate arguments
+#define LOG_PRINT(_priority, ...) \
+	do { \
+		if ((_priority) <= LOG_MAX_LEVEL && Log::isEnabled(_priority)) { \
+			CLOG->print(_priority, __VA_ARGS__); \
+		} \
+	} while (0)
+
+// the CLOG_* defines are the priority, then the file and line.  the
+// priority is qualified so enumerants of the same name in a class don't
+// hide it.
+
+#define CLOG_PRINT		::kPRINT, CLOG_TRACE,
+#define CLOG_CRIT		::kFATAL, CLOG_TRACE,
+#define CLOG_ERR		::kERROR, CLOG_TRACE,
+#define CLOG_WARN		::kWARNING, CLOG_TRACE,
+#define CLOG_NOTE		::kNOTE, CLOG_TRACE,
+#define CLOG_INFO		::kINFO, CLOG_TRACE,
+#define CLOG_DEBUG		::kDEBUG, CLOG_TRACE,
+#define CLOG_DEBUG1		::kDEBUG1, CLOG_TRACE,
+#define CLOG_DEBUG2		::kDEBUG2, CLOG_TRACE,
+#define CLOG_DEBUG3		::kDEBUG3, CLOG_TRACE,
+#define CLOG_DEBUG4		::kDEBUG4, CLOG_TRACE,
+#define CLOG_DEBUG5		::kDEBUG5, CLOG_TRACE,
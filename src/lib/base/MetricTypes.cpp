@@ -0,0 +1,216 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/MetricTypes.h"
+
+// durations below kExact are counted exactly.  each power of two above
+// that is split into kSubBuckets buckets.
+static const UInt32		kExact      = 16;
+static const UInt32		kExactBits  = 4;
+static const UInt32		kSubBits    = 3;
+static const UInt32		kSubBuckets = 1 << kSubBits;
+
+// each thread adds to the stripe it was given the first time it added
+static std::atomic<UInt32>	s_nextStripe(0);
+
+static UInt32
+getStripe()
+{
+	static thread_local UInt32 s_stripe =
+		s_nextStripe.fetch_add(1, std::memory_order_relaxed) %
+		MetricCounter::kNumStripes;
+	return s_stripe;
+}
+
+//
+// MetricCounter
+//
+
+MetricCounter::MetricCounter()
+{
+	for (UInt32 i = 0; i < kNumStripes; ++i) {
+		m_stripes[i].m_value.store(0, std::memory_order_relaxed);
+	}
+}
+
+void
+MetricCounter::add(UInt64 n)
+{
+	m_stripes[getStripe()].m_value.fetch_add(n, std::memory_order_relaxed);
+}
+
+UInt64
+MetricCounter::getValue() const
+{
+	UInt64 value = 0;
+	for (UInt32 i = 0; i < kNumStripes; ++i) {
+		value += m_stripes[i].m_value.load(std::memory_order_relaxed);
+	}
+	return value;
+}
+
+
+//
+// MetricGauge
+//
+
+MetricGauge::MetricGauge() :
+	m_value(0)
+{
+	// do nothing
+}
+
+void
+MetricGauge::set(SInt64 value)
+{
+	m_value.store(value, std::memory_order_relaxed);
+}
+
+void
+MetricGauge::add(SInt64 delta)
+{
+	m_value.fetch_add(delta, std::memory_order_relaxed);
+}
+
+SInt64
+MetricGauge::getValue() const
+{
+	return m_value.load(std::memory_order_relaxed);
+}
+
+
+//
+// MetricHistogram
+//
+
+MetricHistogram::MetricHistogram() :
+	m_count(0),
+	m_sum(0)
+{
+	for (UInt32 i = 0; i < kNumBuckets; ++i) {
+		m_counts[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+void
+MetricHistogram::add(UInt64 us)
+{
+	m_counts[getBucket(us)].fetch_add(1, std::memory_order_relaxed);
+	m_count.fetch_add(1, std::memory_order_relaxed);
+	m_sum.fetch_add(us, std::memory_order_relaxed);
+}
+
+bool
+MetricHistogram::addToBucket(UInt32 bucket, UInt32 count)
+{
+	if (bucket >= kNumBuckets) {
+		return false;
+	}
+	m_counts[bucket].fetch_add(count, std::memory_order_relaxed);
+	m_count.fetch_add(count, std::memory_order_relaxed);
+	m_sum.fetch_add(getBucketLimit(bucket) * count, std::memory_order_relaxed);
+	return true;
+}
+
+UInt64
+MetricHistogram::getCount() const
+{
+	return m_count.load(std::memory_order_relaxed);
+}
+
+UInt64
+MetricHistogram::getSum() const
+{
+	return m_sum.load(std::memory_order_relaxed);
+}
+
+UInt32
+MetricHistogram::getBucketCount(UInt32 bucket) const
+{
+	if (bucket >= kNumBuckets) {
+		return 0;
+	}
+	return m_counts[bucket].load(std::memory_order_relaxed);
+}
+
+UInt64
+MetricHistogram::getPercentile(double percent) const
+{
+	// take a copy so the rank and the buckets agree even while other
+	// threads are adding
+	UInt32 counts[kNumBuckets];
+	UInt64 total = 0;
+	for (UInt32 i = 0; i < kNumBuckets; ++i) {
+		counts[i] = m_counts[i].load(std::memory_order_relaxed);
+		total    += counts[i];
+	}
+	if (total == 0) {
+		return 0;
+	}
+
+	// find the bucket holding the duration with the wanted rank
+	UInt64 rank = static_cast<UInt64>(percent / 100.0 *
+							static_cast<double>(total) + 0.5);
+	if (rank < 1) {
+		rank = 1;
+	}
+	else if (rank > total) {
+		rank = total;
+	}
+	UInt64 seen = 0;
+	for (UInt32 i = 0; i < kNumBuckets; ++i) {
+		seen += counts[i];
+		if (seen >= rank) {
+			return getBucketLimit(i);
+		}
+	}
+	return getBucketLimit(kNumBuckets - 1);
+}
+
+UInt32
+MetricHistogram::getBucket(UInt64 us)
+{
+	if (us < kExact) {
+		return static_cast<UInt32>(us);
+	}
+
+	// find the highest set bit
+	UInt32 bit = kExactBits;
+	while (bit < 63 && (us >> (bit + 1)) != 0) {
+		++bit;
+	}
+
+	// the bits after it select the sub-bucket
+	UInt32 sub    = static_cast<UInt32>(us >> (bit - kSubBits)) & (kSubBuckets - 1);
+	UInt32 bucket = kExact + (bit - kExactBits) * kSubBuckets + sub;
+	return (bucket < kNumBuckets) ? bucket : kNumBuckets - 1;
+}
+
+UInt64
+MetricHistogram::getBucketLimit(UInt32 bucket)
+{
+	if (bucket < kExact) {
+		return bucket;
+	}
+	if (bucket >= kNumBuckets) {
+		bucket = kNumBuckets - 1;
+	}
+	UInt32 bit   = kExactBits + (bucket - kExact) / kSubBuckets;
+	UInt64 sub   = (bucket - kExact) % kSubBuckets;
+	UInt64 width = static_cast<UInt64>(1) << (bit - kSubBits);
+	return ((kSubBuckets + sub) << (bit - kSubBits)) + width - 1;
+}
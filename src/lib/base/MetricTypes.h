@@ -0,0 +1,167 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/basic_types.h"
+
+#include <atomic>
+
+//! Metric counter
+/*!
+A monotonic counter that any thread can add to without locking.  The
+count is spread over a few cache line sized stripes, each thread adding
+to its own, so busy threads don't fight over one cache line.  Reading
+sums the stripes.
+*/
+class MetricCounter {
+public:
+	enum {
+		//! Number of stripes
+		kNumStripes = 8
+	};
+
+	MetricCounter();
+
+	//! @name manipulators
+	//@{
+
+	//! Add to the count
+	void				add(UInt64 n = 1);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get count
+	UInt64				getValue() const;
+
+	//@}
+
+private:
+	class Stripe {
+	public:
+		std::atomic<UInt64>	m_value;
+		char			m_pad[64 - sizeof(std::atomic<UInt64>)];
+	};
+
+	Stripe				m_stripes[kNumStripes];
+};
+
+//! Metric gauge
+/*!
+A value that goes up and down, e.g. the length of a queue.
+*/
+class MetricGauge {
+public:
+	MetricGauge();
+
+	//! @name manipulators
+	//@{
+
+	//! Set value
+	void				set(SInt64 value);
+
+	//! Add to value
+	/*!
+	Adds \c delta, which may be negative, to the value.
+	*/
+	void				add(SInt64 delta);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get value
+	SInt64				getValue() const;
+
+	//@}
+
+private:
+	std::atomic<SInt64>	m_value;
+};
+
+//! Metric histogram
+/*!
+Counts durations in microseconds without locking, in buckets whose
+width grows with the duration so percentiles are within 1/8 of the true
+value from 16us up to over an hour.  Durations below 16us are counted
+exactly.
+*/
+class MetricHistogram {
+public:
+	enum {
+		//! Number of buckets
+		kNumBuckets = 240
+	};
+
+	MetricHistogram();
+
+	//! @name manipulators
+	//@{
+
+	//! Add a duration
+	/*!
+	Counts a duration of \c us microseconds.
+	*/
+	void				add(UInt64 us);
+
+	//! Add to a bucket
+	/*!
+	Adds \c count durations to bucket \c bucket, as if they all were the
+	highest duration of the bucket.  Returns false if there's no such
+	bucket.
+	*/
+	bool				addToBucket(UInt32 bucket, UInt32 count);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get number of durations
+	UInt64				getCount() const;
+
+	//! Get sum of durations
+	/*!
+	Returns the sum of the counted durations in microseconds.
+	*/
+	UInt64				getSum() const;
+
+	//! Get count of a bucket
+	UInt32				getBucketCount(UInt32 bucket) const;
+
+	//! Get percentile
+	/*!
+	Returns the duration in microseconds that \c percent percent of the
+	counted durations don't exceed, rounded up to the end of its bucket.
+	Returns 0 if the histogram is empty.
+	*/
+	UInt64				getPercentile(double percent) const;
+
+	//! Get bucket of a duration
+	static UInt32		getBucket(UInt64 us);
+
+	//! Get highest duration of a bucket
+	static UInt64		getBucketLimit(UInt32 bucket);
+
+	//@}
+
+private:
+	std::atomic<UInt32>	m_counts[kNumBuckets];
+	std::atomic<UInt64>	m_count;
+	std::atomic<UInt64>	m_sum;
+};
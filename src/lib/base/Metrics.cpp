@@ -0,0 +1,238 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Metrics.h"
+#include "arch/Arch.h"
+
+#include <cassert>
+
+// histograms are exported with a bucket for every power of two
+// microseconds, i.e. every 8th MetricHistogram bucket after the exact
+// ones
+static const UInt32		kFirstExportedBucket = 15;
+static const UInt32		kExportedBucketStep  = 8;
+
+template <class T>
+static T*
+getMetric(std::map<String, T*>& metrics, const String& labels)
+{
+	T*& metric = metrics[labels];
+	if (metric == NULL) {
+		metric = new T;
+	}
+	return metric;
+}
+
+template <class T>
+static void
+deleteMetrics(std::map<String, T*>& metrics)
+{
+	for (typename std::map<String, T*>::iterator i = metrics.begin();
+							i != metrics.end(); ++i) {
+		delete i->second;
+	}
+	metrics.clear();
+}
+
+static String
+formatName(const String& name, const String& labels)
+{
+	if (labels.empty()) {
+		return name;
+	}
+	return name + "{" + labels + "}";
+}
+
+static String
+formatSeconds(UInt64 us)
+{
+	return synergy::string::sprintf("%.9g", static_cast<double>(us) / 1.0e6);
+}
+
+static String
+formatCount(UInt64 count)
+{
+	return synergy::string::sprintf("%llu",
+							static_cast<unsigned long long>(count));
+}
+
+//
+// Metrics
+//
+
+Metrics::Metrics()
+{
+	m_mutex = ARCH->newMutex();
+}
+
+Metrics::~Metrics()
+{
+	for (FamilyMap::iterator i = m_families.begin();
+							i != m_families.end(); ++i) {
+		deleteMetrics(i->second.m_counters);
+		deleteMetrics(i->second.m_gauges);
+		deleteMetrics(i->second.m_histograms);
+	}
+	ARCH->closeMutex(m_mutex);
+}
+
+MetricCounter*
+Metrics::getCounter(const char* name, const char* help, const String& labels)
+{
+	ArchMutexLock lock(m_mutex);
+	return getMetric(getFamily(name, help, kCounter).m_counters, labels);
+}
+
+MetricGauge*
+Metrics::getGauge(const char* name, const char* help, const String& labels)
+{
+	ArchMutexLock lock(m_mutex);
+	return getMetric(getFamily(name, help, kGauge).m_gauges, labels);
+}
+
+MetricHistogram*
+Metrics::getHistogram(const char* name, const char* help,
+				const String& labels)
+{
+	ArchMutexLock lock(m_mutex);
+	return getMetric(getFamily(name, help, kHistogram).m_histograms, labels);
+}
+
+String
+Metrics::format() const
+{
+	ArchMutexLock lock(m_mutex);
+
+	String out;
+	for (FamilyMap::const_iterator i = m_families.begin();
+							i != m_families.end(); ++i) {
+		const String& name   = i->first;
+		const Family& family = i->second;
+
+		out += "# HELP " + name + " " + family.m_help + "\n";
+		switch (family.m_type) {
+		case kCounter:
+			out += "# TYPE " + name + " counter\n";
+			for (CounterMap::const_iterator j = family.m_counters.begin();
+							j != family.m_counters.end(); ++j) {
+				out += formatName(name, j->first) + " " +
+						formatCount(j->second->getValue()) + "\n";
+			}
+			break;
+
+		case kGauge:
+			out += "# TYPE " + name + " gauge\n";
+			for (GaugeMap::const_iterator j = family.m_gauges.begin();
+							j != family.m_gauges.end(); ++j) {
+				out += formatName(name, j->first) + " " +
+						synergy::string::sprintf("%lld",
+							static_cast<long long>(j->second->getValue())) +
+						"\n";
+			}
+			break;
+
+		case kHistogram:
+			out += "# TYPE " + name + " histogram\n";
+			for (HistogramMap::const_iterator j = family.m_histograms.begin();
+							j != family.m_histograms.end(); ++j) {
+				formatHistogram(out, name, j->first, *j->second);
+			}
+			break;
+		}
+	}
+	return out;
+}
+
+String
+Metrics::label(const char* name, const String& value)
+{
+	String escaped;
+	escaped.reserve(value.size());
+	for (String::const_iterator i = value.begin(); i != value.end(); ++i) {
+		switch (*i) {
+		case '\\':
+			escaped += "\\\\";
+			break;
+
+		case '"':
+			escaped += "\\\"";
+			break;
+
+		case '\n':
+			escaped += "\\n";
+			break;
+
+		default:
+			escaped += *i;
+			break;
+		}
+	}
+	return String(name) + "=\"" + escaped + "\"";
+}
+
+Metrics&
+Metrics::getInstance()
+{
+	// never destroyed.  static objects are destroyed after main() has
+	// destroyed ARCH, which the registry needs to close its mutex.
+	static Metrics* s_instance = new Metrics;
+	return *s_instance;
+}
+
+Metrics::Family&
+Metrics::getFamily(const char* name, const char* help, EType type)
+{
+	// note -- m_mutex must be locked on entry
+
+	FamilyMap::iterator i = m_families.find(name);
+	if (i == m_families.end()) {
+		Family& family = m_families[name];
+		family.m_type  = type;
+		family.m_help  = help;
+		return family;
+	}
+
+	// a name always has the same type
+	assert(i->second.m_type == type);
+	return i->second;
+}
+
+void
+Metrics::formatHistogram(String& out, const String& name,
+				const String& labels, const MetricHistogram& histogram)
+{
+	String prefix = labels.empty() ? String() : labels + ",";
+
+	// the buckets are cumulative.  the total is summed from the same
+	// reads so it agrees with the buckets while other threads add.
+	UInt64 count = 0;
+	for (UInt32 i = 0; i < MetricHistogram::kNumBuckets; ++i) {
+		count += histogram.getBucketCount(i);
+		if (i >= kFirstExportedBucket &&
+			(i - kFirstExportedBucket) % kExportedBucketStep == 0) {
+			UInt64 limit = MetricHistogram::getBucketLimit(i) + 1;
+			out += name + "_bucket{" + prefix + "le=\"" +
+					formatSeconds(limit) + "\"} " + formatCount(count) + "\n";
+		}
+	}
+	out += name + "_bucket{" + prefix + "le=\"+Inf\"} " +
+			formatCount(count) + "\n";
+	out += formatName(name + "_sum", labels) + " " +
+			formatSeconds(histogram.getSum()) + "\n";
+	out += formatName(name + "_count", labels) + " " +
+			formatCount(count) + "\n";
+}
@@ -0,0 +1,123 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/MetricTypes.h"
+#include "base/String.h"
+#include "arch/IArchMultithread.h"
+#include "common/stdmap.h"
+
+//! Metrics registry
+/*!
+Owns the counters, gauges and histograms that describe how synergy is
+doing and formats them for Prometheus.  A metric is found by its name
+and labels; asking again for the same name and labels returns the same
+metric, so callers normally look a metric up once and keep the pointer.
+Metrics live as long as the registry.
+
+Updating a metric never takes a lock, only looking one up does.
+*/
+class Metrics {
+public:
+	Metrics();
+	~Metrics();
+
+	//! @name manipulators
+	//@{
+
+	//! Get counter
+	/*!
+	Returns the counter named \c name with labels \c labels, creating
+	it if necessary.  \c labels is empty or a comma separated list of
+	label() results.  \c help describes the metric.
+	*/
+	MetricCounter*		getCounter(const char* name, const char* help,
+							const String& labels = String());
+
+	//! Get gauge
+	/*!
+	Like getCounter() but for a gauge.
+	*/
+	MetricGauge*		getGauge(const char* name, const char* help,
+							const String& labels = String());
+
+	//! Get histogram
+	/*!
+	Like getCounter() but for a histogram of durations.  The name should
+	end in \c _seconds because the durations are exported in seconds.
+	*/
+	MetricHistogram*	getHistogram(const char* name, const char* help,
+							const String& labels = String());
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Format metrics
+	/*!
+	Returns all metrics in the Prometheus text exposition format.
+	Histograms get a bucket for every power of two microseconds.
+	*/
+	String				format() const;
+
+	//! Make a label
+	/*!
+	Returns the label \c name with value \c value, escaped as needed.
+	*/
+	static String		label(const char* name, const String& value);
+
+	//! Get the registry
+	/*!
+	Returns the registry the instrumented code uses.  It's created on
+	first use, which must be while ARCH exists, and never destroyed.
+	*/
+	static Metrics&		getInstance();
+
+	//@}
+
+private:
+	enum EType {
+		kCounter,
+		kGauge,
+		kHistogram
+	};
+
+	typedef std::map<String, MetricCounter*> CounterMap;
+	typedef std::map<String, MetricGauge*> GaugeMap;
+	typedef std::map<String, MetricHistogram*> HistogramMap;
+
+	class Family {
+	public:
+		EType			m_type;
+		String			m_help;
+		CounterMap		m_counters;
+		GaugeMap		m_gauges;
+		HistogramMap	m_histograms;
+	};
+	typedef std::map<String, Family> FamilyMap;
+
+	Family&				getFamily(const char* name, const char* help,
+							EType type);
+	static void			formatHistogram(String& out, const String& name,
+							const String& labels,
+							const MetricHistogram& histogram);
+
+private:
+	ArchMutex			m_mutex;
+	FamilyMap			m_families;
+};
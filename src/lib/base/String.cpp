@@ -246,6 +246,68 @@ splitString(String string, const char c)
 	return results;
 }
 
+String
+linefeedToCRLF(const String& src)
+{
+	size_t numNewlines = std::count(src.begin(), src.end(), '\n');
+	if (numNewlines == 0) {
+		return src;
+	}
+
+	// copy the text between newlines with memchr() and memcpy(), which
+	// go through it many bytes at a time
+	String dst(src.size() + numNewlines, '\0');
+	const char* scan = src.data();
+	const char* end  = scan + src.size();
+	char* out        = &dst[0];
+	for (;;) {
+		const char* lf = static_cast<const char*>(
+							memchr(scan, '\n', end - scan));
+		if (lf == NULL) {
+			memcpy(out, scan, end - scan);
+			break;
+		}
+		memcpy(out, scan, lf - scan);
+		out   += lf - scan;
+		*out++ = '\r';
+		*out++ = '\n';
+		scan   = lf + 1;
+	}
+
+	return dst;
+}
+
+String
+crlfToLinefeed(const String& src)
+{
+	if (src.find("\r\n") == String::npos) {
+		return src;
+	}
+
+	String dst(src.size(), '\0');
+	const char* scan = src.data();
+	const char* end  = scan + src.size();
+	char* out        = &dst[0];
+	for (;;) {
+		const char* cr = static_cast<const char*>(
+							memchr(scan, '\r', end - scan));
+		if (cr == NULL) {
+			memcpy(out, scan, end - scan);
+			out += end - scan;
+			break;
+		}
+		memcpy(out, scan, cr - scan);
+		out += cr - scan;
+		if (cr + 1 == end || cr[1] != '\n') {
+			*out++ = '\r';
+		}
+		scan = cr + 1;
+	}
+	dst.resize(out - dst.data());
+
+	return dst;
+}
+
 //
 // CaselessCmp
 //
@@ -107,6 +107,18 @@ Split a \c string that separated by a \c c into substrings
 */
 std::vector<String> splitString(String string, const char c);
 
+//! Convert line feeds to CRLF
+/*!
+Returns \c src with a carriage return inserted before each line feed.
+*/
+String linefeedToCRLF(const String& src);
+
+//! Convert CRLF to line feeds
+/*!
+Returns \c src with the carriage return of each CRLF pair removed.
+*/
+String crlfToLinefeed(const String& src);
+
 //! Case-insensitive comparisons
 /*!
 This class provides case-insensitve comparison functions.
@@ -21,6 +21,12 @@
 
 #include <cstring>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UNICODE_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 //
 // local utility functions
 //
@@ -69,6 +75,219 @@ decode32(const UInt8* n, bool byteSwapped)
 	return c.n32;
 }
 
+//
+// ASCII fast paths.  most text is mostly ASCII so runs of ASCII
+// characters are found and converted many at a time instead of going
+// through fromUTF8() and toUTF8() one character at a time.  16 and 32
+// bit characters are in host byte order.
+//
+
+static
+UInt32
+countASCII8(const UInt8* data, UInt32 n)
+{
+	UInt32 i = 0;
+#if UNICODE_USE_SSE2
+	for (; i + 16 <= n; i += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		if (_mm_movemask_epi8(v) != 0) {
+			break;
+		}
+	}
+#else
+	for (; i + 8 <= n; i += 8) {
+		UInt64 v;
+		memcpy(&v, data + i, 8);
+		if ((v & 0x8080808080808080ULL) != 0) {
+			break;
+		}
+	}
+#endif
+	while (i < n && data[i] < 0x80) {
+		++i;
+	}
+	return i;
+}
+
+static
+UInt32
+countASCII16(const UInt8* data, UInt32 n)
+{
+	UInt32 i = 0;
+#if UNICODE_USE_SSE2
+	const __m128i high = _mm_set1_epi16(static_cast<short>(0xff80));
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 8 <= n; i += 8) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i));
+		v = _mm_cmpeq_epi16(_mm_and_si128(v, high), zero);
+		if (_mm_movemask_epi8(v) != 0xffff) {
+			break;
+		}
+	}
+#endif
+	while (i < n && decode16(data + 2 * i, false) < 0x80) {
+		++i;
+	}
+	return i;
+}
+
+static
+UInt32
+countASCII32(const UInt8* data, UInt32 n)
+{
+	UInt32 i = 0;
+#if UNICODE_USE_SSE2
+	const __m128i high = _mm_set1_epi32(static_cast<int>(0xffffff80));
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 4 <= n; i += 4) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 4 * i));
+		v = _mm_cmpeq_epi32(_mm_and_si128(v, high), zero);
+		if (_mm_movemask_epi8(v) != 0xffff) {
+			break;
+		}
+	}
+#endif
+	while (i < n && decode32(data + 4 * i, false) < 0x80) {
+		++i;
+	}
+	return i;
+}
+
+static
+bool
+bulkUTF8To16(String& dst, const UInt8*& data, UInt32& n)
+{
+	UInt32 count = countASCII8(data, n);
+	if (count == 0) {
+		return false;
+	}
+
+	size_t size = dst.size();
+	dst.resize(size + 2 * count);
+	UInt8* out = reinterpret_cast<UInt8*>(&dst[size]);
+	UInt32 i   = 0;
+#if UNICODE_USE_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= count; i += 16) {
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i),
+							_mm_unpacklo_epi8(v, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 2 * i + 16),
+							_mm_unpackhi_epi8(v, zero));
+	}
+#endif
+	for (; i < count; ++i) {
+		UInt16 c = data[i];
+		memcpy(out + 2 * i, &c, 2);
+	}
+
+	data += count;
+	n    -= count;
+	return true;
+}
+
+static
+bool
+bulkUTF8To32(String& dst, const UInt8*& data, UInt32& n)
+{
+	UInt32 count = countASCII8(data, n);
+	if (count == 0) {
+		return false;
+	}
+
+	size_t size = dst.size();
+	dst.resize(size + 4 * count);
+	UInt8* out = reinterpret_cast<UInt8*>(&dst[size]);
+	UInt32 i   = 0;
+#if UNICODE_USE_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 16 <= count; i += 16) {
+		__m128i v  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+		__m128i lo = _mm_unpacklo_epi8(v, zero);
+		__m128i hi = _mm_unpackhi_epi8(v, zero);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i),
+							_mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i + 16),
+							_mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i + 32),
+							_mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4 * i + 48),
+							_mm_unpackhi_epi16(hi, zero));
+	}
+#endif
+	for (; i < count; ++i) {
+		UInt32 c = data[i];
+		memcpy(out + 4 * i, &c, 4);
+	}
+
+	data += count;
+	n    -= count;
+	return true;
+}
+
+static
+bool
+bulk16ToUTF8(String& dst, const UInt8*& data, UInt32& n)
+{
+	UInt32 count = countASCII16(data, n);
+	if (count == 0) {
+		return false;
+	}
+
+	size_t size = dst.size();
+	dst.resize(size + count);
+	UInt8* out = reinterpret_cast<UInt8*>(&dst[size]);
+	UInt32 i   = 0;
+#if UNICODE_USE_SSE2
+	for (; i + 16 <= count; i += 16) {
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i + 16));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+							_mm_packus_epi16(a, b));
+	}
+#endif
+	for (; i < count; ++i) {
+		out[i] = static_cast<UInt8>(decode16(data + 2 * i, false));
+	}
+
+	data += 2 * count;
+	n    -= count;
+	return true;
+}
+
+static
+bool
+bulk32ToUTF8(String& dst, const UInt8*& data, UInt32& n)
+{
+	UInt32 count = countASCII32(data, n);
+	if (count == 0) {
+		return false;
+	}
+
+	size_t size = dst.size();
+	dst.resize(size + count);
+	UInt8* out = reinterpret_cast<UInt8*>(&dst[size]);
+	UInt32 i   = 0;
+#if UNICODE_USE_SSE2
+	for (; i + 16 <= count; i += 16) {
+		const __m128i* src = reinterpret_cast<const __m128i*>(data + 4 * i);
+		__m128i lo = _mm_packs_epi32(_mm_loadu_si128(src),
+									 _mm_loadu_si128(src + 1));
+		__m128i hi = _mm_packs_epi32(_mm_loadu_si128(src + 2),
+									 _mm_loadu_si128(src + 3));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+							_mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; i < count; ++i) {
+		out[i] = static_cast<UInt8>(decode32(data + 4 * i, false));
+	}
+
+	data += 4 * count;
+	n    -= count;
+	return true;
+}
+
 inline
 static
 void
@@ -100,10 +319,13 @@ UInt32					Unicode::s_replacement = 0x0000fffd;
 bool
 Unicode::isUTF8(const String& src)
 {
-	// convert and test each character
+	// skip runs of ASCII characters and test each other character
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	for (UInt32 n = (UInt32)src.size(); n > 0; ) {
-		if (fromUTF8(data, n) == s_invalid) {
+		UInt32 ascii = countASCII8(data, n);
+		data += ascii;
+		n    -= ascii;
+		if (n > 0 && fromUTF8(data, n) == s_invalid) {
 			return false;
 		}
 	}
@@ -124,6 +346,10 @@ Unicode::UTF8ToUCS2(const String& src, bool* errors)
 	// convert each character
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	while (n > 0) {
+		if (bulkUTF8To16(dst, data, n)) {
+			continue;
+		}
+
 		UInt32 c = fromUTF8(data, n);
 		if (c == s_invalid) {
 			c = s_replacement;
@@ -153,6 +379,10 @@ Unicode::UTF8ToUCS4(const String& src, bool* errors)
 	// convert each character
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	while (n > 0) {
+		if (bulkUTF8To32(dst, data, n)) {
+			continue;
+		}
+
 		UInt32 c = fromUTF8(data, n);
 		if (c == s_invalid) {
 			c = s_replacement;
@@ -177,6 +407,10 @@ Unicode::UTF8ToUTF16(const String& src, bool* errors)
 	// convert each character
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	while (n > 0) {
+		if (bulkUTF8To16(dst, data, n)) {
+			continue;
+		}
+
 		UInt32 c = fromUTF8(data, n);
 		if (c == s_invalid) {
 			c = s_replacement;
@@ -215,6 +449,10 @@ Unicode::UTF8ToUTF32(const String& src, bool* errors)
 	// convert each character
 	const UInt8* data = reinterpret_cast<const UInt8*>(src.c_str());
 	while (n > 0) {
+		if (bulkUTF8To32(dst, data, n)) {
+			continue;
+		}
+
 		UInt32 c = fromUTF8(data, n);
 		if (c == s_invalid) {
 			c = s_replacement;
@@ -406,8 +644,14 @@ Unicode::doUCS2ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 	}
 
 	// convert each character
-	for (; n > 0; data += 2, --n) {
+	while (n > 0) {
+		if (!byteSwapped && bulk16ToUTF8(dst, data, n)) {
+			continue;
+		}
+
 		UInt32 c = decode16(data, byteSwapped);
+		data += 2;
+		--n;
 		toUTF8(dst, c, errors);
 	}
 
@@ -442,8 +686,14 @@ Unicode::doUCS4ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 	}
 
 	// convert each character
-	for (; n > 0; data += 4, --n) {
+	while (n > 0) {
+		if (!byteSwapped && bulk32ToUTF8(dst, data, n)) {
+			continue;
+		}
+
 		UInt32 c = decode32(data, byteSwapped);
+		data += 4;
+		--n;
 		toUTF8(dst, c, errors);
 	}
 
@@ -478,12 +728,18 @@ Unicode::doUTF16ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 	}
 
 	// convert each character
-	for (; n > 0; data += 2, --n) {
+	while (n > 0) {
+		if (!byteSwapped && bulk16ToUTF8(dst, data, n)) {
+			continue;
+		}
+
 		UInt32 c = decode16(data, byteSwapped);
+		data += 2;
+		--n;
 		if (c < 0x0000d800 || c > 0x0000dfff) {
 			toUTF8(dst, c, errors);
 		}
-		else if (n == 1) {
+		else if (n == 0) {
 			// error -- missing second word
 			setError(errors);
 			toUTF8(dst, s_replacement, NULL);
@@ -540,8 +796,14 @@ Unicode::doUTF32ToUTF8(const UInt8* data, UInt32 n, bool* errors)
 	}
 
 	// convert each character
-	for (; n > 0; data += 4, --n) {
+	while (n > 0) {
+		if (!byteSwapped && bulk32ToUTF8(dst, data, n)) {
+			continue;
+		}
+
 		UInt32 c = decode32(data, byteSwapped);
+		data += 4;
+		--n;
 		if (c >= 0x00110000) {
 			setError(errors);
 			c = s_replacement;
@@ -628,25 +890,25 @@ Unicode::fromUTF8(const UInt8*& data, UInt32& n)
 	case 4:
 		c = ((static_cast<UInt32>(data[0]) & 0x07) << 18) |
 			((static_cast<UInt32>(data[1]) & 0x3f) << 12) |
-			((static_cast<UInt32>(data[1]) & 0x3f) <<  6) |
-			((static_cast<UInt32>(data[1]) & 0x3f)      );
+			((static_cast<UInt32>(data[2]) & 0x3f) <<  6) |
+			((static_cast<UInt32>(data[3]) & 0x3f)      );
 		break;
 
 	case 5:
 		c = ((static_cast<UInt32>(data[0]) & 0x03) << 24) |
 			((static_cast<UInt32>(data[1]) & 0x3f) << 18) |
-			((static_cast<UInt32>(data[1]) & 0x3f) << 12) |
-			((static_cast<UInt32>(data[1]) & 0x3f) <<  6) |
-			((static_cast<UInt32>(data[1]) & 0x3f)      );
+			((static_cast<UInt32>(data[2]) & 0x3f) << 12) |
+			((static_cast<UInt32>(data[3]) & 0x3f) <<  6) |
+			((static_cast<UInt32>(data[4]) & 0x3f)      );
 		break;
 
 	case 6:
 		c = ((static_cast<UInt32>(data[0]) & 0x01) << 30) |
 			((static_cast<UInt32>(data[1]) & 0x3f) << 24) |
-			((static_cast<UInt32>(data[1]) & 0x3f) << 18) |
-			((static_cast<UInt32>(data[1]) & 0x3f) << 12) |
-			((static_cast<UInt32>(data[1]) & 0x3f) <<  6) |
-			((static_cast<UInt32>(data[1]) & 0x3f)      );
+			((static_cast<UInt32>(data[2]) & 0x3f) << 18) |
+			((static_cast<UInt32>(data[3]) & 0x3f) << 12) |
+			((static_cast<UInt32>(data[4]) & 0x3f) <<  6) |
+			((static_cast<UInt32>(data[5]) & 0x3f)      );
 		break;
 
 	default:
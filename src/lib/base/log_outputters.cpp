@@ -237,54 +237,273 @@ BufferedLogOutputter::write(ELevel, const char* message)
 // FileLogOutputter
 //
 
-FileLogOutputter::FileLogOutputter(const char* logFile)
+FileLogOutputter::FileLogOutputter(const char* logFile, bool useThread) :
+	m_queueMutex(ARCH->newMutex()),
+	m_queueCond(ARCH->newCondVar()),
+	m_writtenCond(ARCH->newCondVar()),
+	m_running(true),
+	m_writing(false),
+	m_reopen(false),
+	m_policy(kBlock),
+	m_maxQueuedLines(kMaxQueuedLines),
+	m_sampleCount(0),
+	m_droppedLines(0),
+	m_unreportedDrops(0),
+	m_fileSize(0),
+	m_writerThread(NULL)
 {
 	setLogFilename(logFile);
+
+	if (useThread) {
+		m_writerThread = ARCH->newThread(
+							&FileLogOutputter::writerThreadFunc, this);
+	}
 }
 
 FileLogOutputter::~FileLogOutputter()
 {
+	if (m_writerThread != NULL) {
+		{
+			ArchMutexLock lock(m_queueMutex);
+			m_running = false;
+			ARCH->broadcastCondVar(m_queueCond);
+			ARCH->broadcastCondVar(m_writtenCond);
+		}
+		ARCH->wait(m_writerThread, -1.0);
+		ARCH->closeThread(m_writerThread);
+	}
+
+	// write anything queued after the writer stopped
+	writeQueued();
+	m_file.close();
+
+	ARCH->closeCondVar(m_writtenCond);
+	ARCH->closeCondVar(m_queueCond);
+	ARCH->closeMutex(m_queueMutex);
 }
 
 void
 FileLogOutputter::setLogFilename(const char* logFile)
 {
 	assert(logFile != NULL);
+
+	ArchMutexLock lock(m_queueMutex);
 	m_fileName = logFile;
+	m_reopen   = true;
+}
+
+void
+FileLogOutputter::setOverloadPolicy(EOverloadPolicy policy)
+{
+	ArchMutexLock lock(m_queueMutex);
+	m_policy = policy;
+}
+
+void
+FileLogOutputter::setMaxQueuedLines(UInt32 maxQueuedLines)
+{
+	ArchMutexLock lock(m_queueMutex);
+	m_maxQueuedLines = maxQueuedLines;
+}
+
+UInt64
+FileLogOutputter::getDroppedLines() const
+{
+	ArchMutexLock lock(m_queueMutex);
+	return m_droppedLines;
+}
+
+bool
+FileLogOutputter::write(ELevel, const char* message)
+{
+	ArchMutexLock lock(m_queueMutex);
+
+	bool keep = true;
+	if (m_queue.size() >= m_maxQueuedLines) {
+		keep = (m_policy == kBlock && waitForRoom());
+	}
+	else if (m_policy == kSample && m_queue.size() >= m_maxQueuedLines / 2) {
+		keep = (++m_sampleCount % kSampleRate == 0);
+	}
+
+	if (!keep) {
+		++m_droppedLines;
+		++m_unreportedDrops;
+		return true;
+	}
+
+	m_queue.push_back(message);
+	if (m_writerThread != NULL) {
+		ARCH->broadcastCondVar(m_queueCond);
+	}
+	return true;
 }
 
 bool
-FileLogOutputter::write(ELevel level, const char *message)
+FileLogOutputter::waitForRoom()
+{
+	// called with m_queueMutex locked
+	if (m_writerThread == NULL) {
+		// nobody else will write the queue, so write it here
+		ARCH->unlockMutex(m_queueMutex);
+		writeQueued();
+		ARCH->lockMutex(m_queueMutex);
+		return true;
+	}
+
+	// the writer can't wait for itself
+	ArchThread current = ARCH->newCurrentThread();
+	bool isWriter = ARCH->isSameThread(current, m_writerThread);
+	ARCH->closeThread(current);
+	if (isWriter) {
+		return false;
+	}
+
+	while (m_running && m_queue.size() >= m_maxQueuedLines) {
+		ARCH->waitCondVar(m_writtenCond, m_queueMutex, -1.0);
+	}
+	return true;
+}
+
+void
+FileLogOutputter::flush()
+{
+	if (m_writerThread == NULL) {
+		writeQueued();
+		return;
+	}
+
+	ArchMutexLock lock(m_queueMutex);
+	while (m_running && (!m_queue.empty() || m_writing)) {
+		ARCH->waitCondVar(m_writtenCond, m_queueMutex, -1.0);
+	}
+}
+
+void*
+FileLogOutputter::writerThreadFunc(void* vself)
 {
-	bool moveFile = false;
+	static_cast<FileLogOutputter*>(vself)->writerThread();
+	return NULL;
+}
+
+void
+FileLogOutputter::writerThread()
+{
+	for (;;) {
+		{
+			ArchMutexLock lock(m_queueMutex);
+			while (m_running && m_queue.empty()) {
+				ARCH->waitCondVar(m_queueCond, m_queueMutex, -1.0);
+			}
+			if (!m_running) {
+				break;
+			}
+			m_writing = true;
+		}
+
+		writeQueued();
+
+		ArchMutexLock lock(m_queueMutex);
+		m_writing = false;
+		ARCH->broadcastCondVar(m_writtenCond);
+	}
+}
+
+void
+FileLogOutputter::writeQueued()
+{
+	Lines lines;
+	UInt64 dropped;
+	bool reopen;
+	{
+		ArchMutexLock lock(m_queueMutex);
+		lines.swap(m_queue);
+		dropped = m_unreportedDrops;
+		m_unreportedDrops = 0;
+		m_sampleCount = 0;
+		reopen = m_reopen;
+		if (reopen) {
+			m_openFileName = m_fileName;
+			m_reopen = false;
+		}
+
+		// there's room in the queue again
+		ARCH->broadcastCondVar(m_writtenCond);
+	}
 
-	std::ofstream m_handle;
-	m_handle.open(m_fileName.c_str(), std::fstream::app);
-	if (m_handle.is_open() && m_handle.fail() != true) {
-		m_handle << message << std::endl;
+	if (lines.empty() && dropped == 0) {
+		return;
+	}
+
+	if (reopen) {
+		m_file.close();
+	}
+
+	// join the batch so it takes a single write
+	size_t size = 0;
+	for (Lines::const_iterator i = lines.begin(); i != lines.end(); ++i) {
+		size += i->size() + 1;
+	}
+	String batch;
+	batch.reserve(size);
+	for (Lines::const_iterator i = lines.begin(); i != lines.end(); ++i) {
+		batch.append(*i);
+		batch.append(1, '\n');
+	}
+	if (dropped != 0) {
+		batch.append(synergy::string::sizeTypeToString(
+							static_cast<size_t>(dropped)));
+		batch.append(" log lines dropped\n");
+	}
+
+	if (!m_file.is_open()) {
+		openFile();
+	}
+	if (m_file.is_open()) {
+		m_file.write(batch.data(), batch.size());
+		m_file.flush();
+		m_fileSize += batch.size();
 
 		// when file size exceeds limits, move to 'old log' filename.
-		size_t p = m_handle.tellp();
-		if (p > (kFileSizeLimit * 1024)) {
-			moveFile = true;
+		if (m_fileSize > kFileSizeLimit * 1024) {
+			rotateFile();
 		}
 	}
-	m_handle.close();
+}
 
-	if (moveFile) {
-		String oldLogFilename = synergy::string::sprintf("%s.1", m_fileName.c_str());
-		remove(oldLogFilename.c_str());
-		rename(m_fileName.c_str(), oldLogFilename.c_str());
+void
+FileLogOutputter::openFile()
+{
+	m_file.clear();
+	m_file.open(m_openFileName.c_str(), std::fstream::app);
+	if (m_file.fail()) {
+		m_file.close();
+		return;
 	}
 
-	return true;
+	m_file.seekp(0, std::ios::end);
+	std::streamoff size = m_file.tellp();
+	m_fileSize = (size > 0) ? static_cast<size_t>(size) : 0;
+}
+
+void
+FileLogOutputter::rotateFile()
+{
+	m_file.close();
+
+	String oldLogFilename = synergy::string::sprintf("%s.1", m_openFileName.c_str());
+	remove(oldLogFilename.c_str());
+	rename(m_openFileName.c_str(), oldLogFilename.c_str());
 }
 
 void
 FileLogOutputter::open(const char *title) {}
 
 void
-FileLogOutputter::close() {}
+FileLogOutputter::close()
+{
+	flush();
+}
 
 void
 FileLogOutputter::show(bool showIfEmpty) {}
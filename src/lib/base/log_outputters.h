@@ -67,11 +67,38 @@ public:
 /*!
 This outputter writes output to the file.  The level for each
 message is ignored.
-*/
 
+Lines are queued and written by a writer thread, which keeps the file
+open, writes whatever has been queued in one batch and moves the file
+to \c <file>.1 when it gets too big, so logging doesn't wait for the
+disk.  What happens to lines logged faster than they can be written is
+decided by the overload policy.
+*/
 class FileLogOutputter : public ILogOutputter {
 public:
-	FileLogOutputter(const char* logFile);
+	//! Overload policy
+	enum EOverloadPolicy {
+		//! Wait for the writer when the queue is full
+		kBlock,
+		//! Drop lines while the queue is full
+		kDrop,
+		//! Keep one line in kSampleRate once the queue is half full
+		kSample
+	};
+
+	enum {
+		//! Default maximum number of queued lines
+		kMaxQueuedLines = 10000,
+		//! Lines kept by kSample
+		kSampleRate = 10
+	};
+
+	/*!
+	If \p useThread is false there's no writer thread and queued lines
+	are only written by \c flush(), or by \c write() when it would
+	otherwise block.
+	*/
+	FileLogOutputter(const char* logFile, bool useThread = true);
 	virtual ~FileLogOutputter();
 
 	// ILogOutputter overrides
@@ -80,10 +107,74 @@ public:
 	virtual void		show(bool showIfEmpty);
 	virtual bool		write(ELevel level, const char* message);
 
-	void				setLogFilename(const char* title);
+	//! @name manipulators
+	//@{
+
+	//! Set log file
+	/*!
+	Lines queued from now on are written to \p logFile.
+	*/
+	void				setLogFilename(const char* logFile);
+
+	//! Set overload policy
+	void				setOverloadPolicy(EOverloadPolicy policy);
+
+	//! Set maximum number of queued lines
+	void				setMaxQueuedLines(UInt32 maxQueuedLines);
+
+	//! Write queued lines
+	/*!
+	Returns when every line queued so far has been written to the file.
+	Must not be called from the writer thread.
+	*/
+	void				flush();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get dropped line count
+	/*!
+	Returns the number of lines dropped by the overload policy.
+	*/
+	UInt64				getDroppedLines() const;
+
+	//@}
 
 private:
-	std::string			m_fileName;
+	typedef std::deque<String> Lines;
+
+	static void*		writerThreadFunc(void*);
+	void				writerThread();
+	bool				waitForRoom();
+	void				writeQueued();
+	void				openFile();
+	void				rotateFile();
+
+private:
+	// guarded by m_queueMutex
+	ArchMutex			m_queueMutex;
+	ArchCond			m_queueCond;
+	ArchCond			m_writtenCond;
+	Lines				m_queue;
+	bool				m_running;
+	bool				m_writing;
+	String				m_fileName;
+	bool				m_reopen;
+	EOverloadPolicy		m_policy;
+	UInt32				m_maxQueuedLines;
+	UInt32				m_sampleCount;
+	UInt64				m_droppedLines;
+	UInt64				m_unreportedDrops;
+
+	// only used by the thread writing the file
+	String				m_openFileName;
+	std::ofstream		m_file;
+	size_t				m_fileSize;
+
+	// not a Thread, which logs on entry and exit:  the writer must
+	// never log
+	ArchThread			m_writerThread;
 };
 
 //! Write log to system log
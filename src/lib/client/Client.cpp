@@ -26,7 +26,7 @@
 #include "synergy/ProtocolUtil.h"
 #include "synergy/protocol_types.h"
 #include "synergy/XSynergy.h"
-#include "synergy/StreamChunker.h"
+#include "synergy/FileWindow.h"
 #include "synergy/IPlatformScreen.h"
 #include "mt/Thread.h"
 #include "net/TCPSocket.h"
@@ -68,8 +68,8 @@ Client::Client(
 	m_suspended(false),
 	m_connectOnResume(false),
 	m_events(events),
-	m_sendFileThread(NULL),
-	m_writeToDropDirThread(NULL),
+	m_fileTransfers(events, this),
+	m_fileReceiver(events, this),
 	m_socket(NULL),
 	m_useSecureNetwork(args.m_enableCrypto),
 	m_args(args),
@@ -151,8 +151,10 @@ Client::connect()
 		m_socket = dynamic_cast<TCPSocket*>(socket);
 
 		// filter socket messages, including a packetizing filter
-		m_stream = socket;
-		m_stream = new PacketStreamFilter(m_events, m_stream, true);
+		PacketStreamFilter* filter =
+			new PacketStreamFilter(m_events, socket, true);
+		filter->setPeerName("server");
+		m_stream = filter;
 
 		// connect
 		LOG((CLOG_DEBUG1 "connecting to server"));
@@ -192,6 +194,9 @@ Client::handshakeComplete()
 	m_ready = true;
 	m_screen->enable();
 	sendEvent(m_events->forClient().connected(), NULL);
+
+	// resume files queued before the connection was lost
+	m_fileTransfers.connected("");
 }
 
 bool
@@ -236,17 +241,18 @@ Client::getCursorPos(SInt32& x, SInt32& y) const
 	m_screen->getCursorPos(x, y);
 }
 
+const IScreen::MonitorList&
+Client::getMonitors() const
+{
+	return m_screen->getMonitors();
+}
+
 void
 Client::enter(SInt32 xAbs, SInt32 yAbs, UInt32, KeyModifierMask mask, bool)
 {
 	m_active = true;
 	m_screen->mouseMove(xAbs, yAbs);
 	m_screen->enter(mask);
-
-	if (m_sendFileThread != NULL) {
-		StreamChunker::interruptFile();
-		m_sendFileThread = NULL;
-	}
 }
 
 bool
@@ -271,6 +277,7 @@ Client::leave()
 void
 Client::setClipboard(ClipboardID id, const IClipboard* clipboard)
 {
+	cancelPendingClipboard(id);
  	m_screen->setClipboard(id, clipboard);
 	m_ownClipboard[id]  = false;
 	m_sentClipboard[id] = false;
@@ -279,6 +286,7 @@ Client::setClipboard(ClipboardID id, const IClipboard* clipboard)
 void
 Client::grabClipboard(ClipboardID id)
 {
+	cancelPendingClipboard(id);
 	m_screen->grabClipboard(id);
 	m_ownClipboard[id]  = false;
 	m_sentClipboard[id] = false;
@@ -400,18 +408,160 @@ Client::sendClipboard(ClipboardID id)
 		// save new time
 		m_timeClipboard[id] = clipboard.getTime();
 
-		// marshall the data
-		String data = clipboard.marshall();
-
 		// save and send data if different or not yet sent
-		if (!m_sentClipboard[id] || data != m_dataClipboard[id]) {
+		UInt64 hash = clipboard.getHash();
+		if (!m_sentClipboard[id] || hash != m_hashClipboard[id]) {
 			m_sentClipboard[id] = true;
-			m_dataClipboard[id] = data;
+			m_hashClipboard[id] = hash;
 			m_server->onClipboardChanged(id, &clipboard);
+
+			// the server may offer it back later
+			m_clipboardCache.add(clipboard);
 		}
 	}
 }
 
+void
+Client::clipboardOffered(ClipboardID id, UInt32 sequence,
+				const ClipboardOffer& offer)
+{
+	cancelPendingClipboard(id);
+
+	// use the data we've seen before
+	PendingClipboard& pending = m_pendingClipboard[id];
+	Clipboard& clipboard      = pending.m_clipboard;
+	UInt32 missing            = 0;
+	clipboard.open(0);
+	clipboard.empty();
+	const ClipboardOffer::FormatList& formats = offer.getFormats();
+	for (ClipboardOffer::FormatList::const_iterator i = formats.begin();
+								i != formats.end(); ++i) {
+		String data;
+		if (m_clipboardCache.get(i->m_format, i->m_hash, data)) {
+			clipboard.add(i->m_format, data);
+		}
+		else {
+			missing |= (1u << i->m_format);
+		}
+	}
+	clipboard.close();
+
+	if (missing == 0) {
+		LOG((CLOG_DEBUG "clipboard %d is cached", id));
+		setClipboard(id, &clipboard);
+		return;
+	}
+
+	pending.m_sequence  = sequence;
+	pending.m_offer     = offer;
+	pending.m_missing   = missing;
+	pending.m_requested = 0;
+	m_ownClipboard[id]  = false;
+	m_sentClipboard[id] = false;
+
+	// if the screen can, it asks for the data when a program wants it
+	pending.m_promised = m_screen->promiseClipboard(id, &clipboard, missing);
+	if (pending.m_promised) {
+		LOG((CLOG_DEBUG "promised clipboard %d formats=0x%x", id, missing));
+	}
+	else {
+		requestClipboardFormats(id, missing);
+	}
+}
+
+void
+Client::clipboardFormatsReceived(ClipboardID id, UInt32 sequence,
+				const Clipboard& data)
+{
+	PendingClipboard& pending = m_pendingClipboard[id];
+	if (pending.m_sequence == 0 || sequence != pending.m_sequence) {
+		LOG((CLOG_DEBUG "ignoring out of date clipboard %d data seqnum=%d", id, sequence));
+		return;
+	}
+
+	data.open(0);
+	const ClipboardOffer::FormatList& formats = pending.m_offer.getFormats();
+	for (ClipboardOffer::FormatList::const_iterator i = formats.begin();
+								i != formats.end(); ++i) {
+		const UInt32 bit = (1u << i->m_format);
+		if ((pending.m_missing & bit) == 0 || !data.has(i->m_format)) {
+			continue;
+		}
+		pending.m_missing &= ~bit;
+
+		// the data must be what was offered
+		String formatData = data.get(i->m_format);
+		if (data.getHash(i->m_format) != i->m_hash ||
+			formatData.size() != i->m_size) {
+			LOG((CLOG_ERR "clipboard %d format %d doesn't match the offer", id, i->m_format));
+			if (pending.m_promised) {
+				m_screen->fulfillClipboard(id, i->m_format, NULL);
+			}
+			continue;
+		}
+
+		LOG((CLOG_DEBUG "received clipboard %d format %d size=%d", id, i->m_format, (int)formatData.size()));
+		m_clipboardCache.add(i->m_format, i->m_hash, formatData);
+		if (pending.m_promised) {
+			m_screen->fulfillClipboard(id, i->m_format, &formatData);
+		}
+		else {
+			pending.m_clipboard.open(0);
+			pending.m_clipboard.add(i->m_format, formatData);
+			pending.m_clipboard.close();
+		}
+	}
+	data.close();
+
+	if (pending.m_missing == 0) {
+		if (pending.m_promised) {
+			pending.m_sequence = 0;
+		}
+		else {
+			setClipboard(id, &pending.m_clipboard);
+		}
+		LOG((CLOG_INFO "clipboard was updated"));
+	}
+}
+
+void
+Client::requestClipboardFormats(ClipboardID id, UInt32 formats)
+{
+	// ask for each format once
+	PendingClipboard& pending = m_pendingClipboard[id];
+	formats &= pending.m_missing & ~pending.m_requested;
+	pending.m_requested |= formats;
+	for (SInt32 format = 0; format < IClipboard::kNumFormats; ++format) {
+		if ((formats & (1u << format)) != 0) {
+			m_server->requestClipboardFormat(id, pending.m_sequence, format);
+		}
+	}
+}
+
+void
+Client::cancelPendingClipboard(ClipboardID id)
+{
+	PendingClipboard& pending = m_pendingClipboard[id];
+	if (pending.m_sequence == 0) {
+		return;
+	}
+
+	// programs waiting for promised data get nothing
+	if (pending.m_promised) {
+		for (SInt32 format = 0; format < IClipboard::kNumFormats; ++format) {
+			if ((pending.m_missing & (1u << format)) != 0) {
+				m_screen->fulfillClipboard(id,
+							static_cast<IClipboard::EFormat>(format), NULL);
+			}
+		}
+	}
+
+	pending.m_sequence  = 0;
+	pending.m_missing   = 0;
+	pending.m_requested = 0;
+	pending.m_promised  = false;
+}
+
 void
 Client::sendEvent(Event::Type type, void* data)
 {
@@ -432,10 +582,16 @@ Client::sendFileChunk(const void* data)
 {
 	FileChunk* chunk = static_cast<FileChunk*>(const_cast<void*>(data));
 	LOG((CLOG_DEBUG1 "send file chunk"));
-	assert(m_server != NULL);
 
-	// relay
-	m_server->fileChunkSending(chunk->m_chunk[0], &chunk->m_chunk[1], chunk->m_dataSize);
+	// relay.  chunks of a transfer that was cut off are dropped and the
+	// transfer starts again when the server reconnects.
+	String destination;
+	if (m_fileTransfers.relay(*chunk, destination) && m_server != NULL) {
+		m_server->fileChunkSending(*chunk);
+	}
+	if (chunk->m_window != NULL) {
+		chunk->m_window->relayed();
+	}
 }
 
 void
@@ -508,6 +664,10 @@ Client::setupScreen()
 							getEventTarget(),
 							new TMethodEventJob<Client>(this,
 								&Client::handleClipboardGrabbed));
+	m_events->adoptHandler(m_events->forClipboard().clipboardFormatsRequested(),
+							getEventTarget(),
+							new TMethodEventJob<Client>(this,
+								&Client::handleClipboardFormatsRequested));
 }
 
 void
@@ -556,6 +716,9 @@ void
 Client::cleanupScreen()
 {
 	if (m_server != NULL) {
+		for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+			cancelPendingClipboard(id);
+		}
 		if (m_ready) {
 			m_screen->disable();
 			m_ready = false;
@@ -564,8 +727,11 @@ Client::cleanupScreen()
 							getEventTarget());
 		m_events->removeHandler(m_events->forClipboard().clipboardGrabbed(),
 							getEventTarget());
+		m_events->removeHandler(m_events->forClipboard().clipboardFormatsRequested(),
+							getEventTarget());
 		delete m_server;
 		m_server = NULL;
+		m_fileTransfers.disconnected("");
 	}
 }
 
@@ -663,7 +829,8 @@ Client::handleClipboardGrabbed(const Event& event, void*)
 	const IScreen::ClipboardInfo* info =
 		static_cast<const IScreen::ClipboardInfo*>(event.getData());
 
-	// grab ownership
+	// grab ownership.  an offer we haven't got all of is no use now
+	cancelPendingClipboard(info->m_id);
 	m_server->onGrabClipboard(info->m_id);
 
 	// we now own the clipboard and it has not been sent to the server
@@ -678,6 +845,17 @@ Client::handleClipboardGrabbed(const Event& event, void*)
 	}
 }
 
+void
+Client::handleClipboardFormatsRequested(const Event& event, void*)
+{
+	const IScreen::ClipboardFormatInfo* info =
+		static_cast<const IScreen::ClipboardFormatInfo*>(event.getData());
+
+	if (m_pendingClipboard[info->m_id].m_sequence != 0) {
+		requestClipboardFormats(info->m_id, info->m_formats);
+	}
+}
+
 void
 Client::handleHello(const Event&, void*)
 {
@@ -754,10 +932,10 @@ Client::handleFileRecieveCompleted(const Event& event, void*)
 void
 Client::onFileRecieveCompleted()
 {
-	if (isReceivedFileSizeValid()) {
-		m_writeToDropDirThread = new Thread(
+	if (m_fileReceiver.startDrop()) {
+		Thread thread(
 			new TMethodJob<Client>(
-				this, &Client::writeToDropDirThread));
+				this, &Client::dropReceivedFilesThread));
 	}
 }
 
@@ -768,16 +946,23 @@ Client::handleStopRetry(const Event&, void*)
 }
 
 void
-Client::writeToDropDirThread(void*)
+Client::dropReceivedFilesThread(void*)
 {
-	LOG((CLOG_DEBUG "starting write to drop dir thread"));
+	LOG((CLOG_DEBUG "starting drop received files thread"));
 
 	while (m_screen->isFakeDraggingStarted()) {
 		ARCH->sleep(.1f);
 	}
 
-	DropHelper::writeToDir(m_screen->getDropTarget(), m_dragFileList,
-					m_receivedFileData);
+	// files that complete while this runs are dropped too
+	FileReceiver::CompletedList files;
+	while (m_fileReceiver.takeCompleted(files)) {
+		for (size_t i = 0; i < files.size(); ++i) {
+			DropHelper::writeToDir(m_screen->getDropTarget(),
+							files[i].m_name, files[i].m_tempPath);
+		}
+		files.clear();
+	}
 }
 
 void
@@ -797,34 +982,20 @@ Client::dragInfoReceived(UInt32 fileNum, String data)
 bool
 Client::isReceivedFileSizeValid()
 {
-	return m_expectedFileSize == m_receivedFileData.size();
+	return m_fileReceiver.isLastFileComplete();
 }
 
 void
 Client::sendFileToServer(const char* filename)
 {
-	if (m_sendFileThread != NULL) {
-		StreamChunker::interruptFile();
-	}
-
-	m_sendFileThread = new Thread(
-		new TMethodJob<Client>(
-			this, &Client::sendFileThread,
-			static_cast<void*>(const_cast<char*>(filename))));
+	LOG((CLOG_DEBUG "sending file to server, filename=%s", filename));
+	m_fileTransfers.add(filename, "");
 }
 
 void
-Client::sendFileThread(void* filename)
+Client::fileTransferAccepted(UInt32 id, UInt64 offset)
 {
-	try {
-		char* name  = static_cast<char*>(filename);
-		StreamChunker::sendFile(name, m_events, this);
-	}
-	catch (std::runtime_error error) {
-		LOG((CLOG_ERR "failed sending file chunks: %s", error.what()));
-	}
-
-	m_sendFileThread = NULL;
+	m_fileTransfers.accept(id, offset);
 }
 
 void
@@ -21,7 +21,11 @@
 #include "synergy/IClient.h"
 
 #include "synergy/Clipboard.h"
+#include "synergy/ClipboardCache.h"
+#include "synergy/ClipboardOffer.h"
 #include "synergy/DragInformation.h"
+#include "synergy/FileReceiver.h"
+#include "synergy/FileTransferQueue.h"
 #include "synergy/INode.h"
 #include "synergy/ClientArgs.h"
 #include "net/NetworkAddress.h"
@@ -88,8 +92,29 @@ public:
 	//! Received drag information
 	void				dragInfoReceived(UInt32 fileNum, String data);
 
-	//! Create a new thread and use it to send file to Server
+	//! Queue file or directory for sending to the server
 	void				sendFileToServer(const char* filename);
+
+	//! Queued file accepted by server
+	void				fileTransferAccepted(UInt32 id, UInt64 offset);
+
+	//! Received clipboard offer
+	/*!
+	Called when the server offers clipboard \c id.  Formats that are
+	in the cache are used right away.  The others are asked for when
+	a program wants them if the screen can promise formats, otherwise
+	they're asked for now and the clipboard is set when they arrive.
+	*/
+	void				clipboardOffered(ClipboardID id, UInt32 sequence,
+							const ClipboardOffer& offer);
+
+	//! Received offered clipboard formats
+	/*!
+	Called with the \c data of formats asked for from the offer with
+	sequence number \c sequence.
+	*/
+	void				clipboardFormatsReceived(ClipboardID id,
+							UInt32 sequence, const Clipboard& data);
 	
 	//! Send dragging file information back to server
 	void				sendDragInfo(UInt32 fileCount, String& info, size_t size);
@@ -122,11 +147,8 @@ public:
 	//! Return true if recieved file size is valid
 	bool				isReceivedFileSizeValid();
 
-	//! Return expected file size
-	size_t&				getExpectedFileSize() { return m_expectedFileSize; }
-
-	//! Return received file data
-	String&				getReceivedFileData() { return m_receivedFileData; }
+	//! Return receiver of queued files
+	FileReceiver&		getFileReceiver() { return m_fileReceiver; }
 
 	//! Return drag file list
 	DragFileList		getDragFileList() { return m_dragFileList; }
@@ -139,6 +161,8 @@ public:
 	virtual void		getShape(SInt32& x, SInt32& y,
 							SInt32& width, SInt32& height) const;
 	virtual void		getCursorPos(SInt32& x, SInt32& y) const;
+	virtual const MonitorList&
+						getMonitors() const;
 
 	// IClient overrides
 	virtual void		enter(SInt32 xAbs, SInt32 yAbs,
@@ -163,12 +187,32 @@ public:
 	virtual String		getName() const;
 
 private:
+	// an offered clipboard whose data hasn't all arrived
+	class PendingClipboard {
+	public:
+		PendingClipboard() : m_sequence(0), m_missing(0),
+							m_requested(0), m_promised(false) { }
+
+		// sequence number of the offer, 0 if there's none
+		UInt32			m_sequence;
+		ClipboardOffer	m_offer;
+		Clipboard		m_clipboard;
+
+		// bitmasks of the formats we don't have and have asked for
+		UInt32			m_missing;
+		UInt32			m_requested;
+
+		// true iff the screen promised the missing formats
+		bool			m_promised;
+	};
+
 	void				sendClipboard(ClipboardID);
+	void				requestClipboardFormats(ClipboardID, UInt32 formats);
+	void				cancelPendingClipboard(ClipboardID);
 	void				sendEvent(Event::Type, void*);
 	void				sendConnectionFailedEvent(const char* msg);
 	void				sendFileChunk(const void* data);
-	void				sendFileThread(void*);
-	void				writeToDropDirThread(void*);
+	void				dropReceivedFilesThread(void*);
 	void				setupConnecting();
 	void				setupConnection();
 	void				setupScreen();
@@ -185,6 +229,7 @@ private:
 	void				handleDisconnected(const Event&, void*);
 	void				handleShapeChanged(const Event&, void*);
 	void				handleClipboardGrabbed(const Event&, void*);
+	void				handleClipboardFormatsRequested(const Event&, void*);
 	void				handleHello(const Event&, void*);
 	void				handleSuspend(const Event& event, void*);
 	void				handleResume(const Event& event, void*);
@@ -212,14 +257,14 @@ private:
 	bool				m_ownClipboard[kClipboardEnd];
 	bool				m_sentClipboard[kClipboardEnd];
 	IClipboard::Time	m_timeClipboard[kClipboardEnd];
-	String				m_dataClipboard[kClipboardEnd];
+	UInt64				m_hashClipboard[kClipboardEnd];
+	PendingClipboard	m_pendingClipboard[kClipboardEnd];
+	ClipboardCache		m_clipboardCache;
 	IEventQueue*		m_events;
-	std::size_t			m_expectedFileSize;
-	String				m_receivedFileData;
+	FileTransferQueue	m_fileTransfers;
+	FileReceiver		m_fileReceiver;
 	DragFileList		m_dragFileList;
 	String				m_dragFileExt;
-	Thread*				m_sendFileThread;
-	Thread*				m_writeToDropDirThread;
 	TCPSocket*			m_socket;
 	bool				m_useSecureNetwork;
 	ClientArgs			m_args;
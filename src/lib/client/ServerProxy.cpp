@@ -20,9 +20,12 @@
 
 #include "client/Client.h"
 #include "synergy/FileChunk.h"
+#include "synergy/PayloadCompressor.h"
 #include "synergy/ClipboardChunk.h"
 #include "synergy/StreamChunker.h"
 #include "synergy/Clipboard.h"
+#include "synergy/ClipboardOffer.h"
+#include "synergy/LatencyTrace.h"
 #include "synergy/ProtocolUtil.h"
 #include "synergy/option_types.h"
 #include "synergy/protocol_types.h"
@@ -34,6 +37,15 @@
 
 #include <memory>
 
+// microseconds from start to end, or 0 if the clock offset estimate
+// puts end first
+static
+UInt64
+elapsed(UInt64 start, UInt64 end)
+{
+	return (end > start) ? end - start : 0;
+}
+
 //
 // ServerProxy
 //
@@ -52,7 +64,14 @@ ServerProxy::ServerProxy(Client* client, synergy::IStream* stream, IEventQueue*
 	m_keepAliveAlarm(0.0),
 	m_keepAliveAlarmTimer(NULL),
 	m_parser(&ServerProxy::parseHandshakeMessage),
-	m_events(events)
+	m_events(events),
+	m_codecs(kCompressionNone),
+	m_clipboardSender(stream),
+	m_clipboardSize(0),
+	m_latencyTrace(false),
+	m_receiveTime(0),
+	m_inputTraced(false),
+	m_mouseTraced(false)
 {
 	assert(m_client != NULL);
 	assert(m_stream != NULL);
@@ -67,10 +86,11 @@ ServerProxy::ServerProxy(Client* client, synergy::IStream* stream, IEventQueue*
 							new TMethodEventJob<ServerProxy>(this,
 								&ServerProxy::handleData));
 
-	m_events->adoptHandler(m_events->forClipboard().clipboardSending(),
-							this,
+	// pace file and clipboard transfers by the stream's output
+	m_events->adoptHandler(m_events->forIStream().outputFlushed(),
+							m_stream->getEventTarget(),
 							new TMethodEventJob<ServerProxy>(this,
-								&ServerProxy::handleClipboardSendingEvent));
+								&ServerProxy::handleOutputFlushed));
 
 	// send heartbeat
 	setKeepAliveRate(kKeepAliveRate);
@@ -79,8 +99,13 @@ ServerProxy::ServerProxy(Client* client, synergy::IStream* stream, IEventQueue*
 ServerProxy::~ServerProxy()
 {
 	setKeepAliveRate(-1.0);
+	if (m_latencyTrace) {
+		LatencyTrace::setEnabled(false);
+	}
 	m_events->removeHandler(m_events->forIStream().inputReady(),
 							m_stream->getEventTarget());
+	m_events->removeHandler(m_events->forIStream().outputFlushed(),
+							m_stream->getEventTarget());
 }
 
 void
@@ -110,6 +135,10 @@ ServerProxy::setKeepAliveRate(double rate)
 void
 ServerProxy::handleData(const Event&, void*)
 {
+	if (m_latencyTrace) {
+		m_receiveTime = LatencyTrace::now();
+	}
+
 	// handle messages until there are no more.  first read message code.
 	UInt8 code[4];
 	UInt32 n = m_stream->read(code, 4);
@@ -166,6 +195,10 @@ ServerProxy::parseHandshakeMessage(const UInt8* code)
 		resetOptions();
 	}
 
+	else if (memcmp(code, kMsgDCompression, 4) == 0) {
+		compressionReceived();
+	}
+
 	else if (memcmp(code, kMsgCKeepAlive, 4) == 0) {
 		// echo keep alives and reset alarm
 		ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
@@ -255,12 +288,26 @@ ServerProxy::parseMessage(const UInt8* code)
 		// echo keep alives and reset alarm
 		ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
 		resetKeepAliveAlarm();
+
+		if (m_latencyTrace) {
+			sendLatency();
+		}
 	}
 
 	else if (memcmp(code, kMsgCNoop, 4) == 0) {
 		// accept and discard no-op
 	}
 
+	else if (memcmp(code, kMsgDInputTime, 4) == 0) {
+		// the input message that follows gets the reply
+		inputTimeReceived();
+		return kOkay;
+	}
+
+	else if (memcmp(code, kMsgDTime, 4) == 0) {
+		timeReceived();
+	}
+
 	else if (memcmp(code, kMsgCEnter, 4) == 0) {
 		enter();
 	}
@@ -289,6 +336,10 @@ ServerProxy::parseMessage(const UInt8* code)
 		setClipboard();
 	}
 
+	else if (memcmp(code, kMsgDClipboardOffer, 4) == 0) {
+		clipboardOffered();
+	}
+
 	else if (memcmp(code, kMsgCResetOptions, 4) == 0) {
 		resetOptions();
 	}
@@ -297,9 +348,15 @@ ServerProxy::parseMessage(const UInt8* code)
 		setOptions();
 	}
 
-	else if (memcmp(code, kMsgDFileTransfer, 4) == 0) {
+	else if (memcmp(code, kMsgDFileQueue, 4) == 0) {
 		fileChunkReceived();
 	}
+	else if (memcmp(code, kMsgDFileAccept, 4) == 0) {
+		fileAcceptReceived();
+	}
+	else if (memcmp(code, kMsgDCompression, 4) == 0) {
+		compressionReceived();
+	}
 	else if (memcmp(code, kMsgDDragInfo, 4) == 0) {
 		dragInfoReceived();
 	}
@@ -363,7 +420,16 @@ ServerProxy::onClipboardChanged(ClipboardID id, const IClipboard* clipboard)
 	String data = IClipboard::marshall(clipboard);
 	LOG((CLOG_DEBUG "sending clipboard %d seqnum=%d", id, m_seqNum));
 
-	StreamChunker::sendClipboard(data, data.size(), id, m_seqNum, m_events, this);
+	m_clipboardSender.send(id, m_seqNum, data,
+							(m_codecs & kCompressionLZ4) != 0);
+}
+
+void
+ServerProxy::requestClipboardFormat(ClipboardID id, UInt32 sequence,
+				UInt32 format)
+{
+	LOG((CLOG_DEBUG "requesting clipboard %d format %d seqnum=%d", id, format, sequence));
+	ProtocolUtil::writef(m_stream, kMsgQClipboard, id, sequence, format);
 }
 
 void
@@ -379,6 +445,88 @@ ServerProxy::flushCompressedMouse()
 		m_dxMouse = 0;
 		m_dyMouse = 0;
 	}
+	if (m_mouseTraced) {
+		m_mouseTraced = false;
+		recordLatency(m_mouseInput);
+	}
+}
+
+void
+ServerProxy::setLatencyTrace(bool enabled)
+{
+	if (enabled == m_latencyTrace) {
+		return;
+	}
+	LOG((CLOG_DEBUG "latency tracing %s", enabled ? "enabled" : "disabled"));
+
+	m_latencyTrace = enabled;
+	m_inputTraced  = false;
+	m_mouseTraced  = false;
+	m_clockOffset.reset();
+	m_latency.clear();
+	LatencyTrace::setEnabled(enabled);
+}
+
+void
+ServerProxy::traceInjected()
+{
+	if (m_inputTraced) {
+		m_inputTraced = false;
+		recordLatency(m_input);
+	}
+}
+
+void
+ServerProxy::traceCompressedMouse()
+{
+	// the motion is injected when the compressed motion is flushed
+	if (m_inputTraced) {
+		m_inputTraced = false;
+		m_mouseTraced = true;
+		m_mouseInput  = m_input;
+	}
+}
+
+void
+ServerProxy::recordLatency(const TracedInput& input)
+{
+	UInt64 injected = LatencyTrace::getInjectTime();
+	if (injected < input.m_received) {
+		// the screen doesn't note injected events
+		injected = LatencyTrace::now();
+	}
+
+	m_latency.add(LatencyStats::kQueue, elapsed(input.m_captured, input.m_handled));
+	m_latency.add(LatencyStats::kRelay, elapsed(input.m_handled, input.m_sent));
+	m_latency.add(LatencyStats::kInject, elapsed(input.m_received, injected));
+
+	// the other steps need to compare the clocks
+	if (m_clockOffset.isValid()) {
+		m_latency.add(LatencyStats::kNetwork,
+							elapsed(m_clockOffset.toLocal(input.m_sent),
+								input.m_received));
+		m_latency.add(LatencyStats::kTotal,
+							elapsed(m_clockOffset.toLocal(input.m_captured),
+								injected));
+	}
+}
+
+void
+ServerProxy::sendLatency()
+{
+	// measure the clock offset again
+	UInt64 now = LatencyTrace::now();
+	ProtocolUtil::writef(m_stream, kMsgQTime,
+							static_cast<UInt32>(now >> 32),
+							static_cast<UInt32>(now));
+
+	// report latencies since the last keep alive
+	if (!m_latency.isEmpty()) {
+		std::vector<UInt32> data;
+		m_latency.marshall(data);
+		ProtocolUtil::writef(m_stream, kMsgDLatency, &data);
+		m_latency.clear();
+	}
 }
 
 void
@@ -526,6 +674,7 @@ ServerProxy::enter()
 	m_compressMouseRelative = false;
 	m_dxMouse               = 0;
 	m_dyMouse               = 0;
+	m_mouseTraced           = false;
 	m_seqNum                = seqNum;
 
 	// forward
@@ -549,28 +698,55 @@ void
 ServerProxy::setClipboard()
 {
 	// parse
-	static String dataCached;
 	ClipboardID id;
 	UInt32 seq;
 	
-	int r = ClipboardChunk::assemble(m_stream, dataCached, id, seq);
+	int r = ClipboardChunk::assemble(m_stream, m_clipboardData,
+							m_clipboardSize, id, seq);
 
 	if (r == kStart) {
-		size_t size = ClipboardChunk::getExpectedSize();
-		LOG((CLOG_DEBUG "receiving clipboard %d size=%d", id, size));
+		LOG((CLOG_DEBUG "receiving clipboard %d size=%d", id, (int)m_clipboardSize));
 	}
 	else if (r == kFinish) {
-		LOG((CLOG_DEBUG "received clipboard %d size=%d", id, dataCached.size()));
+		LOG((CLOG_DEBUG "received clipboard %d size=%d", id, (int)m_clipboardData.size()));
 		
-		// forward
+		// forward.  a sequence number means it answers an offer
 		Clipboard clipboard;
-		clipboard.unmarshall(dataCached, 0);
+		clipboard.unmarshall(m_clipboardData, 0);
+		String().swap(m_clipboardData);
+		if (seq != 0) {
+			m_client->clipboardFormatsReceived(id, seq, clipboard);
+			return;
+		}
 		m_client->setClipboard(id, &clipboard);
 
 		LOG((CLOG_INFO "clipboard was updated"));
 	}
 }
 
+void
+ServerProxy::clipboardOffered()
+{
+	// parse
+	ClipboardID id;
+	UInt32 seq;
+	std::vector<UInt32> formats;
+	if (!ProtocolUtil::readf(m_stream, kMsgDClipboardOffer + 4,
+							&id, &seq, &formats)) {
+		return;
+	}
+
+	ClipboardOffer offer;
+	if (id >= kClipboardEnd || seq == 0 || !offer.unmarshall(formats)) {
+		LOG((CLOG_ERR "invalid clipboard offer"));
+		return;
+	}
+	LOG((CLOG_DEBUG "recv clipboard %d offer seqnum=%d formats=%d", id, seq, (int)offer.getFormats().size()));
+
+	// forward
+	m_client->clipboardOffered(id, seq, offer);
+}
+
 void
 ServerProxy::grabClipboard()
 {
@@ -610,6 +786,7 @@ ServerProxy::keyDown()
 
 	// forward
 	m_client->keyDown(id2, mask2, button);
+	traceInjected();
 }
 
 void
@@ -634,6 +811,7 @@ ServerProxy::keyRepeat()
 
 	// forward
 	m_client->keyRepeat(id2, mask2, count, button);
+	traceInjected();
 }
 
 void
@@ -657,6 +835,7 @@ ServerProxy::keyUp()
 
 	// forward
 	m_client->keyUp(id2, mask2, button);
+	traceInjected();
 }
 
 void
@@ -719,6 +898,13 @@ ServerProxy::mouseMove()
 	// forward
 	if (!ignore) {
 		m_client->mouseMove(x, y);
+		traceInjected();
+	}
+	else if (m_compressMouse) {
+		traceCompressedMouse();
+	}
+	else {
+		m_inputTraced = false;
 	}
 }
 
@@ -749,6 +935,13 @@ ServerProxy::mouseRelativeMove()
 	// forward
 	if (!ignore) {
 		m_client->mouseRelativeMove(dx, dy);
+		traceInjected();
+	}
+	else if (m_compressMouseRelative) {
+		traceCompressedMouse();
+	}
+	else {
+		m_inputTraced = false;
 	}
 }
 
@@ -791,6 +984,9 @@ ServerProxy::resetOptions()
 	// reset keep alive
 	setKeepAliveRate(kKeepAliveRate);
 
+	// stop tracing latency
+	setLatencyTrace(false);
+
 	// reset modifier translation table
 	for (KeyModifierID id = 0; id < kKeyModifierIDLast; ++id) {
 		m_modifierTranslationTable[id] = id;
@@ -833,6 +1029,9 @@ ServerProxy::setOptions()
 			// update keep alive
 			setKeepAliveRate(1.0e-3 * static_cast<double>(options[i + 1]));
 		}
+		else if (options[i] == kOptionLatencyTrace) {
+			setLatencyTrace(options[i + 1] != 0);
+		}
 
 		if (id != kKeyModifierIDNull) {
 			m_modifierTranslationTable[id] =
@@ -861,20 +1060,36 @@ ServerProxy::infoAcknowledgment()
 void
 ServerProxy::fileChunkReceived()
 {
-	int result = FileChunk::assemble(
-					m_stream,
-					m_client->getReceivedFileData(),
-					m_client->getExpectedFileSize());
+	// the server is the only source of files
+	FileChunk::assembleQueued(m_stream, m_client->getFileReceiver(), "");
+}
 
-	if (result == kFinish) {
-		m_events->addEvent(Event(m_events->forFile().fileRecieveCompleted(), m_client));
+void
+ServerProxy::fileAcceptReceived()
+{
+	// parse
+	UInt32 id = 0;
+	String offset;
+	if (ProtocolUtil::readf(m_stream, kMsgDFileAccept + 4, &id, &offset)) {
+		m_client->fileTransferAccepted(id,
+							synergy::string::stringToSizeType(offset));
 	}
-	else if (result == kStart) {
-		if (m_client->getDragFileList().size() > 0) {
-			String filename = m_client->getDragFileList().at(0).getFilename();
-			LOG((CLOG_DEBUG "start receiving %s", filename.c_str()));
-		}
+}
+
+void
+ServerProxy::compressionReceived()
+{
+	// parse
+	UInt32 codecs = 0;
+	if (!ProtocolUtil::readf(m_stream, kMsgDCompression + 4, &codecs)) {
+		return;
 	}
+
+	// answer with the codecs we can decompress
+	m_codecs = codecs & PayloadCompressor::getCodecs();
+	LOG((CLOG_DEBUG "server compression codecs=%d", m_codecs));
+	ProtocolUtil::writef(m_stream, kMsgDCompression,
+							PayloadCompressor::getCodecs());
 }
 
 void
@@ -889,15 +1104,57 @@ ServerProxy::dragInfoReceived()
 }
 
 void
-ServerProxy::handleClipboardSendingEvent(const Event& event, void*)
+ServerProxy::inputTimeReceived()
+{
+	// parse
+	UInt32 high, low, handled, sent;
+	if (!ProtocolUtil::readf(m_stream, kMsgDInputTime + 4,
+							&high, &low, &handled, &sent)) {
+		return;
+	}
+	if (!m_latencyTrace) {
+		return;
+	}
+
+	// the next key or mouse motion message is the traced event
+	m_inputTraced         = true;
+	m_input.m_captured    = (static_cast<UInt64>(high) << 32) | low;
+	m_input.m_handled     = m_input.m_captured + handled;
+	m_input.m_sent        = m_input.m_captured + sent;
+	m_input.m_received    = m_receiveTime;
+}
+
+void
+ServerProxy::timeReceived()
+{
+	// parse
+	UInt32 sentHigh, sentLow, high, low;
+	if (!ProtocolUtil::readf(m_stream, kMsgDTime + 4,
+							&sentHigh, &sentLow, &high, &low)) {
+		return;
+	}
+	if (!m_latencyTrace) {
+		return;
+	}
+
+	m_clockOffset.addSample((static_cast<UInt64>(sentHigh) << 32) | sentLow,
+							(static_cast<UInt64>(high) << 32) | low,
+							m_receiveTime);
+	LOG((CLOG_DEBUG2 "clock offset %lldus round trip %lluus", m_clockOffset.getOffset(), m_clockOffset.getRoundTrip()));
+}
+
+void
+ServerProxy::fileChunkSending(const FileChunk& chunk)
 {
-	ClipboardChunk::send(m_stream, event.getData());
+	FileChunk::send(m_stream, chunk, (m_codecs & kCompressionLZ4) != 0);
+	m_unflushedChunks.written(chunk);
 }
 
 void
-ServerProxy::fileChunkSending(UInt8 mark, char* data, size_t dataSize)
+ServerProxy::handleOutputFlushed(const Event&, void*)
 {
-	FileChunk::send(m_stream, mark, data, dataSize);
+	m_unflushedChunks.flushed();
+	m_clipboardSender.flushed();
 }
 
 void
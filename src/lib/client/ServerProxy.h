@@ -18,6 +18,10 @@
 
 #pragma once
 
+#include "synergy/ClipboardSender.h"
+#include "synergy/ClockOffset.h"
+#include "synergy/FileWindow.h"
+#include "synergy/LatencyStats.h"
 #include "synergy/clipboard_types.h"
 #include "synergy/key_types.h"
 #include "base/Event.h"
@@ -27,6 +31,7 @@
 class Client;
 class ClientInfo;
 class EventQueueTimer;
+class FileChunk;
 class IClipboard;
 namespace synergy { class IStream; }
 class IEventQueue;
@@ -52,10 +57,19 @@ public:
 	bool				onGrabClipboard(ClipboardID);
 	void				onClipboardChanged(ClipboardID, const IClipboard*);
 
+	//! Ask for offered clipboard format
+	/*!
+	Asks for the data of \c format from the clipboard offer with
+	sequence number \c sequence.  The data is given to
+	Client::clipboardFormatsReceived().
+	*/
+	void				requestClipboardFormat(ClipboardID,
+							UInt32 sequence, UInt32 format);
+
 	//@}
 
 	// sending file chunk to server
-	void				fileChunkSending(UInt8 mark, char* data, size_t dataSize);
+	void				fileChunkSending(const FileChunk& chunk);
 
 	// sending dragging information to server
 	void				sendDragInfo(UInt32 fileCount, const char* info, size_t size);
@@ -70,6 +84,16 @@ protected:
 	EResult				parseMessage(const UInt8* code);
 
 private:
+	// times of a traced input event.  all but m_received are from the
+	// server's clock.
+	class TracedInput {
+	public:
+		UInt64			m_captured;
+		UInt64			m_handled;
+		UInt64			m_sent;
+		UInt64			m_received;
+	};
+
 	// if compressing mouse motion then send the last motion now
 	void				flushCompressedMouse();
 
@@ -78,6 +102,13 @@ private:
 	void				resetKeepAliveAlarm();
 	void				setKeepAliveRate(double);
 
+	// latency tracing
+	void				setLatencyTrace(bool enabled);
+	void				traceInjected();
+	void				traceCompressedMouse();
+	void				recordLatency(const TracedInput&);
+	void				sendLatency();
+
 	// modifier key translation
 	KeyID				translateKey(KeyID) const;
 	KeyModifierMask			translateModifierMask(KeyModifierMask) const;
@@ -85,11 +116,13 @@ private:
 	// event handlers
 	void				handleData(const Event&, void*);
 	void				handleKeepAliveAlarm(const Event&, void*);
+	void				handleOutputFlushed(const Event&, void*);
 
 	// message handlers
 	void				enter();
 	void				leave();
 	void				setClipboard();
+	void				clipboardOffered();
 	void				grabClipboard();
 	void				keyDown();
 	void				keyRepeat();
@@ -105,10 +138,14 @@ private:
 	void				queryInfo();
 	void				infoAcknowledgment();
 	void				fileChunkReceived();
+	void				fileAcceptReceived();
+	void				compressionReceived();
 	void				dragInfoReceived();
-	void				handleClipboardSendingEvent(const Event&, void*);
+	void				inputTimeReceived();
+	void				timeReceived();
 
 private:
+
 	typedef EResult (ServerProxy::*MessageParser)(const UInt8*);
 
 	Client*			m_client;
@@ -130,4 +167,27 @@ private:
 
 	MessageParser		m_parser;
 	IEventQueue*		m_events;
+
+	// codecs the server can decompress
+	UInt32				m_codecs;
+
+	ClipboardSender		m_clipboardSender;
+
+	// file chunks written to the stream that it hasn't sent yet
+	UnflushedFileChunks	m_unflushedChunks;
+
+	// clipboard being received
+	String				m_clipboardData;
+	size_t				m_clipboardSize;
+
+	// latency tracing.  m_mouseInput is the traced input of compressed
+	// mouse motion.
+	bool				m_latencyTrace;
+	UInt64				m_receiveTime;
+	bool				m_inputTraced;
+	TracedInput			m_input;
+	bool				m_mouseTraced;
+	TracedInput			m_mouseInput;
+	ClockOffset			m_clockOffset;
+	LatencyStats		m_latency;
 };
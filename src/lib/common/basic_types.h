@@ -81,6 +81,8 @@ typedef signed TYPE_OF_SIZE_4	SInt32;
 typedef unsigned TYPE_OF_SIZE_1	UInt8;
 typedef unsigned TYPE_OF_SIZE_2	UInt16;
 typedef unsigned TYPE_OF_SIZE_4	UInt32;
+typedef signed long long		SInt64;
+typedef unsigned long long		UInt64;
 #endif
 #endif
 //
@@ -24,6 +24,7 @@
 #include "base/EventTypes.h"
 
 class IEventQueue;
+class SharedBuffer;
 
 namespace synergy {
 
@@ -65,6 +66,29 @@ public:
 	*/
 	virtual void		write(const void* buffer, UInt32 n) = 0;
 
+	//! Write file data to stream
+	/*!
+	Write \c headerSize bytes from \c header followed by \c n bytes of
+	the file open as descriptor \c fd, starting at \c offset, as if by
+	a single write().  A stream that can send straight from a file does
+	so without copying the file data and keeps its own handle on the
+	file, so \c fd can be closed on return.  Other streams return false
+	without writing anything;  the caller should then read the data
+	and use write().
+	*/
+	virtual bool		writeFile(const void* header, UInt32 headerSize,
+							int fd, UInt64 offset, UInt32 n) = 0;
+
+	//! Write shared data to stream
+	/*!
+	Write the bytes of \c buffer to the stream as if by write().  A
+	stream that queues output takes a reference on \c buffer and queues
+	it rather than copying it, so the same buffer can be written to
+	many streams for the cost of one.  The caller keeps its own
+	reference.
+	*/
+	virtual void		writeShared(SharedBuffer* buffer) = 0;
+
 	//! Flush the stream
 	/*!
 	Waits until all buffered data has been written to the stream.
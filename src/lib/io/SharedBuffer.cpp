@@ -0,0 +1,70 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/SharedBuffer.h"
+
+//
+// SharedBuffer
+//
+
+SharedBuffer::SharedBuffer(UInt32 size) :
+	m_refCount(1),
+	m_data(new UInt8[size]),
+	m_size(size)
+{
+	// do nothing
+}
+
+SharedBuffer::~SharedBuffer()
+{
+	delete[] m_data;
+}
+
+void
+SharedBuffer::ref()
+{
+	m_refCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+void
+SharedBuffer::unref()
+{
+	assert(m_refCount.load(std::memory_order_relaxed) > 0);
+
+	// the last owner must see every other owner's use of the data
+	if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		delete this;
+	}
+}
+
+UInt8*
+SharedBuffer::getData()
+{
+	return m_data;
+}
+
+const UInt8*
+SharedBuffer::getData() const
+{
+	return m_data;
+}
+
+UInt32
+SharedBuffer::getSize() const
+{
+	return m_size;
+}
@@ -0,0 +1,83 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/basic_types.h"
+
+#include <atomic>
+
+//! Reference counted byte buffer
+/*!
+A block of bytes that several owners can hold at once, so data sent to
+many streams is built once and queued on each without copying.  The
+creator fills the buffer and then hands out references;  the contents
+must not change once a reference has been given away.  Any thread may
+add and drop references.  The buffer deletes itself when the last
+reference is dropped.
+*/
+class SharedBuffer {
+public:
+	/*!
+	Creates a buffer of \c size bytes holding one reference, which
+	belongs to the caller.
+	*/
+	SharedBuffer(UInt32 size);
+
+	//! @name manipulators
+	//@{
+
+	//! Add a reference
+	void				ref();
+
+	//! Drop a reference
+	/*!
+	Drops a reference and deletes the buffer if it was the last one.
+	*/
+	void				unref();
+
+	//! Get data for filling
+	/*!
+	Returns the bytes of the buffer for writing.  Only the creator may
+	use this, before sharing the buffer.
+	*/
+	UInt8*				getData();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get data
+	const UInt8*		getData() const;
+
+	//! Get size
+	UInt32				getSize() const;
+
+	//@}
+
+private:
+	// use unref()
+	~SharedBuffer();
+
+	SharedBuffer(const SharedBuffer&);
+	SharedBuffer&		operator=(const SharedBuffer&);
+
+private:
+	std::atomic<UInt32>	m_refCount;
+	UInt8*				m_data;
+	UInt32				m_size;
+};
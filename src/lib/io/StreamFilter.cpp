@@ -62,6 +62,19 @@ StreamFilter::write(const void* buffer, UInt32 n)
 	getStream()->write(buffer, n);
 }
 
+bool
+StreamFilter::writeFile(const void* header, UInt32 headerSize,
+				int fd, UInt64 offset, UInt32 n)
+{
+	return getStream()->writeFile(header, headerSize, fd, offset, n);
+}
+
+void
+StreamFilter::writeShared(SharedBuffer* buffer)
+{
+	getStream()->writeShared(buffer);
+}
+
 void
 StreamFilter::flush()
 {
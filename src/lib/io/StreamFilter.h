@@ -42,6 +42,9 @@ public:
 	virtual void		close();
 	virtual UInt32		read(void* buffer, UInt32 n);
 	virtual void		write(const void* buffer, UInt32 n);
+	virtual bool		writeFile(const void* header, UInt32 headerSize,
+							int fd, UInt64 offset, UInt32 n);
+	virtual void		writeShared(SharedBuffer* buffer);
 	virtual void		flush();
 	virtual void		shutdownInput();
 	virtual void		shutdownOutput();
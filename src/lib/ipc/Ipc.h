@@ -23,7 +23,7 @@
 
 enum EIpcMessage {
 	kIpcHello,
-	kIpcLogLine,
+	kIpcLogBatch,
 	kIpcCommand,
 	kIpcShutdown,
 };
@@ -38,9 +38,11 @@ enum EIpcClientType {
 // $1 = type, the client identifies it's self as gui or node (synergyc/s).
 extern const char*		kIpcMsgHello;
 
-// log line: daemon -> gui
-// $1 = aggregate log lines collected from synergys/c or the daemon itself.
-extern const char*		kIpcMsgLogLine;
+// log batch: daemon -> gui
+// $1 = sequence number of the batch, $2 = number of log lines dropped
+// since the previous batch, $3 = the log records collected from synergys/c
+// or the daemon itself, as marshalled by IpcLogBatchMessage.
+extern const char*		kIpcMsgLogBatch;
 
 // command: gui -> daemon
 // $1 = command; the command for the daemon to launch, typically the full
@@ -144,10 +144,12 @@ IpcClientProxy::send(const IpcMessage& message)
 	LOG((CLOG_DEBUG4 "ipc write: %d", message.type()));
 
 	switch (message.type()) {
-	case kIpcLogLine: {
-		const IpcLogLineMessage& llm = static_cast<const IpcLogLineMessage&>(message);
-		const String logLine = llm.logLine();
-		ProtocolUtil::writef(&m_stream, kIpcMsgLogLine, &logLine);
+	case kIpcLogBatch: {
+		const IpcLogBatchMessage& lbm = static_cast<const IpcLogBatchMessage&>(message);
+		String records;
+		lbm.marshall(records);
+		ProtocolUtil::writef(&m_stream, kIpcMsgLogBatch,
+							lbm.sequence(), lbm.dropped(), &records);
 		break;
 	}
 			
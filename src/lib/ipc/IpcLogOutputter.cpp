@@ -31,10 +31,8 @@
 #include "base/TMethodJob.h"
 
 enum EIpcLogOutputter {
-	kBufferMaxSize = 1000,
-	kMaxSendLines = 100,
-	kBufferRateWriteLimit = 1000, // writes per kBufferRateTime
-	kBufferRateTimeLimit = 1 // seconds
+	kBufferMaxSize = 10000,
+	kMaxSendRecords = 1000
 };
 
 IpcLogOutputter::IpcLogOutputter(IpcServer& ipcServer, EIpcClientType clientType, bool useThread) :
@@ -47,10 +45,9 @@ IpcLogOutputter::IpcLogOutputter(IpcServer& ipcServer, EIpcClientType clientType
 	m_notifyMutex(ARCH->newMutex()),
 	m_bufferWaiting(false),
 	m_bufferMaxSize(kBufferMaxSize),
-	m_bufferRateWriteLimit(kBufferRateWriteLimit),
-	m_bufferRateTimeLimit(kBufferRateTimeLimit),
-	m_bufferWriteCount(0),
-	m_bufferRateStart(ARCH->time()),
+	m_sequence(0),
+	m_unsentDropped(0),
+	m_droppedRecords(0),
 	m_clientType(clientType),
 	m_runningMutex(ARCH->newMutex())
 {
@@ -100,43 +97,61 @@ IpcLogOutputter::show(bool showIfEmpty)
 bool
 IpcLogOutputter::write(ELevel, const char* text)
 {
-	// ignore events from the buffer thread (would cause recursion).
-	if (m_bufferThread != nullptr &&
-		Thread::getCurrentThread().getID() == m_bufferThreadId) {
-		return true;
+	// the log calls writeRecord(), so this text was formatted elsewhere
+	// (e.g. output of synergys/c) and is sent as is
+	IpcLogRecord record;
+	record.m_level   = kPRINT;
+	record.m_time    = static_cast<UInt64>(time(NULL));
+	record.m_message = text;
+
+	if (appendBuffer(record)) {
+		notifyBuffer();
 	}
+	return true;
+}
 
-	appendBuffer(text);
-	notifyBuffer();
+bool
+IpcLogOutputter::writeRecord(const LogRecord& logRecord)
+{
+	IpcLogRecord record;
+	record.m_level   = logRecord.m_level;
+	record.m_time    = static_cast<UInt64>(logRecord.m_time);
+	record.m_line    = static_cast<UInt32>(logRecord.m_line);
+	if (logRecord.m_file != NULL) {
+		record.m_file = logRecord.m_file;
+	}
+	record.m_message.assign(logRecord.m_message, logRecord.m_messageSize);
 
+	if (appendBuffer(record)) {
+		notifyBuffer();
+	}
 	return true;
 }
 
-void
-IpcLogOutputter::appendBuffer(const String& text)
+bool
+IpcLogOutputter::appendBuffer(IpcLogRecord& record)
 {
-	ArchMutexLock lock(m_bufferMutex);
+	IArchMultithread::ThreadID threadId = Thread::getCurrentThread().getID();
 
-	double elapsed = ARCH->time() - m_bufferRateStart;
-	if (elapsed < m_bufferRateTimeLimit) {
-		if (m_bufferWriteCount >= m_bufferRateWriteLimit) {
-			// discard the log line if we've logged too much.
-			return;
-		}
-	}
-	else {
-		m_bufferWriteCount = 0;
-		m_bufferRateStart = ARCH->time();
+	// ignore events from the buffer thread (would cause recursion).
+	if (m_bufferThread != nullptr && threadId == m_bufferThreadId) {
+		return false;
 	}
+	record.m_threadId = static_cast<UInt32>(threadId);
+
+	ArchMutexLock lock(m_bufferMutex);
 
 	if (m_buffer.size() >= m_bufferMaxSize) {
 		// if the queue is exceeds size limit,
 		// throw away the oldest item
 		m_buffer.pop_front();
+		++m_unsentDropped;
+		++m_droppedRecords;
 	}
 
-	m_buffer.push_back(text);
-	m_bufferWriteCount++;
+	m_buffer.push_back(IpcLogRecord());
+	std::swap(m_buffer.back(), record);
+	return true;
 }
 
 bool
@@ -176,8 +191,9 @@ IpcLogOutputter::notifyBuffer()
 	ARCH->broadcastCondVar(m_notifyCond);
 }
 
-String
-IpcLogOutputter::getChunk(size_t count)
+void
+IpcLogOutputter::getChunk(size_t count,
+				IpcLogBatchMessage::RecordList& records, UInt32& dropped)
 {
 	ArchMutexLock lock(m_bufferMutex);
 
@@ -185,13 +201,14 @@ IpcLogOutputter::getChunk(size_t count)
 		count = m_buffer.size();
 	}
 
-	String chunk;
+	records.resize(count);
 	for (size_t i = 0; i < count; i++) {
-		chunk.append(m_buffer.front());
-		chunk.append("\n");
+		std::swap(records[i], m_buffer.front());
 		m_buffer.pop_front();
 	}
-	return chunk;
+
+	dropped = m_unsentDropped;
+	m_unsentDropped = 0;
 }
 
 void
@@ -201,7 +218,11 @@ IpcLogOutputter::sendBuffer()
 		return;
 	}
 
-	IpcLogLineMessage message(getChunk(kMaxSendLines));
+	IpcLogBatchMessage::RecordList records;
+	UInt32 dropped;
+	getChunk(kMaxSendRecords, records, dropped);
+
+	IpcLogBatchMessage message(m_sequence++, dropped, records);
 	m_sending = true;
 	m_ipcServer.send(message, kIpcClientGui);
 	m_sending = false;
@@ -219,9 +240,9 @@ IpcLogOutputter::bufferMaxSize() const
 	return m_bufferMaxSize;
 }
 
-void
-IpcLogOutputter::bufferRateLimit(UInt16 writeLimit, double timeLimit)
+UInt64
+IpcLogOutputter::droppedRecords() const
 {
-	m_bufferRateWriteLimit = writeLimit;
-	m_bufferRateTimeLimit = timeLimit;
+	ArchMutexLock lock(m_bufferMutex);
+	return m_droppedRecords;
 }
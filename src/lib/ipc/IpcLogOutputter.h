@@ -22,6 +22,7 @@
 #include "arch/IArchMultithread.h"
 #include "base/ILogOutputter.h"
 #include "ipc/Ipc.h"
+#include "ipc/IpcMessage.h"
 
 #include <deque>
 
@@ -31,7 +32,10 @@ class IpcClientProxy;
 
 //! Write log to GUI over IPC
 /*!
-This outputter writes output to the GUI via IPC.
+This outputter writes output to the GUI via IPC.  Messages are queued
+as log records with their priority, time, thread and source, and sent
+in numbered batches.  When the queue is full the oldest records are
+dropped, and the next batch says how many were.
 */
 class IpcLogOutputter : public ILogOutputter {
 public:
@@ -48,6 +52,7 @@ public:
 	virtual void		close();
 	virtual void		show(bool showIfEmpty);
 	virtual bool		write(ELevel level, const char* message);
+	virtual bool		writeRecord(const LogRecord& record);
 	
 	//! @name manipulators
 	//@{
@@ -62,12 +67,6 @@ public:
 	*/
 	void				bufferMaxSize(UInt16 bufferMaxSize);
 
-	//! Set the rate limit
-	/*!
-	Set the maximum number of \p writeRate for every \p timeRate in seconds.
-	*/
-	void				bufferRateLimit(UInt16 writeLimit, double timeLimit);
-
 	//! Send the buffer
 	/*!
 	Sends a chunk of the buffer to the IPC server, normally called
@@ -85,18 +84,26 @@ public:
 	Returns the maximum size of the buffer.
 	*/
 	UInt16				bufferMaxSize() const;
+
+	//! Get the dropped record count
+	/*!
+	Returns the number of records dropped because the buffer was full.
+	*/
+	UInt64				droppedRecords() const;
 	
 	//@}
 
 private:
 	void				init();
 	void				bufferThread(void*);
-	String				getChunk(size_t count);
-	void				appendBuffer(const String& text);
+	void				getChunk(size_t count,
+							IpcLogBatchMessage::RecordList& records,
+							UInt32& dropped);
+	bool				appendBuffer(IpcLogRecord& record);
 	bool				isRunning();
 
 private:
-	typedef std::deque<String> Buffer;
+	typedef std::deque<IpcLogRecord> Buffer;
 
 	IpcServer&			m_ipcServer;
 	Buffer				m_buffer;
@@ -110,10 +117,9 @@ private:
 	IArchMultithread::ThreadID
 						m_bufferThreadId;
 	UInt16				m_bufferMaxSize;
-	UInt16				m_bufferRateWriteLimit;
-	double				m_bufferRateTimeLimit;
-	UInt16				m_bufferWriteCount;
-	double				m_bufferRateStart;
+	UInt32				m_sequence;
+	UInt32				m_unsentDropped;
+	UInt64				m_droppedRecords;
 	bool				m_useThread;
 	EIpcClientType		m_clientType;
 	ArchMutex			m_runningMutex;
@@ -47,14 +47,135 @@ IpcShutdownMessage::~IpcShutdownMessage()
 {
 }
 
-IpcLogLineMessage::IpcLogLineMessage(const String& logLine) :
-IpcMessage(kIpcLogLine),
-m_logLine(logLine)
+//
+// IpcLogRecord
+//
+
+IpcLogRecord::IpcLogRecord() :
+	m_level(kPRINT),
+	m_time(0),
+	m_threadId(0),
+	m_line(0)
+{
+}
+
+//
+// IpcLogBatchMessage
+//
+
+// each record is the level plus one, the time, the thread id, the line,
+// then the file and the message each preceded by their size
+static const size_t		kRecordFixedSize = 1 + 8 + 4 + 4 + 4 + 4;
+
+static void
+writeInt(String& data, UInt64 value, size_t size)
+{
+	while (size-- > 0) {
+		data.push_back(static_cast<char>((value >> (8 * size)) & 0xff));
+	}
+}
+
+static UInt64
+readInt(const String& data, size_t& offset, size_t size)
+{
+	UInt64 value = 0;
+	for (; size > 0; --size) {
+		value = (value << 8) | static_cast<UInt8>(data[offset++]);
+	}
+	return value;
+}
+
+static bool
+readString(const String& data, size_t& offset, String& value)
+{
+	size_t size = static_cast<size_t>(readInt(data, offset, 4));
+	if (size > data.size() - offset) {
+		return false;
+	}
+	value.assign(data, offset, size);
+	offset += size;
+	return true;
+}
+
+IpcLogBatchMessage::IpcLogBatchMessage() :
+	IpcMessage(kIpcLogBatch),
+	m_sequence(0),
+	m_dropped(0)
+{
+}
+
+IpcLogBatchMessage::IpcLogBatchMessage(
+				UInt32 sequence, UInt32 dropped, RecordList& records) :
+	IpcMessage(kIpcLogBatch),
+	m_sequence(sequence),
+	m_dropped(dropped)
+{
+	m_records.swap(records);
+}
+
+IpcLogBatchMessage::~IpcLogBatchMessage()
 {
 }
 
-IpcLogLineMessage::~IpcLogLineMessage()
+bool
+IpcLogBatchMessage::unmarshall(UInt32 sequence, UInt32 dropped,
+				const String& data)
 {
+	m_sequence = sequence;
+	m_dropped  = dropped;
+	m_records.clear();
+
+	size_t offset = 0;
+	while (offset < data.size()) {
+		if (data.size() - offset < kRecordFixedSize) {
+			m_records.clear();
+			return false;
+		}
+
+		int level = static_cast<int>(readInt(data, offset, 1)) - 1;
+		if (level > kDEBUG5) {
+			m_records.clear();
+			return false;
+		}
+
+		IpcLogRecord record;
+		record.m_level    = static_cast<ELevel>(level);
+		record.m_time     = readInt(data, offset, 8);
+		record.m_threadId = static_cast<UInt32>(readInt(data, offset, 4));
+		record.m_line     = static_cast<UInt32>(readInt(data, offset, 4));
+		if (!readString(data, offset, record.m_file) ||
+			data.size() - offset < 4 ||
+			!readString(data, offset, record.m_message)) {
+			m_records.clear();
+			return false;
+		}
+		m_records.push_back(record);
+	}
+	return true;
+}
+
+void
+IpcLogBatchMessage::marshall(String& data) const
+{
+	size_t size = 0;
+	for (RecordList::const_iterator i = m_records.begin();
+								i != m_records.end(); ++i) {
+		size += kRecordFixedSize + i->m_file.size() + i->m_message.size();
+	}
+
+	data.clear();
+	data.reserve(size);
+	for (RecordList::const_iterator i = m_records.begin();
+								i != m_records.end(); ++i) {
+		writeInt(data, static_cast<UInt64>(i->m_level + 1), 1);
+		writeInt(data, i->m_time, 8);
+		writeInt(data, i->m_threadId, 4);
+		writeInt(data, i->m_line, 4);
+		writeInt(data, i->m_file.size(), 4);
+		data.append(i->m_file);
+		writeInt(data, i->m_message.size(), 4);
+		data.append(i->m_message);
+	}
 }
 
 IpcCommandMessage::IpcCommandMessage(const String& command, bool elevate) :
@@ -22,6 +22,8 @@
 #include "base/EventTypes.h"
 #include "base/String.h"
 #include "base/Event.h"
+#include "base/ELevel.h"
+#include "common/stdvector.h"
 
 class IpcMessage : public EventData {
 public:
@@ -56,16 +58,77 @@ public:
 };
 
 
-class IpcLogLineMessage : public IpcMessage {
+//! Log record sent over IPC
+class IpcLogRecord {
 public:
-	IpcLogLineMessage(const String& logLine);
-	virtual ~IpcLogLineMessage();
+	IpcLogRecord();
+
+	ELevel				m_level;
+	//! Seconds since the epoch
+	UInt64				m_time;
+	UInt32				m_threadId;
+	//! Source file or empty if unknown
+	String				m_file;
+	UInt32				m_line;
+	String				m_message;
+};
+
+//! Batch of log records
+/*!
+Log records are sent in batches, numbered so the receiver can tell if
+one went missing, along with how many records were dropped on the
+sending side since the previous batch.
+*/
+class IpcLogBatchMessage : public IpcMessage {
+public:
+	typedef std::vector<IpcLogRecord> RecordList;
+
+	//! Create empty batch
+	IpcLogBatchMessage();
+
+	/*!
+	Takes the records from \p records, leaving it empty.
+	*/
+	IpcLogBatchMessage(UInt32 sequence, UInt32 dropped, RecordList& records);
+	virtual ~IpcLogBatchMessage();
+
+	//! @name manipulators
+	//@{
+
+	//! Unmarshall batch
+	/*!
+	Replaces the batch with the one in a kIpcMsgLogBatch message.  Returns
+	false if \p data is malformed, leaving the batch without records.
+	*/
+	bool				unmarshall(UInt32 sequence, UInt32 dropped,
+							const String& data);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Marshall records
+	/*!
+	Saves the records in \p data, the last argument of a kIpcMsgLogBatch
+	message.
+	*/
+	void				marshall(String& data) const;
+
+	//! Gets the sequence number.
+	UInt32				sequence() const { return m_sequence; }
+
+	//! Gets the number of records dropped before this batch.
+	UInt32				dropped() const { return m_dropped; }
+
+	//! Gets the records.
+	const RecordList&	records() const { return m_records; }
 
-	//! Gets the log line.
-	String				logLine() const { return m_logLine; }
+	//@}
 
 private:
-	String				m_logLine;
+	UInt32				m_sequence;
+	UInt32				m_dropped;
+	RecordList			m_records;
 };
 
 class IpcCommandMessage : public IpcMessage {
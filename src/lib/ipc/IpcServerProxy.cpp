@@ -58,8 +58,8 @@ IpcServerProxy::handleData(const Event&, void*)
 			code[0], code[1], code[2], code[3]));
 		
 		IpcMessage* m = nullptr;
-		if (memcmp(code, kIpcMsgLogLine, 4) == 0) {
-			m = parseLogLine();
+		if (memcmp(code, kIpcMsgLogBatch, 4) == 0) {
+			m = parseLogBatch();
 		}
 		else if (memcmp(code, kIpcMsgShutdown, 4) == 0) {
 			m = new IpcShutdownMessage();
@@ -105,14 +105,20 @@ IpcServerProxy::send(const IpcMessage& message)
 	}
 }
 
-IpcLogLineMessage*
-IpcServerProxy::parseLogLine()
+IpcLogBatchMessage*
+IpcServerProxy::parseLogBatch()
 {
-	String logLine;
-	ProtocolUtil::readf(&m_stream, kIpcMsgLogLine + 4, &logLine);
-	
+	UInt32 sequence, dropped;
+	String records;
+	ProtocolUtil::readf(&m_stream, kIpcMsgLogBatch + 4,
+							&sequence, &dropped, &records);
+
 	// must be deleted by event handler.
-	return new IpcLogLineMessage(logLine);
+	IpcLogBatchMessage* message = new IpcLogBatchMessage();
+	if (!message->unmarshall(sequence, dropped, records)) {
+		LOG((CLOG_ERR "invalid ipc log batch"));
+	}
+	return message;
 }
 
 void
@@ -23,7 +23,7 @@
 
 namespace synergy { class IStream; }
 class IpcMessage;
-class IpcLogLineMessage;
+class IpcLogBatchMessage;
 class IEventQueue;
 
 class IpcServerProxy {
@@ -37,7 +37,7 @@ private:
 	void				send(const IpcMessage& message);
 
 	void				handleData(const Event&, void*);
-	IpcLogLineMessage*	parseLogLine();
+	IpcLogBatchMessage*	parseLogBatch();
 	void				disconnect();
 
 private:
@@ -64,6 +64,9 @@ public:
 	// IStream overrides
 	virtual UInt32		read(void* buffer, UInt32 n) = 0;
 	virtual void		write(const void* buffer, UInt32 n) = 0;
+	virtual bool		writeFile(const void* header, UInt32 headerSize,
+							int fd, UInt64 offset, UInt32 n) = 0;
+	virtual void		writeShared(SharedBuffer* buffer) = 0;
 	virtual void		flush() = 0;
 	virtual void		shutdownInput() = 0;
 	virtual void		shutdownOutput() = 0;
@@ -36,11 +36,7 @@ SecureListenSocket::SecureListenSocket(
 
 SecureListenSocket::~SecureListenSocket()
 {
-	SecureSocketSet::iterator it;
-	for (it = m_secureSocketSet.begin(); it != m_secureSocketSet.end(); it++) {
-		delete *it;
-	}
-	m_secureSocketSet.clear();
+	// the accepted sockets belong to whoever accepted them
 }
 
 IDataSocket*
@@ -69,8 +65,6 @@ SecureListenSocket::accept()
 
 		socket->secureAccept();
 
-		m_secureSocketSet.insert(socket);
-
 		return dynamic_cast<IDataSocket*>(socket);
 	}
 	catch (XArchNetwork&) {
@@ -18,7 +18,6 @@
 #pragma once
 
 #include "net/TCPListenSocket.h"
-#include "common/stdset.h"
 
 class IEventQueue;
 class SocketMultiplexer;
@@ -33,9 +32,4 @@ public:
 	// IListenSocket overrides
 	virtual IDataSocket*
 						accept();
-
-private:
-	typedef std::set<IDataSocket*> SecureSocketSet;
-
-	SecureSocketSet		m_secureSocketSet;
 };
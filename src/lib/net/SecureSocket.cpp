@@ -20,9 +20,11 @@
 #include "net/TSocketMultiplexerMethodJob.h"
 #include "base/TMethodEventJob.h"
 #include "net/TCPSocket.h"
+#include "io/SharedBuffer.h"
 #include "mt/Lock.h"
 #include "arch/XArch.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
 
 #include <openssl/ssl.h>
 #include <openssl/err.h>
@@ -61,7 +63,7 @@ SecureSocket::SecureSocket(
 		IEventQueue* events,
 		SocketMultiplexer* socketMultiplexer,
 		ArchSocket socket) :
-	TCPSocket(events, socketMultiplexer, socket),
+	TCPSocket(events, socketMultiplexer, socket, false),
 	m_secureReady(false),
 	m_fatal(false)
 {
@@ -69,6 +71,9 @@ SecureSocket::SecureSocket(
 
 SecureSocket::~SecureSocket()
 {
+	// stop servicing the socket before its SSL state goes away
+	setJob(NULL);
+
 	isFatal(true);
 	if (m_ssl->m_ssl != NULL) {
 		SSL_shutdown(m_ssl->m_ssl);
@@ -94,6 +99,21 @@ SecureSocket::close()
 	TCPSocket::close();
 }
 
+bool
+SecureSocket::writeFile(const void*, UInt32, int, UInt64, UInt32)
+{
+	// file data must be encrypted so it can't go straight to the socket
+	return false;
+}
+
+void
+SecureSocket::writeShared(SharedBuffer* buffer)
+{
+	// the data must be encrypted per connection so it's copied in with
+	// the rest of the output
+	write(buffer->getData(), buffer->getSize());
+}
+
 void
 SecureSocket::connect(const NetworkAddress& addr)
 {
@@ -120,6 +140,7 @@ SecureSocket::newJob()
 void
 SecureSocket::secureConnect()
 {
+	m_handshakeTime.reset();
 	setJob(new TSocketMultiplexerMethodJob<SecureSocket>(
 					this, &SecureSocket::serviceConnect,
 					getSocket(), isReadable(), isWritable()));
@@ -128,6 +149,7 @@ SecureSocket::secureConnect()
 void
 SecureSocket::secureAccept()
 {
+	m_handshakeTime.reset();
 	setJob(new TSocketMultiplexerMethodJob<SecureSocket>(
 					this, &SecureSocket::serviceAccept,
 					getSocket(), isReadable(), isWritable()));
@@ -428,6 +450,7 @@ SecureSocket::secureAccept(int socket)
 	// If not fatal and no retry, state is good
 	if (retry == 0) {
 		m_secureReady = true;
+		countHandshake("accept");
 		LOG((CLOG_INFO "accepted secure socket"));
 		if (CLOG->getFilter() >= kDEBUG1) {
 			showSecureCipherInfo();
@@ -494,6 +517,7 @@ SecureSocket::secureConnect(int socket)
 		return -1; // Fingerprint failed, error
 	}
 	LOG((CLOG_DEBUG2 "connected secure socket"));
+	countHandshake("connect");
 	if (CLOG->getFilter() >= kDEBUG1) {
 		showSecureCipherInfo();
 	}
@@ -501,6 +525,16 @@ SecureSocket::secureConnect(int socket)
 	return 1;
 }
 
+void
+SecureSocket::countHandshake(const char* role)
+{
+	MetricHistogram* time = Metrics::getInstance().getHistogram(
+							"synergy_tls_handshake_seconds",
+							"Time taken by successful TLS handshakes.",
+							Metrics::label("role", role));
+	time->add(static_cast<UInt64>(m_handshakeTime.getTime() * 1.0e6));
+}
+
 bool
 SecureSocket::showCertificate()
 {
@@ -746,6 +780,9 @@ SecureSocket::serviceAccept(ISocketMultiplexerJob* job,
 #endif
 		// If status < 0, error happened
 	if (status < 0) {
+		// we've already said we're disconnected.  don't say it again
+		// when closing because a new socket may have our address by then.
+		m_connected = false;
 		return NULL;
 	}
 
@@ -19,6 +19,7 @@
 
 #include "net/TCPSocket.h"
 #include "net/XSocket.h"
+#include "base/Stopwatch.h"
 
 
 #if WIN32
@@ -52,6 +53,11 @@ public:
 	// ISocket overrides
 	void				close();
 
+	// IStream overrides
+	virtual bool		writeFile(const void* header, UInt32 headerSize,
+							int fd, UInt64 offset, UInt32 n);
+	virtual void		writeShared(SharedBuffer* buffer);
+
 	// IDataSocket overrides
 	virtual void		connect(const NetworkAddress&);
 
@@ -98,9 +104,13 @@ private:
 	void				showSecureCipherInfo();
 
 	void				handleTCPConnected(const Event& event, void*);
+	void				countHandshake(const char* role);
 
 private:
 	Ssl*				m_ssl;
 	bool				m_secureReady;
 	bool				m_fatal;
+
+	// time since the handshake started
+	Stopwatch			m_handshakeTime;
 };
@@ -26,6 +26,7 @@
 #include "arch/Arch.h"
 #include "arch/XArch.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
 #include "base/TMethodJob.h"
 #include "common/stdvector.h"
 
@@ -145,16 +146,16 @@ SocketMultiplexer::removeSocket(ISocket* socket)
 void
 SocketMultiplexer::serviceThread(void*)
 {
-#ifdef SYSAPI_WIN32
+	// the poll entries are only rebuilt when the jobs change, so they
+	// must outlive each pass through the loop
 	std::vector<IArchNetwork::PollEntry> pfds;
-#endif
 	IArchNetwork::PollEntry pfd;
+	MetricCounter* wakeups = Metrics::getInstance().getCounter(
+							"synergy_multiplexer_wakeups_total",
+							"Times the socket multiplexer woke from polling.");
 
 	// service the connections
 	for (;;) {
-#ifdef SYSAPI_UNIX
-		std::vector<IArchNetwork::PollEntry> pfds;
-#endif
 		Thread::testCancel();
 
 		// wait until there are jobs to handle
@@ -200,6 +201,7 @@ SocketMultiplexer::serviceThread(void*)
 			// check for status
 			if (!pfds.empty()) {
 				status = ARCH->pollSocket(&pfds[0], (int)pfds.size(), -1);
+				wakeups->add();
 			}
 			else {
 				status = 0;
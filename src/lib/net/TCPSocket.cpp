@@ -22,6 +22,7 @@
 #include "net/SocketMultiplexer.h"
 #include "net/TSocketMultiplexerMethodJob.h"
 #include "net/XSocket.h"
+#include "io/SharedBuffer.h"
 #include "mt/Lock.h"
 #include "arch/Arch.h"
 #include "arch/XArch.h"
@@ -32,6 +33,9 @@
 #include <cstring>
 #include <cstdlib>
 #include <memory>
+#if HAVE_SYS_SENDFILE_H
+#	include <unistd.h>
+#endif
 
 //
 // TCPSocket
@@ -54,7 +58,7 @@ TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer)
 	init();
 }
 
-TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer, ArchSocket socket) :
+TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer, ArchSocket socket, bool service) :
 	IDataSocket(events),
 	m_events(events),
 	m_mutex(),
@@ -67,7 +71,9 @@ TCPSocket::TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
 	// socket starts in connected state
 	init();
 	onConnected();
-	setJob(newJob());
+	if (service) {
+		setJob(newJob());
+	}
 }
 
 TCPSocket::~TCPSocket()
@@ -170,7 +176,7 @@ TCPSocket::write(const void* buffer, UInt32 n)
 		}
 
 		// copy data to the output buffer
-		wasEmpty = (m_outputBuffer.getSize() == 0);
+		wasEmpty = !hasOutput();
 		m_outputBuffer.write(buffer, n);
 
 		// there's data to write
@@ -183,6 +189,101 @@ TCPSocket::write(const void* buffer, UInt32 n)
 	}
 }
 
+bool
+TCPSocket::writeFile(const void* header, UInt32 headerSize,
+				int fd, UInt64 offset, UInt32 n)
+{
+#if HAVE_SYS_SENDFILE_H
+	bool wasEmpty;
+	{
+		Lock lock(&m_mutex);
+
+		// must not have shutdown output
+		if (!m_writable) {
+			sendEvent(m_events->forIStream().outputError());
+			return true;
+		}
+
+		// keep our own handle so the caller can close the file
+		OutputSegment segment;
+		segment.m_fd     = -1;
+		segment.m_buffer = NULL;
+		if (n > 0) {
+			segment.m_fd = dup(fd);
+			if (segment.m_fd == -1) {
+				return false;
+			}
+		}
+
+		// copy the header to the output buffer and queue the file data
+		// behind it
+		wasEmpty = !hasOutput();
+		m_outputBuffer.write(header, headerSize);
+		if (n > 0) {
+			segment.m_position = m_outputBuffer.getSize();
+			segment.m_offset   = offset;
+			segment.m_size     = n;
+			m_outputSegments.push_back(segment);
+		}
+
+		// there's data to write
+		m_flushed = !hasOutput();
+	}
+
+	// make sure we're waiting to write
+	if (wasEmpty) {
+		setJob(newJob());
+	}
+	return true;
+#else
+	(void)header;
+	(void)headerSize;
+	(void)fd;
+	(void)offset;
+	(void)n;
+	return false;
+#endif
+}
+
+void
+TCPSocket::writeShared(SharedBuffer* buffer)
+{
+	bool wasEmpty;
+	{
+		Lock lock(&m_mutex);
+
+		// must not have shutdown output
+		if (!m_writable) {
+			sendEvent(m_events->forIStream().outputError());
+			return;
+		}
+
+		// ignore empty writes
+		if (buffer->getSize() == 0) {
+			return;
+		}
+
+		// queue a reference to the data behind the output buffer
+		OutputSegment segment;
+		segment.m_position = m_outputBuffer.getSize();
+		segment.m_fd       = -1;
+		segment.m_buffer   = buffer;
+		segment.m_offset   = 0;
+		segment.m_size     = buffer->getSize();
+		buffer->ref();
+		wasEmpty = !hasOutput();
+		m_outputSegments.push_back(segment);
+
+		// there's data to write
+		m_flushed = false;
+	}
+
+	// make sure we're waiting to write
+	if (wasEmpty) {
+		setJob(newJob());
+	}
+}
+
 void
 TCPSocket::flush()
 {
@@ -366,16 +467,87 @@ TCPSocket::doRead()
 TCPSocket::EJobResult
 TCPSocket::doWrite()
 {
-	// write data
-	UInt32 bufferSize = 0;
-	int bytesWrote = 0;
+	// send file data once everything ahead of it is written
+	OutputSegmentList::const_iterator segment = m_outputSegments.begin();
+	if (segment != m_outputSegments.end() &&
+		segment->m_fd != -1 && segment->m_position == 0) {
+		return doWriteFile();
+	}
+
+	// gather the output buffer and the shared data queued in it, up to
+	// the next file data
+	UInt32 bufferSize = m_outputBuffer.getSize();
+	for (OutputSegmentList::const_iterator i = segment;
+								i != m_outputSegments.end(); ++i) {
+		if (i->m_fd != -1) {
+			bufferSize = i->m_position;
+			break;
+		}
+	}
+	const UInt8* buffer =
+		static_cast<const UInt8*>(m_outputBuffer.peek(bufferSize));
+
+	IArchNetwork::WriteBuffer pieces[IArchNetwork::kMAXWRITEBUFFERS];
+	int numPieces = 0;
+	UInt32 position = 0;
+	for (; segment != m_outputSegments.end() && segment->m_fd == -1 &&
+			numPieces + 2 <= IArchNetwork::kMAXWRITEBUFFERS; ++segment) {
+		if (segment->m_position > position) {
+			pieces[numPieces].m_data = buffer + position;
+			pieces[numPieces].m_size = segment->m_position - position;
+			++numPieces;
+			position = segment->m_position;
+		}
+		pieces[numPieces].m_data = segment->m_buffer->getData() +
+										segment->m_offset;
+		pieces[numPieces].m_size = segment->m_size;
+		++numPieces;
+	}
+	UInt32 end = bufferSize;
+	if (segment != m_outputSegments.end()) {
+		end = segment->m_position;
+	}
+	if (end > position && numPieces < IArchNetwork::kMAXWRITEBUFFERS) {
+		pieces[numPieces].m_data = buffer + position;
+		pieces[numPieces].m_size = end - position;
+		++numPieces;
+	}
 
-	bufferSize = m_outputBuffer.getSize();
-	const void* buffer = m_outputBuffer.peek(bufferSize);
-	bytesWrote = (UInt32)ARCH->writeSocket(m_socket, buffer, bufferSize);
+	// a single piece needs no gathering
+	size_t bytesWrote;
+	if (numPieces == 1) {
+		bytesWrote = ARCH->writeSocket(m_socket,
+							pieces[0].m_data, pieces[0].m_size);
+	}
+	else {
+		bytesWrote = ARCH->writeSocketBuffers(m_socket, pieces, numPieces);
+	}
 
 	if (bytesWrote > 0) {
-		discardWrittenData(bytesWrote);
+		discardWrittenData((int)bytesWrote);
+		return kNew;
+	}
+
+	return kRetry;
+}
+
+TCPSocket::EJobResult
+TCPSocket::doWriteFile()
+{
+	OutputSegment& segment = m_outputSegments.front();
+	size_t bytesWrote = ARCH->writeSocketFromFile(m_socket, segment.m_fd,
+							segment.m_offset, segment.m_size);
+
+	if (bytesWrote > 0) {
+		segment.m_offset += bytesWrote;
+		segment.m_size   -= (UInt32)bytesWrote;
+		if (segment.m_size == 0) {
+#if HAVE_SYS_SENDFILE_H
+			::close(segment.m_fd);
+#endif
+			m_outputSegments.pop_front();
+			discardWrittenData(0);
+		}
 		return kNew;
 	}
 
@@ -412,13 +584,13 @@ TCPSocket::newJob()
 								m_socket, m_readable, m_writable);
 	}
 	else {
-		if (!(m_readable || (m_writable && (m_outputBuffer.getSize() > 0)))) {
+		if (!(m_readable || (m_writable && hasOutput()))) {
 			return NULL;
 		}
 		return new TSocketMultiplexerMethodJob<TCPSocket>(
 								this, &TCPSocket::serviceConnected,
 								m_socket, m_readable,
-								m_writable && (m_outputBuffer.getSize() > 0));
+								m_writable && hasOutput());
 	}
 }
 
@@ -439,14 +611,68 @@ TCPSocket::sendEvent(Event::Type type)
 void
 TCPSocket::discardWrittenData(int bytesWrote)
 {
-	m_outputBuffer.pop(bytesWrote);
-	if (m_outputBuffer.getSize() == 0) {
+	// the data went out in order:  output buffer bytes up to each
+	// segment's position, then the segment
+	UInt32 n = (UInt32)bytesWrote;
+	while (n > 0) {
+		UInt32 ahead = m_outputBuffer.getSize();
+		if (!m_outputSegments.empty()) {
+			ahead = m_outputSegments.front().m_position;
+		}
+		if (ahead > 0) {
+			UInt32 count = (n < ahead) ? n : ahead;
+			m_outputBuffer.pop(count);
+			for (OutputSegmentList::iterator i = m_outputSegments.begin();
+								i != m_outputSegments.end(); ++i) {
+				i->m_position -= count;
+			}
+			n -= count;
+			continue;
+		}
+
+		// file data is written separately by doWriteFile()
+		OutputSegment& segment = m_outputSegments.front();
+		assert(segment.m_buffer != NULL);
+		UInt32 count = (n < segment.m_size) ? n : segment.m_size;
+		segment.m_offset += count;
+		segment.m_size   -= count;
+		n -= count;
+		if (segment.m_size == 0) {
+			segment.m_buffer->unref();
+			m_outputSegments.pop_front();
+		}
+	}
+
+	if (!hasOutput()) {
 		sendEvent(m_events->forIStream().outputFlushed());
 		m_flushed = true;
 		m_flushed.broadcast();
 	}
 }
 
+bool
+TCPSocket::hasOutput() const
+{
+	return (m_outputBuffer.getSize() > 0 || !m_outputSegments.empty());
+}
+
+void
+TCPSocket::clearOutputSegments()
+{
+	for (OutputSegmentList::iterator i = m_outputSegments.begin();
+								i != m_outputSegments.end(); ++i) {
+		if (i->m_buffer != NULL) {
+			i->m_buffer->unref();
+		}
+#if HAVE_SYS_SENDFILE_H
+		if (i->m_fd != -1) {
+			::close(i->m_fd);
+		}
+#endif
+	}
+	m_outputSegments.clear();
+}
+
 void
 TCPSocket::onConnected()
 {
@@ -466,6 +692,7 @@ void
 TCPSocket::onOutputShutdown()
 {
 	m_outputBuffer.pop(m_outputBuffer.getSize());
+	clearOutputSegments();
 	m_writable = false;
 
 	// we're now flushed
@@ -23,6 +23,7 @@
 #include "mt/CondVar.h"
 #include "mt/Mutex.h"
 #include "arch/IArchNetwork.h"
+#include "common/stddeque.h"
 
 class Mutex;
 class Thread;
@@ -37,7 +38,14 @@ A data socket using TCP.
 class TCPSocket : public IDataSocket {
 public:
 	TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer);
-	TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer, ArchSocket socket);
+	//! Adopt an accepted socket
+	/*!
+	The socket is serviced as a connected socket right away unless
+	\c service is false, for subclasses that set their own job once
+	they're constructed.  A job started here would call our doRead()
+	rather than theirs until then.
+	*/
+	TCPSocket(IEventQueue* events, SocketMultiplexer* socketMultiplexer, ArchSocket socket, bool service = true);
 	virtual ~TCPSocket();
 
 	// ISocket overrides
@@ -48,6 +56,9 @@ public:
 	// IStream overrides
 	virtual UInt32		read(void* buffer, UInt32 n);
 	virtual void		write(const void* buffer, UInt32 n);
+	virtual bool		writeFile(const void* header, UInt32 headerSize,
+							int fd, UInt64 offset, UInt32 n);
+	virtual void		writeShared(SharedBuffer* buffer);
 	virtual void		flush();
 	virtual void		shutdownInput();
 	virtual void		shutdownOutput();
@@ -83,9 +94,28 @@ protected:
 
 	void				sendEvent(Event::Type);
 	void				discardWrittenData(int bytesWrote);
+	bool				hasOutput() const;
 
 private:
+	// data queued by writeFile() or writeShared() rather than copied
+	// into the output buffer.  it's sent once the m_position bytes of
+	// the output buffer ahead of it have been written:  file data
+	// (m_fd != -1) straight from the file and shared data (m_buffer !=
+	// NULL) straight from the shared buffer, gathered with the output
+	// buffer around it.
+	struct OutputSegment {
+	public:
+		UInt32			m_position;
+		int				m_fd;
+		SharedBuffer*	m_buffer;
+		UInt64			m_offset;
+		UInt32			m_size;
+	};
+	typedef std::deque<OutputSegment> OutputSegmentList;
+
 	void				init();
+	EJobResult			doWriteFile();
+	void				clearOutputSegments();
 
 	void				sendConnectionFailedEvent(const char*);
 	void				onConnected();
@@ -109,6 +139,7 @@ protected:
 	StreamBuffer		m_outputBuffer;
 	
 private:
+	OutputSegmentList	m_outputSegments;
 	Mutex				m_mutex;
 	ArchSocket			m_socket;
 	CondVar<bool>		m_flushed;
@@ -18,6 +18,8 @@
 
 #include "platform/MSWindowsClipboardAnyTextConverter.h"
 
+#include "base/String.h"
+
 //
 // MSWindowsClipboardAnyTextConverter
 //
@@ -88,62 +90,12 @@ MSWindowsClipboardAnyTextConverter::convertLinefeedToWin32(
 				const String& src) const
 {
 	// note -- we assume src is a valid UTF-8 string
-
-	// count newlines in string
-	UInt32 numNewlines = 0;
-	UInt32 n = (UInt32)src.size();
-	for (const char* scan = src.c_str(); n > 0; ++scan, --n) {
-		if (*scan == '\n') {
-			++numNewlines;
-		}
-	}
-	if (numNewlines == 0) {
-		return src;
-	}
-
-	// allocate new string
-	String dst;
-	dst.reserve(src.size() + numNewlines);
-
-	// copy string, converting newlines
-	n = (UInt32)src.size();
-	for (const char* scan = src.c_str(); n > 0; ++scan, --n) {
-		if (scan[0] == '\n') {
-			dst += '\r';
-		}
-		dst += scan[0];
-	}
-
-	return dst;
+	return synergy::string::linefeedToCRLF(src);
 }
 
 String
 MSWindowsClipboardAnyTextConverter::convertLinefeedToUnix(
 				const String& src) const
 {
-	// count newlines in string
-	UInt32 numNewlines = 0;
-	UInt32 n = (UInt32)src.size();
-	for (const char* scan = src.c_str(); n > 0; ++scan, --n) {
-		if (scan[0] == '\r' && scan[1] == '\n') {
-			++numNewlines;
-		}
-	}
-	if (numNewlines == 0) {
-		return src;
-	}
-
-	// allocate new string
-	String dst;
-	dst.reserve(src.size());
-
-	// copy string, converting newlines
-	n = (UInt32)src.size();
-	for (const char* scan = src.c_str(); n > 0; ++scan, --n) {
-		if (scan[0] != '\r' || scan[1] != '\n') {
-			dst += scan[0];
-		}
-	}
-
-	return dst;
+	return synergy::string::crlfToLinefeed(src);
 }
@@ -138,7 +138,9 @@ MSWindowsClipboardBitmapConverter::toIClipboard(HANDLE data) const
 	GdiFlush();
 
 	// extract data
-	String image((const char*)&info, info.biSize);
+	String image;
+	image.reserve(info.biSize + 4 * w * h);
+	image.append((const char*)&info, info.biSize);
 	image.append((const char*)raw, 4 * w * h);
 
 	// clean up GDI
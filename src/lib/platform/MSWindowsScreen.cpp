@@ -146,6 +146,7 @@ MSWindowsScreen::MSWindowsScreen(
 
 		updateScreenShape();
 		m_class       = createWindowClass();
+		updateMonitors();
 		m_window      = createWindow(m_class, "Synergy");
 		forceShowCursor();
 		LOG((CLOG_DEBUG "screen shape: %d,%d %dx%d %s", m_x, m_y, m_w, m_h, m_multimon ? "(multi-monitor)" : ""));
@@ -1466,6 +1467,7 @@ MSWindowsScreen::onDisplayChange()
 
 	// update shape
 	updateScreenShape();
+	updateMonitors();
 
 	// do nothing if resolution hasn't changed
 	if (xOld != m_x || yOld != m_y || wOld != m_w || hOld != m_h) {
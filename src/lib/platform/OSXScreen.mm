@@ -1542,6 +1542,7 @@ OSXScreen::updateScreenShape()
 	m_y = (SInt32)totalBounds.origin.y;
 	m_w = (SInt32)totalBounds.size.width;
 	m_h = (SInt32)totalBounds.size.height;
+	updateMonitors();
 
 	// get center of default screen
   CGDirectDisplayID main = CGMainDisplayID();
@@ -47,7 +47,8 @@ XWindowsClipboard::XWindowsClipboard(Display* display,
 	m_time(0),
 	m_owner(false),
 	m_timeOwned(0),
-	m_timeLost(0)
+	m_timeLost(0),
+	m_requested(0)
 {
 	// get some atoms
 	m_atomTargets         = XInternAtom(m_display, "TARGETS", False);
@@ -94,6 +95,9 @@ XWindowsClipboard::XWindowsClipboard(Display* display,
 								"STRING"));
 
 	// we have no data
+	for (SInt32 index = 0; index < kNumFormats; ++index) {
+		m_promised[index] = false;
+	}
 	clearCache();
 }
 
@@ -188,6 +192,16 @@ XWindowsClipboard::addSimpleRequest(Window requestor,
 					// ignore -- cannot convert
 				}
 			}
+			else if (m_promised[clipboardFormat]) {
+				// answer when the data is given
+				LOG((CLOG_DEBUG1 "waiting for promised format %d", clipboardFormat));
+				Reply* reply = new Reply(requestor, target, time,
+								property, String(), None, 32);
+				reply->m_waiting = true;
+				insertReply(reply);
+				m_requested |= (1u << clipboardFormat);
+				return true;
+			}
 		}
 	}
 
@@ -253,6 +267,49 @@ XWindowsClipboard::destroyRequest(Window requestor)
 	return true;
 }
 
+void
+XWindowsClipboard::promise(UInt32 formats)
+{
+	assert(m_owner);
+
+	for (SInt32 index = 0; index < kNumFormats; ++index) {
+		if ((formats & (1u << index)) != 0 && !m_added[index]) {
+			LOG((CLOG_DEBUG "promise clipboard %d format: %d", m_id, index));
+			m_promised[index] = true;
+		}
+	}
+}
+
+void
+XWindowsClipboard::fulfill(EFormat format, const String* data)
+{
+	// ignore if the promise has ended
+	if (!m_promised[format]) {
+		return;
+	}
+	m_promised[format] = false;
+
+	if (data != NULL) {
+		LOG((CLOG_DEBUG "fulfill clipboard %d format: %d with %d bytes", m_id, format, data->size()));
+		m_data[format]  = *data;
+		m_added[format] = true;
+	}
+	else {
+		LOG((CLOG_DEBUG "clipboard %d format %d is not available", m_id, format));
+	}
+
+	answerWaitingReplies(format);
+	pushReplies();
+}
+
+UInt32
+XWindowsClipboard::takeRequestedFormats()
+{
+	UInt32 requested = m_requested;
+	m_requested = 0;
+	return requested;
+}
+
 Window
 XWindowsClipboard::getWindow() const
 {
@@ -456,6 +513,43 @@ XWindowsClipboard::checkCache() const
 	}
 }
 
+void
+XWindowsClipboard::answerWaitingReplies(EFormat format)
+{
+	for (ReplyMap::iterator index = m_replies.begin();
+								index != m_replies.end(); ++index) {
+		ReplyList& replies = index->second;
+		for (ReplyList::iterator index2 = replies.begin();
+								index2 != replies.end(); ++index2) {
+			Reply* reply = *index2;
+			if (!reply->m_waiting) {
+				continue;
+			}
+			IXWindowsClipboardConverter* converter =
+								getConverter(reply->m_target);
+			if (converter == NULL || converter->getFormat() != format) {
+				continue;
+			}
+
+			reply->m_waiting = false;
+			if (m_added[format]) {
+				try {
+					reply->m_data   = converter->fromIClipboard(m_data[format]);
+					reply->m_format = converter->getDataSize();
+					reply->m_type   = converter->getAtom();
+					continue;
+				}
+				catch (...) {
+					// ignore -- cannot convert
+				}
+			}
+
+			// send failure
+			reply->m_property = None;
+		}
+	}
+}
+
 void
 XWindowsClipboard::clearCache() const
 {
@@ -471,6 +565,20 @@ XWindowsClipboard::doClearCache()
 		m_data[index]  = "";
 		m_added[index] = false;
 	}
+
+	// the promised data will never come
+	m_requested = 0;
+	bool promised = false;
+	for (SInt32 index = 0; index < kNumFormats; ++index) {
+		if (m_promised[index]) {
+			m_promised[index] = false;
+			answerWaitingReplies(static_cast<EFormat>(index));
+			promised = true;
+		}
+	}
+	if (promised) {
+		pushReplies();
+	}
 }
 
 void
@@ -949,7 +1057,8 @@ XWindowsClipboard::pushReplies()
 				break;
 			++listit;
 		}
-		if (listit != index->second.end() && !(*listit)->m_replied) {
+		if (listit != index->second.end() && !(*listit)->m_replied &&
+			!(*listit)->m_waiting) {
 			pushReplies(index, index->second, listit);
 		}
 		else {
@@ -962,8 +1071,9 @@ void
 XWindowsClipboard::pushReplies(ReplyMap::iterator& mapIndex,
 				ReplyList& replies, ReplyList::iterator index)
 {
+	// replies waiting for promised data hold up the ones after them
 	Reply* reply = *index;
-	while (sendReply(reply)) {
+	while (!reply->m_waiting && sendReply(reply)) {
 		// reply is complete.  discard it and send the next reply,
 		// if any.
 		index = replies.erase(index);
@@ -1231,7 +1341,8 @@ XWindowsClipboard::getTargetsData(String& data, int* format) const
 		IXWindowsClipboardConverter* converter = *index;
 
 		// skip formats we don't have
-		if (m_added[converter->getFormat()]) {
+		if (m_added[converter->getFormat()] ||
+			m_promised[converter->getFormat()]) {
 			XWindowsUtil::appendAtomData(data, converter->getAtom());
 		}
 	}
@@ -1500,6 +1611,7 @@ XWindowsClipboard::Reply::Reply(Window requestor, Atom target, ::Time time) :
 	m_property(None),
 	m_replied(false),
 	m_done(false),
+	m_waiting(false),
 	m_data(),
 	m_type(None),
 	m_format(32),
@@ -1516,6 +1628,7 @@ XWindowsClipboard::Reply::Reply(Window requestor, Atom target, ::Time time,
 	m_property(property),
 	m_replied(false),
 	m_done(false),
+	m_waiting(false),
 	m_data(data),
 	m_type(type),
 	m_format(format),
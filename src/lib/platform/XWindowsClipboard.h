@@ -73,6 +73,30 @@ public:
 	*/
 	bool				destroyRequest(Window requestor);
 
+	//! Promise formats
+	/*!
+	Claims to have the formats in \c formats, a bitmask of
+	<tt>1 << format</tt>, without their data.  Requests for a promised
+	format wait until it's given with fulfill().  The clipboard must
+	be owned;  the promise ends when it's emptied or lost.
+	*/
+	void				promise(UInt32 formats);
+
+	//! Fulfill promised format
+	/*!
+	Gives the \c data of promised \c format and answers the requests
+	waiting for it.  If \c data is NULL the format is no longer
+	promised and the waiting requests fail.
+	*/
+	void				fulfill(EFormat format, const String* data);
+
+	//! Take requested formats
+	/*!
+	Returns the promised formats that have been requested since the
+	last call, as a bitmask of <tt>1 << format</tt>.
+	*/
+	UInt32				takeRequestedFormats();
+
 	//! Get window
 	/*!
 	Returns the clipboard's window (passed the c'tor).
@@ -122,8 +146,12 @@ private:
 	// clear it.  this has the side effect of updating m_timeOwned.
 	void				checkCache() const;
 
+	// answer the replies waiting for the data of a promised format.
+	// they fail if the format hasn't been added.
+	void				answerWaitingReplies(EFormat);
+
 	// clear the cache, resetting the cached flag and the added flag for
-	// each format.
+	// each format and failing the requests for promised formats.
 	void				clearCache() const;
 	void				doClearCache();
 
@@ -238,6 +266,10 @@ private:
 		// true iff the reply has sent its last message
 		bool			m_done;
 
+		// true iff the reply is for a promised format whose data
+		// hasn't been given yet
+		bool			m_waiting;
+
 		// the data to send and its type and format
 		String			m_data;
 		Atom			m_type;
@@ -305,6 +337,10 @@ private:
 	bool				m_added[kNumFormats];
 	String				m_data[kNumFormats];
 
+	// the promised formats and those requested but not yet reported
+	bool				m_promised[kNumFormats];
+	UInt32				m_requested;
+
 	// conversion request replies
 	ReplyMap			m_replies;
 	ReplyEventMask		m_eventMasks;
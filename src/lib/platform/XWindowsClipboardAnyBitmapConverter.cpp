@@ -125,6 +125,11 @@ XWindowsClipboardAnyBitmapConverter::getDataSize() const
 String
 XWindowsClipboardAnyBitmapConverter::fromIClipboard(const String& bmp) const
 {
+	// make sure data is big enough for the info header
+	if (bmp.size() < 40) {
+		return String();
+	}
+
 	// fill BMP info header with native-endian data
 	CBMPInfoHeader infoHeader;
 	const UInt8* rawBMPInfoHeader = reinterpret_cast<const UInt8*>(bmp.data());
@@ -186,6 +191,9 @@ XWindowsClipboardAnyBitmapConverter::toIClipboard(const String& image) const
 	toLE(dst, static_cast<UInt32>(0));
 
 	// construct image
-	return String(reinterpret_cast<const char*>(infoHeader),
-							sizeof(infoHeader)) + rawBMP;
+	String bmp;
+	bmp.reserve(sizeof(infoHeader) + rawBMP.size());
+	bmp.append(reinterpret_cast<const char*>(infoHeader), sizeof(infoHeader));
+	bmp.append(rawBMP);
+	return bmp;
 }
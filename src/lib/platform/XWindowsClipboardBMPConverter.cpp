@@ -113,7 +113,12 @@ XWindowsClipboardBMPConverter::fromIClipboard(const String& bmp) const
 	toLE(dst, static_cast<UInt16>(0));
 	toLE(dst, static_cast<UInt16>(0));
 	toLE(dst, static_cast<UInt32>(14 + 40));
-	return String(reinterpret_cast<const char*>(header), 14) + bmp;
+
+	String image;
+	image.reserve(14 + bmp.size());
+	image.append(reinterpret_cast<const char*>(header), 14);
+	image.append(bmp);
+	return image;
 }
 
 String
@@ -137,7 +142,14 @@ XWindowsClipboardBMPConverter::toIClipboard(const String& bmp) const
 	if (offset == 14 + 40) {
 		return bmp.substr(14);
 	}
+	else if (offset < 14 + 40 || offset > bmp.size()) {
+		return String();
+	}
 	else {
-		return bmp.substr(14, 40) + bmp.substr(offset, bmp.size() - offset);
+		String image;
+		image.reserve(40 + bmp.size() - offset);
+		image.append(bmp, 14, 40);
+		image.append(bmp, offset, String::npos);
+		return image;
 	}
 }
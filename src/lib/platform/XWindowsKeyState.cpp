@@ -19,11 +19,13 @@
 #include "platform/XWindowsKeyState.h"
 
 #include "platform/XWindowsUtil.h"
+#include "synergy/LatencyTrace.h"
 #include "base/Log.h"
 #include "base/String.h"
 #include "common/stdmap.h"
 
 #include <cstddef>
+#include <cstring>
 #include <algorithm>
 #if X_DISPLAY_MISSING
 #	error X11 is required to build synergy
@@ -40,6 +42,31 @@
 
 static const size_t ModifiersFromXDefaultSize = 32;
 
+// the parts of the XKB keyboard description we use
+#if HAVE_XKB_EXTENSION
+static const unsigned int kXKBMapParts =
+	XkbKeyActionsMask | XkbKeyBehaviorsMask | XkbAllClientInfoMask;
+#endif
+
+// FNV-1a hash of size bytes at data, continuing from hash
+static UInt64
+hashBytes(UInt64 hash, const void* data, size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+template <class T>
+static UInt64
+hashValue(UInt64 hash, T value)
+{
+	return hashBytes(hash, &value, sizeof(value));
+}
+
 XWindowsKeyState::XWindowsKeyState(
 		Display* display, bool useXKB,
 		IEventQueue* events) :
@@ -75,12 +102,13 @@ XWindowsKeyState::init(Display* display, bool useXKB)
 	XGetKeyboardControl(m_display, &m_keyboardState);
 #if HAVE_XKB_EXTENSION
 	if (useXKB) {
-		m_xkb = XkbGetMap(m_display, XkbKeyActionsMask | XkbKeyBehaviorsMask |
-								XkbAllClientInfoMask, XkbUseCoreKbd);
+		m_xkb = XkbGetMap(m_display, kXKBMapParts, XkbUseCoreKbd);
 	}
 	else {
 		m_xkb = NULL;
 	}
+	memset(&m_xkbChanges, 0, sizeof(m_xkbChanges));
+	m_xkbValid = false;
 #endif
 	setActiveGroup(kGroupPollAndSet);
 }
@@ -109,6 +137,18 @@ XWindowsKeyState::setAutoRepeat(const XKeyboardState& state)
 	m_keyboardState = state;
 }
 
+#if HAVE_XKB_EXTENSION
+void
+XWindowsKeyState::noteMapChanges(const XkbMapNotifyEvent* event)
+{
+	if (m_xkb != NULL) {
+		XkbNoteMapChanges(&m_xkbChanges,
+							const_cast<XkbMapNotifyEvent*>(event),
+							kXKBMapParts);
+	}
+}
+#endif
+
 KeyModifierMask
 XWindowsKeyState::mapModifiersFromX(unsigned int state) const
 {
@@ -219,6 +259,19 @@ XWindowsKeyState::pollPressedKeys(KeyButtonSet& pressedKeys) const
 
 void
 XWindowsKeyState::getKeyMap(synergy::KeyMap& keyMap)
+{
+	// getKeyMapSignature() has already refreshed the keyboard description
+#if HAVE_XKB_EXTENSION
+	if (m_xkb != NULL && m_xkbValid) {
+		updateKeysymMapXKB(keyMap);
+		return;
+	}
+#endif
+	updateKeysymMap(keyMap);
+}
+
+UInt64
+XWindowsKeyState::getKeyMapSignature()
 {
 	// get autorepeat info.  we must use the global_auto_repeat told to
 	// us because it may have modified by synergy.
@@ -228,14 +281,50 @@ XWindowsKeyState::getKeyMap(synergy::KeyMap& keyMap)
 
 #if HAVE_XKB_EXTENSION
 	if (m_xkb != NULL) {
-		if (XkbGetUpdatedMap(m_display, XkbKeyActionsMask |
-				XkbKeyBehaviorsMask | XkbAllClientInfoMask, m_xkb) == Success) {
-			updateKeysymMapXKB(keyMap);
-			return;
+		m_xkbValid = updateXKBMap();
+
+		// without modifiers the key map depends on the last known good
+		// modifiers (see updateKeysymMapXKB()) so it can't be cached
+		if (m_xkbValid && hasModifiersXKB()) {
+			return getXKBMapSignature();
 		}
 	}
 #endif
-	updateKeysymMap(keyMap);
+
+	// the core keyboard mapping is always rebuilt
+	return 0;
+}
+
+void
+XWindowsKeyState::stashKeyMapState(UInt64 signature)
+{
+	KeyMapState& state = m_keyMapStates[signature];
+	state.m_modifierFromX.swap(m_modifierFromX);
+	state.m_modifierToX.swap(m_modifierToX);
+	state.m_keyCodeFromKey.swap(m_keyCodeFromKey);
+
+	// copy rather than swap since the next key map may need these
+	state.m_lastGoodXKBModifiers = m_lastGoodXKBModifiers;
+}
+
+void
+XWindowsKeyState::restoreKeyMapState(UInt64 signature)
+{
+	KeyMapStateCache::iterator i = m_keyMapStates.find(signature);
+	assert(i != m_keyMapStates.end());
+
+	KeyMapState& state = i->second;
+	m_modifierFromX.swap(state.m_modifierFromX);
+	m_modifierToX.swap(state.m_modifierToX);
+	m_keyCodeFromKey.swap(state.m_keyCodeFromKey);
+	m_lastGoodXKBModifiers.swap(state.m_lastGoodXKBModifiers);
+	m_keyMapStates.erase(i);
+}
+
+void
+XWindowsKeyState::discardKeyMapState(UInt64 signature)
+{
+	m_keyMapStates.erase(signature);
 }
 
 void
@@ -257,6 +346,7 @@ XWindowsKeyState::fakeKey(const Keystroke& keystroke)
 		XTestFakeKeyEvent(m_display, keystroke.m_data.m_button.m_button,
 							keystroke.m_data.m_button.m_press ? True : False,
 							CurrentTime);
+		LatencyTrace::injected();
 		break;
 
 	case Keystroke::kGroup:
@@ -824,6 +914,75 @@ XWindowsKeyState::hasModifiersXKB() const
 	return false;
 }
 
+bool
+XWindowsKeyState::updateXKBMap()
+{
+#if HAVE_XKB_EXTENSION
+	// fetch just the parts that changed if we know what they are
+	if (m_xkbChanges.changed != 0) {
+		Status status = XkbGetMapChanges(m_display, m_xkb, &m_xkbChanges);
+		memset(&m_xkbChanges, 0, sizeof(m_xkbChanges));
+		if (status == Success) {
+			return true;
+		}
+		LOG((CLOG_DEBUG1 "failed to get XKB map changes, getting whole map"));
+	}
+	return (XkbGetUpdatedMap(m_display, kXKBMapParts, m_xkb) == Success);
+#else
+	return false;
+#endif
+}
+
+UInt64
+XWindowsKeyState::getXKBMapSignature() const
+{
+	// hash everything in the keyboard description that updateKeysymMapXKB()
+	// reads.  fields are hashed one at a time to skip structure padding.
+	UInt64 hash = 14695981039346656037ULL;
+#if HAVE_XKB_EXTENSION
+	XkbClientMapPtr map = m_xkb->map;
+	hash = hashValue(hash, m_xkb->min_key_code);
+	hash = hashValue(hash, m_xkb->max_key_code);
+
+	// key types
+	for (int i = 0; i < map->num_types; ++i) {
+		const XkbKeyTypeRec& type = map->types[i];
+		hash = hashValue(hash, type.mods.mask);
+		hash = hashValue(hash, type.num_levels);
+		hash = hashValue(hash, type.map_count);
+		for (int j = 0; j < type.map_count; ++j) {
+			hash = hashValue(hash, type.map[j].active);
+			hash = hashValue(hash, type.map[j].level);
+			hash = hashValue(hash, type.map[j].mods.mask);
+			if (type.preserve != NULL) {
+				hash = hashValue(hash, type.preserve[j].mask);
+			}
+		}
+	}
+
+	// per key symbols, types, modifiers, behaviors and actions
+	for (int i = m_xkb->min_key_code; i <= m_xkb->max_key_code; ++i) {
+		KeyCode keycode = static_cast<KeyCode>(i);
+		const XkbSymMapRec& symMap = map->key_sym_map[keycode];
+		hash = hashBytes(hash, symMap.kt_index, sizeof(symMap.kt_index));
+		hash = hashValue(hash, symMap.group_info);
+		hash = hashValue(hash, symMap.width);
+		hash = hashBytes(hash, XkbKeySymsPtr(m_xkb, keycode),
+							XkbKeyNumSyms(m_xkb, keycode) * sizeof(KeySym));
+		hash = hashValue(hash, map->modmap[keycode]);
+		hash = hashValue(hash, m_xkb->server->behaviors[keycode].type);
+		if (XkbKeyHasActions(m_xkb, keycode) == True) {
+			hash = hashBytes(hash, XkbKeyActionsPtr(m_xkb, keycode),
+							XkbKeyNumActions(m_xkb, keycode) *
+								sizeof(XkbAction));
+		}
+	}
+#endif
+
+	// 0 means no signature
+	return (hash == 0) ? 1 : hash;
+}
+
 int
 XWindowsKeyState::getEffectiveGroup(KeyCode keycode, int group) const
 {
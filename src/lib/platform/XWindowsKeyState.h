@@ -33,6 +33,7 @@
 #	endif
 #	if HAVE_XKB_EXTENSION
 #		include <X11/extensions/XKBstr.h>
+#		include <X11/XKBlib.h>
 #	endif
 #endif
 
@@ -74,6 +75,16 @@ public:
 	*/
 	void				setAutoRepeat(const XKeyboardState&);
 
+#if HAVE_XKB_EXTENSION
+	//! Note keyboard mapping changes
+	/*!
+	Accumulates the changes described by an XKB map notify event.  The
+	next key map update fetches only the changed parts of the keyboard
+	description from the server instead of all of it.
+	*/
+	void				noteMapChanges(const XkbMapNotifyEvent*);
+#endif
+
 	//@}
 	//! @name accessors
 	//@{
@@ -113,6 +124,10 @@ public:
 protected:
 	// KeyState overrides
 	virtual void		getKeyMap(synergy::KeyMap& keyMap);
+	virtual UInt64		getKeyMapSignature();
+	virtual void		stashKeyMapState(UInt64 signature);
+	virtual void		restoreKeyMapState(UInt64 signature);
+	virtual void		discardKeyMapState(UInt64 signature);
 	virtual void		fakeKey(const Keystroke& keystroke);
 
 private:
@@ -120,6 +135,8 @@ private:
 	void				updateKeysymMap(synergy::KeyMap&);
 	void				updateKeysymMapXKB(synergy::KeyMap&);
 	bool				hasModifiersXKB() const;
+	bool				updateXKBMap();
+	UInt64				getXKBMapSignature() const;
 	int					getEffectiveGroup(KeyCode, int group) const;
 	UInt32				getGroupFromState(unsigned int state) const;
 
@@ -145,9 +162,25 @@ private:
 	typedef std::map<KeyCode, unsigned int> NonXKBModifierMap;
 	typedef std::map<UInt32, XKBModifierInfo> XKBModifierMap;
 
+	// the state getKeyMap() derives for a layout, kept for cached layouts
+	struct KeyMapState {
+	public:
+		KeyModifierMaskList	m_modifierFromX;
+		KeyModifierToXMask	m_modifierToX;
+		KeyToKeyCodeMap		m_keyCodeFromKey;
+		XKBModifierMap		m_lastGoodXKBModifiers;
+	};
+	typedef std::map<UInt64, KeyMapState> KeyMapStateCache;
+
 	Display*			m_display;
 #if HAVE_XKB_EXTENSION
 	XkbDescPtr			m_xkb;
+
+	// changes to m_xkb not yet fetched from the server
+	XkbMapChangesRec	m_xkbChanges;
+
+	// true if m_xkb was brought up to date by the last key map update
+	bool				m_xkbValid;
 #endif
 	SInt32				m_group;
 	XKBModifierMap		m_lastGoodXKBModifiers;
@@ -165,6 +198,9 @@ private:
 	// autorepeat state
 	XKeyboardState		m_keyboardState;
 
+	// derived state for layouts in the key map cache
+	KeyMapStateCache	m_keyMapStates;
+
 #ifdef TEST_ENV
 public:
 	SInt32                  group() const { return m_group; }
@@ -25,6 +25,7 @@
 #include "platform/XWindowsUtil.h"
 #include "synergy/Clipboard.h"
 #include "synergy/KeyMap.h"
+#include "synergy/LatencyTrace.h"
 #include "synergy/XScreen.h"
 #include "arch/XArch.h"
 #include "arch/Arch.h"
@@ -122,6 +123,7 @@ XWindowsScreen::XWindowsScreen(
 	m_xkb(false),
 	m_xi2detected(false),
 	m_xrandr(false),
+	m_xrandrMonitors(false),
 	m_events(events),
 	PlatformScreen(events)
 {
@@ -408,6 +410,27 @@ XWindowsScreen::setClipboard(ClipboardID id, const IClipboard* clipboard)
 	}
 }
 
+bool
+XWindowsScreen::promiseClipboard(ClipboardID id,
+				const IClipboard* clipboard, UInt32 promised)
+{
+	// requests for the promised formats wait for the data
+	if (!setClipboard(id, clipboard)) {
+		return false;
+	}
+	m_clipboard[id]->promise(promised);
+	return true;
+}
+
+void
+XWindowsScreen::fulfillClipboard(ClipboardID id,
+				IClipboard::EFormat format, const String* data)
+{
+	if (m_clipboard[id] != NULL) {
+		m_clipboard[id]->fulfill(format, data);
+	}
+}
+
 void
 XWindowsScreen::checkClipboards()
 {
@@ -509,6 +532,12 @@ XWindowsScreen::getShape(SInt32& x, SInt32& y, SInt32& w, SInt32& h) const
 	h = m_h;
 }
 
+const IScreen::MonitorList&
+XWindowsScreen::getMonitors() const
+{
+	return m_monitors;
+}
+
 void
 XWindowsScreen::getCursorPos(SInt32& x, SInt32& y) const
 {
@@ -843,6 +872,7 @@ XWindowsScreen::fakeMouseMove(SInt32 x, SInt32 y)
 							x, y, CurrentTime);
 	}
 	XFlush(m_display);
+	LatencyTrace::injected();
 }
 
 void
@@ -856,6 +886,7 @@ XWindowsScreen::fakeMouseRelativeMove(SInt32 dx, SInt32 dy) const
 		XTestFakeRelativeMotionEvent(m_display, dx, dy, CurrentTime);
 	}
 	XFlush(m_display);
+	LatencyTrace::injected();
 }
 
 void
@@ -955,6 +986,14 @@ XWindowsScreen::openDisplay(const char* displayName)
 	if (m_xrandr) {
 		// enable XRRScreenChangeNotifyEvent
 		XRRSelectInput(display, DefaultRootWindow(display), RRScreenChangeNotifyMask | RRCrtcChangeNotifyMask);
+
+#if RANDR_MAJOR > 1 || RANDR_MINOR >= 5
+		// monitors are new in XRandR 1.5
+		int major, minor;
+		if (XRRQueryVersion(display, &major, &minor)) {
+			m_xrandrMonitors = (major > 1 || (major == 1 && minor >= 5));
+		}
+#endif
 	}
 #endif
 
@@ -991,6 +1030,25 @@ XWindowsScreen::saveShape()
 	m_xCenter = m_x + (m_w >> 1);
 	m_yCenter = m_y + (m_h >> 1);
 
+	// get the monitors.  XRandR 1.5 monitors are preferred since they
+	// can also describe a monitor split across outputs or an output
+	// split into monitors.  otherwise use the Xinerama screens below.
+	m_monitors.clear();
+#if HAVE_X11_EXTENSIONS_XRANDR_H && (RANDR_MAJOR > 1 || RANDR_MINOR >= 5)
+	if (m_xrandrMonitors) {
+		int numMonitors;
+		XRRMonitorInfo* monitors = XRRGetMonitors(m_display,
+							DefaultRootWindow(m_display), True, &numMonitors);
+		if (monitors != NULL) {
+			for (int i = 0; i < numMonitors; ++i) {
+				addMonitor(monitors[i].x, monitors[i].y,
+							monitors[i].width, monitors[i].height);
+			}
+			XRRFreeMonitors(monitors);
+		}
+	}
+#endif
+
 	// check if xinerama is enabled and there is more than one screen.
 	// get center of first Xinerama screen.  Xinerama appears to have
 	// a bug when XWarpPointer() is used in combination with
@@ -1018,10 +1076,34 @@ XWindowsScreen::saveShape()
 				m_xCenter  = screens[0].x_org + (screens[0].width  >> 1);
 				m_yCenter  = screens[0].y_org + (screens[0].height >> 1);
 			}
+			if (m_monitors.empty()) {
+				for (int i = 0; i < numScreens; ++i) {
+					addMonitor(screens[i].x_org, screens[i].y_org,
+								screens[i].width, screens[i].height);
+				}
+			}
 			XFree(screens);
 		}
 	}
 #endif
+
+	// one monitor covering the screen if we couldn't find any
+	if (m_monitors.empty()) {
+		addMonitor(m_x, m_y, m_w, m_h);
+	}
+
+	LOG((CLOG_DEBUG1 "screen has %d monitor(s)", (int)m_monitors.size()));
+}
+
+void
+XWindowsScreen::addMonitor(SInt32 x, SInt32 y, SInt32 w, SInt32 h)
+{
+	MonitorInfo monitor;
+	monitor.m_x = x;
+	monitor.m_y = y;
+	monitor.m_w = w;
+	monitor.m_h = h;
+	m_monitors.push_back(monitor);
 }
 
 Window
@@ -1176,6 +1258,9 @@ XWindowsScreen::handleSystemEvent(const Event& event, void*)
 	XEvent* xevent = static_cast<XEvent*>(event.getData());
 	assert(xevent != NULL);
 
+	// input events posted while handling this one were captured now
+	LatencyTrace::CaptureScope captureScope;
+
 	// update key state
 	bool isRepeat = false;
 	if (m_isPrimary) {
@@ -1349,6 +1434,17 @@ XWindowsScreen::handleSystemEvent(const Event& event, void*)
 								xevent->xselectionrequest.target,
 								xevent->xselectionrequest.time,
 								xevent->xselectionrequest.property);
+
+				// ask for the data of promised formats
+				UInt32 requested = m_clipboard[id]->takeRequestedFormats();
+				if (requested != 0) {
+					ClipboardFormatInfo* info =
+						(ClipboardFormatInfo*)malloc(sizeof(ClipboardFormatInfo));
+					info->m_id      = id;
+					info->m_formats = requested;
+					sendEvent(m_events->forClipboard().clipboardFormatsRequested(),
+								info);
+				}
 				return;
 			}
 		}
@@ -2047,29 +2143,48 @@ XWindowsScreen::grabMouseAndKeyboard()
 void
 XWindowsScreen::refreshKeyboard(XEvent* event)
 {
+	// keyboard mapping changed.  note what changed for every event, even
+	// ones we discard below, so a burst of changes can be applied at once.
+#if HAVE_XKB_EXTENSION
+	if (m_xkb && event->type == m_xkbEventBase) {
+		XkbMapNotifyEvent* mapEvent =
+			reinterpret_cast<XkbMapNotifyEvent*>(event);
+		XkbRefreshKeyboardMapping(mapEvent);
+		m_keyState->noteMapChanges(mapEvent);
+	}
+	else
+#endif
+	{
+		XRefreshKeyboardMapping(&event->xmapping);
+	}
+
 	if (XPending(m_display) > 0) {
 		XEvent tmpEvent;
 		XPeekEvent(m_display, &tmpEvent);
-		if (tmpEvent.type == MappingNotify) {
+		if (isKeyboardMappingEvent(&tmpEvent)) {
 			// discard this event since another follows.
 			// we tend to get a bunch of these in a row.
 			return;
 		}
 	}
 
-	// keyboard mapping changed
+	m_keyState->updateKeyMap();
+	m_keyState->updateKeyState();
+}
+
+bool
+XWindowsScreen::isKeyboardMappingEvent(XEvent* event) const
+{
+	if (event->type == MappingNotify) {
+		return true;
+	}
 #if HAVE_XKB_EXTENSION
 	if (m_xkb && event->type == m_xkbEventBase) {
-		XkbRefreshKeyboardMapping((XkbMapNotifyEvent*)event);
-	}
-	else
-#else
-	{
-		XRefreshKeyboardMapping(&event->xmapping);
+		XkbEvent* xkbEvent = reinterpret_cast<XkbEvent*>(event);
+		return (xkbEvent->any.xkb_type == XkbMapNotify);
 	}
 #endif
-	m_keyState->updateKeyMap();
-	m_keyState->updateKeyState();
+	return false;
 }
 
 
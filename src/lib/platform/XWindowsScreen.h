@@ -52,6 +52,8 @@ public:
 	virtual void		getShape(SInt32& x, SInt32& y,
 							SInt32& width, SInt32& height) const;
 	virtual void		getCursorPos(SInt32& x, SInt32& y) const;
+	virtual const MonitorList&
+						getMonitors() const;
 
 	// IPrimaryScreen overrides
 	virtual void		reconfigure(UInt32 activeSides);
@@ -76,6 +78,10 @@ public:
 	virtual void		enter();
 	virtual bool		leave();
 	virtual bool		setClipboard(ClipboardID, const IClipboard*);
+	virtual bool		promiseClipboard(ClipboardID,
+							const IClipboard*, UInt32 promised);
+	virtual void		fulfillClipboard(ClipboardID,
+							IClipboard::EFormat, const String* data);
 	virtual void		checkClipboards();
 	virtual void		openScreensaver(bool notify);
 	virtual void		closeScreensaver();
@@ -125,6 +131,7 @@ private:
 
 	Display*			openDisplay(const char* displayName);
 	void				saveShape();
+	void				addMonitor(SInt32 x, SInt32 y, SInt32 w, SInt32 h);
 	Window				openWindow() const;
 	void				openIM();
 
@@ -154,6 +161,7 @@ private:
 	void				warpCursorNoFlush(SInt32 x, SInt32 y);
 
 	void				refreshKeyboard(XEvent*);
+	bool				isKeyboardMappingEvent(XEvent*) const;
 
 	static Bool			findKeyEvent(Display*, XEvent* xevent, XPointer arg);
 
@@ -196,6 +204,7 @@ private:
 	SInt32				m_x, m_y;
 	SInt32				m_w, m_h;
 	SInt32				m_xCenter, m_yCenter;
+	MonitorList			m_monitors;
 
 	// last mouse position
 	SInt32				m_xCursor, m_yCursor;
@@ -253,6 +262,7 @@ private:
 	// XRandR extension stuff
 	bool                m_xrandr;
 	int                 m_xrandrEventBase;
+	bool				m_xrandrMonitors;
 
 	IEventQueue*		m_events;
 	synergy::KeyMap				m_keyMap;
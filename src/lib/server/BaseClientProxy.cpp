@@ -35,6 +35,20 @@ BaseClientProxy::~BaseClientProxy()
 	// do nothing
 }
 
+void
+BaseClientProxy::broadcastKeyDown(KeyID key, KeyModifierMask mask,
+				KeyButton button, BroadcastMessages&)
+{
+	keyDown(key, mask, button);
+}
+
+void
+BaseClientProxy::broadcastKeyUp(KeyID key, KeyModifierMask mask,
+				KeyButton button, BroadcastMessages&)
+{
+	keyUp(key, mask, button);
+}
+
 void
 BaseClientProxy::setJumpCursorPos(SInt32 x, SInt32 y)
 {
@@ -21,6 +21,10 @@
 #include "synergy/IClient.h"
 #include "base/String.h"
 
+class BroadcastMessages;
+class FileChunk;
+class InputTime;
+class LatencyStats;
 namespace synergy { class IStream; }
 
 //! Generic proxy for client or primary
@@ -41,6 +45,31 @@ public:
 	*/
 	void				setJumpCursorPos(SInt32 x, SInt32 y);
 
+	//! Trace input
+	/*!
+	Gives the times of the input event that the next key or mouse
+	motion call relays, so the client can measure its latency.
+	*/
+	virtual void		traceInput(const InputTime&) { }
+
+	//! Broadcast key press
+	/*!
+	Like keyDown() but for a key sent to several clients at once.  The
+	protocol message is written through \c messages, which every
+	target of the key shares, so it's built only once.  The default
+	calls keyDown().
+	*/
+	virtual void		broadcastKeyDown(KeyID, KeyModifierMask, KeyButton,
+							BroadcastMessages& messages);
+
+	//! Broadcast key release
+	/*!
+	Like keyUp() but for a key sent to several clients at once.  See
+	broadcastKeyDown().
+	*/
+	virtual void		broadcastKeyUp(KeyID, KeyModifierMask, KeyButton,
+							BroadcastMessages& messages);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -57,6 +86,21 @@ public:
 	*/
 	virtual bool		isPrimary() const { return false; }
 
+	//! Check file queue support
+	/*!
+	Return true if the client receives files through a FileTransferQueue
+	rather than one at a time with kMsgDFileTransfer.
+	*/
+	virtual bool		isFileQueueSupported() const { return false; }
+
+	//! Get input latencies
+	/*!
+	Returns the latencies the client measured for traced input events,
+	or NULL if the client doesn't trace latency.
+	*/
+	virtual const LatencyStats*
+						getLatencyStats() const { return NULL; }
+
 	//@}
 
 	// IScreen
@@ -88,7 +132,7 @@ public:
 	virtual void		setOptions(const OptionsList& options) = 0;
 	virtual void		sendDragInfo(UInt32 fileCount, const char* info,
 							size_t size) = 0;
-	virtual void		fileChunkSending(UInt8 mark, char* data, size_t dataSize) = 0;
+	virtual void		fileChunkSending(const FileChunk& chunk) = 0;
 	virtual String		getName() const;
 	virtual synergy::IStream*
 						getStream() const = 0;
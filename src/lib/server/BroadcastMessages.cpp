@@ -0,0 +1,78 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/BroadcastMessages.h"
+
+#include "synergy/ProtocolUtil.h"
+#include "io/IStream.h"
+#include "io/SharedBuffer.h"
+
+#include <stdarg.h>
+
+//
+// BroadcastMessages
+//
+
+BroadcastMessages::BroadcastMessages()
+{
+	// do nothing
+}
+
+BroadcastMessages::~BroadcastMessages()
+{
+	clear();
+}
+
+void
+BroadcastMessages::write(synergy::IStream* stream, const char* fmt, ...)
+{
+	assert(stream != NULL);
+	assert(fmt != NULL);
+
+	// find the message or build it
+	SharedBuffer* buffer = NULL;
+	for (MessageList::const_iterator i = m_messages.begin();
+								i != m_messages.end(); ++i) {
+		if (i->m_fmt == fmt) {
+			buffer = i->m_buffer;
+			break;
+		}
+	}
+	if (buffer == NULL) {
+		va_list args;
+		va_start(args, fmt);
+		buffer = ProtocolUtil::vformat(fmt, args);
+		va_end(args);
+
+		Message message;
+		message.m_fmt    = fmt;
+		message.m_buffer = buffer;
+		m_messages.push_back(message);
+	}
+
+	stream->writeShared(buffer);
+}
+
+void
+BroadcastMessages::clear()
+{
+	for (MessageList::iterator i = m_messages.begin();
+								i != m_messages.end(); ++i) {
+		i->m_buffer->unref();
+	}
+	m_messages.clear();
+}
@@ -0,0 +1,70 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/stdvector.h"
+
+namespace synergy { class IStream; }
+class SharedBuffer;
+
+//! Protocol messages shared by the targets of a broadcast
+/*!
+Holds the protocol messages built for one event that the server sends
+to several clients, so each message is formatted once and every
+client's stream queues the same buffer.  Clients that speak different
+protocol versions use different message formats;  each format is
+built the first time a client needs it.
+*/
+class BroadcastMessages {
+public:
+	BroadcastMessages();
+	~BroadcastMessages();
+
+	//! @name manipulators
+	//@{
+
+	//! Write message
+	/*!
+	Writes the message formatted from \c fmt and the arguments, as by
+	ProtocolUtil::writef(), to \c stream.  The message is formatted
+	only the first time \c fmt is written after a clear();  later
+	writes share that buffer, so every write with \c fmt between
+	clears must pass the same arguments.  Formats are told apart by
+	address, as the protocol's message constants are.
+	*/
+	void				write(synergy::IStream* stream, const char* fmt, ...);
+
+	//! Drop messages
+	/*!
+	Drops the messages built since the last clear().  Call this after
+	every target has been sent the event.
+	*/
+	void				clear();
+
+	//@}
+
+private:
+	class Message {
+	public:
+		const char*		m_fmt;
+		SharedBuffer*	m_buffer;
+	};
+	typedef std::vector<Message> MessageList;
+
+	MessageList			m_messages;
+};
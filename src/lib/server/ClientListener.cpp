@@ -20,6 +20,7 @@
 
 #include "server/ClientProxy.h"
 #include "server/ClientProxyUnknown.h"
+#include "server/Server.h"
 #include "synergy/PacketStreamFilter.h"
 #include "net/IDataSocket.h"
 #include "net/IListenSocket.h"
@@ -74,6 +75,18 @@ ClientListener::~ClientListener()
 {
 	LOG((CLOG_DEBUG1 "stop listening for clients"));
 
+	// discard sockets that haven't been accepted yet
+	for (NewSockets::iterator index = m_newSockets.begin();
+								index != m_newSockets.end(); ++index) {
+		IDataSocket* socket = *index;
+		m_events->removeHandler(m_events->forClientListener().accepted(),
+							socket->getEventTarget());
+		m_events->removeHandler(m_events->forISocket().disconnected(),
+							socket->getEventTarget());
+		delete socket;
+	}
+	m_newSockets.clear();
+
 	// discard already connected clients
 	for (NewClients::iterator index = m_newClients.begin();
 								index != m_newClients.end(); ++index) {
@@ -128,10 +141,15 @@ ClientListener::handleClientConnecting(const Event&, void*)
 		return;
 	}
 	
+	m_newSockets.insert(socket);
 	m_events->adoptHandler(m_events->forClientListener().accepted(),
 				socket->getEventTarget(),
 				new TMethodEventJob<ClientListener>(this,
 						&ClientListener::handleClientAccepted, socket));
+	m_events->adoptHandler(m_events->forISocket().disconnected(),
+				socket->getEventTarget(),
+				new TMethodEventJob<ClientListener>(this,
+						&ClientListener::handleClientAcceptFailed, socket));
 	
 	// When using non SSL, server accepts clients immediately, while SSL
 	// has to call secure accept which may require retry
@@ -147,6 +165,13 @@ ClientListener::handleClientAccepted(const Event&, void* vsocket)
 	LOG((CLOG_NOTE "accepted client connection"));
 
 	IDataSocket* socket = static_cast<IDataSocket*>(vsocket);
+
+	// the socket now belongs to the client proxy
+	m_newSockets.erase(socket);
+	m_events->removeHandler(m_events->forClientListener().accepted(),
+				socket->getEventTarget());
+	m_events->removeHandler(m_events->forISocket().disconnected(),
+				socket->getEventTarget());
 	
 	// filter socket messages, including a packetizing filter
 	synergy::IStream* stream = new PacketStreamFilter(m_events, socket, true);
@@ -168,6 +193,20 @@ ClientListener::handleClientAccepted(const Event&, void* vsocket)
 						&ClientListener::handleUnknownClient, client));
 }
 
+void
+ClientListener::handleClientAcceptFailed(const Event&, void* vsocket)
+{
+	LOG((CLOG_NOTE "client connection failed before it was accepted"));
+
+	IDataSocket* socket = static_cast<IDataSocket*>(vsocket);
+	m_newSockets.erase(socket);
+	m_events->removeHandler(m_events->forClientListener().accepted(),
+				socket->getEventTarget());
+	m_events->removeHandler(m_events->forISocket().disconnected(),
+				socket->getEventTarget());
+	delete socket;
+}
+
 void
 ClientListener::handleUnknownClient(const Event&, void* vclient)
 {
@@ -181,7 +220,14 @@ ClientListener::handleUnknownClient(const Event&, void* vclient)
 	ClientProxy* client = unknownClient->orphanClientProxy();
 	bool handshakeOk = true;
 	if (client != NULL) {
-		// handshake was successful
+		// handshake was successful.  count the client's traffic under
+		// its screen's name from now on.
+		PacketStreamFilter* filter =
+			dynamic_cast<PacketStreamFilter*>(client->getStream());
+		if (filter != NULL) {
+			filter->setPeerName(m_server->getScreenLabel(client->getName()));
+		}
+
 		m_waitingClients.push_back(client);
 		m_events->addEvent(Event(m_events->forClientListener().connected(),
 								 this));
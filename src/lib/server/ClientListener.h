@@ -26,6 +26,7 @@
 
 class ClientProxy;
 class ClientProxyUnknown;
+class IDataSocket;
 class NetworkAddress;
 class IListenSocket;
 class ISocketFactory;
@@ -68,17 +69,23 @@ private:
 	// client connection event handlers
 	void				handleClientConnecting(const Event&, void*);
 	void				handleClientAccepted(const Event&, void*);
+	void				handleClientAcceptFailed(const Event&, void*);
 	void				handleUnknownClient(const Event&, void*);
 	void				handleClientDisconnected(const Event&, void*);
 
 	void				cleanupListenSocket();
 
 private:
+	typedef std::set<IDataSocket*> NewSockets;
 	typedef std::set<ClientProxyUnknown*> NewClients;
 	typedef std::deque<ClientProxy*> WaitingClients;
 
 	IListenSocket*		m_listen;
 	ISocketFactory*		m_socketFactory;
+
+	// sockets that are still being accepted (the TLS handshake may take
+	// a while or fail).  they're ours until they're accepted.
+	NewSockets			m_newSockets;
 	NewClients			m_newClients;
 	WaitingClients		m_waitingClients;
 	Server*				m_server;
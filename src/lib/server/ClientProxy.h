@@ -84,7 +84,7 @@ public:
 	virtual void		setOptions(const OptionsList& options) = 0;
 	virtual void		sendDragInfo(UInt32 fileCount, const char* info,
 							size_t size) = 0;
-	virtual void		fileChunkSending(UInt8 mark, char* data, size_t dataSize) = 0;
+	virtual void		fileChunkSending(const FileChunk& chunk) = 0;
 
 private:
 	synergy::IStream*	m_stream;
@@ -18,6 +18,7 @@
 
 #include "server/ClientProxy1_0.h"
 
+#include "server/BroadcastMessages.h"
 #include "synergy/ProtocolUtil.h"
 #include "synergy/XSynergy.h"
 #include "io/IStream.h"
@@ -33,10 +34,21 @@
 
 ClientProxy1_0::ClientProxy1_0(const String& name, synergy::IStream* stream, IEventQueue* events) :
 	ClientProxy(name, stream),
+	m_monitors(1),
 	m_heartbeatTimer(NULL),
 	m_parser(&ClientProxy1_0::parseHandshakeMessage),
 	m_events(events)
 {
+	// the client's shape is empty until it sends its info.  the empty
+	// screen is also its only monitor.
+	m_info.m_x  = 0;
+	m_info.m_y  = 0;
+	m_info.m_w  = 0;
+	m_info.m_h  = 0;
+	m_info.m_mx = 0;
+	m_info.m_my = 0;
+	updateMonitors();
+
 	// install event handlers
 	m_events->adoptHandler(m_events->forIStream().inputReady(),
 							stream->getEventTarget(),
@@ -253,6 +265,14 @@ ClientProxy1_0::getCursorPos(SInt32& x, SInt32& y) const
 	y = m_info.m_my;
 }
 
+const IScreen::MonitorList&
+ClientProxy1_0::getMonitors() const
+{
+	// the protocol doesn't describe monitors so the client's screen is
+	// treated as a single monitor
+	return m_monitors;
+}
+
 void
 ClientProxy1_0::enter(SInt32 xAbs, SInt32 yAbs,
 				UInt32 seqNum, KeyModifierMask mask, bool)
@@ -284,8 +304,9 @@ ClientProxy1_0::grabClipboard(ClipboardID id)
 	LOG((CLOG_DEBUG "send grab clipboard %d to \"%s\"", id, getName().c_str()));
 	ProtocolUtil::writef(getStream(), kMsgCClipboard, id, 0);
 
-	// this clipboard is now dirty
+	// this clipboard is now dirty and the client's data is gone
 	m_clipboard[id].m_dirty = true;
+	m_clipboard[id].m_hash  = 0;
 }
 
 void
@@ -294,6 +315,22 @@ ClientProxy1_0::setClipboardDirty(ClipboardID id, bool dirty)
 	m_clipboard[id].m_dirty = dirty;
 }
 
+void
+ClientProxy1_0::broadcastKeyDown(KeyID key, KeyModifierMask mask,
+				KeyButton, BroadcastMessages& messages)
+{
+	LOG((CLOG_DEBUG1 "send key down to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key, mask));
+	messages.write(getStream(), kMsgDKeyDown1_0, key, mask);
+}
+
+void
+ClientProxy1_0::broadcastKeyUp(KeyID key, KeyModifierMask mask,
+				KeyButton, BroadcastMessages& messages)
+{
+	LOG((CLOG_DEBUG1 "send key up to \"%s\" id=%d, mask=0x%04x", getName().c_str(), key, mask));
+	messages.write(getStream(), kMsgDKeyUp1_0, key, mask);
+}
+
 void
 ClientProxy1_0::keyDown(KeyID key, KeyModifierMask mask, KeyButton)
 {
@@ -359,7 +396,7 @@ ClientProxy1_0::sendDragInfo(UInt32 fileCount, const char* info, size_t size)
 }
 
 void
-ClientProxy1_0::fileChunkSending(UInt8 mark, char* data, size_t dataSize)
+ClientProxy1_0::fileChunkSending(const FileChunk& chunk)
 {
 	// ignore -- not supported in protocol 1.0
 	LOG((CLOG_DEBUG "fileChunkSending not supported"));
@@ -432,12 +469,23 @@ ClientProxy1_0::recvInfo()
 	m_info.m_mx = mx;
 	m_info.m_my = my;
 
+	updateMonitors();
+
 	// acknowledge receipt
 	LOG((CLOG_DEBUG1 "send info ack to \"%s\"", getName().c_str()));
 	ProtocolUtil::writef(getStream(), kMsgCInfoAck);
 	return true;
 }
 
+void
+ClientProxy1_0::updateMonitors()
+{
+	m_monitors[0].m_x = m_info.m_x;
+	m_monitors[0].m_y = m_info.m_y;
+	m_monitors[0].m_w = m_info.m_w;
+	m_monitors[0].m_h = m_info.m_h;
+}
+
 bool
 ClientProxy1_0::recvClipboard()
 {
@@ -461,6 +509,9 @@ ClientProxy1_0::recvGrabClipboard()
 		return false;
 	}
 
+	// the client's data isn't known until it sends it
+	m_clipboard[id].m_hash = 0;
+
 	// notify
 	ClipboardInfo* info   = new ClipboardInfo;
 	info->m_id             = id;
@@ -478,7 +529,8 @@ ClientProxy1_0::recvGrabClipboard()
 ClientProxy1_0::ClientClipboard::ClientClipboard() :
 	m_clipboard(),
 	m_sequenceNumber(0),
-	m_dirty(true)
+	m_dirty(true),
+	m_hash(0)
 {
 	// do nothing
 }
@@ -37,6 +37,14 @@ public:
 	virtual void		getShape(SInt32& x, SInt32& y,
 							SInt32& width, SInt32& height) const;
 	virtual void		getCursorPos(SInt32& x, SInt32& y) const;
+	virtual const MonitorList&
+						getMonitors() const;
+
+	// BaseClientProxy overrides
+	virtual void		broadcastKeyDown(KeyID, KeyModifierMask, KeyButton,
+							BroadcastMessages&);
+	virtual void		broadcastKeyUp(KeyID, KeyModifierMask, KeyButton,
+							BroadcastMessages&);
 
 	// IClient overrides
 	virtual void		enter(SInt32 xAbs, SInt32 yAbs,
@@ -59,7 +67,7 @@ public:
 	virtual void		resetOptions();
 	virtual void		setOptions(const OptionsList& options);
 	virtual void		sendDragInfo(UInt32 fileCount, const char* info, size_t size);
-	virtual void		fileChunkSending(UInt8 mark, char* data, size_t dataSize);
+	virtual void		fileChunkSending(const FileChunk& chunk);
 
 protected:
 	virtual bool		parseHandshakeMessage(const UInt8* code);
@@ -83,6 +91,9 @@ private:
 	bool				recvInfo();
 	bool				recvGrabClipboard();
 
+	// make the single monitor cover the shape in m_info
+	void				updateMonitors();
+
 protected:
 	struct ClientClipboard {
 	public:
@@ -92,6 +103,9 @@ protected:
 		Clipboard		m_clipboard;
 		UInt32			m_sequenceNumber;
 		bool			m_dirty;
+
+		// hash of the data the client holds, 0 if it's not known
+		UInt64			m_hash;
 	};
 
 	ClientClipboard	m_clipboard[kClipboardEnd];
@@ -100,6 +114,7 @@ private:
 	typedef bool (ClientProxy1_0::*MessageParser)(const UInt8*);
 
 	ClientInfo			m_info;
+	MonitorList			m_monitors;
 	double				m_heartbeatAlarm;
 	EventQueueTimer*	m_heartbeatTimer;
 	MessageParser		m_parser;
@@ -18,6 +18,7 @@
 
 #include "server/ClientProxy1_1.h"
 
+#include "server/BroadcastMessages.h"
 #include "synergy/ProtocolUtil.h"
 #include "base/Log.h"
 
@@ -38,6 +39,22 @@ ClientProxy1_1::~ClientProxy1_1()
 	// do nothing
 }
 
+void
+ClientProxy1_1::broadcastKeyDown(KeyID key, KeyModifierMask mask,
+				KeyButton button, BroadcastMessages& messages)
+{
+	LOG((CLOG_DEBUG1 "send key down to \"%s\" id=%d, mask=0x%04x, button=0x%04x", getName().c_str(), key, mask, button));
+	messages.write(getStream(), kMsgDKeyDown, key, mask, button);
+}
+
+void
+ClientProxy1_1::broadcastKeyUp(KeyID key, KeyModifierMask mask,
+				KeyButton button, BroadcastMessages& messages)
+{
+	LOG((CLOG_DEBUG1 "send key up to \"%s\" id=%d, mask=0x%04x, button=0x%04x", getName().c_str(), key, mask, button));
+	messages.write(getStream(), kMsgDKeyUp, key, mask, button);
+}
+
 void
 ClientProxy1_1::keyDown(KeyID key, KeyModifierMask mask, KeyButton button)
 {
@@ -26,6 +26,12 @@ public:
 	ClientProxy1_1(const String& name, synergy::IStream* adoptedStream, IEventQueue* events);
 	~ClientProxy1_1();
 
+	// BaseClientProxy overrides
+	virtual void		broadcastKeyDown(KeyID, KeyModifierMask, KeyButton,
+							BroadcastMessages&);
+	virtual void		broadcastKeyUp(KeyID, KeyModifierMask, KeyButton,
+							BroadcastMessages&);
+
 	// IClient overrides
 	virtual void		keyDown(KeyID, KeyModifierMask, KeyButton);
 	virtual void		keyRepeat(KeyID, KeyModifierMask,
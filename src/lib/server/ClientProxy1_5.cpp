@@ -40,11 +40,18 @@ ClientProxy1_5::ClientProxy1_5(const String& name, synergy::IStream* stream, Ser
 							this,
 							new TMethodEventJob<ClientProxy1_3>(this,
 								&ClientProxy1_3::handleKeepAlive, NULL));
+
+	m_events->adoptHandler(m_events->forIStream().outputFlushed(),
+							getStream()->getEventTarget(),
+							new TMethodEventJob<ClientProxy1_5>(this,
+								&ClientProxy1_5::handleOutputFlushed));
 }
 
 ClientProxy1_5::~ClientProxy1_5()
 {
 	m_events->removeHandler(m_events->forFile().keepAlive(), this);
+	m_events->removeHandler(m_events->forIStream().outputFlushed(),
+							getStream()->getEventTarget());
 }
 
 void
@@ -56,9 +63,16 @@ ClientProxy1_5::sendDragInfo(UInt32 fileCount, const char* info, size_t size)
 }
 
 void
-ClientProxy1_5::fileChunkSending(UInt8 mark, char* data, size_t dataSize)
+ClientProxy1_5::fileChunkSending(const FileChunk& chunk)
 {
-	FileChunk::send(getStream(), mark, data, dataSize);
+	FileChunk::send(getStream(), chunk, isCompressionEnabled());
+	m_unflushedChunks.written(chunk);
+}
+
+bool
+ClientProxy1_5::isCompressionEnabled() const
+{
+	return false;
 }
 
 bool
@@ -81,11 +95,7 @@ void
 ClientProxy1_5::fileChunkReceived()
 {
 	Server* server = getServer();
-	int result = FileChunk::assemble(
-					getStream(),
-					server->getReceivedFileData(),
-					server->getExpectedFileSize());
-	
+	int result = FileChunk::assemble(getStream(), server->getReceivedFile());
 
 	if (result == kFinish) {
 		m_events->addEvent(Event(m_events->forFile().fileRecieveCompleted(), server));
@@ -98,6 +108,18 @@ ClientProxy1_5::fileChunkReceived()
 	}
 }
 
+void
+ClientProxy1_5::outputFlushed()
+{
+	m_unflushedChunks.flushed();
+}
+
+void
+ClientProxy1_5::handleOutputFlushed(const Event&, void*)
+{
+	outputFlushed();
+}
+
 void
 ClientProxy1_5::dragInfoReceived()
 {
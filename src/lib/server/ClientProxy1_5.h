@@ -18,6 +18,7 @@
 #pragma once
 
 #include "server/ClientProxy1_4.h"
+#include "synergy/FileWindow.h"
 #include "base/Stopwatch.h"
 #include "common/stdvector.h"
 
@@ -31,11 +32,30 @@ public:
 	~ClientProxy1_5();
 
 	virtual void		sendDragInfo(UInt32 fileCount, const char* info, size_t size);
-	virtual void		fileChunkSending(UInt8 mark, char* data, size_t dataSize);
+	virtual void		fileChunkSending(const FileChunk& chunk);
 	virtual bool		parseMessage(const UInt8* code);
 	void				fileChunkReceived();
 	void				dragInfoReceived();
 
+protected:
+	//! Check compression
+	/*!
+	Returns true if the client accepts compressed chunks.
+	*/
+	virtual bool		isCompressionEnabled() const;
+
+	//! Handle stream flushed
+	/*!
+	Called when the stream has sent all of its buffered output.
+	*/
+	virtual void		outputFlushed();
+
+private:
+	void				handleOutputFlushed(const Event&, void*);
+
 private:
 	IEventQueue*		m_events;
+
+	// file chunks written to the stream that it hasn't sent yet
+	UnflushedFileChunks	m_unflushedChunks;
 };
@@ -19,10 +19,8 @@
 
 #include "server/Server.h"
 #include "synergy/ProtocolUtil.h"
-#include "synergy/StreamChunker.h"
 #include "synergy/ClipboardChunk.h"
 #include "io/IStream.h"
-#include "base/TMethodEventJob.h"
 #include "base/Log.h"
 
 //
@@ -31,12 +29,10 @@
 
 ClientProxy1_6::ClientProxy1_6(const String& name, synergy::IStream* stream, Server* server, IEventQueue* events) :
 	ClientProxy1_5(name, stream, server, events),
-	m_events(events)
+	m_events(events),
+	m_clipboardSender(stream),
+	m_clipboardSize(0)
 {
-	m_events->adoptHandler(m_events->forClipboard().clipboardSending(),
-								this,
-								new TMethodEventJob<ClientProxy1_6>(this,
-									&ClientProxy1_6::handleClipboardSendingEvent));
 }
 
 ClientProxy1_6::~ClientProxy1_6()
@@ -52,41 +48,56 @@ ClientProxy1_6::setClipboard(ClipboardID id, const IClipboard* clipboard)
 		m_clipboard[id].m_dirty = false;
 		Clipboard::copy(&m_clipboard[id].m_clipboard, clipboard);
 
+		// skip data the client already holds
+		UInt64 hash = m_clipboard[id].m_clipboard.getHash();
+		if (hash == m_clipboard[id].m_hash) {
+			LOG((CLOG_DEBUG "client \"%s\" already has clipboard %d", getName().c_str(), id));
+			return;
+		}
+		m_clipboard[id].m_hash = hash;
+
 		String data = m_clipboard[id].m_clipboard.marshall();
 
-		size_t size = data.size();
 		LOG((CLOG_DEBUG "sending clipboard %d to \"%s\"", id, getName().c_str()));
 
-		StreamChunker::sendClipboard(data, size, id, 0, m_events, this);
+		sendClipboard(id, 0, data);
 	}
 }
 
 void
-ClientProxy1_6::handleClipboardSendingEvent(const Event& event, void*)
+ClientProxy1_6::sendClipboard(ClipboardID id, UInt32 sequence, String& data)
+{
+	m_clipboardSender.send(id, sequence, data, isCompressionEnabled());
+}
+
+void
+ClientProxy1_6::outputFlushed()
 {
-	ClipboardChunk::send(getStream(), event.getData());
+	ClientProxy1_5::outputFlushed();
+	m_clipboardSender.flushed();
 }
 
 bool
 ClientProxy1_6::recvClipboard()
 {
 	// parse message
-	static String dataCached;
 	ClipboardID id;
 	UInt32 seq;
 
-	int r = ClipboardChunk::assemble(getStream(), dataCached, id, seq);
+	int r = ClipboardChunk::assemble(getStream(), m_clipboardData,
+							m_clipboardSize, id, seq);
 
 	if (r == kStart) {
-		size_t size = ClipboardChunk::getExpectedSize();
-		LOG((CLOG_DEBUG "receiving clipboard %d size=%d", id, size));
+		LOG((CLOG_DEBUG "receiving clipboard %d size=%d", id, (int)m_clipboardSize));
 	}
 	else if (r == kFinish) {
 		LOG((CLOG_DEBUG "received client \"%s\" clipboard %d seqnum=%d, size=%d",
-				getName().c_str(), id, seq, dataCached.size()));
+				getName().c_str(), id, seq, (int)m_clipboardData.size()));
 		// save clipboard
-		m_clipboard[id].m_clipboard.unmarshall(dataCached, 0);
+		m_clipboard[id].m_clipboard.unmarshall(m_clipboardData, 0);
+		String().swap(m_clipboardData);
 		m_clipboard[id].m_sequenceNumber = seq;
+		m_clipboard[id].m_hash = m_clipboard[id].m_clipboard.getHash();
 		
 		// notify
 		ClipboardInfo* info = new ClipboardInfo;
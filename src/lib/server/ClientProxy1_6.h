@@ -18,6 +18,7 @@
 #pragma once
 
 #include "server/ClientProxy1_5.h"
+#include "synergy/ClipboardSender.h"
 
 class Server;
 class IEventQueue;
@@ -31,9 +32,23 @@ public:
 	virtual void		setClipboard(ClipboardID id, const IClipboard* clipboard);
 	virtual bool		recvClipboard();
 
-private:
-	void				handleClipboardSendingEvent(const Event&, void*);
+protected:
+	//! Send clipboard data
+	/*!
+	Queues the marshalled clipboard \c data for sending, leaving
+	\c data empty.
+	*/
+	void				sendClipboard(ClipboardID id, UInt32 sequence,
+							String& data);
+
+	// ClientProxy1_5 overrides
+	virtual void		outputFlushed();
 
 private:
 	IEventQueue*		m_events;
+	ClipboardSender		m_clipboardSender;
+
+	// clipboard being received
+	String				m_clipboardData;
+	size_t				m_clipboardSize;
 };
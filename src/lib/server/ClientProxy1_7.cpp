@@ -0,0 +1,181 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/ClientProxy1_7.h"
+
+#include "server/Server.h"
+#include "synergy/ProtocolUtil.h"
+#include "synergy/ClipboardOffer.h"
+#include "synergy/FileChunk.h"
+#include "synergy/PayloadCompressor.h"
+#include "synergy/protocol_types.h"
+#include "base/String.h"
+#include "base/Log.h"
+
+#include <cstring>
+
+//
+// ClientProxy1_7
+//
+
+ClientProxy1_7::ClientProxy1_7(const String& name, synergy::IStream* stream, Server* server, IEventQueue* events) :
+	ClientProxy1_6(name, stream, server, events),
+	m_codecs(kCompressionNone),
+	m_nextOfferSequence(1)
+{
+	for (ClipboardID id = 0; id < kClipboardEnd; ++id) {
+		m_offerSequence[id] = 0;
+	}
+
+	// until the client answers, it gets everything uncompressed
+	ProtocolUtil::writef(getStream(), kMsgDCompression,
+							PayloadCompressor::getCodecs());
+}
+
+ClientProxy1_7::~ClientProxy1_7()
+{
+	// do nothing
+}
+
+bool
+ClientProxy1_7::isFileQueueSupported() const
+{
+	return true;
+}
+
+bool
+ClientProxy1_7::parseMessage(const UInt8* code)
+{
+	if (memcmp(code, kMsgDFileQueue, 4) == 0) {
+		FileChunk::assembleQueued(getStream(),
+							getServer()->getFileReceiver(), getName());
+	}
+	else if (memcmp(code, kMsgDFileAccept, 4) == 0) {
+		fileAcceptReceived();
+	}
+	else if (memcmp(code, kMsgDCompression, 4) == 0) {
+		compressionReceived();
+	}
+	else if (memcmp(code, kMsgQClipboard, 4) == 0) {
+		clipboardRequested();
+	}
+	else {
+		return ClientProxy1_6::parseMessage(code);
+	}
+
+	return true;
+}
+
+void
+ClientProxy1_7::setClipboard(ClipboardID id, const IClipboard* clipboard)
+{
+	// ignore if this clipboard is already clean
+	if (!m_clipboard[id].m_dirty) {
+		return;
+	}
+
+	// this clipboard is now clean
+	m_clipboard[id].m_dirty = false;
+	Clipboard::copy(&m_clipboard[id].m_clipboard, clipboard);
+
+	// skip data the client already holds
+	UInt64 hash = m_clipboard[id].m_clipboard.getHash();
+	if (hash == m_clipboard[id].m_hash) {
+		LOG((CLOG_DEBUG "client \"%s\" already has clipboard %d", getName().c_str(), id));
+		return;
+	}
+	m_clipboard[id].m_hash = hash;
+
+	// the client asks for the data it doesn't have when it needs it
+	UInt32 sequence = m_nextOfferSequence++;
+	if (m_nextOfferSequence == 0) {
+		m_nextOfferSequence = 1;
+	}
+	m_offerSequence[id] = sequence;
+
+	ClipboardOffer offer;
+	offer.set(m_clipboard[id].m_clipboard);
+	std::vector<UInt32> formats;
+	offer.marshall(formats);
+
+	LOG((CLOG_DEBUG "offering clipboard %d to \"%s\" seqnum=%d formats=%d", id, getName().c_str(), sequence, (int)offer.getFormats().size()));
+	ProtocolUtil::writef(getStream(), kMsgDClipboardOffer, id, sequence, &formats);
+}
+
+void
+ClientProxy1_7::fileAcceptReceived()
+{
+	// parse
+	UInt32 id = 0;
+	String offset;
+	if (ProtocolUtil::readf(getStream(), kMsgDFileAccept + 4, &id, &offset)) {
+		getServer()->fileTransferAccepted(id,
+							synergy::string::stringToSizeType(offset));
+	}
+}
+
+void
+ClientProxy1_7::compressionReceived()
+{
+	// parse
+	UInt32 codecs = 0;
+	if (ProtocolUtil::readf(getStream(), kMsgDCompression + 4, &codecs)) {
+		m_codecs = codecs & PayloadCompressor::getCodecs();
+		LOG((CLOG_DEBUG "client \"%s\" compression codecs=%d", getName().c_str(), m_codecs));
+	}
+}
+
+bool
+ClientProxy1_7::isCompressionEnabled() const
+{
+	return (m_codecs & kCompressionLZ4) != 0;
+}
+
+void
+ClientProxy1_7::clipboardRequested()
+{
+	// parse
+	ClipboardID id;
+	UInt32 sequence, format;
+	if (!ProtocolUtil::readf(getStream(), kMsgQClipboard + 4,
+							&id, &sequence, &format)) {
+		return;
+	}
+	if (id >= kClipboardEnd) {
+		LOG((CLOG_ERR "client \"%s\" requested invalid clipboard %d", getName().c_str(), id));
+		return;
+	}
+
+	// an out of date offer gets an empty clipboard
+	Clipboard data;
+	const Clipboard& clipboard = m_clipboard[id].m_clipboard;
+	if (sequence == m_offerSequence[id] &&
+		format < static_cast<UInt32>(IClipboard::kNumFormats)) {
+		IClipboard::EFormat requested = static_cast<IClipboard::EFormat>(format);
+		clipboard.open(0);
+		if (clipboard.has(requested)) {
+			data.open(0);
+			data.add(requested, clipboard.get(requested));
+			data.close();
+		}
+		clipboard.close();
+	}
+
+	String marshalled = data.marshall();
+	LOG((CLOG_DEBUG "sending clipboard %d format %d to \"%s\" seqnum=%d size=%d", id, format, getName().c_str(), sequence, (int)marshalled.size()));
+	sendClipboard(id, sequence, marshalled);
+}
@@ -0,0 +1,199 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/ClientProxy1_8.h"
+
+#include "server/Server.h"
+#include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_types.h"
+#include "base/Log.h"
+#include "base/Metrics.h"
+
+#include <cstring>
+
+// seconds between logging the latencies of a client
+static const double		kLatencyLogInterval = 60.0;
+
+//
+// ClientProxy1_8
+//
+
+ClientProxy1_8::ClientProxy1_8(const String& name, synergy::IStream* stream, Server* server, IEventQueue* events) :
+	ClientProxy1_7(name, stream, server, events),
+	m_latencyLogTime(true)
+{
+	String client = Metrics::label("client", server->getScreenLabel(name));
+	for (int i = 0; i < LatencyStats::kNumStages; ++i) {
+		LatencyStats::EStage stage = static_cast<LatencyStats::EStage>(i);
+		m_latencyMetrics[i] = Metrics::getInstance().getHistogram(
+							"synergy_input_latency_seconds",
+							"Input latency to a client by stage, measured by the client.",
+							client + "," +
+							Metrics::label("stage", LatencyStats::getStageName(stage)));
+	}
+}
+
+ClientProxy1_8::~ClientProxy1_8()
+{
+	// do nothing
+}
+
+bool
+ClientProxy1_8::parseMessage(const UInt8* code)
+{
+	if (memcmp(code, kMsgQTime, 4) == 0) {
+		timeQueried();
+	}
+	else if (memcmp(code, kMsgDLatency, 4) == 0) {
+		latencyReceived();
+	}
+	else {
+		return ClientProxy1_7::parseMessage(code);
+	}
+
+	return true;
+}
+
+void
+ClientProxy1_8::traceInput(const InputTime& time)
+{
+	m_inputTime = time;
+}
+
+const LatencyStats*
+ClientProxy1_8::getLatencyStats() const
+{
+	return &m_latency;
+}
+
+void
+ClientProxy1_8::broadcastKeyDown(KeyID key, KeyModifierMask mask,
+				KeyButton button, BroadcastMessages& messages)
+{
+	sendInputTime();
+	ClientProxy1_7::broadcastKeyDown(key, mask, button, messages);
+}
+
+void
+ClientProxy1_8::broadcastKeyUp(KeyID key, KeyModifierMask mask,
+				KeyButton button, BroadcastMessages& messages)
+{
+	sendInputTime();
+	ClientProxy1_7::broadcastKeyUp(key, mask, button, messages);
+}
+
+void
+ClientProxy1_8::keyDown(KeyID key, KeyModifierMask mask, KeyButton button)
+{
+	sendInputTime();
+	ClientProxy1_7::keyDown(key, mask, button);
+}
+
+void
+ClientProxy1_8::keyRepeat(KeyID key, KeyModifierMask mask,
+				SInt32 count, KeyButton button)
+{
+	sendInputTime();
+	ClientProxy1_7::keyRepeat(key, mask, count, button);
+}
+
+void
+ClientProxy1_8::keyUp(KeyID key, KeyModifierMask mask, KeyButton button)
+{
+	sendInputTime();
+	ClientProxy1_7::keyUp(key, mask, button);
+}
+
+void
+ClientProxy1_8::mouseMove(SInt32 xAbs, SInt32 yAbs)
+{
+	sendInputTime();
+	ClientProxy1_7::mouseMove(xAbs, yAbs);
+}
+
+void
+ClientProxy1_8::mouseRelativeMove(SInt32 xRel, SInt32 yRel)
+{
+	sendInputTime();
+	ClientProxy1_7::mouseRelativeMove(xRel, yRel);
+}
+
+void
+ClientProxy1_8::sendInputTime()
+{
+	if (m_inputTime.m_captured == 0) {
+		return;
+	}
+
+	UInt64 captured = m_inputTime.m_captured;
+	UInt64 sent     = LatencyTrace::now();
+	ProtocolUtil::writef(getStream(), kMsgDInputTime,
+							static_cast<UInt32>(captured >> 32),
+							static_cast<UInt32>(captured),
+							static_cast<UInt32>(m_inputTime.m_handled - captured),
+							static_cast<UInt32>(sent - captured));
+	m_inputTime = InputTime();
+}
+
+void
+ClientProxy1_8::timeQueried()
+{
+	// parse
+	UInt32 high, low;
+	if (!ProtocolUtil::readf(getStream(), kMsgQTime + 4, &high, &low)) {
+		return;
+	}
+
+	// answer
+	UInt64 now = LatencyTrace::now();
+	ProtocolUtil::writef(getStream(), kMsgDTime, high, low,
+							static_cast<UInt32>(now >> 32),
+							static_cast<UInt32>(now));
+}
+
+void
+ClientProxy1_8::latencyReceived()
+{
+	// parse
+	std::vector<UInt32> data;
+	if (!ProtocolUtil::readf(getStream(), kMsgDLatency + 4, &data)) {
+		return;
+	}
+
+	LatencyStats stats;
+	if (!stats.unmarshall(data)) {
+		LOG((CLOG_ERR "invalid latencies from \"%s\"", getName().c_str()));
+		return;
+	}
+	m_latency.add(stats);
+	for (int i = 0; i < LatencyStats::kNumStages; ++i) {
+		const LatencyHistogram& histogram =
+			stats.get(static_cast<LatencyStats::EStage>(i));
+		for (UInt32 bucket = 0; bucket < LatencyHistogram::kNumBuckets; ++bucket) {
+			UInt32 count = histogram.getBucketCount(bucket);
+			if (count != 0) {
+				m_latencyMetrics[i]->addToBucket(bucket, count);
+			}
+		}
+	}
+
+	// log now and then
+	if (m_latencyLogTime.getTime() >= kLatencyLogInterval) {
+		m_latencyLogTime.reset();
+		LOG((CLOG_INFO "latency to \"%s\": %s", getName().c_str(), m_latency.format().c_str()));
+	}
+}
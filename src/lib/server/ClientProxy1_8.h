@@ -0,0 +1,69 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "server/ClientProxy1_7.h"
+#include "synergy/LatencyStats.h"
+#include "synergy/LatencyTrace.h"
+#include "base/Stopwatch.h"
+
+class Server;
+class IEventQueue;
+class MetricHistogram;
+
+//! Proxy for client implementing protocol version 1.8
+class ClientProxy1_8 : public ClientProxy1_7 {
+public:
+	ClientProxy1_8(const String& name, synergy::IStream* adoptedStream, Server* server, IEventQueue* events);
+	~ClientProxy1_8();
+
+	virtual bool		parseMessage(const UInt8* code);
+
+	// BaseClientProxy overrides
+	virtual void		traceInput(const InputTime& time);
+	virtual void		broadcastKeyDown(KeyID key, KeyModifierMask mask,
+							KeyButton button, BroadcastMessages& messages);
+	virtual void		broadcastKeyUp(KeyID key, KeyModifierMask mask,
+							KeyButton button, BroadcastMessages& messages);
+	virtual const LatencyStats*
+						getLatencyStats() const;
+
+	// IClient overrides
+	virtual void		keyDown(KeyID key, KeyModifierMask mask, KeyButton button);
+	virtual void		keyRepeat(KeyID key, KeyModifierMask mask, SInt32 count, KeyButton button);
+	virtual void		keyUp(KeyID key, KeyModifierMask mask, KeyButton button);
+	virtual void		mouseMove(SInt32 xAbs, SInt32 yAbs);
+	virtual void		mouseRelativeMove(SInt32 xRel, SInt32 yRel);
+
+private:
+	// send the times of the traced input event, if any
+	void				sendInputTime();
+
+	void				timeQueried();
+	void				latencyReceived();
+
+private:
+	InputTime			m_inputTime;
+
+	// latencies measured by the client since it connected
+	LatencyStats		m_latency;
+	Stopwatch			m_latencyLogTime;
+
+	// the same latencies, exported as metrics
+	MetricHistogram*	m_latencyMetrics[LatencyStats::kNumStages];
+};
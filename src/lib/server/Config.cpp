@@ -641,6 +641,23 @@ Config::getInputFilter()
 	return &m_inputFilter;
 }
 
+bool
+Config::update(const Config& config)
+{
+	m_map                   = config.m_map;
+	m_nameToCanonicalName   = config.m_nameToCanonicalName;
+	m_synergyAddress        = config.m_synergyAddress;
+	m_globalOptions         = config.m_globalOptions;
+	m_hasLockToScreenAction = config.m_hasLockToScreenAction;
+
+	// replacing the filter disables and reenables every rule
+	if (m_inputFilter.hasSameRules(config.m_inputFilter)) {
+		return false;
+	}
+	m_inputFilter = config.m_inputFilter;
+	return true;
+}
+
 String
 Config::formatInterval(const Interval& x)
 {
@@ -768,6 +785,9 @@ Config::readSectionOptions(ConfigReadContext& s)
 		else if (name == "clipboardSharing") {
 			addOption("", kOptionClipboardSharing, s.parseBoolean(value));
 		}
+		else if (name == "latencyTrace") {
+			addOption("", kOptionLatencyTrace, s.parseBoolean(value));
+		}
 
 		else {
 			handled = false;
@@ -1383,6 +1403,9 @@ Config::getOptionName(OptionID id)
 	if (id == kOptionClipboardSharing) {
 		return "clipboardSharing";
 	}
+	if (id == kOptionLatencyTrace) {
+		return "latencyTrace";
+	}
 	return NULL;
 }
 
@@ -1400,7 +1423,8 @@ Config::getOptionValue(OptionID id, OptionValue value)
 		id == kOptionRelativeMouseMoves ||
 		id == kOptionWin32KeepForeground ||
 		id == kOptionScreenPreserveFocus ||
-		id == kOptionClipboardSharing) {
+		id == kOptionClipboardSharing ||
+		id == kOptionLatencyTrace) {
 		return (value != 0) ? "true" : "false";
 	}
 	if (id == kOptionModifierMapForShift ||
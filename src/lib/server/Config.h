@@ -320,6 +320,15 @@ public:
 	virtual InputFilter*
 						getInputFilter();
 
+	//! Update configuration
+	/*!
+	Makes this configuration equal to \c config.  The input filter is
+	only replaced if its rules differ from those in \c config so the
+	rules keep their state and hotkeys when they haven't changed.
+	Returns true iff the input filter was replaced.
+	*/
+	bool				update(const Config& config);
+
 	//@}
 	//! @name accessors
 	//@{
@@ -89,6 +89,12 @@ InputFilter::KeystrokeCondition::getMask() const
 	return m_mask;
 }
 
+UInt32
+InputFilter::KeystrokeCondition::getID() const
+{
+	return m_id;
+}
+
 InputFilter::Condition*
 InputFilter::KeystrokeCondition::clone() const
 {
@@ -142,6 +148,10 @@ InputFilter::KeystrokeCondition::disablePrimary(PrimaryClient* primary)
 	m_id = 0;
 }
 
+const KeyModifierMask	InputFilter::MouseButtonCondition::s_ignoreMask =
+	KeyModifierAltGr | KeyModifierCapsLock |
+	KeyModifierNumLock | KeyModifierScrollLock;
+
 InputFilter::MouseButtonCondition::MouseButtonCondition(
 		IEventQueue* events, IPlatformScreen::ButtonInfo* info) :
 	m_button(info->m_button),
@@ -196,10 +206,6 @@ InputFilter::MouseButtonCondition::format() const
 InputFilter::EFilterStatus		
 InputFilter::MouseButtonCondition::match(const Event& event)
 {
-	static const KeyModifierMask s_ignoreMask =
-		KeyModifierAltGr | KeyModifierCapsLock |
-		KeyModifierNumLock | KeyModifierScrollLock;
-
 	EFilterStatus status;
 
 	// check for hotkey events
@@ -889,7 +895,8 @@ InputFilter::Rule::getAction(bool onActivation, UInt32 index) const
 // -----------------------------------------------------------------------------
 InputFilter::InputFilter(IEventQueue* events) :
 	m_primaryClient(NULL),
-	m_events(events)
+	m_events(events),
+	m_compiled(false)
 {
 	// do nothing
 }
@@ -897,7 +904,8 @@ InputFilter::InputFilter(IEventQueue* events) :
 InputFilter::InputFilter(const InputFilter& x) :
 	m_ruleList(x.m_ruleList),
 	m_primaryClient(NULL),
-	m_events(x.m_events)
+	m_events(x.m_events),
+	m_compiled(false)
 {
 	setPrimaryClient(x.m_primaryClient);
 }
@@ -915,6 +923,7 @@ InputFilter::operator=(const InputFilter& x)
 		setPrimaryClient(NULL);
 
 		m_ruleList = x.m_ruleList;
+		m_compiled = false;
 
 		setPrimaryClient(oldClient);
 	}
@@ -928,6 +937,7 @@ InputFilter::addFilterRule(const Rule& rule)
 	if (m_primaryClient != NULL) {
 		m_ruleList.back().enable(m_primaryClient);
 	}
+	m_compiled = false;
 }
 
 void
@@ -937,11 +947,14 @@ InputFilter::removeFilterRule(UInt32 index)
 		m_ruleList[index].disable(m_primaryClient);
 	}
 	m_ruleList.erase(m_ruleList.begin() + index);
+	m_compiled = false;
 }
 
 InputFilter::Rule&
 InputFilter::getRule(UInt32 index)
 {
+	// the caller may change the condition
+	m_compiled = false;
 	return m_ruleList[index];
 }
 
@@ -976,7 +989,9 @@ InputFilter::setPrimaryClient(PrimaryClient* client)
 							m_primaryClient->getEventTarget());
 	}
 
+	// hotkey ids change with the primary client
 	m_primaryClient = client;
+	m_compiled      = false;
 
 	if (m_primaryClient != NULL) {
 		m_events->adoptHandler(m_events->forIKeyState().keyDown(),
@@ -1068,6 +1083,20 @@ InputFilter::operator!=(const InputFilter& x) const
 	return !operator==(x);
 }
 
+bool
+InputFilter::hasSameRules(const InputFilter& x) const
+{
+	if (m_ruleList.size() != x.m_ruleList.size()) {
+		return false;
+	}
+	for (RuleList::size_type i = 0; i < m_ruleList.size(); ++i) {
+		if (m_ruleList[i].format() != x.m_ruleList[i].format()) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void
 InputFilter::handleEvent(const Event& event, void*)
 {
@@ -1076,11 +1105,26 @@ InputFilter::handleEvent(const Event& event, void*)
 								event.getFlags() | Event::kDontFreeData |
 								Event::kDeliverImmediately);
 
-	// let each rule try to match the event until one does
-	for (RuleList::iterator rule  = m_ruleList.begin();
-							 rule != m_ruleList.end(); ++rule) {
-		if (rule->handleEvent(myEvent)) {
-			// handled
+	if (!m_compiled) {
+		compileRules();
+	}
+
+	// let each rule that could match the event try it, in order, until
+	// one does.  an indexed rule always matches but the rules that
+	// aren't indexed get to try first if they come before it.
+	UInt32 indexed = findIndexedRule(event);
+	RuleIndexList::const_iterator other = m_otherRules.begin();
+	for (; other != m_otherRules.end() && *other < indexed; ++other) {
+		if (m_ruleList[*other].handleEvent(myEvent)) {
+			return;
+		}
+	}
+	if (indexed < m_ruleList.size() &&
+		m_ruleList[indexed].handleEvent(myEvent)) {
+		return;
+	}
+	for (; other != m_otherRules.end(); ++other) {
+		if (m_ruleList[*other].handleEvent(myEvent)) {
 			return;
 		}
 	}
@@ -1088,3 +1132,68 @@ InputFilter::handleEvent(const Event& event, void*)
 	// not handled so pass through
 	m_events->addEvent(myEvent);
 }
+
+void
+InputFilter::compileRules()
+{
+	m_hotKeyRules.clear();
+	m_buttonRules.clear();
+	m_otherRules.clear();
+
+	for (UInt32 index = 0; index < m_ruleList.size(); ++index) {
+		const Condition* condition = m_ruleList[index].getCondition();
+		if (condition == NULL) {
+			// never matches
+			continue;
+		}
+
+		const KeystrokeCondition* keystroke =
+			dynamic_cast<const KeystrokeCondition*>(condition);
+		if (keystroke != NULL) {
+			// a hotkey that couldn't be registered is never reported
+			if (keystroke->getID() != 0) {
+				m_hotKeyRules.insert(std::make_pair(keystroke->getID(), index));
+			}
+			continue;
+		}
+
+		const MouseButtonCondition* button =
+			dynamic_cast<const MouseButtonCondition*>(condition);
+		if (button != NULL) {
+			UInt64 key = ((UInt64)button->getButton() << 32) | button->getMask();
+			m_buttonRules.insert(std::make_pair(key, index));
+			continue;
+		}
+
+		m_otherRules.push_back(index);
+	}
+
+	m_compiled = true;
+}
+
+UInt32
+InputFilter::findIndexedRule(const Event& event) const
+{
+	UInt32 none = static_cast<UInt32>(m_ruleList.size());
+
+	Event::Type type = event.getType();
+	if (type == m_events->forIPrimaryScreen().hotKeyDown() ||
+		type == m_events->forIPrimaryScreen().hotKeyUp()) {
+		const IPrimaryScreen::HotKeyInfo* kinfo =
+			static_cast<const IPrimaryScreen::HotKeyInfo*>(event.getData());
+		HotKeyIndex::const_iterator i = m_hotKeyRules.find(kinfo->m_id);
+		return (i != m_hotKeyRules.end()) ? i->second : none;
+	}
+
+	if (type == m_events->forIPrimaryScreen().buttonDown() ||
+		type == m_events->forIPrimaryScreen().buttonUp()) {
+		const IPrimaryScreen::ButtonInfo* minfo =
+			static_cast<const IPrimaryScreen::ButtonInfo*>(event.getData());
+		UInt64 key = ((UInt64)minfo->m_button << 32) |
+			(minfo->m_mask & ~MouseButtonCondition::s_ignoreMask);
+		ButtonIndex::const_iterator i = m_buttonRules.find(key);
+		return (i != m_buttonRules.end()) ? i->second : none;
+	}
+
+	return none;
+}
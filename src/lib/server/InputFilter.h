@@ -25,6 +25,8 @@
 #include "base/String.h"
 #include "common/stdmap.h"
 #include "common/stdset.h"
+#include "common/stdunordered_map.h"
+#include "common/stdvector.h"
 
 class PrimaryClient;
 class Event;
@@ -65,6 +67,10 @@ public:
 		KeyID					getKey() const;
 		KeyModifierMask			getMask() const;
 
+		// get the hotkey id the primary screen reports the keystroke
+		// with.  it's zero while the condition isn't enabled.
+		UInt32					getID() const;
+
 		// Condition overrides
 		virtual Condition*		clone() const;
 		virtual String			format() const;
@@ -89,6 +95,10 @@ public:
 		ButtonID				getButton() const;
 		KeyModifierMask			getMask() const;
 
+		// modifiers that can't be combined with a mouse button and so
+		// are ignored when matching
+		static const KeyModifierMask	s_ignoreMask;
+
 		// Condition overrides
 		virtual Condition*		clone() const;
 		virtual String			format() const;
@@ -321,7 +331,7 @@ public:
 	virtual ~InputFilter();
 
 #ifdef TEST_ENV
-	InputFilter() : m_primaryClient(NULL) { }
+	InputFilter() : m_primaryClient(NULL), m_compiled(false) { }
 #endif
 
 	InputFilter&		operator=(const InputFilter&);
@@ -350,12 +360,37 @@ public:
 	//! Compare filters
 	bool				operator!=(const InputFilter&) const;
 
+	// true iff both filters have the same rules in the same order.
+	// operator== ignores the order but the first matching rule wins.
+	bool				hasSameRules(const InputFilter&) const;
+
 private:
 	// event handling
 	void				handleEvent(const Event&, void*);
 
+	// index the rules by the hotkey or mouse button their conditions
+	// match
+	void				compileRules();
+
+	// find the first rule indexed for the event, if any
+	UInt32				findIndexedRule(const Event&) const;
+
 private:
+	// rule indices by hotkey id and by mouse button and modifiers.  a
+	// key maps to the first rule with that condition since only the
+	// first can ever win.  rules with any other condition might match
+	// any event and are tried in order around the indexed rule.  the
+	// index is recompiled on the first event after the rules or their
+	// hotkeys change.
+	typedef std::unordered_map<UInt32, UInt32> HotKeyIndex;
+	typedef std::unordered_map<UInt64, UInt32> ButtonIndex;
+	typedef std::vector<UInt32> RuleIndexList;
+
 	RuleList			m_ruleList;
 	PrimaryClient*		m_primaryClient;
 	IEventQueue*		m_events;
+	bool				m_compiled;
+	HotKeyIndex			m_hotKeyRules;
+	ButtonIndex			m_buttonRules;
+	RuleIndexList		m_otherRules;
 };
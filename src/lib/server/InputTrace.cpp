@@ -0,0 +1,529 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/InputTrace.h"
+
+#include "server/Server.h"
+#include "server/Config.h"
+#include "synergy/IKeyState.h"
+#include "synergy/IPrimaryScreen.h"
+#include "synergy/IScreen.h"
+#include "base/IEventQueue.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+static const char		kMagic[]   = "SYNTRACE";
+static const UInt8		kVersion   = 1;
+
+// the members written for each record type
+enum {
+	kFieldX      = 1 << 0,
+	kFieldY      = 1 << 1,
+	kFieldID     = 1 << 2,
+	kFieldMask   = 1 << 3,
+	kFieldButton = 1 << 4,
+	kFieldCount  = 1 << 5,
+	kFieldSize   = 1 << 6,
+	kFieldName   = 1 << 7
+};
+
+static const UInt32		kFields[InputTraceRecord::kNumTypes] = {
+	kFieldX | kFieldY,												// kMotionOnPrimary
+	kFieldX | kFieldY,												// kMotionOnSecondary
+	kFieldX | kFieldY,												// kWheel
+	kFieldID | kFieldMask,											// kButtonDown
+	kFieldID | kFieldMask,											// kButtonUp
+	kFieldID | kFieldMask | kFieldButton | kFieldCount | kFieldName,	// kKeyDown
+	kFieldID | kFieldMask | kFieldButton | kFieldCount | kFieldName,	// kKeyUp
+	kFieldID | kFieldMask | kFieldButton | kFieldCount | kFieldName,	// kKeyRepeat
+	kFieldID | kFieldCount,											// kClipboardGrabbed
+	kFieldID | kFieldCount | kFieldSize,							// kClipboardChanged
+	kFieldName,														// kSwitchToScreen
+	kFieldID,														// kSwitchInDirection
+	kFieldID | kFieldName,											// kKeyboardBroadcast
+	kFieldID														// kLockCursorToScreen
+};
+
+// integers are written 7 bits a byte, low bits first, with the top bit
+// set on all but the last byte.  signed integers are zigzag encoded so
+// small negative numbers are short too.
+static void
+writeUInt(std::ostream& stream, UInt64 value)
+{
+	while (value >= 0x80) {
+		stream.put(static_cast<char>((value & 0x7f) | 0x80));
+		value >>= 7;
+	}
+	stream.put(static_cast<char>(value));
+}
+
+static void
+writeSInt(std::ostream& stream, SInt32 value)
+{
+	writeUInt(stream, (static_cast<UInt32>(value) << 1) ^
+							static_cast<UInt32>(value >> 31));
+}
+
+static void
+writeString(std::ostream& stream, const String& value)
+{
+	writeUInt(stream, value.size());
+	stream.write(value.data(), value.size());
+}
+
+static bool
+readUInt(std::istream& stream, UInt64& value)
+{
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		int c = stream.get();
+		if (c == EOF) {
+			return false;
+		}
+		value |= static_cast<UInt64>(c & 0x7f) << shift;
+		if ((c & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool
+readUInt(std::istream& stream, UInt32& value)
+{
+	UInt64 value64;
+	if (!readUInt(stream, value64) || value64 > 0xffffffffu) {
+		return false;
+	}
+	value = static_cast<UInt32>(value64);
+	return true;
+}
+
+static bool
+readSInt(std::istream& stream, SInt32& value)
+{
+	UInt32 zigzag;
+	if (!readUInt(stream, zigzag)) {
+		return false;
+	}
+	value = static_cast<SInt32>((zigzag >> 1) ^ (0 - (zigzag & 1)));
+	return true;
+}
+
+static bool
+readString(std::istream& stream, String& value, UInt64 maxSize)
+{
+	// the size comes from the file so don't allocate more than the file
+	// could hold
+	UInt32 size;
+	if (!readUInt(stream, size) || size > maxSize) {
+		return false;
+	}
+	value.resize(size);
+	if (size > 0) {
+		stream.read(&value[0], size);
+	}
+	return !stream.fail();
+}
+
+//
+// InputTraceRecord
+//
+
+InputTraceRecord::InputTraceRecord() :
+	m_time(0),
+	m_type(kMotionOnPrimary),
+	m_x(0),
+	m_y(0),
+	m_id(0),
+	m_mask(0),
+	m_button(0),
+	m_count(0),
+	m_size(0)
+{
+	// do nothing
+}
+
+bool
+InputTraceRecord::set(IEventQueue* events, const Event& event)
+{
+	Event::Type type = event.getType();
+	if (type == events->forIPrimaryScreen().motionOnPrimary() ||
+		type == events->forIPrimaryScreen().motionOnSecondary()) {
+		const IPrimaryScreen::MotionInfo* info =
+			static_cast<const IPrimaryScreen::MotionInfo*>(event.getData());
+		m_type = (type == events->forIPrimaryScreen().motionOnPrimary()) ?
+							kMotionOnPrimary : kMotionOnSecondary;
+		m_x    = info->m_x;
+		m_y    = info->m_y;
+	}
+	else if (type == events->forIPrimaryScreen().wheel()) {
+		const IPrimaryScreen::WheelInfo* info =
+			static_cast<const IPrimaryScreen::WheelInfo*>(event.getData());
+		m_type = kWheel;
+		m_x    = info->m_xDelta;
+		m_y    = info->m_yDelta;
+	}
+	else if (type == events->forIPrimaryScreen().buttonDown() ||
+			type == events->forIPrimaryScreen().buttonUp()) {
+		const IPrimaryScreen::ButtonInfo* info =
+			static_cast<const IPrimaryScreen::ButtonInfo*>(event.getData());
+		m_type = (type == events->forIPrimaryScreen().buttonDown()) ?
+							kButtonDown : kButtonUp;
+		m_id   = info->m_button;
+		m_mask = info->m_mask;
+	}
+	else if (type == events->forIKeyState().keyDown() ||
+			type == events->forIKeyState().keyUp() ||
+			type == events->forIKeyState().keyRepeat()) {
+		const IKeyState::KeyInfo* info =
+			static_cast<const IKeyState::KeyInfo*>(event.getData());
+		if (type == events->forIKeyState().keyDown()) {
+			m_type = kKeyDown;
+		}
+		else if (type == events->forIKeyState().keyUp()) {
+			m_type = kKeyUp;
+		}
+		else {
+			m_type = kKeyRepeat;
+		}
+		m_id     = info->m_key;
+		m_mask   = info->m_mask;
+		m_button = info->m_button;
+		m_count  = static_cast<UInt32>(info->m_count);
+		m_name   = IKeyState::KeyInfo::isDefault(info->m_screens) ?
+							"" : info->m_screens;
+	}
+	else if (type == events->forClipboard().clipboardGrabbed() ||
+			type == events->forClipboard().clipboardChanged()) {
+		const IScreen::ClipboardInfo* info =
+			static_cast<const IScreen::ClipboardInfo*>(event.getData());
+		m_type  = (type == events->forClipboard().clipboardGrabbed()) ?
+							kClipboardGrabbed : kClipboardChanged;
+		m_id    = info->m_id;
+		m_count = info->m_sequenceNumber;
+	}
+	else if (type == events->forServer().switchToScreen()) {
+		const Server::SwitchToScreenInfo* info =
+			static_cast<const Server::SwitchToScreenInfo*>(event.getData());
+		m_type = kSwitchToScreen;
+		m_name = info->m_screen;
+	}
+	else if (type == events->forServer().switchInDirection()) {
+		const Server::SwitchInDirectionInfo* info =
+			static_cast<const Server::SwitchInDirectionInfo*>(event.getData());
+		m_type = kSwitchInDirection;
+		m_id   = info->m_direction;
+	}
+	else if (type == events->forServer().keyboardBroadcast()) {
+		const Server::KeyboardBroadcastInfo* info =
+			static_cast<const Server::KeyboardBroadcastInfo*>(event.getData());
+		m_type = kKeyboardBroadcast;
+		m_id   = info->m_state;
+		m_name = info->m_screens;
+	}
+	else if (type == events->forServer().lockCursorToScreen()) {
+		const Server::LockCursorToScreenInfo* info =
+			static_cast<const Server::LockCursorToScreenInfo*>(event.getData());
+		m_type = kLockCursorToScreen;
+		m_id   = info->m_state;
+	}
+	else {
+		return false;
+	}
+	return true;
+}
+
+Event
+InputTraceRecord::makeEvent(IEventQueue* events,
+				void* primaryTarget, void* filterTarget) const
+{
+	switch (m_type) {
+	case kMotionOnPrimary:
+		return Event(events->forIPrimaryScreen().motionOnPrimary(),
+							primaryTarget,
+							IPrimaryScreen::MotionInfo::alloc(m_x, m_y));
+
+	case kMotionOnSecondary:
+		return Event(events->forIPrimaryScreen().motionOnSecondary(),
+							primaryTarget,
+							IPrimaryScreen::MotionInfo::alloc(m_x, m_y));
+
+	case kWheel:
+		return Event(events->forIPrimaryScreen().wheel(), primaryTarget,
+							IPrimaryScreen::WheelInfo::alloc(m_x, m_y));
+
+	case kButtonDown:
+	case kButtonUp:
+		return Event((m_type == kButtonDown) ?
+							events->forIPrimaryScreen().buttonDown() :
+							events->forIPrimaryScreen().buttonUp(),
+							filterTarget,
+							IPrimaryScreen::ButtonInfo::alloc(
+								static_cast<ButtonID>(m_id), m_mask));
+
+	case kKeyDown:
+	case kKeyUp:
+	case kKeyRepeat: {
+		Event::Type type;
+		if (m_type == kKeyDown) {
+			type = events->forIKeyState().keyDown();
+		}
+		else if (m_type == kKeyUp) {
+			type = events->forIKeyState().keyUp();
+		}
+		else {
+			type = events->forIKeyState().keyRepeat();
+		}
+		std::set<String> screens;
+		IKeyState::KeyInfo::split(m_name.c_str(), screens);
+		IKeyState::KeyInfo* info;
+		if (screens.empty()) {
+			info = IKeyState::KeyInfo::alloc(m_id, m_mask,
+							static_cast<KeyButton>(m_button),
+							static_cast<SInt32>(m_count));
+		}
+		else {
+			info = IKeyState::KeyInfo::alloc(m_id, m_mask,
+							static_cast<KeyButton>(m_button),
+							static_cast<SInt32>(m_count), screens);
+		}
+		return Event(type, filterTarget, info);
+	}
+
+	case kClipboardGrabbed:
+	case kClipboardChanged: {
+		IScreen::ClipboardInfo* info =
+			(IScreen::ClipboardInfo*)malloc(sizeof(IScreen::ClipboardInfo));
+		info->m_id             = static_cast<ClipboardID>(m_id);
+		info->m_sequenceNumber = m_count;
+		return Event((m_type == kClipboardGrabbed) ?
+							events->forClipboard().clipboardGrabbed() :
+							events->forClipboard().clipboardChanged(),
+							primaryTarget, info);
+	}
+
+	case kSwitchToScreen:
+		return Event(events->forServer().switchToScreen(), filterTarget,
+							Server::SwitchToScreenInfo::alloc(m_name));
+
+	case kSwitchInDirection:
+		return Event(events->forServer().switchInDirection(), filterTarget,
+							Server::SwitchInDirectionInfo::alloc(
+								static_cast<EDirection>(m_id)));
+
+	case kKeyboardBroadcast:
+		return Event(events->forServer().keyboardBroadcast(), filterTarget,
+							Server::KeyboardBroadcastInfo::alloc(
+								static_cast<Server::KeyboardBroadcastInfo::State>(m_id),
+								m_name));
+
+	case kLockCursorToScreen:
+		return Event(events->forServer().lockCursorToScreen(), filterTarget,
+							Server::LockCursorToScreenInfo::alloc(
+								static_cast<Server::LockCursorToScreenInfo::State>(m_id)));
+
+	default:
+		return Event();
+	}
+}
+
+//
+// InputTraceWriter
+//
+
+InputTraceWriter::InputTraceWriter() :
+	m_lastTime(0)
+{
+	// do nothing
+}
+
+InputTraceWriter::~InputTraceWriter()
+{
+	close();
+}
+
+bool
+InputTraceWriter::open(const String& filename, const Config& config,
+				const String& screen)
+{
+	close();
+	m_file.open(filename.c_str(), std::ios::out | std::ios::binary);
+	if (!m_file.is_open()) {
+		return false;
+	}
+
+	std::ostringstream configText;
+	configText << config;
+	m_file.write(kMagic, sizeof(kMagic) - 1);
+	m_file.put(static_cast<char>(kVersion));
+	writeString(m_file, configText.str());
+	writeString(m_file, screen);
+
+	m_time.reset();
+	m_lastTime = 0;
+	return !m_file.fail();
+}
+
+void
+InputTraceWriter::close()
+{
+	if (m_file.is_open()) {
+		m_file.close();
+	}
+}
+
+void
+InputTraceWriter::write(InputTraceRecord& record)
+{
+	record.m_time = static_cast<UInt64>(m_time.getTime() * 1000000.0);
+	if (record.m_time < m_lastTime) {
+		record.m_time = m_lastTime;
+	}
+
+	UInt32 fields = kFields[record.m_type];
+	m_file.put(static_cast<char>(record.m_type));
+	writeUInt(m_file, record.m_time - m_lastTime);
+	if ((fields & kFieldX) != 0) {
+		writeSInt(m_file, record.m_x);
+	}
+	if ((fields & kFieldY) != 0) {
+		writeSInt(m_file, record.m_y);
+	}
+	if ((fields & kFieldID) != 0) {
+		writeUInt(m_file, record.m_id);
+	}
+	if ((fields & kFieldMask) != 0) {
+		writeUInt(m_file, record.m_mask);
+	}
+	if ((fields & kFieldButton) != 0) {
+		writeUInt(m_file, record.m_button);
+	}
+	if ((fields & kFieldCount) != 0) {
+		writeUInt(m_file, record.m_count);
+	}
+	if ((fields & kFieldSize) != 0) {
+		writeUInt(m_file, record.m_size);
+	}
+	if ((fields & kFieldName) != 0) {
+		writeString(m_file, record.m_name);
+	}
+	m_lastTime = record.m_time;
+}
+
+bool
+InputTraceWriter::isOpen() const
+{
+	return m_file.is_open();
+}
+
+//
+// InputTraceReader
+//
+
+InputTraceReader::InputTraceReader() :
+	m_fileSize(0),
+	m_lastTime(0)
+{
+	// do nothing
+}
+
+InputTraceReader::~InputTraceReader()
+{
+	close();
+}
+
+bool
+InputTraceReader::open(const String& filename)
+{
+	close();
+	m_file.open(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!m_file.is_open()) {
+		return false;
+	}
+	m_file.seekg(0, std::ios::end);
+	std::streamoff fileSize = m_file.tellg();
+	m_file.seekg(0, std::ios::beg);
+	if (fileSize < 0) {
+		close();
+		return false;
+	}
+	m_fileSize = static_cast<UInt64>(fileSize);
+
+	char magic[sizeof(kMagic) - 1];
+	m_file.read(magic, sizeof(magic));
+	if (m_file.fail() || memcmp(magic, kMagic, sizeof(magic)) != 0 ||
+		m_file.get() != kVersion ||
+		!readString(m_file, m_config, m_fileSize) ||
+		!readString(m_file, m_screen, m_fileSize)) {
+		close();
+		return false;
+	}
+
+	m_lastTime = 0;
+	return true;
+}
+
+void
+InputTraceReader::close()
+{
+	if (m_file.is_open()) {
+		m_file.close();
+	}
+}
+
+bool
+InputTraceReader::read(InputTraceRecord& record)
+{
+	int type = m_file.get();
+	if (type == EOF || type >= InputTraceRecord::kNumTypes) {
+		return false;
+	}
+
+	record        = InputTraceRecord();
+	record.m_type = static_cast<InputTraceRecord::EType>(type);
+	UInt32 fields = kFields[type];
+	UInt64 delta;
+	if (!readUInt(m_file, delta) ||
+		((fields & kFieldX) != 0 && !readSInt(m_file, record.m_x)) ||
+		((fields & kFieldY) != 0 && !readSInt(m_file, record.m_y)) ||
+		((fields & kFieldID) != 0 && !readUInt(m_file, record.m_id)) ||
+		((fields & kFieldMask) != 0 && !readUInt(m_file, record.m_mask)) ||
+		((fields & kFieldButton) != 0 && !readUInt(m_file, record.m_button)) ||
+		((fields & kFieldCount) != 0 && !readUInt(m_file, record.m_count)) ||
+		((fields & kFieldSize) != 0 && !readUInt(m_file, record.m_size)) ||
+		((fields & kFieldName) != 0 && !readString(m_file, record.m_name, m_fileSize))) {
+		return false;
+	}
+	m_lastTime   += delta;
+	record.m_time = m_lastTime;
+	return true;
+}
+
+const String&
+InputTraceReader::getConfig() const
+{
+	return m_config;
+}
+
+const String&
+InputTraceReader::getScreen() const
+{
+	return m_screen;
+}
@@ -0,0 +1,204 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/Event.h"
+#include "base/Stopwatch.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+
+#include <fstream>
+
+class Config;
+class IEventQueue;
+
+//! Recorded input event
+/*!
+An input event from the primary screen, or an action on the server's
+input filter such as a screen switch, as recorded in an input trace.
+Which members are used depends on the type.
+*/
+class InputTraceRecord {
+public:
+	enum EType {
+		kMotionOnPrimary,		//!< m_x, m_y
+		kMotionOnSecondary,		//!< m_x, m_y
+		kWheel,					//!< m_x, m_y
+		kButtonDown,			//!< m_id, m_mask
+		kButtonUp,				//!< m_id, m_mask
+		kKeyDown,				//!< m_id, m_mask, m_button, m_count, m_name
+		kKeyUp,					//!< m_id, m_mask, m_button, m_count, m_name
+		kKeyRepeat,				//!< m_id, m_mask, m_button, m_count, m_name
+		kClipboardGrabbed,		//!< m_id, m_count
+		kClipboardChanged,		//!< m_id, m_count, m_size
+		kSwitchToScreen,		//!< m_name
+		kSwitchInDirection,		//!< m_id
+		kKeyboardBroadcast,		//!< m_id, m_name
+		kLockCursorToScreen,	//!< m_id
+		kNumTypes
+	};
+
+	InputTraceRecord();
+
+	//! @name manipulators
+	//@{
+
+	//! Set from event
+	/*!
+	Sets the type and members from \c event.  Returns false if events
+	of its type aren't recorded.  The size of clipboard data isn't part
+	of the event so it must be set afterwards.
+	*/
+	bool				set(IEventQueue* events, const Event& event);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Make event
+	/*!
+	Returns the event this record was set from.  Events from the
+	primary screen are sent to \c primaryTarget and actions to
+	\c filterTarget.
+	*/
+	Event				makeEvent(IEventQueue* events,
+							void* primaryTarget, void* filterTarget) const;
+
+	//@}
+
+public:
+	//! Microseconds since recording started
+	UInt64				m_time;
+	EType				m_type;
+	SInt32				m_x;
+	SInt32				m_y;
+	UInt32				m_id;
+	UInt32				m_mask;
+	UInt32				m_button;
+	UInt32				m_count;
+	UInt32				m_size;
+	String				m_name;
+};
+
+//! Input trace writer
+/*!
+Writes the input a server handles to a file, so it can be replayed to
+a server later, e.g. to benchmark it.  The file starts with the
+server's configuration and the name of its screen, then each record is
+a type byte, the time since the previous record and the members used by
+the type, all as variable length integers, so mouse motion takes a few
+bytes per event.
+
+Note that the trace has every key typed on the server's screen.
+*/
+class InputTraceWriter {
+public:
+	InputTraceWriter();
+	~InputTraceWriter();
+
+	//! @name manipulators
+	//@{
+
+	//! Open file
+	/*!
+	Creates \c filename and writes \c config and \c screen, the name of
+	the server's screen, to it.  Returns false if the file can't be
+	created.
+	*/
+	bool				open(const String& filename, const Config& config,
+							const String& screen);
+
+	//! Close file
+	void				close();
+
+	//! Write record
+	/*!
+	Sets the time of \c record to now and writes it.
+	*/
+	void				write(InputTraceRecord& record);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Test if open
+	bool				isOpen() const;
+
+	//@}
+
+private:
+	std::ofstream		m_file;
+	Stopwatch			m_time;
+	UInt64				m_lastTime;
+};
+
+//! Input trace reader
+/*!
+Reads a file written by InputTraceWriter.
+*/
+class InputTraceReader {
+public:
+	InputTraceReader();
+	~InputTraceReader();
+
+	//! @name manipulators
+	//@{
+
+	//! Open file
+	/*!
+	Opens \c filename and reads the configuration and screen name.
+	Returns false if the file can't be opened or isn't an input trace.
+	*/
+	bool				open(const String& filename);
+
+	//! Close file
+	void				close();
+
+	//! Read record
+	/*!
+	Reads the next record into \c record.  Returns false at the end of
+	the file or if the record is invalid.
+	*/
+	bool				read(InputTraceRecord& record);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get configuration
+	/*!
+	Returns the server's configuration as text, for reading into a
+	Config.
+	*/
+	const String&		getConfig() const;
+
+	//! Get screen name
+	/*!
+	Returns the name of the server's screen.
+	*/
+	const String&		getScreen() const;
+
+	//@}
+
+private:
+	std::ifstream		m_file;
+	UInt64				m_fileSize;
+	String				m_config;
+	String				m_screen;
+	UInt64				m_lastTime;
+};
@@ -0,0 +1,255 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/NeighborGraph.h"
+
+#include "server/Config.h"
+#include "synergy/option_types.h"
+#include "base/Log.h"
+
+#include <algorithm>
+
+//
+// NeighborGraph
+//
+
+NeighborGraph::NeighborGraph()
+{
+	// do nothing
+}
+
+NeighborGraph::~NeighborGraph()
+{
+	// do nothing
+}
+
+void
+NeighborGraph::compile(const Config& config, const ClientMap& clients)
+{
+	clear();
+
+	// one node per screen.  Config iterates canonical names.
+	std::map<String, size_t, synergy::string::CaselessCmp> nodeIndex;
+	for (Config::const_iterator index = config.begin();
+							index != config.end(); ++index) {
+		Node node;
+		node.m_name   = *index;
+		node.m_client = NULL;
+		ClientMap::const_iterator client = clients.find(node.m_name);
+		if (client != clients.end()) {
+			node.m_client = client->second;
+		}
+		getSwitchCorners(config, node.m_name,
+							node.m_switchCorners, node.m_switchCornerSize);
+		for (int i = 0; i < kNumDirections; ++i) {
+			EDirection dir = static_cast<EDirection>(i + kFirstDirection);
+			node.m_hasLinks[i] = config.hasNeighbor(node.m_name, dir);
+		}
+
+		nodeIndex.insert(std::make_pair(node.m_name, m_nodes.size()));
+		if (node.m_client != NULL) {
+			m_clientIndex.insert(std::make_pair(node.m_client, m_nodes.size()));
+		}
+		m_nodes.push_back(node);
+	}
+
+	// links.  the links of a cell are ordered by side then by the start
+	// of the interval and the intervals on a side never overlap, so
+	// each side's list comes out sorted and ready for binary search.
+	for (NodeList::iterator node = m_nodes.begin();
+							node != m_nodes.end(); ++node) {
+		for (Config::link_const_iterator
+							index = config.beginNeighbor(node->m_name),
+							end   = config.endNeighbor(node->m_name);
+							index != end; ++index) {
+			const Config::CellEdge& srcEdge = index->first;
+			const Config::CellEdge& dstEdge = index->second;
+			std::map<String, size_t, synergy::string::CaselessCmp>::
+				const_iterator dst = nodeIndex.find(
+								config.getCanonicalName(dstEdge.getName()));
+			if (dst == nodeIndex.end()) {
+				continue;
+			}
+
+			Link link;
+			link.m_start    = srcEdge.getInterval().first;
+			link.m_end      = srcEdge.getInterval().second;
+			link.m_dstStart = dstEdge.getInterval().first;
+			link.m_dstEnd   = dstEdge.getInterval().second;
+			link.m_dst      = dst->second;
+			node->m_links[srcEdge.getSide() - kFirstDirection].push_back(link);
+		}
+	}
+
+	LOG((CLOG_DEBUG1 "compiled neighbor graph: %d screens, %d connected", (int)m_nodes.size(), (int)m_clientIndex.size()));
+}
+
+void
+NeighborGraph::clear()
+{
+	m_nodes.clear();
+	m_clientIndex.clear();
+}
+
+BaseClientProxy*
+NeighborGraph::getNeighbor(const BaseClientProxy* src,
+				EDirection dir, float t, float& tOut) const
+{
+	assert(dir >= kFirstDirection && dir <= kLastDirection);
+
+	const Node* node = findNode(src);
+	if (node == NULL) {
+		return NULL;
+	}
+
+	// follow links until we reach a screen with a client.  there can't
+	// be more hops than screens unless the links loop through screens
+	// that aren't connected, in which case we'll never find one.
+	const Node* srcNode = node;
+	for (size_t hops = 0; hops < m_nodes.size(); ++hops) {
+		const Link* link = findLink(*node, dir, t);
+		if (link == NULL) {
+			LOG((CLOG_DEBUG2 "no neighbor on %s of \"%s\"", Config::dirName(dir), node->m_name.c_str()));
+			return NULL;
+		}
+
+		// map position onto the destination's interval
+		t = (t - link->m_start) / (link->m_end - link->m_start);
+		t = t * (link->m_dstEnd - link->m_dstStart) + link->m_dstStart;
+
+		const Node* dst = &m_nodes[link->m_dst];
+		if (dst->m_client != NULL) {
+			LOG((CLOG_DEBUG2 "\"%s\" is on %s of \"%s\" at %f", dst->m_name.c_str(), Config::dirName(dir), node->m_name.c_str(), t));
+			tOut = t;
+			return dst->m_client;
+		}
+
+		// skip over unconnected screen
+		LOG((CLOG_DEBUG2 "ignored \"%s\" on %s of \"%s\"", dst->m_name.c_str(), Config::dirName(dir), node->m_name.c_str()));
+		node = dst;
+	}
+
+	LOG((CLOG_DEBUG2 "no connected neighbor on %s of \"%s\"", Config::dirName(dir), srcNode->m_name.c_str()));
+	return NULL;
+}
+
+bool
+NeighborGraph::hasLink(const BaseClientProxy* src,
+				EDirection dir, float t) const
+{
+	assert(dir >= kFirstDirection && dir <= kLastDirection);
+
+	const Node* node = findNode(src);
+	return (node != NULL && findLink(*node, dir, t) != NULL);
+}
+
+bool
+NeighborGraph::hasAnyLink(const BaseClientProxy* src, EDirection dir) const
+{
+	assert(dir >= kFirstDirection && dir <= kLastDirection);
+
+	const Node* node = findNode(src);
+	return (node != NULL && node->m_hasLinks[dir - kFirstDirection]);
+}
+
+void
+NeighborGraph::getSwitchCorners(const BaseClientProxy* client,
+				UInt32& corners, SInt32& size) const
+{
+	const Node* node = findNode(client);
+	if (node == NULL) {
+		corners = 0;
+		size    = 0;
+	}
+	else {
+		corners = node->m_switchCorners;
+		size    = node->m_switchCornerSize;
+	}
+}
+
+const String&
+NeighborGraph::getName(const BaseClientProxy* client) const
+{
+	static const String s_noName;
+
+	const Node* node = findNode(client);
+	if (node == NULL) {
+		return s_noName;
+	}
+	return node->m_name;
+}
+
+void
+NeighborGraph::getSwitchCorners(const Config& config, const String& name,
+				UInt32& corners, SInt32& size)
+{
+	corners = 0;
+	size    = 0;
+
+	// screen options override the global options
+	const Config::ScreenOptions* options = config.getOptions(name);
+	if (options == NULL || options->count(kOptionScreenSwitchCorners) == 0) {
+		options = config.getOptions("");
+	}
+	if (options == NULL) {
+		return;
+	}
+
+	Config::ScreenOptions::const_iterator i =
+		options->find(kOptionScreenSwitchCorners);
+	if (i != options->end()) {
+		corners = static_cast<UInt32>(i->second);
+		i = options->find(kOptionScreenSwitchCornerSize);
+		if (i != options->end()) {
+			size = i->second;
+		}
+	}
+}
+
+bool
+NeighborGraph::isLinkBefore(float t, const Link& link)
+{
+	return (t < link.m_start);
+}
+
+const NeighborGraph::Node*
+NeighborGraph::findNode(const BaseClientProxy* client) const
+{
+	ClientIndex::const_iterator index = m_clientIndex.find(client);
+	if (index == m_clientIndex.end()) {
+		return NULL;
+	}
+	return &m_nodes[index->second];
+}
+
+const NeighborGraph::Link*
+NeighborGraph::findLink(const Node& node, EDirection dir, float t) const
+{
+	// find the last link starting at or before t and check that t is
+	// inside it.  this matches Config::Cell::getLink().
+	const LinkList& links = node.m_links[dir - kFirstDirection];
+	LinkList::const_iterator i =
+		std::upper_bound(links.begin(), links.end(), t, &isLinkBefore);
+	if (i == links.begin()) {
+		return NULL;
+	}
+	--i;
+	if (t >= i->m_start && t < i->m_end) {
+		return &*i;
+	}
+	return NULL;
+}
@@ -0,0 +1,148 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/protocol_types.h"
+#include "base/String.h"
+#include "common/stdmap.h"
+#include "common/stdvector.h"
+
+class BaseClientProxy;
+class Config;
+
+//! Compiled screen neighbor graph
+/*!
+This class holds the screen links of a Config compiled into a form
+that can be queried on the mouse motion path.  Screens are indexed by
+their client rather than by name and the links on each side of a
+screen are kept sorted by interval so finding the neighbor at a
+position is a binary search.  Queries never allocate.
+
+Screens in the configuration without a connected client are kept in
+the graph so links can be followed through them.  The graph is a
+snapshot;  it must be recompiled whenever the configuration or the
+set of connected clients changes.
+*/
+class NeighborGraph {
+public:
+	//! Clients indexed by canonical screen name
+	typedef std::map<String, BaseClientProxy*> ClientMap;
+
+	NeighborGraph();
+	~NeighborGraph();
+
+	//! @name manipulators
+	//@{
+
+	//! Compile graph
+	/*!
+	Replaces the graph with the screens and links in \c config.  Each
+	screen is attached to the client in \c clients with its canonical
+	name, if any.
+	*/
+	void				compile(const Config& config, const ClientMap& clients);
+
+	//! Clear graph
+	/*!
+	Removes all screens and links.
+	*/
+	void				clear();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get neighbor
+	/*!
+	Returns the closest connected client on side \c dir of \c src at
+	position \c t, where \c t is the fraction along that side in [0,1).
+	Screens without a connected client are skipped over.  Returns
+	\c NULL if there's no such client, otherwise saves the position on
+	the neighbor's opposite side in \c tOut.
+	*/
+	BaseClientProxy*	getNeighbor(const BaseClientProxy* src, EDirection dir,
+							float t, float& tOut) const;
+
+	//! Check for link
+	/*!
+	Returns \c true if \c src has a link on side \c dir at position
+	\c t, whether or not the linked screen has a connected client.
+	*/
+	bool				hasLink(const BaseClientProxy* src,
+							EDirection dir, float t) const;
+
+	//! Check for any link
+	/*!
+	Returns \c true if \c src has a link anywhere along side \c dir.
+	*/
+	bool				hasAnyLink(const BaseClientProxy* src,
+							EDirection dir) const;
+
+	//! Get switch corners
+	/*!
+	Returns the \c kOptionScreenSwitchCorners mask and corner size in
+	effect for \c client, taken from its screen options or, if they
+	don't set the corners, from the global options.  Both are zero if
+	no corners are locked.
+	*/
+	void				getSwitchCorners(const BaseClientProxy* client,
+							UInt32& corners, SInt32& size) const;
+
+	//! Get screen name
+	/*!
+	Returns the canonical screen name of \c client, or the empty
+	string if the client isn't in the graph.
+	*/
+	const String&		getName(const BaseClientProxy* client) const;
+
+	//@}
+
+private:
+	// a link from an interval on one side of a screen to an interval
+	// on the opposite side of screen m_dst (an index into m_nodes)
+	struct Link {
+	public:
+		float			m_start, m_end;
+		float			m_dstStart, m_dstEnd;
+		size_t			m_dst;
+	};
+	typedef std::vector<Link> LinkList;
+
+	struct Node {
+	public:
+		String			m_name;
+		BaseClientProxy*	m_client;
+		UInt32			m_switchCorners;
+		SInt32			m_switchCornerSize;
+		bool			m_hasLinks[kNumDirections];
+		LinkList		m_links[kNumDirections];
+	};
+	typedef std::vector<Node> NodeList;
+	typedef std::map<const BaseClientProxy*, size_t> ClientIndex;
+
+	static void			getSwitchCorners(const Config&, const String& name,
+							UInt32& corners, SInt32& size);
+	static bool			isLinkBefore(float t, const Link&);
+
+	const Node*			findNode(const BaseClientProxy*) const;
+	const Link*			findLink(const Node&, EDirection, float t) const;
+
+private:
+	NodeList			m_nodes;
+	ClientIndex			m_clientIndex;
+};
@@ -125,6 +125,12 @@ PrimaryClient::getCursorPos(SInt32& x, SInt32& y) const
 	m_screen->getCursorPos(x, y);
 }
 
+const IScreen::MonitorList&
+PrimaryClient::getMonitors() const
+{
+	return m_screen->getMonitors();
+}
+
 void
 PrimaryClient::enable()
 {
@@ -256,7 +262,7 @@ PrimaryClient::sendDragInfo(UInt32 fileCount, const char* info, size_t size)
 }
 
 void
-PrimaryClient::fileChunkSending(UInt8 mark, char* data, size_t dataSize)
+PrimaryClient::fileChunkSending(const FileChunk& chunk)
 {
 	// ignore
 }
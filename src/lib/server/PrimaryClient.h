@@ -122,6 +122,8 @@ public:
 	virtual void		getShape(SInt32& x, SInt32& y,
 							SInt32& width, SInt32& height) const;
 	virtual void		getCursorPos(SInt32& x, SInt32& y) const;
+	virtual const MonitorList&
+						getMonitors() const;
 
 	// IClient overrides
 	virtual void		enter(SInt32 xAbs, SInt32 yAbs,
@@ -144,7 +146,7 @@ public:
 	virtual void		resetOptions();
 	virtual void		setOptions(const OptionsList& options);
 	virtual void		sendDragInfo(UInt32 fileCount, const char* info, size_t size);
-	virtual void		fileChunkSending(UInt8 mark, char* data, size_t dataSize);
+	virtual void		fileChunkSending(const FileChunk& chunk);
 
 	virtual synergy::IStream*
 						getStream() const { return NULL; }
@@ -22,6 +22,7 @@
 #include "server/ClientProxyUnknown.h"
 #include "server/PrimaryClient.h"
 #include "server/ClientListener.h"
+#include "server/InputTrace.h"
 #include "synergy/FileChunk.h"
 #include "synergy/IPlatformScreen.h"
 #include "synergy/DropHelper.h"
@@ -42,6 +43,7 @@
 #include "base/TMethodJob.h"
 #include "base/IEventQueue.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
 #include "base/TMethodEventJob.h"
 #include "common/stdexcept.h"
 
@@ -51,6 +53,15 @@
 #include <fstream>
 #include <ctime>
 
+static void
+countScreens(size_t n)
+{
+	static MetricGauge* s_screens = Metrics::getInstance().getGauge(
+							"synergy_screens",
+							"Screens connected to the server, including its own.");
+	s_screens->set(static_cast<SInt64>(n));
+}
+
 //
 // Server
 //
@@ -69,6 +80,12 @@ Server::Server(
 	m_yDelta(0),
 	m_xDelta2(0),
 	m_yDelta2(0),
+	m_primaryShapeValid(false),
+	m_primaryX(0),
+	m_primaryY(0),
+	m_primaryW(0),
+	m_primaryH(0),
+	m_primaryJumpZone(0),
 	m_config(&config),
 	m_inputFilter(config.getInputFilter()),
 	m_activeSaver(NULL),
@@ -85,16 +102,21 @@ Server::Server(
 	m_switchNeedsAlt(false),
 	m_relativeMoves(false),
 	m_keyboardBroadcasting(false),
+	m_keyTargetsValid(false),
 	m_lockedToScreen(false),
 	m_screen(screen),
 	m_events(events),
+	m_fileTransfers(events, this),
+	m_fileReceiver(events, this),
 	m_sendFileThread(NULL),
 	m_writeToDropDirThread(NULL),
 	m_ignoreFileTransfer(false),
 	m_enableClipboard(true),
+	m_latencyTrace(false),
 	m_sendDragInfoThread(NULL),
 	m_waitDragInfoThread(true),
-	m_args(args)
+	m_args(args),
+	m_inputTrace(NULL)
 {
 	// must have a primary client and it must have a canonical name
 	assert(m_primaryClient != NULL);
@@ -112,7 +134,7 @@ Server::Server(
 			clipboard.m_clipboard.empty();
 			clipboard.m_clipboard.close();
 		}
-		clipboard.m_clipboardData   = clipboard.m_clipboard.marshall();
+		clipboard.m_clipboardHash   = clipboard.m_clipboard.getHash();
 	}
 
 	// install event handlers
@@ -215,6 +237,10 @@ Server::Server(
 
 Server::~Server()
 {
+	if (m_latencyTrace) {
+		LatencyTrace::setEnabled(false);
+	}
+
 	if (m_mock) {
 		return;
 	}
@@ -274,36 +300,61 @@ Server::setConfig(const Config& config)
 		return false;
 	}
 
+	// the first configuration is the one the server was created with
+	if (&config == m_config) {
+		processOptions();
+		compileNeighbors();
+		addLockToScreenHotKey(*m_config);
+
+		// tell primary screen about reconfiguration
+		m_primaryClient->reconfigure(getActivePrimarySides());
+
+		// tell all (connected) clients about current options
+		for (ClientList::const_iterator index = m_clients.begin();
+									index != m_clients.end(); ++index) {
+			BaseClientProxy* client = index->second;
+			sendOptions(client);
+		}
+		return true;
+	}
+
 	// close clients that are connected but being dropped from the
 	// configuration.
 	closeClients(config);
 
-	// cut over
-	processOptions();
+	// note what the remaining clients have before cutting over
+	typedef std::map<BaseClientProxy*, Config::ScreenOptions> ClientOptions;
+	ClientOptions oldOptions;
+	for (ClientList::const_iterator index = m_clients.begin();
+								index != m_clients.end(); ++index) {
+		getClientOptions(index->first, oldOptions[index->second]);
+	}
+	bool globalOptionsChanged =
+		(*m_config->getOptions("") != *config.getOptions(""));
+	UInt32 oldSides = getActivePrimarySides();
 
-	// add ScrollLock as a hotkey to lock to the screen.  this was a
-	// built-in feature in earlier releases and is now supported via
-	// the user configurable hotkey mechanism.  if the user has already
-	// registered ScrollLock for something else then that will win but
-	// we will unfortunately generate a warning.  if the user has
-	// configured a LockCursorToScreenAction then we don't add
-	// ScrollLock as a hotkey.
-	if (!m_config->hasLockToScreenAction()) {
-		IPlatformScreen::KeyInfo* key =
-			IPlatformScreen::KeyInfo::alloc(kKeyScrollLock, 0, 0, 0);
-		InputFilter::Rule rule(new InputFilter::KeystrokeCondition(m_events, key));
-		rule.adoptAction(new InputFilter::LockCursorToScreenAction(m_events), true);
-		m_inputFilter->addFilterRule(rule);
+	// cut over.  the filter must have the ScrollLock hotkey before
+	// comparing or it would always differ from the running one.
+	Config newConfig(config);
+	addLockToScreenHotKey(newConfig);
+	if (m_config->update(newConfig)) {
+		LOG((CLOG_DEBUG "input filter changed"));
 	}
+	if (globalOptionsChanged) {
+		processOptions();
+	}
+	compileNeighbors();
 
 	// tell primary screen about reconfiguration
-	m_primaryClient->reconfigure(getActivePrimarySides());
+	UInt32 sides = getActivePrimarySides();
+	if (sides != oldSides) {
+		m_primaryClient->reconfigure(sides);
+	}
 
-	// tell all (connected) clients about current options
-	for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-		BaseClientProxy* client = index->second;
-		sendOptions(client);
+	// tell clients about the options that changed for them
+	for (ClientOptions::const_iterator index = oldOptions.begin();
+								index != oldOptions.end(); ++index) {
+		sendChangedOptions(index->first, index->second);
 	}
 
 	return true;
@@ -379,6 +430,15 @@ Server::getClients(std::vector<String>& list) const
 	}
 }
 
+String
+Server::getScreenLabel(const String& name) const
+{
+	if (!m_config->isScreen(name)) {
+		return "unknown";
+	}
+	return m_config->getCanonicalName(name);
+}
+
 String
 Server::getName(const BaseClientProxy* client) const
 {
@@ -446,6 +506,75 @@ Server::getJumpZoneSize(BaseClientProxy* client) const
 	}
 }
 
+void
+Server::updatePrimaryShape()
+{
+	m_primaryClient->getShape(m_primaryX, m_primaryY,
+							m_primaryW, m_primaryH);
+	m_primaryJumpZone = m_primaryClient->getJumpZoneSize();
+	m_primaryMonitors = m_primaryClient->getMonitors();
+	m_primaryShapeValid = true;
+	LOG((CLOG_DEBUG1 "primary screen shape %d,%d %dx%d, %d monitor(s)", m_primaryX, m_primaryY, m_primaryW, m_primaryH, (int)m_primaryMonitors.size()));
+}
+
+static bool
+isOnMonitor(const IScreen::MonitorList& monitors, SInt32 x, SInt32 y)
+{
+	for (IScreen::MonitorList::const_iterator i = monitors.begin();
+							i != monitors.end(); ++i) {
+		if (x >= i->m_x && x < i->m_x + i->m_w &&
+			y >= i->m_y && y < i->m_y + i->m_h) {
+			return true;
+		}
+	}
+	return false;
+}
+
+UInt32
+Server::getPrimaryEdges(SInt32 x, SInt32 y,
+				SInt32& ax, SInt32& ay, SInt32& aw, SInt32& ah) const
+{
+	for (IScreen::MonitorList::const_iterator i = m_primaryMonitors.begin();
+							i != m_primaryMonitors.end(); ++i) {
+		if (x < i->m_x || x >= i->m_x + i->m_w ||
+			y < i->m_y || y >= i->m_y + i->m_h) {
+			continue;
+		}
+
+		// a side of the monitor is an edge of the screen unless
+		// another monitor continues past it at x,y.  monitors of
+		// different sizes leave parts of the screen's bounding box
+		// the cursor can't reach, so the bounding box's edges aren't
+		// always where the cursor stops.
+		ax = i->m_x;
+		ay = i->m_y;
+		aw = i->m_w;
+		ah = i->m_h;
+		UInt32 sides = 0;
+		if (!isOnMonitor(m_primaryMonitors, ax - 1, y)) {
+			sides |= kLeftMask;
+		}
+		if (!isOnMonitor(m_primaryMonitors, ax + aw, y)) {
+			sides |= kRightMask;
+		}
+		if (!isOnMonitor(m_primaryMonitors, x, ay - 1)) {
+			sides |= kTopMask;
+		}
+		if (!isOnMonitor(m_primaryMonitors, x, ay + ah)) {
+			sides |= kBottomMask;
+		}
+		return sides;
+	}
+
+	// not on any monitor, e.g. the monitors changed and the shape
+	// change hasn't been handled yet.  use the whole screen.
+	ax = m_primaryX;
+	ay = m_primaryY;
+	aw = m_primaryW;
+	ah = m_primaryH;
+	return kLeftMask | kRightMask | kTopMask | kBottomMask;
+}
+
 void
 Server::switchScreen(BaseClientProxy* dst,
 				SInt32 x, SInt32 y, bool forScreensaver)
@@ -584,12 +713,63 @@ Server::mapToPixel(BaseClientProxy* client,
 	}
 }
 
+void
+Server::compileNeighbors()
+{
+	m_neighbors.compile(*m_config, m_clients);
+}
+
+void
+Server::compileBroadcastTargets()
+{
+	m_clientSlots.clear();
+	for (ClientList::const_iterator index = m_clients.begin();
+								index != m_clients.end(); ++index) {
+		m_clientSlots.push_back(index->second);
+	}
+
+	// broadcasting without screens goes to every screen
+	const char* screens = m_keyboardBroadcastingScreens.c_str();
+	if (IKeyState::KeyInfo::isDefault(screens)) {
+		screens = "*";
+	}
+	resolveTargets(screens, m_broadcastTargets);
+	m_keyTargetsValid = false;
+}
+
+const std::vector<bool>&
+Server::getKeyTargets(const char* screens)
+{
+	// keys that don't name screens go to the broadcast screens
+	if (IKeyState::KeyInfo::isDefault(screens)) {
+		return m_broadcastTargets;
+	}
+
+	if (!m_keyTargetsValid || m_keyTargetsScreens != screens) {
+		resolveTargets(screens, m_keyTargets);
+		m_keyTargetsScreens = screens;
+		m_keyTargetsValid   = true;
+	}
+	return m_keyTargets;
+}
+
+void
+Server::resolveTargets(const char* screens, std::vector<bool>& targets) const
+{
+	targets.assign(m_clientSlots.size(), false);
+	size_t slot = 0;
+	for (ClientList::const_iterator index = m_clients.begin();
+								index != m_clients.end(); ++index, ++slot) {
+		targets[slot] = IKeyState::KeyInfo::contains(screens, index->first);
+	}
+}
+
 bool
 Server::hasAnyNeighbor(BaseClientProxy* client, EDirection dir) const
 {
 	assert(client != NULL);
 
-	return m_config->hasNeighbor(getName(client), dir);
+	return m_neighbors.hasAnyLink(client, dir);
 }
 
 BaseClientProxy*
@@ -600,44 +780,19 @@ Server::getNeighbor(BaseClientProxy* src,
 
 	assert(src != NULL);
 
-	// get source screen name
-	String srcName = getName(src);
-	assert(!srcName.empty());
-	LOG((CLOG_DEBUG2 "find neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str()));
+	LOG((CLOG_DEBUG2 "find neighbor on %s of \"%s\"", Config::dirName(dir), m_neighbors.getName(src).c_str()));
 
 	// convert position to fraction
 	float t = mapToFraction(src, dir, x, y);
 
-	// search for the closest neighbor that exists in direction dir
-	float tTmp;
-	for (;;) {
-		String dstName(m_config->getNeighbor(srcName, dir, t, &tTmp));
-
-		// if nothing in that direction then return NULL. if the
-		// destination is the source then we can make no more
-		// progress in this direction.  since we haven't found a
-		// connected neighbor we return NULL.
-		if (dstName.empty()) {
-			LOG((CLOG_DEBUG2 "no neighbor on %s of \"%s\"", Config::dirName(dir), srcName.c_str()));
-			return NULL;
-		}
-
-		// look up neighbor cell.  if the screen is connected and
-		// ready then we can stop.
-		ClientList::const_iterator index = m_clients.find(dstName);
-		if (index != m_clients.end()) {
-			LOG((CLOG_DEBUG2 "\"%s\" is on %s of \"%s\" at %f", dstName.c_str(), Config::dirName(dir), srcName.c_str(), t));
-			mapToPixel(index->second, dir, tTmp, x, y);
-			return index->second;
-		}
-
-		// skip over unconnected screen
-		LOG((CLOG_DEBUG2 "ignored \"%s\" on %s of \"%s\"", dstName.c_str(), Config::dirName(dir), srcName.c_str()));
-		srcName = dstName;
-
-		// use position on skipped screen
-		t = tTmp;
+	// search for the closest neighbor that exists in direction dir,
+	// skipping over screens that aren't connected
+	float tDst;
+	BaseClientProxy* dst = m_neighbors.getNeighbor(src, dir, t, tDst);
+	if (dst != NULL) {
+		mapToPixel(dst, dir, tDst, x, y);
 	}
+	return dst;
 }
 
 BaseClientProxy*
@@ -756,7 +911,6 @@ Server::avoidJumpZone(BaseClientProxy* dst,
 		return;
 	}
 
-	const String dstName(getName(dst));
 	SInt32 dx, dy, dw, dh;
 	dst->getShape(dx, dy, dw, dh);
 	float t = mapToFraction(dst, dir, x, y);
@@ -767,25 +921,25 @@ Server::avoidJumpZone(BaseClientProxy* dst,
 	// don't need to move inwards because that side can't provoke a jump.
 	switch (dir) {
 	case kLeft:
-		if (!m_config->getNeighbor(dstName, kRight, t, NULL).empty() &&
+		if (m_neighbors.hasLink(dst, kRight, t) &&
 			x > dx + dw - 1 - z)
 			x = dx + dw - 1 - z;
 		break;
 
 	case kRight:
-		if (!m_config->getNeighbor(dstName, kLeft, t, NULL).empty() &&
+		if (m_neighbors.hasLink(dst, kLeft, t) &&
 			x < dx + z)
 			x = dx + z;
 		break;
 
 	case kTop:
-		if (!m_config->getNeighbor(dstName, kBottom, t, NULL).empty() &&
+		if (m_neighbors.hasLink(dst, kBottom, t) &&
 			y > dy + dh - 1 - z)
 			y = dy + dh - 1 - z;
 		break;
 
 	case kBottom:
-		if (!m_config->getNeighbor(dstName, kTop, t, NULL).empty() &&
+		if (m_neighbors.hasLink(dst, kTop, t) &&
 			y < dy + z)
 			y = dy + z;
 		break;
@@ -800,7 +954,7 @@ Server::isSwitchOkay(BaseClientProxy* newScreen,
 				EDirection dir, SInt32 x, SInt32 y,
 				SInt32 xActive, SInt32 yActive)
 {
-	LOG((CLOG_DEBUG1 "try to leave \"%s\" on %s", getName(m_active).c_str(), Config::dirName(dir)));
+	LOG((CLOG_DEBUG1 "try to leave \"%s\" on %s", m_neighbors.getName(m_active).c_str(), Config::dirName(dir)));
 
 	// is there a neighbor?
 	if (newScreen == NULL) {
@@ -848,22 +1002,10 @@ Server::isSwitchOkay(BaseClientProxy* newScreen,
 
 	// are we in a locked corner?  first check if screen has the option set
 	// and, if not, check the global options.
-	const Config::ScreenOptions* options =
-						m_config->getOptions(getName(m_active));
-	if (options == NULL || options->count(kOptionScreenSwitchCorners) == 0) {
-		options = m_config->getOptions("");
-	}
-	if (options != NULL && options->count(kOptionScreenSwitchCorners) > 0) {
-		// get corner mask and size
-		Config::ScreenOptions::const_iterator i =
-			options->find(kOptionScreenSwitchCorners);
-		UInt32 corners = static_cast<UInt32>(i->second);
-		i = options->find(kOptionScreenSwitchCornerSize);
-		SInt32 size = 0;
-		if (i != options->end()) {
-			size = i->second;
-		}
-
+	UInt32 corners;
+	SInt32 size;
+	m_neighbors.getSwitchCorners(m_active, corners, size);
+	if (corners != 0) {
 		// see if we're in a locked corner
 		if ((getCorner(m_active, xActive, yActive, size) & corners) != 0) {
 			// yep, no switching
@@ -1127,6 +1269,74 @@ Server::sendOptions(BaseClientProxy* client) const
 	client->setOptions(optionsList);
 }
 
+void
+Server::getClientOptions(const String& name,
+				Config::ScreenOptions& options) const
+{
+	// global options are sent last so they win
+	options.clear();
+	const Config::ScreenOptions* screenOptions = m_config->getOptions(name);
+	if (screenOptions != NULL) {
+		options = *screenOptions;
+	}
+	const Config::ScreenOptions* globalOptions = m_config->getOptions("");
+	for (Config::ScreenOptions::const_iterator index = globalOptions->begin();
+								index != globalOptions->end(); ++index) {
+		options[index->first] = index->second;
+	}
+}
+
+void
+Server::sendChangedOptions(BaseClientProxy* client,
+				const Config::ScreenOptions& oldOptions) const
+{
+	Config::ScreenOptions options;
+	getClientOptions(getName(client), options);
+
+	// an option can't be removed without resetting them all
+	for (Config::ScreenOptions::const_iterator index = oldOptions.begin();
+								index != oldOptions.end(); ++index) {
+		if (options.count(index->first) == 0) {
+			sendOptions(client);
+			return;
+		}
+	}
+
+	OptionsList optionsList;
+	for (Config::ScreenOptions::const_iterator index = options.begin();
+								index != options.end(); ++index) {
+		Config::ScreenOptions::const_iterator old =
+			oldOptions.find(index->first);
+		if (old == oldOptions.end() || old->second != index->second) {
+			optionsList.push_back(index->first);
+			optionsList.push_back(static_cast<UInt32>(index->second));
+		}
+	}
+	if (!optionsList.empty()) {
+		LOG((CLOG_DEBUG "%d options changed for \"%s\"", optionsList.size() / 2, getName(client).c_str()));
+		client->setOptions(optionsList);
+	}
+}
+
+void
+Server::addLockToScreenHotKey(Config& config) const
+{
+	// add ScrollLock as a hotkey to lock to the screen.  this was a
+	// built-in feature in earlier releases and is now supported via
+	// the user configurable hotkey mechanism.  if the user has already
+	// registered ScrollLock for something else then that will win but
+	// we will unfortunately generate a warning.  if the user has
+	// configured a LockCursorToScreenAction then we don't add
+	// ScrollLock as a hotkey.
+	if (!config.hasLockToScreenAction()) {
+		IPlatformScreen::KeyInfo* key =
+			IPlatformScreen::KeyInfo::alloc(kKeyScrollLock, 0, 0, 0);
+		InputFilter::Rule rule(new InputFilter::KeystrokeCondition(m_events, key));
+		rule.adoptAction(new InputFilter::LockCursorToScreenAction(m_events), true);
+		config.getInputFilter()->addFilterRule(rule);
+	}
+}
+
 void
 Server::processOptions()
 {
@@ -1140,6 +1350,7 @@ Server::processOptions()
 	m_switchNeedsAlt = false;		// doesnt' work correct.
 
 	bool newRelativeMoves = m_relativeMoves;
+	bool latencyTrace     = false;
 	for (Config::ScreenOptions::const_iterator index = options->begin();
 								index != options->end(); ++index) {
 		const OptionID id       = index->first;
@@ -1177,6 +1388,14 @@ Server::processOptions()
 				LOG((CLOG_NOTE "clipboard sharing is disabled"));
 			}
 		}
+		else if (id == kOptionLatencyTrace) {
+			latencyTrace = (value != 0);
+		}
+	}
+	if (latencyTrace != m_latencyTrace) {
+		LOG((CLOG_NOTE "latency tracing is %s", latencyTrace ? "enabled" : "disabled"));
+		m_latencyTrace = latencyTrace;
+		LatencyTrace::setEnabled(latencyTrace);
 	}
 	if (m_relativeMoves && !newRelativeMoves) {
 		stopRelativeMoves();
@@ -1208,11 +1427,12 @@ Server::handleShapeChanged(const Event&, void* vclient)
 
 	// handle resolution change to primary screen
 	if (client == m_primaryClient) {
+		m_primaryShapeValid = false;
 		if (client == m_active) {
 			onMouseMovePrimary(m_x, m_y);
 		}
 		else {
-			onMouseMoveSecondary(0, 0);
+			onMouseMoveSecondary(0, 0, 0);
 		}
 	}
 }
@@ -1231,6 +1451,9 @@ Server::handleClipboardGrabbed(const Event& event, void* vclient)
 	}
 	const IScreen::ClipboardInfo* info =
 		static_cast<const IScreen::ClipboardInfo*>(event.getData());
+	if (grabber == m_primaryClient) {
+		recordInput(event);
+	}
 
 	// ignore grab if sequence number is old.  always allow primary
 	// screen to grab.
@@ -1251,7 +1474,7 @@ Server::handleClipboardGrabbed(const Event& event, void* vclient)
 		clipboard.m_clipboard.empty();
 		clipboard.m_clipboard.close();
 	}
-	clipboard.m_clipboardData = clipboard.m_clipboard.marshall();
+	clipboard.m_clipboardHash = clipboard.m_clipboard.getHash();
 
 	// tell all other screens to take ownership of clipboard.  tell the
 	// grabber that it's clipboard isn't dirty.
@@ -1278,35 +1501,49 @@ Server::handleClipboardChanged(const Event& event, void* vclient)
 	const IScreen::ClipboardInfo* info =
 		static_cast<const IScreen::ClipboardInfo*>(event.getData());
 	onClipboardChanged(sender, info->m_id, info->m_sequenceNumber);
+	if (sender == m_primaryClient) {
+		recordInput(event);
+	}
 }
 
 void
 Server::handleKeyDownEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	IPlatformScreen::KeyInfo* info =
 		static_cast<IPlatformScreen::KeyInfo*>(event.getData());
-	onKeyDown(info->m_key, info->m_mask, info->m_button, info->m_screens);
+	onKeyDown(info->m_key, info->m_mask, info->m_button, info->m_screens,
+				info->m_time);
 }
 
 void
 Server::handleKeyUpEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	IPlatformScreen::KeyInfo* info =
 		 static_cast<IPlatformScreen::KeyInfo*>(event.getData());
-	onKeyUp(info->m_key, info->m_mask, info->m_button, info->m_screens);
+	onKeyUp(info->m_key, info->m_mask, info->m_button, info->m_screens,
+				info->m_time);
 }
 
 void
 Server::handleKeyRepeatEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	IPlatformScreen::KeyInfo* info =
 		static_cast<IPlatformScreen::KeyInfo*>(event.getData());
-	onKeyRepeat(info->m_key, info->m_mask, info->m_count, info->m_button);
+	onKeyRepeat(info->m_key, info->m_mask, info->m_count, info->m_button,
+				info->m_time);
 }
 
 void
 Server::handleButtonDownEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	IPlatformScreen::ButtonInfo* info =
 		static_cast<IPlatformScreen::ButtonInfo*>(event.getData());
 	onMouseDown(info->m_button);
@@ -1315,6 +1552,8 @@ Server::handleButtonDownEvent(const Event& event, void*)
 void
 Server::handleButtonUpEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	IPlatformScreen::ButtonInfo* info =
 		static_cast<IPlatformScreen::ButtonInfo*>(event.getData());
 	onMouseUp(info->m_button);
@@ -1323,6 +1562,8 @@ Server::handleButtonUpEvent(const Event& event, void*)
 void
 Server::handleMotionPrimaryEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	IPlatformScreen::MotionInfo* info =
 		static_cast<IPlatformScreen::MotionInfo*>(event.getData());
 	onMouseMovePrimary(info->m_x, info->m_y);
@@ -1331,14 +1572,18 @@ Server::handleMotionPrimaryEvent(const Event& event, void*)
 void
 Server::handleMotionSecondaryEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	IPlatformScreen::MotionInfo* info =
 		static_cast<IPlatformScreen::MotionInfo*>(event.getData());
-	onMouseMoveSecondary(info->m_x, info->m_y);
+	onMouseMoveSecondary(info->m_x, info->m_y, info->m_time);
 }
 
 void
 Server::handleWheelEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	IPlatformScreen::WheelInfo* info =
 		static_cast<IPlatformScreen::WheelInfo*>(event.getData());
 	onMouseWheel(info->m_xDelta, info->m_yDelta);
@@ -1396,6 +1641,8 @@ Server::handleClientCloseTimeout(const Event&, void* vclient)
 void
 Server::handleSwitchToScreenEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	SwitchToScreenInfo* info =
 		static_cast<SwitchToScreenInfo*>(event.getData());
 
@@ -1411,6 +1658,8 @@ Server::handleSwitchToScreenEvent(const Event& event, void*)
 void
 Server::handleSwitchInDirectionEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	SwitchInDirectionInfo* info =
 		static_cast<SwitchInDirectionInfo*>(event.getData());
 
@@ -1429,6 +1678,8 @@ Server::handleSwitchInDirectionEvent(const Event& event, void*)
 void
 Server::handleKeyboardBroadcastEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	KeyboardBroadcastInfo* info = (KeyboardBroadcastInfo*)event.getData();
 
 	// choose new state
@@ -1453,6 +1704,7 @@ Server::handleKeyboardBroadcastEvent(const Event& event, void*)
 		info->m_screens != m_keyboardBroadcastingScreens) {
 		m_keyboardBroadcasting        = newState;
 		m_keyboardBroadcastingScreens = info->m_screens;
+		compileBroadcastTargets();
 		LOG((CLOG_DEBUG "keyboard broadcasting %s: %s", m_keyboardBroadcasting ? "on" : "off", m_keyboardBroadcastingScreens.c_str()));
 	}
 }
@@ -1460,6 +1712,8 @@ Server::handleKeyboardBroadcastEvent(const Event& event, void*)
 void
 Server::handleLockCursorToScreenEvent(const Event& event, void*)
 {
+	recordInput(event);
+
 	LockCursorToScreenInfo* info = (LockCursorToScreenInfo*)event.getData();
 
 	// choose new state
@@ -1534,15 +1788,15 @@ Server::onClipboardChanged(BaseClientProxy* sender,
 	sender->getClipboard(id, &clipboard.m_clipboard);
 
 	// ignore if data hasn't changed
-	String data = clipboard.m_clipboard.marshall();
-	if (data == clipboard.m_clipboardData) {
+	UInt64 hash = clipboard.m_clipboard.getHash();
+	if (hash == clipboard.m_clipboardHash) {
 		LOG((CLOG_DEBUG "ignored screen \"%s\" update of clipboard %d (unchanged)", clipboard.m_clipboardOwner.c_str(), id));
 		return;
 	}
 
 	// got new data
 	LOG((CLOG_INFO "screen \"%s\" updated clipboard %d", clipboard.m_clipboardOwner.c_str(), id));
-	clipboard.m_clipboardData = data;
+	clipboard.m_clipboardHash = hash;
 
 	// tell all clients except the sender that the clipboard is dirty
 	for (ClientList::const_iterator index = m_clients.begin();
@@ -1612,66 +1866,65 @@ Server::onScreensaver(bool activated)
 
 void
 Server::onKeyDown(KeyID id, KeyModifierMask mask, KeyButton button,
-				const char* screens)
+				const char* screens, UInt64 captureTime)
 {
 	LOG((CLOG_DEBUG1 "onKeyDown id=%d mask=0x%04x button=0x%04x", id, mask, button));
 	assert(m_active != NULL);
+	InputTime time = stampInput(captureTime);
 
 	// relay
 	if (!m_keyboardBroadcasting && IKeyState::KeyInfo::isDefault(screens)) {
+		m_active->traceInput(time);
 		m_active->keyDown(id, mask, button);
 	}
 	else {
-		if (!screens && m_keyboardBroadcasting) {
-			screens = m_keyboardBroadcastingScreens.c_str();
-			if (IKeyState::KeyInfo::isDefault(screens)) {
-				screens = "*";
-			}
-		}
-		for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-			if (IKeyState::KeyInfo::contains(screens, index->first)) {
-				index->second->keyDown(id, mask, button);
+		const std::vector<bool>& targets = getKeyTargets(screens);
+		for (size_t slot = 0; slot < targets.size(); ++slot) {
+			if (targets[slot]) {
+				m_clientSlots[slot]->traceInput(time);
+				m_clientSlots[slot]->broadcastKeyDown(id, mask, button,
+							m_broadcastMessages);
 			}
 		}
+		m_broadcastMessages.clear();
 	}
 }
 
 void
 Server::onKeyUp(KeyID id, KeyModifierMask mask, KeyButton button,
-				const char* screens)
+				const char* screens, UInt64 captureTime)
 {
 	LOG((CLOG_DEBUG1 "onKeyUp id=%d mask=0x%04x button=0x%04x", id, mask, button));
 	assert(m_active != NULL);
+	InputTime time = stampInput(captureTime);
 
 	// relay
 	if (!m_keyboardBroadcasting && IKeyState::KeyInfo::isDefault(screens)) {
+		m_active->traceInput(time);
 		m_active->keyUp(id, mask, button);
 	}
 	else {
-		if (!screens && m_keyboardBroadcasting) {
-			screens = m_keyboardBroadcastingScreens.c_str();
-			if (IKeyState::KeyInfo::isDefault(screens)) {
-				screens = "*";
-			}
-		}
-		for (ClientList::const_iterator index = m_clients.begin();
-								index != m_clients.end(); ++index) {
-			if (IKeyState::KeyInfo::contains(screens, index->first)) {
-				index->second->keyUp(id, mask, button);
+		const std::vector<bool>& targets = getKeyTargets(screens);
+		for (size_t slot = 0; slot < targets.size(); ++slot) {
+			if (targets[slot]) {
+				m_clientSlots[slot]->traceInput(time);
+				m_clientSlots[slot]->broadcastKeyUp(id, mask, button,
+							m_broadcastMessages);
 			}
 		}
+		m_broadcastMessages.clear();
 	}
 }
 
 void
 Server::onKeyRepeat(KeyID id, KeyModifierMask mask,
-				SInt32 count, KeyButton button)
+				SInt32 count, KeyButton button, UInt64 captureTime)
 {
 	LOG((CLOG_DEBUG1 "onKeyRepeat id=%d mask=0x%04x count=%d button=0x%04x", id, mask, count, button));
 	assert(m_active != NULL);
 
 	// relay
+	m_active->traceInput(stampInput(captureTime));
 	m_active->keyRepeat(id, mask, count, button);
 }
 
@@ -1738,42 +1991,48 @@ Server::onMouseMovePrimary(SInt32 x, SInt32 y)
 	m_x       = x;
 	m_y       = y;
 
-	// get screen shape
+	// get the edges of the monitor the cursor is on.  we're on the
+	// primary screen so use the cache.
+	if (!m_primaryShapeValid) {
+		updatePrimaryShape();
+	}
 	SInt32 ax, ay, aw, ah;
-	m_active->getShape(ax, ay, aw, ah);
-	SInt32 zoneSize = getJumpZoneSize(m_active);
+	const UInt32 sides = getPrimaryEdges(x, y, ax, ay, aw, ah);
+	const SInt32 zoneSize = m_primaryJumpZone;
 
 	// clamp position to screen
 	SInt32 xc = x, yc = y;
-	if (xc < ax + zoneSize) {
+	if ((sides & kLeftMask) != 0 && xc < ax + zoneSize) {
 		xc = ax;
 	}
-	else if (xc >= ax + aw - zoneSize) {
+	else if ((sides & kRightMask) != 0 && xc >= ax + aw - zoneSize) {
 		xc = ax + aw - 1;
 	}
-	if (yc < ay + zoneSize) {
+	if ((sides & kTopMask) != 0 && yc < ay + zoneSize) {
 		yc = ay;
 	}
-	else if (yc >= ay + ah - zoneSize) {
+	else if ((sides & kBottomMask) != 0 && yc >= ay + ah - zoneSize) {
 		yc = ay + ah - 1;
 	}
 
-	// see if we should change screens
+	// see if we should change screens.  neighbors are found from the
+	// whole screen so a monitor edge inside the screen's bounding box
+	// is moved out to the bounding box's edge.
 	EDirection dir;
-	if (x < ax + zoneSize) {
-		x  -= zoneSize;
+	if ((sides & kLeftMask) != 0 && x < ax + zoneSize) {
+		x  += m_primaryX - ax - zoneSize;
 		dir = kLeft;
 	}
-	else if (x >= ax + aw - zoneSize) {
-		x  += zoneSize;
+	else if ((sides & kRightMask) != 0 && x >= ax + aw - zoneSize) {
+		x  += m_primaryX + m_primaryW - ax - aw + zoneSize;
 		dir = kRight;
 	}
-	else if (y < ay + zoneSize) {
-		y  -= zoneSize;
+	else if ((sides & kTopMask) != 0 && y < ay + zoneSize) {
+		y  += m_primaryY - ay - zoneSize;
 		dir = kTop;
 	}
-	else if (y >= ay + ah - zoneSize) {
-		y  += zoneSize;
+	else if ((sides & kBottomMask) != 0 && y >= ay + ah - zoneSize) {
+		y  += m_primaryY + m_primaryH - ay - ah + zoneSize;
 		dir = kBottom;
 	}
 	else {
@@ -1860,7 +2119,7 @@ Server::sendDragInfo(BaseClientProxy* newScreen)
 }
 
 void
-Server::onMouseMoveSecondary(SInt32 dx, SInt32 dy)
+Server::onMouseMoveSecondary(SInt32 dx, SInt32 dy, UInt64 captureTime)
 {
 	LOG((CLOG_DEBUG2 "onMouseMoveSecondary %+d,%+d", dx, dy));
 
@@ -1870,6 +2129,7 @@ Server::onMouseMoveSecondary(SInt32 dx, SInt32 dy)
 		// stale event -- we're actually on the primary screen
 		return;
 	}
+	InputTime time = stampInput(captureTime);
 
 	// if doing relative motion on secondary screens and we're locked
 	// to the screen (which activates relative moves) then send a
@@ -1879,6 +2139,7 @@ Server::onMouseMoveSecondary(SInt32 dx, SInt32 dy)
 	// have no idea where it really is.
 	if (m_relativeMoves && isLockedToScreenServer()) {
 		LOG((CLOG_DEBUG2 "relative move on %s by %d,%d", getName(m_active).c_str(), dx, dy));
+		m_active->traceInput(time);
 		m_active->mouseRelativeMove(dx, dy);
 		return;
 	}
@@ -1989,7 +2250,7 @@ Server::onMouseMoveSecondary(SInt32 dx, SInt32 dy)
 
 	if (jump) {
 		if (m_sendFileThread != NULL) {
-			StreamChunker::interruptFile();
+			m_sendFileWindow.stopSenders();
 			m_sendFileThread = NULL;
 		}
 
@@ -2023,6 +2284,7 @@ Server::onMouseMoveSecondary(SInt32 dx, SInt32 dy)
 		// warp cursor if it moved.
 		if (m_x != xOld || m_y != yOld) {
 			LOG((CLOG_DEBUG2 "move on %s to %d,%d", getName(m_active).c_str(), m_x, m_y));
+			m_active->traceInput(time);
 			m_active->mouseMove(m_x, m_y);
 		}
 	}
@@ -2046,23 +2308,87 @@ Server::onFileChunkSending(const void* data)
 	LOG((CLOG_DEBUG1 "sending file chunk"));
 	assert(m_active != NULL);
 
-	// relay
-	m_active->fileChunkSending(chunk->m_chunk[0], &chunk->m_chunk[1], chunk->m_dataSize);
+	// relay.  queued chunks go to the client the file was queued for
+	// even if the cursor has moved on.
+	if (chunk->m_transferId == 0) {
+		m_active->fileChunkSending(*chunk);
+	}
+	else {
+		String name;
+		if (m_fileTransfers.relay(*chunk, name)) {
+			ClientList::const_iterator i = m_clients.find(name);
+			if (i != m_clients.end()) {
+				i->second->fileChunkSending(*chunk);
+			}
+		}
+	}
+	if (chunk->m_window != NULL) {
+		chunk->m_window->relayed();
+	}
 }
 
 void
 Server::onFileRecieveCompleted()
 {
 	if (isReceivedFileSizeValid()) {
+		// the thread takes over the temporary file so receiving the
+		// next file can't replace it before it's been moved into place
+		String* tempPath = new String(m_receivedFile.detach());
 		m_writeToDropDirThread = new Thread(
-									   new TMethodJob<Server>(
-															   this, &Server::writeToDropDirThread));
+			new TMethodJob<Server>(
+				this, &Server::writeToDropDirThread,
+				static_cast<void*>(tempPath)));
+	}
+	else if (m_fileReceiver.startDrop()) {
+		Thread thread(
+			new TMethodJob<Server>(
+				this, &Server::dropReceivedFilesThread));
 	}
 }
 
+InputTime
+Server::stampInput(UInt64 captureTime) const
+{
+	InputTime time;
+	if (captureTime != 0) {
+		time.m_captured = captureTime;
+		time.m_handled  = LatencyTrace::now();
+	}
+	return time;
+}
+
 void
-Server::writeToDropDirThread(void*)
+Server::recordInput(const Event& event)
 {
+	if (m_inputTrace == NULL) {
+		return;
+	}
+
+	InputTraceRecord record;
+	if (!record.set(m_events, event)) {
+		return;
+	}
+	if (record.m_type == InputTraceRecord::kClipboardChanged) {
+		// the replay needs the amount of data, not the data itself
+		Clipboard& clipboard = m_clipboards[record.m_id].m_clipboard;
+		if (clipboard.open(0)) {
+			for (SInt32 format = 0; format < IClipboard::kNumFormats; ++format) {
+				IClipboard::EFormat f = static_cast<IClipboard::EFormat>(format);
+				if (clipboard.has(f)) {
+					record.m_size += static_cast<UInt32>(clipboard.get(f).size());
+				}
+			}
+			clipboard.close();
+		}
+	}
+	m_inputTrace->write(record);
+}
+
+void
+Server::writeToDropDirThread(void* data)
+{
+	String* tempPath = static_cast<String*>(data);
+
 	LOG((CLOG_DEBUG "starting write to drop dir thread"));
 
 	while (m_screen->isFakeDraggingStarted()) {
@@ -2070,7 +2396,28 @@ Server::writeToDropDirThread(void*)
 	}
 
 	DropHelper::writeToDir(m_screen->getDropTarget(), m_fakeDragFileList,
-					m_receivedFileData);
+					*tempPath);
+	delete tempPath;
+}
+
+void
+Server::dropReceivedFilesThread(void*)
+{
+	LOG((CLOG_DEBUG "starting drop received files thread"));
+
+	while (m_screen->isFakeDraggingStarted()) {
+		ARCH->sleep(.1f);
+	}
+
+	// files that complete while this runs are dropped too
+	FileReceiver::CompletedList files;
+	while (m_fileReceiver.takeCompleted(files)) {
+		for (size_t i = 0; i < files.size(); ++i) {
+			DropHelper::writeToDir(m_screen->getDropTarget(),
+							files[i].m_name, files[i].m_tempPath);
+		}
+		files.clear();
+	}
 }
 
 bool
@@ -2098,6 +2445,14 @@ Server::addClient(BaseClientProxy* client)
 	// add to list
 	m_clientSet.insert(client);
 	m_clients.insert(std::make_pair(name, client));
+	compileNeighbors();
+	compileBroadcastTargets();
+	countScreens(m_clients.size());
+
+	// resume files queued before the client disconnected
+	if (client->isFileQueueSupported()) {
+		m_fileTransfers.connected(name);
+	}
 
 	// initialize client data
 	SInt32 x, y;
@@ -2130,6 +2485,13 @@ Server::removeClient(BaseClientProxy* client)
 	// remove from list
 	m_clients.erase(getName(client));
 	m_clientSet.erase(i);
+	compileNeighbors();
+	compileBroadcastTargets();
+	countScreens(m_clients.size());
+
+	if (client->isFileQueueSupported()) {
+		m_fileTransfers.disconnected(getName(client));
+	}
 
 	return true;
 }
@@ -2269,7 +2631,7 @@ Server::forceLeaveClient(BaseClientProxy* client)
 
 Server::ClipboardInfo::ClipboardInfo() :
 	m_clipboard(),
-	m_clipboardData(),
+	m_clipboardHash(0),
 	m_clipboardOwner(),
 	m_clipboardSeqNum(0)
 {
@@ -2347,14 +2709,19 @@ Server::KeyboardBroadcastInfo::alloc(State state, const String& screens)
 bool
 Server::isReceivedFileSizeValid()
 {
-	return m_expectedFileSize == m_receivedFileData.size();
+	return m_receivedFile.isComplete();
 }
 
 void
 Server::sendFileToClient(const char* filename)
 {
+	if (m_active->isFileQueueSupported()) {
+		m_fileTransfers.add(filename, getName(m_active));
+		return;
+	}
+
 	if (m_sendFileThread != NULL) {
-		StreamChunker::interruptFile();
+		m_sendFileWindow.stopSenders();
 	}
 
 	m_sendFileThread = new Thread(
@@ -2363,13 +2730,25 @@ Server::sendFileToClient(const char* filename)
 			static_cast<void*>(const_cast<char*>(filename))));
 }
 
+void
+Server::setInputTrace(InputTraceWriter* trace)
+{
+	m_inputTrace = trace;
+}
+
+void
+Server::fileTransferAccepted(UInt32 id, UInt64 offset)
+{
+	m_fileTransfers.accept(id, offset);
+}
+
 void
 Server::sendFileThread(void* data)
 {
 	try {
 		char* filename = static_cast<char*>(data);
 		LOG((CLOG_DEBUG "sending file to client, filename=%s", filename));
-		StreamChunker::sendFile(filename, m_events, this);
+		StreamChunker::sendFile(filename, m_events, this, m_sendFileWindow);
 	}
 	catch (std::runtime_error error) {
 		LOG((CLOG_ERR "failed sending file chunks, error: %s", error.what()));
@@ -18,13 +18,21 @@
 
 #pragma once
 
+#include "server/BroadcastMessages.h"
 #include "server/Config.h"
+#include "server/NeighborGraph.h"
 #include "synergy/clipboard_types.h"
 #include "synergy/Clipboard.h"
 #include "synergy/key_types.h"
 #include "synergy/mouse_types.h"
 #include "synergy/INode.h"
+#include "synergy/IScreen.h"
 #include "synergy/DragInformation.h"
+#include "synergy/DropFile.h"
+#include "synergy/FileReceiver.h"
+#include "synergy/FileTransferQueue.h"
+#include "synergy/FileWindow.h"
+#include "synergy/LatencyTrace.h"
 #include "synergy/ServerArgs.h"
 #include "base/Event.h"
 #include "base/Stopwatch.h"
@@ -37,6 +45,7 @@ class BaseClientProxy;
 class EventQueueTimer;
 class PrimaryClient;
 class InputFilter;
+class InputTraceWriter;
 namespace synergy { class Screen; }
 class IEventQueue;
 class Thread;
@@ -111,7 +120,8 @@ public:
 	~Server();
 
 #ifdef TEST_ENV
-	Server() : m_mock(true), m_config(NULL) { }
+	Server() : m_mock(true), m_config(NULL),
+		m_fileTransfers(NULL, this), m_fileReceiver(NULL, this) { }
 	void setActive(BaseClientProxy* active) {	m_active = active; }
 #endif
 
@@ -123,6 +133,9 @@ public:
 	Change the server's configuration.  Returns true iff the new
 	configuration was accepted (it must include the server's name).
 	This will disconnect any clients no longer in the configuration.
+	Only what differs from the current configuration is changed so
+	the other clients keep their state and are only sent the options
+	that changed for them.
 	*/
 	bool				setConfig(const Config&);
 
@@ -142,14 +155,29 @@ public:
 	*/
 	void				disconnect();
 
-	//! Create a new thread and use it to send file to client
+	//! Send file to client
+	/*!
+	Queues the file or directory \c filename for sending to the active
+	client.  Clients that don't support the file queue get the file on a
+	new thread instead, and only one file at a time.
+	*/
 	void				sendFileToClient(const char* filename);
 
+	//! Queued file accepted by client
+	void				fileTransferAccepted(UInt32 id, UInt64 offset);
+
 	//! Received dragging information from client
 	void				dragInfoReceived(UInt32 fileNum, String content);
 
 	//! Store ClientListener pointer
 	void				setListener(ClientListener* p) { m_clientListener = p; }
+
+	//! Record input
+	/*!
+	Writes the input the server handles to \p trace from now on, or
+	stops recording if \p trace is NULL.  The trace is not adopted.
+	*/
+	void				setInputTrace(InputTraceWriter* trace);
 	
 	//@}
 	//! @name accessors
@@ -166,19 +194,28 @@ public:
 	Set the \c list to the names of the currently connected clients.
 	*/
 	void				getClients(std::vector<String>& list) const;
+
+	//! Get a screen's metrics label
+	/*!
+	Returns the canonical name of screen \c name, or "unknown" if it's
+	not in the configuration.  Metrics are labelled with this, so a
+	screen's series are reused when it reconnects and clients sending
+	arbitrary names can't add series without limit.
+	*/
+	String				getScreenLabel(const String& name) const;
 	
 	//! Return true if recieved file size is valid
 	bool				isReceivedFileSizeValid();
 
-	//! Return expected file data size
-	size_t&				getExpectedFileSize() { return m_expectedFileSize; }
-
-	//! Return received file data
-	String&				getReceivedFileData() { return m_receivedFileData; }
+	//! Return file being received
+	DropFile&			getReceivedFile() { return m_receivedFile; }
 
 	//! Return fake drag file list
 	DragFileList		getFakeDragFileList() { return m_fakeDragFileList; }
 
+	//! Return receiver of queued files
+	FileReceiver&		getFileReceiver() { return m_fileReceiver; }
+
 	//@}
 
 private:
@@ -200,6 +237,17 @@ private:
 	// returns the jump zone of the client
 	SInt32				getJumpZoneSize(BaseClientProxy*) const;
 
+	// cache the primary screen's shape, monitors and jump zone size
+	void				updatePrimaryShape();
+
+	// find the edges of the primary screen near x,y.  returns the rect
+	// of the monitor under x,y in ax,ay,aw,ah and a mask of its sides
+	// that are edges of the screen at x,y, i.e. that have no monitor
+	// beyond them.  uses the cached shape.
+	UInt32				getPrimaryEdges(SInt32 x, SInt32 y,
+							SInt32& ax, SInt32& ay,
+							SInt32& aw, SInt32& ah) const;
+
 	// change the active screen
 	void				switchScreen(BaseClientProxy*,
 							SInt32 x, SInt32 y, bool forScreenSaver);
@@ -217,6 +265,23 @@ private:
 	void				mapToPixel(BaseClientProxy*, EDirection, float f,
 							SInt32& x, SInt32& y) const;
 
+	// recompile m_neighbors from the configuration and clients
+	void				compileNeighbors();
+
+	// renumber the client slots and resolve the broadcast screens
+	// against them.  call whenever the clients or the broadcast
+	// screens change.
+	void				compileBroadcastTargets();
+
+	// the client slots a key goes to when broadcasting or when it
+	// names its own screens
+	const std::vector<bool>&
+						getKeyTargets(const char* screens);
+
+	// set the slots of the clients named in screens
+	void				resolveTargets(const char* screens,
+							std::vector<bool>& targets) const;
+
 	// returns true if the client has a neighbor anywhere along the edge
 	// indicated by the direction.
 	bool				hasAnyNeighbor(BaseClientProxy*, EDirection) const;
@@ -287,6 +352,18 @@ private:
 	// send screen options to \c client
 	void				sendOptions(BaseClientProxy* client) const;
 
+	// get the options for the screen \c name, including the global
+	// options, as the client has them after sendOptions()
+	void				getClientOptions(const String& name,
+							Config::ScreenOptions& options) const;
+
+	// send \c client the options that differ from \c oldOptions
+	void				sendChangedOptions(BaseClientProxy* client,
+							const Config::ScreenOptions& oldOptions) const;
+
+	// add ScrollLock as a hotkey to \c config's input filter if needed
+	void				addLockToScreenHotKey(Config& config) const;
+
 	// process options from configuration
 	void				processOptions();
 
@@ -321,18 +398,27 @@ private:
 							ClipboardID id, UInt32 seqNum);
 	void				onScreensaver(bool activated);
 	void				onKeyDown(KeyID, KeyModifierMask, KeyButton,
-							const char* screens);
+							const char* screens, UInt64 captureTime);
 	void				onKeyUp(KeyID, KeyModifierMask, KeyButton,
-							const char* screens);
-	void				onKeyRepeat(KeyID, KeyModifierMask, SInt32, KeyButton);
+							const char* screens, UInt64 captureTime);
+	void				onKeyRepeat(KeyID, KeyModifierMask, SInt32, KeyButton,
+							UInt64 captureTime);
 	void				onMouseDown(ButtonID);
 	void				onMouseUp(ButtonID);
 	bool				onMouseMovePrimary(SInt32 x, SInt32 y);
-	void				onMouseMoveSecondary(SInt32 dx, SInt32 dy);
+	void				onMouseMoveSecondary(SInt32 dx, SInt32 dy,
+							UInt64 captureTime);
 	void				onMouseWheel(SInt32 xDelta, SInt32 yDelta);
 	void				onFileChunkSending(const void* data);
 	void				onFileRecieveCompleted();
 
+	// get the times of an input event captured at captureTime and
+	// handled now, for latency tracing
+	InputTime			stampInput(UInt64 captureTime) const;
+
+	// write an input event to the input trace, if recording
+	void				recordInput(const Event&);
+
 	// add client to list and attach event handlers for client
 	bool				addClient(BaseClientProxy*);
 
@@ -362,6 +448,9 @@ private:
 	// thread function for writing file to drop directory
 	void				writeToDropDirThread(void*);
 
+	// thread function for moving queued files to the drop directory
+	void				dropReceivedFilesThread(void*);
+
 	// thread function for sending drag information
 	void				sendDragInfoThread(void*);
 
@@ -378,7 +467,7 @@ private:
 
 	public:
 		Clipboard		m_clipboard;
-		String			m_clipboardData;
+		UInt64			m_clipboardHash;
 		String			m_clipboardOwner;
 		UInt32			m_clipboardSeqNum;
 	};
@@ -413,9 +502,22 @@ private:
 	SInt32				m_xDelta, m_yDelta;
 	SInt32				m_xDelta2, m_yDelta2;
 
+	// primary screen geometry.  this is cached on the first mouse motion
+	// after the primary screen's shape changes so mouse motion on the
+	// primary screen is handled without querying the screen.
+	bool				m_primaryShapeValid;
+	SInt32				m_primaryX, m_primaryY;
+	SInt32				m_primaryW, m_primaryH;
+	SInt32				m_primaryJumpZone;
+	IScreen::MonitorList	m_primaryMonitors;
+
 	// current configuration
 	Config*				m_config;
 
+	// screen links from m_config compiled against m_clients.  this is
+	// recompiled whenever either changes.
+	NeighborGraph		m_neighbors;
+
 	// input filter (from m_config);
 	InputFilter*		m_inputFilter;
 
@@ -456,6 +558,20 @@ private:
 	bool				m_keyboardBroadcasting;
 	String				m_keyboardBroadcastingScreens;
 
+	// m_clients by slot, in name order, and the slots of the broadcast
+	// screens.  broadcast keys go to the set slots.  m_keyTargets holds
+	// the slots for the screens named by the last key that named its
+	// own, m_keyTargetsScreens, since hotkeys repeat the same screens.
+	std::vector<BaseClientProxy*>	m_clientSlots;
+	std::vector<bool>	m_broadcastTargets;
+	std::vector<bool>	m_keyTargets;
+	String				m_keyTargetsScreens;
+	bool				m_keyTargetsValid;
+
+	// protocol messages of the key being broadcast, built once for
+	// all its targets
+	BroadcastMessages	m_broadcastMessages;
+
 	// screen locking (former scroll lock)
 	bool				m_lockedToScreen;
 
@@ -465,19 +581,25 @@ private:
 	IEventQueue*		m_events;
 
 	// file transfer
-	size_t				m_expectedFileSize;
-	String				m_receivedFileData;
+	FileTransferQueue	m_fileTransfers;
+	FileReceiver		m_fileReceiver;
+	DropFile			m_receivedFile;
 	DragFileList		m_dragFileList;
 	DragFileList		m_fakeDragFileList;
+	FileWindow			m_sendFileWindow;
 	Thread*				m_sendFileThread;
 	Thread*				m_writeToDropDirThread;
 	String				m_dragFileExt;
 	bool				m_ignoreFileTransfer;
 	bool				m_enableClipboard;
+	bool				m_latencyTrace;
 
 	Thread*				m_sendDragInfoThread;
 	bool				m_waitDragInfoThread;
 
 	ClientListener*		m_clientListener;
 	ServerArgs			m_args;
+
+	// input recording
+	InputTraceWriter*	m_inputTrace;
 };
@@ -25,8 +25,10 @@
 #include "base/XBase.h"
 #include "arch/XArch.h"
 #include "base/log_outputters.h"
+#include "base/AllocationTracker.h"
 #include "synergy/XSynergy.h"
 #include "synergy/ArgsBase.h"
+#include "synergy/MetricsServer.h"
 #include "ipc/IpcServerProxy.h"
 #include "base/TMethodEventJob.h"
 #include "ipc/IpcMessage.h"
@@ -64,7 +66,8 @@ App::App(IEventQueue* events, CreateTaskBarReceiverFunc createTaskBarReceiver, A
 	m_args(args),
 	m_createTaskBarReceiver(createTaskBarReceiver),
 	m_appUtil(events),
-	m_ipcClient(nullptr)
+	m_ipcClient(nullptr),
+	m_metricsServer(NULL)
 {
 	assert(s_instance == nullptr);
 	s_instance = this;
@@ -190,6 +193,11 @@ App::initApp(int argc, const char** argv)
 	// setup file logging after parsing args
 	setupFileLogging();
 
+	// log where memory is allocated from when asked
+	if (AllocationTracker::isEnabled()) {
+		ARCH->setSignalHandler(Arch::kUSER, &allocationsSignalHandler, NULL);
+	}
+
 	// load configuration
 	loadConfig();
 
@@ -225,6 +233,31 @@ App::cleanupIpcClient()
 	delete m_ipcClient;
 }
 
+void
+App::initMetricsServer()
+{
+	if (argsBase().m_metricsPort == 0) {
+		return;
+	}
+
+	m_metricsServer = new MetricsServer(m_events, m_socketMultiplexer,
+							argsBase().m_metricsPort);
+	try {
+		m_metricsServer->listen();
+	}
+	catch (XBase& e) {
+		LOG((CLOG_WARN "cannot serve metrics: %s", e.what()));
+		cleanupMetricsServer();
+	}
+}
+
+void
+App::cleanupMetricsServer()
+{
+	delete m_metricsServer;
+	m_metricsServer = NULL;
+}
+
 void
 App::handleIpcMessage(const Event& e, void*)
 {
@@ -235,6 +268,12 @@ App::handleIpcMessage(const Event& e, void*)
     }
 }
 
+void
+App::allocationsSignalHandler(Arch::ESignal, void*)
+{
+	LOG((CLOG_NOTE "%s", AllocationTracker::format().c_str()));
+}
+
 void
 App::runEventsLoop(void*)
 {
@@ -38,6 +38,7 @@ class FileLogOutputter;
 namespace synergy { class Screen; }
 class IEventQueue;
 class SocketMultiplexer;
+class MetricsServer;
 
 typedef IArchTaskBarReceiver* (*CreateTaskBarReceiverFunc)(const BufferedLogOutputter*, IEventQueue* events);
 
@@ -102,10 +103,13 @@ public:
 
 private:
 	void				handleIpcMessage(const Event&, void*);
+	static void			allocationsSignalHandler(Arch::ESignal, void*);
 
 protected:
 	void				initIpcClient();
 	void				cleanupIpcClient();
+	void				initMetricsServer();
+	void				cleanupMetricsServer();
 	void				runEventsLoop(void*);
 
 	IArchTaskBarReceiver* m_taskBarReceiver;
@@ -120,6 +124,7 @@ private:
 	ARCH_APP_UTIL m_appUtil;
 	IpcClient*			m_ipcClient;
 	SocketMultiplexer*	m_socketMultiplexer;
+	MetricsServer*		m_metricsServer;
 };
 
 class MinimalApp : public App {
@@ -164,7 +169,9 @@ private:
 	"  -l  --log <file>         write log messages to file.\n" \
 	"      --no-tray            disable the system tray icon.\n" \
 	"      --enable-drag-drop   enable file drag & drop.\n" \
-	"      --enable-crypto      enable the crypto (ssl) plugin.\n"
+	"      --enable-crypto      enable the crypto (ssl) plugin.\n" \
+	"      --metrics-port <port>\n" \
+	"                             serve metrics for prometheus on localhost.\n"
 
 #define HELP_COMMON_INFO_2 \
 	"  -h, --help               display this help and exit.\n" \
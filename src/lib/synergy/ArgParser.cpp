@@ -57,6 +57,10 @@ ArgParser::parseServerArgs(ServerArgs& args, int argc, const char* const* argv)
 			// save configuration file path
 			args.m_configFile = argv[++i];
 		}
+		else if (isArg(i, argc, argv, NULL, "--record-input", 1)) {
+			// save input trace file path
+			args.m_inputTraceFile = argv[++i];
+		}
 		else {
 			LOG((CLOG_PRINT "%s: unrecognized option `%s'" BYE, args.m_pname, argv[i], args.m_pname));
 			return false;
@@ -238,6 +242,9 @@ ArgParser::parseGenericArgs(int argc, const char* const* argv, int& i)
 	else if (isArg(i, argc, argv, NULL, "--config-dir", 1)) {
 		argsBase().m_configDirectory = argv[++i];
 	}
+	else if (isArg(i, argc, argv, NULL, "--metrics-port", 1)) {
+		argsBase().m_metricsPort = atoi(argv[++i]);
+	}
 	else {
 		// option not supported here
 		return false;
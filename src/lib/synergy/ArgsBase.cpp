@@ -42,8 +42,9 @@ m_enableIpc(false),
 m_enableDragDrop(false),
 m_shouldExit(false),
 m_synergyAddress(),
-m_enableCrypto(false)/*,
-m_configDirectory("")*/
+m_enableCrypto(false),
+/*m_configDirectory(""),*/
+m_metricsPort(0)
 {
 }
 
@@ -50,4 +50,5 @@ public:
 	String				m_synergyAddress;
 	bool				m_enableCrypto;
 	String				m_configDirectory;
+	int					m_metricsPort;
 };
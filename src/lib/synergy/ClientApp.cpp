@@ -464,6 +464,9 @@ ClientApp::mainLoop()
 		initIpcClient();
 	}
 
+	// metrics are only served when asked for
+	initMetricsServer();
+
 	// run event loop.  if startClient() failed we're supposed to retry
 	// later.  the timer installed by startClient() will take care of
 	// that.
@@ -497,6 +500,7 @@ ClientApp::mainLoop()
 	if (argsBase().m_enableIpc) {
 		cleanupIpcClient();
 	}
+	cleanupMetricsServer();
 
 	return kExitSuccess;
 }
@@ -18,6 +18,8 @@
 
 #include "synergy/Clipboard.h"
 
+#include "synergy/ContentHash.h"
+
 //
 // Clipboard
 //
@@ -45,6 +47,7 @@ Clipboard::empty()
 	for (SInt32 index = 0; index < kNumFormats; ++index) {
 		m_data[index]  = "";
 		m_added[index] = false;
+		m_hash[index]  = 0;
 	}
 
 	// save time
@@ -64,6 +67,7 @@ Clipboard::add(EFormat format, const String& data)
 
 	m_data[format]  = data;
 	m_added[format] = true;
+	m_hash[format]  = ContentHash::hash(data.data(), data.size());
 }
 
 bool
@@ -116,3 +120,31 @@ Clipboard::marshall() const
 {
 	return IClipboard::marshall(this);
 }
+
+UInt64
+Clipboard::getHash() const
+{
+	// hash each format and its data's hash as little endian bytes so
+	// the result doesn't depend on the machine's byte order
+	ContentHash hash;
+	for (UInt32 format = 0; format != kNumFormats; ++format) {
+		if (m_added[format]) {
+			UInt8 buffer[12];
+			for (int i = 0; i < 4; ++i) {
+				buffer[i] = static_cast<UInt8>((format >> (8 * i)) & 0xff);
+			}
+			for (int i = 0; i < 8; ++i) {
+				buffer[4 + i] =
+					static_cast<UInt8>((m_hash[format] >> (8 * i)) & 0xff);
+			}
+			hash.update(buffer, sizeof(buffer));
+		}
+	}
+	return hash.digest();
+}
+
+UInt64
+Clipboard::getHash(EFormat format) const
+{
+	return m_hash[format];
+}
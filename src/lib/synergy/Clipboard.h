@@ -50,6 +50,26 @@ public:
 	*/
 	String				marshall() const;
 
+	//! Get content hash
+	/*!
+	Returns a hash of the formats and data in the clipboard.  Two
+	clipboards with the same hash marshall to the same data with high
+	probability, not with certainty.  Callers that skip work on the
+	hash alone accept the small risk of a collision; callers that
+	can't must also compare the data.  The hash of each format is
+	computed as the format is added so this doesn't look at the data
+	again.
+	*/
+	UInt64				getHash() const;
+
+	//! Get content hash of format
+	/*!
+	Returns the ContentHash of the data of \c format, or 0 if the
+	clipboard doesn't have that format.  Equal hashes mean equal data
+	with high probability only, as for getHash().
+	*/
+	UInt64				getHash(EFormat format) const;
+
 	//@}
 
 	// IClipboard overrides
@@ -68,4 +88,5 @@ private:
 	Time				m_timeOwned;
 	bool				m_added[kNumFormats];
 	String				m_data[kNumFormats];
+	UInt64				m_hash[kNumFormats];
 };
@@ -0,0 +1,101 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ClipboardCache.h"
+
+#include "synergy/Clipboard.h"
+
+//
+// ClipboardCache
+//
+
+ClipboardCache::ClipboardCache(size_t maxSize) :
+	m_maxSize(maxSize),
+	m_size(0)
+{
+	// do nothing
+}
+
+void
+ClipboardCache::add(IClipboard::EFormat format, UInt64 hash,
+				const String& data)
+{
+	Key key(format, hash);
+	EntryMap::iterator i = m_index.find(key);
+	if (i != m_index.end()) {
+		// already cached, just note it was used
+		m_entries.splice(m_entries.begin(), m_entries, i->second);
+		return;
+	}
+	if (data.size() > m_maxSize) {
+		return;
+	}
+
+	// make room
+	while (m_size + data.size() > m_maxSize) {
+		Entry& last = m_entries.back();
+		m_size -= last.m_data.size();
+		m_index.erase(last.m_key);
+		m_entries.pop_back();
+	}
+
+	m_entries.push_front(Entry());
+	m_entries.front().m_key  = key;
+	m_entries.front().m_data = data;
+	m_index[key] = m_entries.begin();
+	m_size += data.size();
+}
+
+void
+ClipboardCache::add(const Clipboard& clipboard)
+{
+	clipboard.open(0);
+	for (SInt32 index = 0; index < IClipboard::kNumFormats; ++index) {
+		IClipboard::EFormat format = static_cast<IClipboard::EFormat>(index);
+		if (clipboard.has(format)) {
+			add(format, clipboard.getHash(format), clipboard.get(format));
+		}
+	}
+	clipboard.close();
+}
+
+bool
+ClipboardCache::get(IClipboard::EFormat format, UInt64 hash, String& data)
+{
+	EntryMap::iterator i = m_index.find(Key(format, hash));
+	if (i == m_index.end()) {
+		return false;
+	}
+
+	m_entries.splice(m_entries.begin(), m_entries, i->second);
+	data = i->second->m_data;
+	return true;
+}
+
+void
+ClipboardCache::clear()
+{
+	m_entries.clear();
+	m_index.clear();
+	m_size = 0;
+}
+
+size_t
+ClipboardCache::getSize() const
+{
+	return m_size;
+}
@@ -0,0 +1,103 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/IClipboard.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "common/stdlist.h"
+#include "common/stdmap.h"
+
+class Clipboard;
+
+//! Cache of clipboard format data
+/*!
+Keeps the data of recently seen clipboard formats, found by format
+and ContentHash, so an offered format that was seen before doesn't
+have to be sent again.  When the cache holds more than its maximum
+size the least recently used data is dropped.
+*/
+class ClipboardCache {
+public:
+	enum {
+		//! Default maximum size of the cached data
+		kMaxSize = 32 * 1024 * 1024
+	};
+
+	ClipboardCache(size_t maxSize = kMaxSize);
+
+	//! @name manipulators
+	//@{
+
+	//! Add format data
+	/*!
+	Caches \c data of \c format, whose ContentHash is \c hash.  Data
+	bigger than the maximum size isn't cached.
+	*/
+	void				add(IClipboard::EFormat format, UInt64 hash,
+							const String& data);
+
+	//! Add clipboard
+	/*!
+	Caches the data of all formats of \c clipboard.
+	*/
+	void				add(const Clipboard& clipboard);
+
+	//! Get format data
+	/*!
+	Saves the cached data of \c format with ContentHash \c hash in
+	\c data and returns true, or returns false if it isn't cached.
+	The data is found by its hash alone so a hash collision returns
+	the wrong data; that risk is accepted to avoid sending the data.
+	*/
+	bool				get(IClipboard::EFormat format, UInt64 hash,
+							String& data);
+
+	//! Empty cache
+	void				clear();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get size
+	/*!
+	Returns the size of the cached data.
+	*/
+	size_t				getSize() const;
+
+	//@}
+
+private:
+	typedef std::pair<IClipboard::EFormat, UInt64> Key;
+	class Entry {
+	public:
+		Key				m_key;
+		String			m_data;
+	};
+	typedef std::list<Entry> EntryList;
+	typedef std::map<Key, EntryList::iterator> EntryMap;
+
+private:
+	size_t				m_maxSize;
+	size_t				m_size;
+
+	// most recently used first
+	EntryList			m_entries;
+	EntryMap			m_index;
+};
@@ -17,13 +17,17 @@
 
 #include "synergy/ClipboardChunk.h"
 
+#include "synergy/PayloadCompressor.h"
 #include "synergy/ProtocolUtil.h"
 #include "synergy/protocol_types.h"
 #include "io/IStream.h"
 #include "base/Log.h"
+#include "base/Metrics.h"
 #include <cstring>
 
-size_t ClipboardChunk::s_expectedSize = 0;
+// most room reserved for clipboard data before it arrives, so a bogus
+// size from the other side can't make us reserve a huge buffer
+static const size_t		kMaxReserve = 16 * 1024 * 1024;
 
 ClipboardChunk::ClipboardChunk(size_t size) :
 	Chunk(size)
@@ -86,6 +90,7 @@ ClipboardChunk::end(ClipboardID id, UInt32 sequence)
 int
 ClipboardChunk::assemble(synergy::IStream* stream,
 					String& dataCached,
+					size_t& expectedSize,
 					ClipboardID& id,
 					UInt32& sequence)
 {
@@ -97,58 +102,51 @@ ClipboardChunk::assemble(synergy::IStream* stream,
 	}
 	
 	if (mark == kDataStart) {
-		s_expectedSize = synergy::string::stringToSizeType(data);
+		expectedSize = synergy::string::stringToSizeType(data);
 		LOG((CLOG_DEBUG "start receiving clipboard data"));
 		dataCached.clear();
+		dataCached.reserve(expectedSize < kMaxReserve ? expectedSize : kMaxReserve);
 		return kStart;
 	}
 	else if (mark == kDataChunk) {
+		if (data.size() > expectedSize - dataCached.size()) {
+			LOG((CLOG_ERR "corrupted clipboard data, more than expected size=%d", (int)expectedSize));
+			return kError;
+		}
 		dataCached.append(data);
 		return kNotFinish;
 	}
+	else if (mark == kDataCompressed) {
+		String decompressed;
+		if (!PayloadCompressor::decompress(data.data(), data.size(),
+							decompressed)) {
+			LOG((CLOG_ERR "corrupted compressed clipboard data"));
+			return kError;
+		}
+		if (decompressed.size() > expectedSize - dataCached.size()) {
+			LOG((CLOG_ERR "corrupted clipboard data, more than expected size=%d", (int)expectedSize));
+			return kError;
+		}
+		dataCached.append(decompressed);
+		return kNotFinish;
+	}
 	else if (mark == kDataEnd) {
 		// validate
 		if (id >= kClipboardEnd) {
 			return kError;
 		}
-		else if (s_expectedSize != dataCached.size()) {
-			LOG((CLOG_ERR "corrupted clipboard data, expected size=%d actual size=%d", s_expectedSize, dataCached.size()));
+		else if (expectedSize != dataCached.size()) {
+			LOG((CLOG_ERR "corrupted clipboard data, expected size=%d actual size=%d", (int)expectedSize, (int)dataCached.size()));
 			return kError;
 		}
+
+		static MetricCounter* s_bytes = Metrics::getInstance().getCounter(
+							"synergy_clipboard_received_bytes_total",
+							"Clipboard bytes received, after decompression.");
+		s_bytes->add(dataCached.size());
 		return kFinish;
 	}
 
 	LOG((CLOG_ERR "clipboard transmission failed: unknown error"));
 	return kError;
 }
-
-void
-ClipboardChunk::send(synergy::IStream* stream, void* data)
-{
-	ClipboardChunk* clipboardData = static_cast<ClipboardChunk*>(data);
-
-	LOG((CLOG_DEBUG1 "sending clipboard chunk"));
-
-	char* chunk = clipboardData->m_chunk;
-	ClipboardID id = chunk[0];
-	UInt32 sequence;
-	std::memcpy (&sequence, &chunk[1], 4);
-	UInt8 mark = chunk[5];
-	String dataChunk(&chunk[6], clipboardData->m_dataSize);
-
-	switch (mark) {
-	case kDataStart:
-		LOG((CLOG_DEBUG2 "sending clipboard chunk start: size=%s", dataChunk.c_str()));
-		break;
-
-	case kDataChunk:
-		LOG((CLOG_DEBUG2 "sending clipboard chunk data: size=%i", dataChunk.size()));
-		break;
-
-	case kDataEnd:
-		LOG((CLOG_DEBUG2 "sending clipboard finished"));
-		break;
-	}
-
-	ProtocolUtil::writef(stream, kMsgDClipboard, id, sequence, mark, &dataChunk);
-}
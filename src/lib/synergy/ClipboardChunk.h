@@ -45,16 +45,17 @@ public:
 	static ClipboardChunk*
 						end(ClipboardID id, UInt32 sequence);
 
+	//! Assemble clipboard
+	/*!
+	Reads a kMsgDClipboard chunk from \c stream and adds its data to
+	\c dataCached.  \c dataCached and \c expectedSize belong to the
+	connection:  the start chunk saves the size of the clipboard in
+	\c expectedSize and reserves room for the data in \c dataCached.
+	*/
 	static int			assemble(
 							synergy::IStream* stream,
 							String& dataCached,
+							size_t& expectedSize,
 							ClipboardID& id,
 							UInt32& sequence);
-
-	static void			send(synergy::IStream* stream, void* data);
-
-	static size_t		getExpectedSize() { return s_expectedSize; }
-
-private:
-	static size_t		s_expectedSize;
 };
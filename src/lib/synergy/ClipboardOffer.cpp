@@ -0,0 +1,109 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ClipboardOffer.h"
+
+#include "synergy/Clipboard.h"
+
+// each format is sent as the format, the size and the high and low
+// halves of the hash
+static const size_t		kFieldsPerFormat = 4;
+
+//
+// ClipboardOffer
+//
+
+ClipboardOffer::ClipboardOffer()
+{
+	// do nothing
+}
+
+void
+ClipboardOffer::set(const Clipboard& clipboard)
+{
+	m_formats.clear();
+
+	clipboard.open(0);
+	for (SInt32 index = 0; index < IClipboard::kNumFormats; ++index) {
+		IClipboard::EFormat format = static_cast<IClipboard::EFormat>(index);
+		if (clipboard.has(format)) {
+			Format offered;
+			offered.m_format = format;
+			offered.m_size   = static_cast<UInt32>(clipboard.get(format).size());
+			offered.m_hash   = clipboard.getHash(format);
+			m_formats.push_back(offered);
+		}
+	}
+	clipboard.close();
+}
+
+bool
+ClipboardOffer::unmarshall(const std::vector<UInt32>& data)
+{
+	m_formats.clear();
+	if (data.size() % kFieldsPerFormat != 0) {
+		return false;
+	}
+
+	for (size_t i = 0; i < data.size(); i += kFieldsPerFormat) {
+		// each format may only be offered once
+		if (data[i] >= static_cast<UInt32>(IClipboard::kNumFormats) ||
+			find(static_cast<IClipboard::EFormat>(data[i])) != NULL) {
+			m_formats.clear();
+			return false;
+		}
+
+		Format offered;
+		offered.m_format = static_cast<IClipboard::EFormat>(data[i]);
+		offered.m_size   = data[i + 1];
+		offered.m_hash   = (static_cast<UInt64>(data[i + 2]) << 32) | data[i + 3];
+		m_formats.push_back(offered);
+	}
+	return true;
+}
+
+void
+ClipboardOffer::marshall(std::vector<UInt32>& data) const
+{
+	data.clear();
+	data.reserve(m_formats.size() * kFieldsPerFormat);
+	for (FormatList::const_iterator i = m_formats.begin();
+								i != m_formats.end(); ++i) {
+		data.push_back(static_cast<UInt32>(i->m_format));
+		data.push_back(i->m_size);
+		data.push_back(static_cast<UInt32>(i->m_hash >> 32));
+		data.push_back(static_cast<UInt32>(i->m_hash));
+	}
+}
+
+const ClipboardOffer::FormatList&
+ClipboardOffer::getFormats() const
+{
+	return m_formats;
+}
+
+const ClipboardOffer::Format*
+ClipboardOffer::find(IClipboard::EFormat format) const
+{
+	for (FormatList::const_iterator i = m_formats.begin();
+								i != m_formats.end(); ++i) {
+		if (i->m_format == format) {
+			return &*i;
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,87 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/IClipboard.h"
+#include "common/basic_types.h"
+#include "common/stdvector.h"
+
+class Clipboard;
+
+//! Clipboard offer
+/*!
+Describes the formats of a clipboard without their data:  the size
+and ContentHash of each format.  The primary screen sends an offer
+instead of the clipboard and the secondary screen asks for the data
+of the formats it doesn't already have when it needs them.
+*/
+class ClipboardOffer {
+public:
+	//! Offered format
+	class Format {
+	public:
+		IClipboard::EFormat	m_format;
+		UInt32			m_size;
+		UInt64			m_hash;
+	};
+	typedef std::vector<Format> FormatList;
+
+	ClipboardOffer();
+
+	//! @name manipulators
+	//@{
+
+	//! Describe clipboard
+	/*!
+	Replaces the offer with the formats of \c clipboard.
+	*/
+	void				set(const Clipboard& clipboard);
+
+	//! Unmarshall offer
+	/*!
+	Replaces the offer with the one in \c data, the list of a
+	kMsgDClipboardOffer message.  Returns false if the list is
+	malformed, leaving the offer empty.
+	*/
+	bool				unmarshall(const std::vector<UInt32>& data);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Marshall offer
+	/*!
+	Saves the offer in \c data, the list of a kMsgDClipboardOffer
+	message.
+	*/
+	void				marshall(std::vector<UInt32>& data) const;
+
+	//! Get formats
+	const FormatList&	getFormats() const;
+
+	//! Find format
+	/*!
+	Returns the offered \c format or NULL if it isn't offered.
+	*/
+	const Format*		find(IClipboard::EFormat format) const;
+
+	//@}
+
+private:
+	FormatList			m_formats;
+};
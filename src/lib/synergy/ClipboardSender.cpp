@@ -0,0 +1,178 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ClipboardSender.h"
+
+#include "synergy/PayloadCompressor.h"
+#include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_types.h"
+#include "io/IStream.h"
+#include "base/Log.h"
+#include "base/Metrics.h"
+
+#include <cstring>
+
+// code, clipboard id, sequence number, mark and data size
+static const size_t		kHeaderSize = 4 + 1 + 4 + 1 + 4;
+
+//
+// ClipboardSender
+//
+
+ClipboardSender::ClipboardSender(synergy::IStream* stream) :
+	m_stream(stream)
+{
+	// do nothing
+}
+
+ClipboardSender::~ClipboardSender()
+{
+	// do nothing
+}
+
+void
+ClipboardSender::send(ClipboardID id, UInt32 sequence,
+				String& data, bool compress)
+{
+	bool idle = m_transfers.empty();
+
+	m_transfers.push_back(Transfer());
+	Transfer& transfer   = m_transfers.back();
+	transfer.m_id        = id;
+	transfer.m_sequence  = sequence;
+	transfer.m_offset    = 0;
+	transfer.m_started   = false;
+	transfer.m_compress  = compress;
+	transfer.m_data.swap(data);
+
+	// otherwise the stream hasn't flushed the clipboard before this
+	// one and flushed() will get to it
+	if (idle) {
+		m_keepAliveTimer.reset();
+		writeChunks();
+	}
+}
+
+void
+ClipboardSender::flushed()
+{
+	writeChunks();
+}
+
+bool
+ClipboardSender::isSending() const
+{
+	return !m_transfers.empty();
+}
+
+void
+ClipboardSender::writeChunks()
+{
+	if (m_transfers.empty()) {
+		return;
+	}
+
+	// sending is paced by the stream so only keep the other side
+	// waiting for a clipboard alive when it's taking a while
+	if (m_keepAliveTimer.getTime() >= kKeepAliveRate) {
+		ProtocolUtil::writef(m_stream, kMsgCKeepAlive);
+		m_keepAliveTimer.reset();
+	}
+
+	size_t written = 0;
+	while (!m_transfers.empty() && written < kChunksAhead * kChunkSize) {
+		Transfer& transfer = m_transfers.front();
+		if (!transfer.m_started) {
+			String size = synergy::string::sizeTypeToString(
+							transfer.m_data.size());
+			LOG((CLOG_DEBUG2 "sending clipboard chunk start: size=%s", size.c_str()));
+			writeChunk(transfer, kDataStart, size.data(), size.size());
+			transfer.m_started = true;
+		}
+
+		size_t remaining = transfer.m_data.size() - transfer.m_offset;
+		if (remaining > 0) {
+			size_t size = (remaining < kChunkSize) ? remaining : kChunkSize;
+			LOG((CLOG_DEBUG2 "sending clipboard chunk data: size=%i", (int)size));
+			writeChunk(transfer, kDataChunk,
+							transfer.m_data.data() + transfer.m_offset, size);
+			transfer.m_offset += size;
+			written           += size;
+		}
+
+		if (transfer.m_offset == transfer.m_data.size()) {
+			writeChunk(transfer, kDataEnd, NULL, 0);
+			LOG((CLOG_DEBUG "sent clipboard size=%d", (int)transfer.m_data.size()));
+			countSent(transfer);
+			m_transfers.pop_front();
+		}
+	}
+
+	// don't hold on to chunk sized buffers between clipboards
+	if (m_transfers.empty()) {
+		std::vector<UInt8>().swap(m_message);
+		String().swap(m_compressed);
+	}
+}
+
+void
+ClipboardSender::countSent(const Transfer& transfer)
+{
+	static MetricCounter* s_bytes = Metrics::getInstance().getCounter(
+							"synergy_clipboard_sent_bytes_total",
+							"Clipboard bytes sent, before compression.");
+	static MetricHistogram* s_time = Metrics::getInstance().getHistogram(
+							"synergy_clipboard_send_seconds",
+							"Time from queueing a clipboard to writing its last chunk.");
+
+	s_bytes->add(transfer.m_data.size());
+	s_time->add(static_cast<UInt64>(transfer.m_time.getTime() * 1.0e6));
+}
+
+void
+ClipboardSender::writeChunk(const Transfer& transfer, UInt8 mark,
+				const char* data, size_t size)
+{
+	if (mark == kDataChunk && transfer.m_compress &&
+		PayloadCompressor::compress(data, size, m_compressed)) {
+		LOG((CLOG_DEBUG2 "compressed clipboard chunk: size=%i", (int)m_compressed.size()));
+		mark = kDataCompressed;
+		data = m_compressed.data();
+		size = m_compressed.size();
+	}
+
+	// build the message ProtocolUtil::writef() would for kMsgDClipboard
+	// with a single copy of the data
+	m_message.resize(kHeaderSize + size);
+	UInt8* dst = &m_message[0];
+	memcpy(dst, kMsgDClipboard, 4);
+	dst += 4;
+	*dst++ = static_cast<UInt8>(transfer.m_id);
+	*dst++ = static_cast<UInt8>((transfer.m_sequence >> 24) & 0xff);
+	*dst++ = static_cast<UInt8>((transfer.m_sequence >> 16) & 0xff);
+	*dst++ = static_cast<UInt8>((transfer.m_sequence >>  8) & 0xff);
+	*dst++ = static_cast<UInt8>( transfer.m_sequence        & 0xff);
+	*dst++ = mark;
+	*dst++ = static_cast<UInt8>((size >> 24) & 0xff);
+	*dst++ = static_cast<UInt8>((size >> 16) & 0xff);
+	*dst++ = static_cast<UInt8>((size >>  8) & 0xff);
+	*dst++ = static_cast<UInt8>( size        & 0xff);
+	if (size > 0) {
+		memcpy(dst, data, size);
+	}
+	m_stream->write(&m_message[0], static_cast<UInt32>(m_message.size()));
+}
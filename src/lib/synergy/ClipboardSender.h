@@ -0,0 +1,119 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/clipboard_types.h"
+#include "base/Stopwatch.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "common/stdlist.h"
+#include "common/stdvector.h"
+
+namespace synergy {
+class IStream;
+};
+
+//! Paced clipboard sender
+/*!
+Sends clipboards over a stream as kMsgDClipboard chunks.  Each chunk
+is written straight from its slice of the marshalled clipboard and
+only a few chunks are written ahead of the stream, so a big clipboard
+doesn't pile up in the stream's output buffer:  call flushed() when
+the stream has sent its output to write the next ones.  Clipboards
+are sent in the order they were queued.
+
+While a clipboard takes longer than the keep alive rate to send, a
+kMsgCKeepAlive is written between chunks so the other side doesn't
+give up on the connection.
+*/
+class ClipboardSender {
+public:
+	enum {
+		//! Size of the data in a chunk
+		kChunkSize   = 512 * 1024,
+		//! Chunks written before waiting for the stream to flush
+		kChunksAhead = 2
+	};
+
+	ClipboardSender(synergy::IStream* stream);
+	~ClipboardSender();
+
+	//! @name manipulators
+	//@{
+
+	//! Send clipboard
+	/*!
+	Queues the marshalled clipboard \c data for clipboard \c id with
+	\c sequence and writes as much of it as the stream takes now.  The
+	data is taken from \c data, which is left empty.  If \c compress is
+	true the other side accepts compressed chunks.
+	*/
+	void				send(ClipboardID id, UInt32 sequence,
+							String& data, bool compress);
+
+	//! Note stream flushed
+	/*!
+	Called when the stream has sent all of its buffered output.
+	Writes the next chunks of the queued clipboards.
+	*/
+	void				flushed();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Check for unsent clipboards
+	/*!
+	Returns true iff there are queued clipboards that haven't been
+	completely written to the stream.
+	*/
+	bool				isSending() const;
+
+	//@}
+
+private:
+	class Transfer {
+	public:
+		ClipboardID		m_id;
+		UInt32			m_sequence;
+		String			m_data;
+		size_t			m_offset;
+		bool			m_started;
+		bool			m_compress;
+
+		// time since the clipboard was queued
+		Stopwatch		m_time;
+	};
+	typedef std::list<Transfer> TransferList;
+
+	void				writeChunks();
+	void				countSent(const Transfer&);
+	void				writeChunk(const Transfer&, UInt8 mark,
+							const char* data, size_t size);
+
+private:
+	synergy::IStream*	m_stream;
+	TransferList		m_transfers;
+
+	// reused for every chunk so sending doesn't allocate per chunk
+	std::vector<UInt8>	m_message;
+	String				m_compressed;
+
+	// time since the last keep alive while sending
+	Stopwatch			m_keepAliveTimer;
+};
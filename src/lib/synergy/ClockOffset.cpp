@@ -0,0 +1,88 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ClockOffset.h"
+
+//
+// ClockOffset
+//
+
+ClockOffset::ClockOffset() :
+	m_numSamples(0),
+	m_next(0),
+	m_best(0)
+{
+	// do nothing
+}
+
+void
+ClockOffset::addSample(UInt64 sent, UInt64 remote, UInt64 received)
+{
+	if (received < sent) {
+		return;
+	}
+
+	// the remote time is taken to be half way through the round trip
+	Sample& sample     = m_samples[m_next];
+	sample.m_roundTrip = received - sent;
+	sample.m_offset    = static_cast<SInt64>(sent + sample.m_roundTrip / 2) -
+							static_cast<SInt64>(remote);
+	m_next = (m_next + 1) % kMaxSamples;
+	if (m_numSamples < kMaxSamples) {
+		++m_numSamples;
+	}
+
+	// use the query with the shortest round trip
+	m_best = 0;
+	for (UInt32 i = 1; i < m_numSamples; ++i) {
+		if (m_samples[i].m_roundTrip < m_samples[m_best].m_roundTrip) {
+			m_best = i;
+		}
+	}
+}
+
+void
+ClockOffset::reset()
+{
+	m_numSamples = 0;
+	m_next       = 0;
+	m_best       = 0;
+}
+
+bool
+ClockOffset::isValid() const
+{
+	return (m_numSamples != 0);
+}
+
+SInt64
+ClockOffset::getOffset() const
+{
+	return isValid() ? m_samples[m_best].m_offset : 0;
+}
+
+UInt64
+ClockOffset::getRoundTrip() const
+{
+	return isValid() ? m_samples[m_best].m_roundTrip : 0;
+}
+
+UInt64
+ClockOffset::toLocal(UInt64 remote) const
+{
+	return static_cast<UInt64>(static_cast<SInt64>(remote) + getOffset());
+}
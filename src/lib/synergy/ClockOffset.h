@@ -0,0 +1,95 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/basic_types.h"
+
+//! Estimate of the offset between two clocks
+/*!
+Estimates how far a remote clock is from the local one from time
+queries:  the local time a query was sent, the remote time it was
+answered and the local time the answer arrived.  The remote time is
+assumed to be half way through the round trip.  Of the last few
+queries the one with the shortest round trip is used, since it was
+delayed least by queueing on either side.
+*/
+class ClockOffset {
+public:
+	enum {
+		//! Number of queries the estimate is taken from
+		kMaxSamples = 8
+	};
+
+	ClockOffset();
+
+	//! @name manipulators
+	//@{
+
+	//! Add a query
+	/*!
+	Adds a query sent at local time \c sent, answered with remote
+	time \c remote and received at local time \c received.  Queries
+	received before they were sent are ignored.
+	*/
+	void				addSample(UInt64 sent, UInt64 remote, UInt64 received);
+
+	//! Forget all queries
+	void				reset();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Test if there's an estimate
+	/*!
+	Returns true if at least one query was added.
+	*/
+	bool				isValid() const;
+
+	//! Get offset
+	/*!
+	Returns the local time minus the remote time.
+	*/
+	SInt64				getOffset() const;
+
+	//! Get round trip time
+	/*!
+	Returns the round trip time of the query the offset is taken from.
+	*/
+	UInt64				getRoundTrip() const;
+
+	//! Convert remote time
+	/*!
+	Returns the local time at remote time \c remote.
+	*/
+	UInt64				toLocal(UInt64 remote) const;
+
+	//@}
+
+private:
+	class Sample {
+	public:
+		SInt64			m_offset;
+		UInt64			m_roundTrip;
+	};
+
+	Sample				m_samples[kMaxSamples];
+	UInt32				m_numSamples;
+	UInt32				m_next;
+	UInt32				m_best;
+};
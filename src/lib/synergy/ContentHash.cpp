@@ -0,0 +1,183 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ContentHash.h"
+
+#include <cstring>
+
+static const UInt64		kPrime1 = 11400714785074694791ULL;
+static const UInt64		kPrime2 = 14029467366897019727ULL;
+static const UInt64		kPrime3 = 1609587929392839161ULL;
+static const UInt64		kPrime4 = 9650029242287828579ULL;
+static const UInt64		kPrime5 = 2870177450012600261ULL;
+
+static inline UInt64
+rotl(UInt64 x, int r)
+{
+	return (x << r) | (x >> (64 - r));
+}
+
+// XXH64 reads words little endian.  compilers turn these into plain
+// loads on little endian machines.
+static inline UInt64
+read64(const UInt8* p)
+{
+	return  static_cast<UInt64>(p[0])        |
+		   (static_cast<UInt64>(p[1]) <<  8) |
+		   (static_cast<UInt64>(p[2]) << 16) |
+		   (static_cast<UInt64>(p[3]) << 24) |
+		   (static_cast<UInt64>(p[4]) << 32) |
+		   (static_cast<UInt64>(p[5]) << 40) |
+		   (static_cast<UInt64>(p[6]) << 48) |
+		   (static_cast<UInt64>(p[7]) << 56);
+}
+
+static inline UInt32
+read32(const UInt8* p)
+{
+	return  static_cast<UInt32>(p[0])        |
+		   (static_cast<UInt32>(p[1]) <<  8) |
+		   (static_cast<UInt32>(p[2]) << 16) |
+		   (static_cast<UInt32>(p[3]) << 24);
+}
+
+static inline UInt64
+hashRound(UInt64 lane, UInt64 input)
+{
+	lane += input * kPrime2;
+	lane  = rotl(lane, 31);
+	return lane * kPrime1;
+}
+
+static inline UInt64
+mergeRound(UInt64 hash, UInt64 lane)
+{
+	hash ^= hashRound(0, lane);
+	return hash * kPrime1 + kPrime4;
+}
+
+//
+// ContentHash
+//
+
+ContentHash::ContentHash(UInt64 seed) :
+	m_seed(seed),
+	m_total(0),
+	m_bufferSize(0)
+{
+	m_lane[0] = seed + kPrime1 + kPrime2;
+	m_lane[1] = seed + kPrime2;
+	m_lane[2] = seed;
+	m_lane[3] = seed - kPrime1;
+}
+
+void
+ContentHash::update(const void* data, size_t size)
+{
+	const UInt8* p   = static_cast<const UInt8*>(data);
+	const UInt8* end = p + size;
+	m_total += size;
+
+	// top up a partial stripe first
+	if (m_bufferSize + size < 32) {
+		if (size > 0) {
+			memcpy(m_buffer + m_bufferSize, p, size);
+		}
+		m_bufferSize += size;
+		return;
+	}
+	if (m_bufferSize > 0) {
+		size_t n = 32 - m_bufferSize;
+		memcpy(m_buffer + m_bufferSize, p, n);
+		p += n;
+		m_lane[0] = hashRound(m_lane[0], read64(m_buffer));
+		m_lane[1] = hashRound(m_lane[1], read64(m_buffer + 8));
+		m_lane[2] = hashRound(m_lane[2], read64(m_buffer + 16));
+		m_lane[3] = hashRound(m_lane[3], read64(m_buffer + 24));
+		m_bufferSize = 0;
+	}
+
+	// the lanes don't depend on each other so the rounds overlap
+	UInt64 v0 = m_lane[0];
+	UInt64 v1 = m_lane[1];
+	UInt64 v2 = m_lane[2];
+	UInt64 v3 = m_lane[3];
+	for (; p + 32 <= end; p += 32) {
+		v0 = hashRound(v0, read64(p));
+		v1 = hashRound(v1, read64(p + 8));
+		v2 = hashRound(v2, read64(p + 16));
+		v3 = hashRound(v3, read64(p + 24));
+	}
+	m_lane[0] = v0;
+	m_lane[1] = v1;
+	m_lane[2] = v2;
+	m_lane[3] = v3;
+
+	m_bufferSize = static_cast<size_t>(end - p);
+	if (m_bufferSize > 0) {
+		memcpy(m_buffer, p, m_bufferSize);
+	}
+}
+
+UInt64
+ContentHash::digest() const
+{
+	UInt64 h;
+	if (m_total >= 32) {
+		h = rotl(m_lane[0], 1) + rotl(m_lane[1], 7) +
+			rotl(m_lane[2], 12) + rotl(m_lane[3], 18);
+		h = mergeRound(h, m_lane[0]);
+		h = mergeRound(h, m_lane[1]);
+		h = mergeRound(h, m_lane[2]);
+		h = mergeRound(h, m_lane[3]);
+	}
+	else {
+		h = m_seed + kPrime5;
+	}
+	h += m_total;
+
+	const UInt8* p   = m_buffer;
+	const UInt8* end = m_buffer + m_bufferSize;
+	for (; p + 8 <= end; p += 8) {
+		h ^= hashRound(0, read64(p));
+		h  = rotl(h, 27) * kPrime1 + kPrime4;
+	}
+	if (p + 4 <= end) {
+		h ^= static_cast<UInt64>(read32(p)) * kPrime1;
+		h  = rotl(h, 23) * kPrime2 + kPrime3;
+		p += 4;
+	}
+	for (; p < end; ++p) {
+		h ^= static_cast<UInt64>(*p) * kPrime5;
+		h  = rotl(h, 11) * kPrime1;
+	}
+
+	h ^= h >> 33;
+	h *= kPrime2;
+	h ^= h >> 29;
+	h *= kPrime3;
+	h ^= h >> 32;
+	return h;
+}
+
+UInt64
+ContentHash::hash(const void* data, size_t size, UInt64 seed)
+{
+	ContentHash hash(seed);
+	hash.update(data, size);
+	return hash.digest();
+}
@@ -0,0 +1,69 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/basic_types.h"
+
+#include <cstddef>
+
+//! Streaming content hash
+/*!
+Computes a 64 bit XXH64 hash of data that may arrive in pieces.  The
+four independent lanes keep the CPU's multipliers busy so hashing runs
+at memory speed.  The data is read as little endian words like the
+reference XXH64 so every machine computes the same hash for the same
+bytes, which lets hashes be sent to and compared on other machines.
+*/
+class ContentHash {
+public:
+	ContentHash(UInt64 seed = 0);
+
+	//! @name manipulators
+	//@{
+
+	//! Add data
+	/*!
+	Adds the \c size bytes at \c data to the hashed data.
+	*/
+	void				update(const void* data, size_t size);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get hash
+	/*!
+	Returns the hash of the data added so far.
+	*/
+	UInt64				digest() const;
+
+	//! Hash data
+	/*!
+	Returns the hash of the \c size bytes at \c data.
+	*/
+	static UInt64		hash(const void* data, size_t size, UInt64 seed = 0);
+
+	//@}
+
+private:
+	UInt64				m_seed;
+	UInt64				m_total;
+	UInt64				m_lane[4];
+	UInt8				m_buffer[32];
+	size_t				m_bufferSize;
+};
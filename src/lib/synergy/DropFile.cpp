@@ -0,0 +1,180 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/DropFile.h"
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+//
+// DropFile
+//
+
+UInt32					DropFile::s_count = 0;
+
+DropFile::DropFile() :
+	m_expectedSize(0),
+	m_size(0),
+	m_failed(false),
+	m_complete(false)
+{
+	// do nothing
+}
+
+DropFile::~DropFile()
+{
+	discard();
+}
+
+bool
+DropFile::begin(size_t expectedSize)
+{
+	discard();
+
+	m_expectedSize = expectedSize;
+	m_size         = 0;
+	m_failed       = false;
+	m_complete     = false;
+
+	// temporary names only need to be unique between the transfers of
+	// one process and the processes running at the same time
+	String dir = getTempDirectory();
+	m_path = synergy::string::sprintf("%s%ssynergy-%u-%u.tmp", dir.c_str(),
+#ifdef SYSAPI_WIN32
+					"\\",
+#else
+					"/",
+#endif
+					static_cast<UInt32>(ARCH->time() * 1000.0), ++s_count);
+
+	m_file.open(m_path.c_str(),
+				std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!m_file.is_open()) {
+		LOG((CLOG_ERR "drop file failed: can not create %s", m_path.c_str()));
+		m_path.clear();
+		m_failed = true;
+		return false;
+	}
+
+	LOG((CLOG_DEBUG1 "receiving file into %s", m_path.c_str()));
+	return true;
+}
+
+bool
+DropFile::write(const void* data, size_t size)
+{
+	if (m_failed || !m_file.is_open()) {
+		return false;
+	}
+
+	m_file.write(static_cast<const char*>(data), size);
+	if (!m_file.good()) {
+		LOG((CLOG_ERR "drop file failed: can not write %s", m_path.c_str()));
+		m_failed = true;
+		return false;
+	}
+
+	m_size += size;
+	return true;
+}
+
+bool
+DropFile::end()
+{
+	if (m_file.is_open()) {
+		m_file.close();
+		if (m_file.fail()) {
+			m_failed = true;
+		}
+	}
+
+	m_complete = (!m_failed && !m_path.empty() && m_size == m_expectedSize);
+	return m_complete;
+}
+
+String
+DropFile::detach()
+{
+	if (!m_complete) {
+		return String();
+	}
+
+	String path = m_path;
+	m_path.clear();
+	m_complete = false;
+	return path;
+}
+
+void
+DropFile::discard()
+{
+	if (m_file.is_open()) {
+		m_file.close();
+	}
+	if (!m_path.empty()) {
+		std::remove(m_path.c_str());
+		m_path.clear();
+	}
+	m_complete = false;
+}
+
+bool
+DropFile::isOpen() const
+{
+	return (m_file.is_open() && !m_failed);
+}
+
+bool
+DropFile::isComplete() const
+{
+	return m_complete;
+}
+
+size_t
+DropFile::getExpectedSize() const
+{
+	return m_expectedSize;
+}
+
+size_t
+DropFile::getSize() const
+{
+	return m_size;
+}
+
+String
+DropFile::getTempDirectory()
+{
+#ifdef SYSAPI_WIN32
+	const char* dir = getenv("TEMP");
+	if (dir == NULL || dir[0] == '\0') {
+		dir = getenv("TMP");
+	}
+	if (dir == NULL || dir[0] == '\0') {
+		dir = ".";
+	}
+#else
+	const char* dir = getenv("TMPDIR");
+	if (dir == NULL || dir[0] == '\0') {
+		dir = "/tmp";
+	}
+#endif
+	return dir;
+}
@@ -0,0 +1,118 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+
+#include <fstream>
+
+//! Dropped file being received
+/*!
+This class writes a file received from another screen to a temporary
+file as its chunks arrive, so only one chunk is held in memory at a
+time.  The drop target usually isn't known until the user finishes
+dragging, so once the file is complete its temporary path is handed
+over with detach() and the file is moved into place by DropHelper.
+
+A temporary file that is never detached is removed when the next file
+begins or when the object is destroyed.
+*/
+class DropFile {
+public:
+	DropFile();
+	~DropFile();
+
+	//! @name manipulators
+	//@{
+
+	//! Begin file
+	/*!
+	Discards any file being received and creates a temporary file for
+	a new one of \c expectedSize bytes.  Returns false if the temporary
+	file can't be created.
+	*/
+	bool				begin(size_t expectedSize);
+
+	//! Write data
+	/*!
+	Appends \c size bytes to the file.  Returns false if the file isn't
+	open or the write fails.
+	*/
+	bool				write(const void* data, size_t size);
+
+	//! End file
+	/*!
+	Closes the temporary file.  Returns true iff every write succeeded
+	and the file has its expected size.
+	*/
+	bool				end();
+
+	//! Detach temporary file
+	/*!
+	Returns the path of the temporary file and gives up ownership of
+	it;  the caller is responsible for moving or removing it.  Returns
+	the empty string if there is no complete file.  The file is no
+	longer complete afterwards.
+	*/
+	String				detach();
+
+	//! Discard file
+	/*!
+	Closes and removes the temporary file, if any.
+	*/
+	void				discard();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Check for open file
+	/*!
+	Returns true iff a file has begun but not ended and every write to
+	it so far has succeeded.
+	*/
+	bool				isOpen() const;
+
+	//! Check for complete file
+	/*!
+	Returns true iff the last file ended with its expected size.
+	*/
+	bool				isComplete() const;
+
+	//! Get expected size
+	size_t				getExpectedSize() const;
+
+	//! Get received size
+	size_t				getSize() const;
+
+	//@}
+
+private:
+	static String		getTempDirectory();
+
+private:
+	std::ofstream		m_file;
+	String				m_path;
+	size_t				m_expectedSize;
+	size_t				m_size;
+	bool				m_failed;
+	bool				m_complete;
+
+	static UInt32		s_count;
+};
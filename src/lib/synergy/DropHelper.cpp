@@ -17,37 +17,103 @@
 
 #include "synergy/DropHelper.h"
 
+#include "arch/Arch.h"
 #include "base/Log.h"
 
+#include <cstdio>
 #include <fstream>
 
 void
-DropHelper::writeToDir(const String& destination, DragFileList& fileList, String& data)
+DropHelper::writeToDir(const String& destination, DragFileList& fileList,
+				const String& tempPath)
 {
 	LOG((CLOG_DEBUG "dropping file, files=%i target=%s", fileList.size(), destination.c_str()));
 
-	if (!destination.empty() && fileList.size() > 0) {
-		std::fstream file;
-		String dropTarget = destination;
+	if (fileList.size() > 0) {
+		writeToDir(destination, fileList.at(0).getFilename(), tempPath);
+		fileList.clear();
+	}
+	else {
+		LOG((CLOG_ERR "drop file failed: drag file list is empty"));
+		std::remove(tempPath.c_str());
+	}
+}
+
+void
+DropHelper::writeToDir(const String& destination, const String& name,
+				const String& tempPath)
+{
 #ifdef SYSAPI_WIN32
-		dropTarget.append("\\");
+	const char* separator = "\\";
 #else
-		dropTarget.append("/");
+	const char* separator = "/";
 #endif
-		dropTarget.append(fileList.at(0).getFilename());
-		file.open(dropTarget.c_str(), std::ios::out | std::ios::binary);
-		if (!file.is_open()) {
-			LOG((CLOG_ERR "drop file failed: can not open %s", dropTarget.c_str()));
+
+	if (destination.empty()) {
+		LOG((CLOG_ERR "drop file failed: drop target is empty"));
+		std::remove(tempPath.c_str());
+		return;
+	}
+
+	// create the directories on the way to the file
+	String dropTarget = destination;
+	size_t start = 0;
+	size_t slash;
+	while ((slash = name.find('/', start)) != String::npos) {
+		dropTarget.append(separator);
+		dropTarget.append(name, start, slash - start);
+		if (!ARCH->createDirectory(dropTarget)) {
+			LOG((CLOG_ERR "drop file failed: can not create %s", dropTarget.c_str()));
+			std::remove(tempPath.c_str());
+			return;
 		}
-		
-		file.write(data.c_str(), data.size());
-		file.close();
+		start = slash + 1;
+	}
+	dropTarget.append(separator);
+	dropTarget.append(name, start, String::npos);
 
-		LOG((CLOG_DEBUG "%s is saved to %s", fileList.at(0).getFilename().c_str(), destination.c_str()));
+	// rename() replaces an existing file everywhere but windows
+#ifdef SYSAPI_WIN32
+	std::remove(dropTarget.c_str());
+#endif
 
-		fileList.clear();
+	// the temporary file is usually on another file system than the
+	// drop target, in which case it's copied next to the target
+	// first so the rename into place is still atomic.
+	bool saved = (std::rename(tempPath.c_str(), dropTarget.c_str()) == 0);
+	if (!saved) {
+		String partPath = dropTarget + ".part";
+		saved = copyFile(tempPath, partPath) &&
+				std::rename(partPath.c_str(), dropTarget.c_str()) == 0;
+		if (!saved) {
+			std::remove(partPath.c_str());
+		}
+	}
+
+	if (saved) {
+		LOG((CLOG_DEBUG "%s is saved to %s", name.c_str(), destination.c_str()));
 	}
 	else {
-		LOG((CLOG_ERR "drop file failed: drop target is empty"));
+		LOG((CLOG_ERR "drop file failed: can not write %s", dropTarget.c_str()));
+	}
+
+	std::remove(tempPath.c_str());
+}
+
+bool
+DropHelper::copyFile(const String& from, const String& to)
+{
+	std::ifstream in(from.c_str(), std::ios::in | std::ios::binary);
+	std::ofstream out(to.c_str(),
+					std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!in.is_open() || !out.is_open()) {
+		return false;
+	}
+
+	// copies through the streams' buffers, not the whole file at once
+	if (in.peek() != std::ifstream::traits_type::eof()) {
+		out << in.rdbuf();
 	}
+	out.close();
+	return !out.fail();
 }
@@ -22,6 +22,26 @@
 
 class DropHelper {
 public:
+	//! Move received file to drop target
+	/*!
+	Moves the complete temporary file at \c tempPath into the
+	\c destination directory under the name of the first file in
+	\c fileList.  The file only appears under its final name once it
+	has been written in full.  The temporary file is always removed.
+	*/
 	static void			writeToDir(const String& destination,
-							DragFileList& fileList, String& data);
+							DragFileList& fileList, const String& tempPath);
+
+	//! Move received file to drop target
+	/*!
+	Moves the complete temporary file at \c tempPath to \c name in the
+	\c destination directory, where \c name may be a relative path
+	with '/' separators.  Directories on the path are created as
+	needed.  The temporary file is always removed.
+	*/
+	static void			writeToDir(const String& destination,
+							const String& name, const String& tempPath);
+
+private:
+	static bool			copyFile(const String& from, const String& to);
 };
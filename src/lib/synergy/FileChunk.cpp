@@ -17,16 +17,50 @@
 
 #include "synergy/FileChunk.h"
 
+#include "synergy/DropFile.h"
+#include "synergy/FileReceiver.h"
+#include "synergy/PayloadCompressor.h"
 #include "synergy/ProtocolUtil.h"
 #include "synergy/protocol_types.h"
 #include "io/IStream.h"
 #include "base/Stopwatch.h"
 #include "base/Log.h"
+#include "common/stdvector.h"
+
+#if HAVE_SYS_SENDFILE_H
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
 
 static const UInt16 kIntervalThreshold = 1;
 
+// message code, transfer id for kMsgDFileQueue, mark and data length
+static const UInt32 kMaxHeaderSize = 4 + 4 + 1 + 4;
+
+#if HAVE_SYS_SENDFILE_H
+static bool
+readAt(int fd, UInt64 offset, UInt8* data, size_t size)
+{
+	size_t done = 0;
+	while (done < size) {
+		ssize_t n = pread(fd, data + done, size - done,
+						static_cast<off_t>(offset + done));
+		if (n <= 0) {
+			return false;
+		}
+		done += static_cast<size_t>(n);
+	}
+	return true;
+}
+#endif
+
 FileChunk::FileChunk(size_t size) :
-	Chunk(size)
+	Chunk(size),
+	m_inFile(false),
+	m_fileOffset(0),
+	m_transferId(0),
+	m_transferAttempt(0),
+	m_window(NULL)
 {
 		m_dataSize = size - FILE_CHUNK_META_SIZE;
 }
@@ -56,6 +90,39 @@ FileChunk::data(UInt8* data, size_t dataSize)
 	return chunk;
 }
 
+FileChunk*
+FileChunk::data(std::istream& file, size_t dataSize)
+{
+	// read straight into the chunk rather than through a buffer
+	FileChunk* chunk = new FileChunk(dataSize + FILE_CHUNK_META_SIZE);
+	char* chunkData = chunk->m_chunk;
+	chunkData[0] = kDataChunk;
+	file.read(&chunkData[1], dataSize);
+	chunkData[dataSize + 1] = '\0';
+
+	if (static_cast<size_t>(file.gcount()) != dataSize) {
+		delete chunk;
+		return NULL;
+	}
+
+	return chunk;
+}
+
+FileChunk*
+FileChunk::data(const String& path, UInt64 offset, size_t dataSize)
+{
+	FileChunk* chunk = new FileChunk(path.size() + FILE_CHUNK_META_SIZE);
+	char* chunkData = chunk->m_chunk;
+	chunkData[0] = kDataChunk;
+	memcpy(&chunkData[1], path.c_str(), path.size());
+	chunkData[path.size() + 1] = '\0';
+	chunk->m_dataSize   = dataSize;
+	chunk->m_inFile     = true;
+	chunk->m_fileOffset = offset;
+
+	return chunk;
+}
+
 FileChunk*
 FileChunk::end()
 {
@@ -68,7 +135,7 @@ FileChunk::end()
 }
 
 int
-FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expectedSize)
+FileChunk::assemble(synergy::IStream* stream, DropFile& file)
 {
 	// parse
 	UInt8 mark = 0;
@@ -83,8 +150,9 @@ FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expe
 
 	switch (mark) {
 	case kDataStart:
-		dataReceived.clear();
-		expectedSize = synergy::string::stringToSizeType(content);
+		if (!file.begin(synergy::string::stringToSizeType(content))) {
+			return kError;
+		}
 		receivedDataSize = 0;
 		elapsedTime = 0;
 		stopwatch.reset();
@@ -95,8 +163,21 @@ FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expe
 		}
 		return kStart;
 
+	case kDataCompressed: {
+		String data;
+		if (!PayloadCompressor::decompress(content.data(), content.size(),
+							data)) {
+			LOG((CLOG_ERR "corrupted compressed file data"));
+			return kError;
+		}
+		content.swap(data);
+	}
+		// fall through
+
 	case kDataChunk:
-		dataReceived.append(content);
+		if (!file.write(content.data(), content.size())) {
+			return kError;
+		}
 		if (CLOG->getFilter() >= kDEBUG2) {
 				LOG((CLOG_DEBUG2 "recv file chunck size=%i", content.size()));
 				double interval = stopwatch.getTime();
@@ -114,17 +195,17 @@ FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expe
 		return kNotFinish;
 
 	case kDataEnd:
-		if (expectedSize != dataReceived.size()) {
-			LOG((CLOG_ERR "corrupted clipboard data, expected size=%d actual size=%d", expectedSize, dataReceived.size()));
+		if (!file.end()) {
+			LOG((CLOG_ERR "corrupted file data, expected size=%d actual size=%d", (int)file.getExpectedSize(), (int)file.getSize()));
 			return kError;
 		}
 
 		if (CLOG->getFilter() >= kDEBUG2) {
 			LOG((CLOG_DEBUG2 "file transfer finished"));
 			elapsedTime += stopwatch.getTime();
-			double averageSpeed = expectedSize / elapsedTime / 1000;
+			double averageSpeed = file.getSize() / elapsedTime / 1000;
 			LOG((CLOG_DEBUG2 "file transfer finished: total time consumed=%f s", elapsedTime));
-			LOG((CLOG_DEBUG2 "file transfer finished: total data received=%i kb", expectedSize / 1000));
+			LOG((CLOG_DEBUG2 "file transfer finished: total data received=%i kb", (int)(file.getSize() / 1000)));
 			LOG((CLOG_DEBUG2 "file transfer finished: total average speed=%f kb/s", averageSpeed));
 		}
 		return kFinish;
@@ -134,17 +215,61 @@ FileChunk::assemble(synergy::IStream* stream, String& dataReceived, size_t& expe
 }
 
 void
-FileChunk::send(synergy::IStream* stream, UInt8 mark, char* data, size_t dataSize)
+FileChunk::assembleQueued(synergy::IStream* stream, FileReceiver& receiver,
+				const String& source)
+{
+	UInt32 id = 0;
+	UInt8 mark = 0;
+	String content;
+	if (!ProtocolUtil::readf(stream, kMsgDFileQueue + 4, &id, &mark, &content)) {
+		return;
+	}
+
+	switch (mark) {
+	case kDataStart: {
+		UInt64 offset = 0;
+		receiver.begin(source, id, content, offset);
+		String offsetString = synergy::string::sizeTypeToString(
+							static_cast<size_t>(offset));
+		ProtocolUtil::writef(stream, kMsgDFileAccept, id, &offsetString);
+		break;
+	}
+
+	case kDataCompressed: {
+		String data;
+		if (!PayloadCompressor::decompress(content.data(), content.size(),
+							data)) {
+			// the file ends up short and is dropped when it ends
+			LOG((CLOG_ERR "corrupted compressed file data from %s", source.c_str()));
+			break;
+		}
+		receiver.write(source, id, data.data(), data.size());
+		break;
+	}
+
+	case kDataChunk:
+		receiver.write(source, id, content.data(), content.size());
+		break;
+
+	case kDataEnd:
+		receiver.end(source, id);
+		break;
+	}
+}
+
+void
+FileChunk::send(synergy::IStream* stream, const FileChunk& chunk,
+				bool compress)
 {
-	String chunk(data, dataSize);
+	UInt8 mark = chunk.m_chunk[0];
 
 	switch (mark) {
 	case kDataStart:
-		LOG((CLOG_DEBUG2 "sending file chunk start: size=%s", data));
+		LOG((CLOG_DEBUG2 "sending file chunk start: size=%s", &chunk.m_chunk[1]));
 		break;
 
 	case kDataChunk:
-		LOG((CLOG_DEBUG2 "sending file chunk: size=%i", chunk.size()));
+		LOG((CLOG_DEBUG2 "sending file chunk: size=%i", (int)chunk.m_dataSize));
 		break;
 
 	case kDataEnd:
@@ -152,5 +277,134 @@ FileChunk::send(synergy::IStream* stream, UInt8 mark, char* data, size_t dataSiz
 		break;
 	}
 
-	ProtocolUtil::writef(stream, kMsgDFileTransfer, mark, &chunk);
+	const UInt8* data = reinterpret_cast<const UInt8*>(&chunk.m_chunk[1]);
+	UInt32 size = static_cast<UInt32>(chunk.m_dataSize);
+	UInt8 header[kMaxHeaderSize];
+
+	// compressing needs the data in memory, so it wins over sending
+	// straight from the file
+	std::vector<UInt8> fileData;
+	String compressed;
+	if (compress && mark == kDataChunk &&
+		chunk.m_dataSize >= PayloadCompressor::kThreshold) {
+		if (chunk.m_inFile) {
+			fileData.resize(size);
+			if (!readFromFile(chunk, &fileData[0])) {
+				return;
+			}
+			data = &fileData[0];
+		}
+		if (PayloadCompressor::compress(reinterpret_cast<const char*>(data),
+							size, compressed)) {
+			LOG((CLOG_DEBUG2 "compressed file chunk: size=%i", (int)compressed.size()));
+			mark = kDataCompressed;
+			data = reinterpret_cast<const UInt8*>(compressed.data());
+			size = static_cast<UInt32>(compressed.size());
+		}
+	}
+	else if (chunk.m_inFile) {
+		UInt32 headerSize = makeHeader(header, chunk, mark, size);
+		sendFromFile(stream, chunk, header, headerSize);
+		return;
+	}
+
+	// write the header and data with a single copy of the data
+	UInt32 headerSize = makeHeader(header, chunk, mark, size);
+	std::vector<UInt8> message(headerSize + size);
+	memcpy(&message[0], header, headerSize);
+	if (size > 0) {
+		memcpy(&message[headerSize], data, size);
+	}
+	stream->write(&message[0], static_cast<UInt32>(message.size()));
+}
+
+UInt32
+FileChunk::makeHeader(UInt8* header, const FileChunk& chunk,
+				UInt8 mark, UInt32 size)
+{
+	// build the header ProtocolUtil::writef() would for kMsgDFileQueue,
+	// or for kMsgDFileTransfer if the chunk isn't part of a queued file
+	UInt8* dst = header;
+	if (chunk.m_transferId != 0) {
+		UInt32 id = chunk.m_transferId;
+		memcpy(dst, kMsgDFileQueue, 4);
+		dst += 4;
+		*dst++ = static_cast<UInt8>((id >> 24) & 0xff);
+		*dst++ = static_cast<UInt8>((id >> 16) & 0xff);
+		*dst++ = static_cast<UInt8>((id >>  8) & 0xff);
+		*dst++ = static_cast<UInt8>( id        & 0xff);
+	}
+	else {
+		memcpy(dst, kMsgDFileTransfer, 4);
+		dst += 4;
+	}
+	*dst++ = mark;
+	*dst++ = static_cast<UInt8>((size >> 24) & 0xff);
+	*dst++ = static_cast<UInt8>((size >> 16) & 0xff);
+	*dst++ = static_cast<UInt8>((size >>  8) & 0xff);
+	*dst++ = static_cast<UInt8>( size        & 0xff);
+	return static_cast<UInt32>(dst - header);
+}
+
+bool
+FileChunk::readFromFile(const FileChunk& chunk, UInt8* data)
+{
+#if HAVE_SYS_SENDFILE_H
+	const char* path = &chunk.m_chunk[1];
+
+	int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		LOG((CLOG_ERR "failed to open file for sending: %s", path));
+		return false;
+	}
+
+	bool read = readAt(fd, chunk.m_fileOffset, data, chunk.m_dataSize);
+	close(fd);
+
+	if (!read) {
+		LOG((CLOG_ERR "failed to read file for sending: %s", path));
+	}
+	return read;
+#else
+	(void)chunk;
+	(void)data;
+	assert(0 && "file data chunks are not supported");
+	return false;
+#endif
+}
+
+void
+FileChunk::sendFromFile(synergy::IStream* stream, const FileChunk& chunk,
+				const UInt8* header, UInt32 headerSize)
+{
+#if HAVE_SYS_SENDFILE_H
+	const char* path = &chunk.m_chunk[1];
+	UInt32 size = static_cast<UInt32>(chunk.m_dataSize);
+
+	int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		LOG((CLOG_ERR "failed to open file for sending: %s", path));
+		return;
+	}
+
+	// the stream keeps its own handle on the file if it takes the data
+	// straight from it, otherwise read the data in behind the header
+	if (!stream->writeFile(header, headerSize, fd, chunk.m_fileOffset, size)) {
+		std::vector<UInt8> message(headerSize + size);
+		memcpy(&message[0], header, headerSize);
+		if (readAt(fd, chunk.m_fileOffset, &message[0] + headerSize, size)) {
+			stream->write(&message[0], static_cast<UInt32>(message.size()));
+		}
+		else {
+			LOG((CLOG_ERR "failed to read file for sending: %s", path));
+		}
+	}
+	close(fd);
+#else
+	(void)stream;
+	(void)chunk;
+	(void)header;
+	(void)headerSize;
+	assert(0 && "file data chunks are not supported");
+#endif
 }
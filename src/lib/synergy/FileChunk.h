@@ -20,12 +20,18 @@
 #include "synergy/Chunk.h"
 #include "base/String.h"
 #include "common/basic_types.h"
+#include "common/stdvector.h"
+
+#include <istream>
 
 #define FILE_CHUNK_META_SIZE 2
 
 namespace synergy {
 class IStream;
 };
+class DropFile;
+class FileReceiver;
+class FileWindow;
 
 class FileChunk : public Chunk {
 public:
@@ -33,14 +39,64 @@ public:
 
 	static FileChunk*	start(const String& size);
 	static FileChunk*	data(UInt8* data, size_t dataSize);
+	static FileChunk*	data(std::istream& file, size_t dataSize);
+
+	//! Create chunk that refers to file data
+	/*!
+	Creates a data chunk that holds only the path of the file.  The
+	\c dataSize bytes at \c offset are read when the chunk is sent and,
+	where the stream allows, go from the file to the socket without
+	being copied.
+	*/
+	static FileChunk*	data(const String& path,
+							UInt64 offset, size_t dataSize);
 	static FileChunk*	end();
 	static int			assemble(
 							synergy::IStream* stream,
-							String& dataCached,
-							size_t& expectedSize);
+							DropFile& file);
+
+	//! Send chunk
+	/*!
+	Sends \c chunk to \c stream.  If \c compress is true the other side
+	accepts compressed chunks and file data is compressed if that makes
+	it smaller.
+	*/
 	static void			send(
 							synergy::IStream* stream,
-							UInt8 mark,
-							char* data,
-							size_t dataSize);
+							const FileChunk& chunk,
+							bool compress = false);
+
+	//! Receive part of a queued file
+	/*!
+	Reads a kMsgDFileQueue message from \c stream and passes it to
+	\c receiver as a part of a file from \c source.  Answers the start
+	of a file with kMsgDFileAccept.
+	*/
+	static void			assembleQueued(
+							synergy::IStream* stream,
+							FileReceiver& receiver,
+							const String& source);
+
+private:
+	static UInt32		makeHeader(UInt8* header, const FileChunk& chunk,
+							UInt8 mark, UInt32 size);
+	static bool			readFromFile(const FileChunk& chunk, UInt8* data);
+	static void			sendFromFile(
+							synergy::IStream* stream,
+							const FileChunk& chunk,
+							const UInt8* header,
+							UInt32 headerSize);
+
+public:
+	// true if m_chunk holds the path of the file rather than the data
+	bool				m_inFile;
+	UInt64				m_fileOffset;
+
+	// the FileTransferQueue transfer the chunk belongs to, or 0 if it's
+	// sent with kMsgDFileTransfer, and the attempt it was made for
+	UInt32				m_transferId;
+	UInt32				m_transferAttempt;
+
+	// the send window the chunk counts against, or NULL
+	FileWindow*			m_window;
 };
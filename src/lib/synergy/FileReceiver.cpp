@@ -0,0 +1,213 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileReceiver.h"
+
+#include "synergy/DropFile.h"
+#include "mt/Lock.h"
+#include "base/IEventQueue.h"
+#include "base/EventTypes.h"
+#include "base/Log.h"
+#include "base/Metrics.h"
+
+#include <cstdio>
+
+//
+// FileReceiver
+//
+
+FileReceiver::FileReceiver(IEventQueue* events, void* eventTarget) :
+	m_events(events),
+	m_eventTarget(eventTarget),
+	m_lastFileComplete(false),
+	m_dropping(false)
+{
+	// do nothing
+}
+
+FileReceiver::~FileReceiver()
+{
+	for (ReceiveMap::iterator i = m_receives.begin();
+								i != m_receives.end(); ++i) {
+		delete i->second.m_file;
+	}
+
+	Lock lock(&m_mutex);
+	for (CompletedList::iterator i = m_completed.begin();
+								i != m_completed.end(); ++i) {
+		std::remove(i->m_tempPath.c_str());
+	}
+}
+
+bool
+FileReceiver::begin(const String& source, UInt32 id,
+				const String& info, UInt64& offset)
+{
+	// a refused file is skipped by asking for the data after its end
+	offset = 0;
+	size_t comma = info.find(',');
+	if (comma == String::npos) {
+		LOG((CLOG_ERR "invalid file info from %s: %s", source.c_str(), info.c_str()));
+		return false;
+	}
+
+	UInt64 size  = synergy::string::stringToSizeType(info.substr(0, comma));
+	String name  = info.substr(comma + 1);
+	offset       = size;
+	if (!isNameSafe(name)) {
+		LOG((CLOG_ERR "refusing file from %s: %s", source.c_str(), name.c_str()));
+		return false;
+	}
+
+	// resume a file that was cut off by a disconnect
+	ReceiveKey key(source, id);
+	ReceiveMap::iterator i = m_receives.find(key);
+	if (i != m_receives.end()) {
+		Receive& receive = i->second;
+		if (receive.m_name == name && receive.m_size == size &&
+			receive.m_file->isOpen()) {
+			offset = receive.m_file->getSize();
+			LOG((CLOG_DEBUG "resume receiving %s at %d", name.c_str(), (int)offset));
+			return true;
+		}
+		delete receive.m_file;
+		m_receives.erase(i);
+	}
+
+	DropFile* file = new DropFile;
+	if (!file->begin(static_cast<size_t>(size))) {
+		delete file;
+		return false;
+	}
+
+	Receive& receive = m_receives[key];
+	receive.m_name   = name;
+	receive.m_size   = size;
+	receive.m_file   = file;
+
+	offset = 0;
+	LOG((CLOG_DEBUG "start receiving %s size=%d", name.c_str(), (int)size));
+	return true;
+}
+
+bool
+FileReceiver::write(const String& source, UInt32 id,
+				const void* data, size_t size)
+{
+	ReceiveMap::iterator i = m_receives.find(ReceiveKey(source, id));
+	if (i == m_receives.end()) {
+		return false;
+	}
+
+	return i->second.m_file->write(data, size);
+}
+
+bool
+FileReceiver::end(const String& source, UInt32 id)
+{
+	ReceiveMap::iterator i = m_receives.find(ReceiveKey(source, id));
+	if (i == m_receives.end()) {
+		return false;
+	}
+
+	Receive& receive = i->second;
+	m_lastFileComplete = receive.m_file->end();
+	if (m_lastFileComplete) {
+		CompletedFile completed;
+		completed.m_name     = receive.m_name;
+		completed.m_tempPath = receive.m_file->detach();
+		LOG((CLOG_DEBUG "received %s", receive.m_name.c_str()));
+
+		static MetricCounter* s_bytes = Metrics::getInstance().getCounter(
+							"synergy_file_received_bytes_total",
+							"Bytes of dropped files received.");
+		s_bytes->add(receive.m_file->getSize());
+
+		Lock lock(&m_mutex);
+		m_completed.push_back(completed);
+	}
+	else {
+		LOG((CLOG_ERR "corrupted file data for %s, expected size=%d actual size=%d",
+			receive.m_name.c_str(),
+			(int)receive.m_file->getExpectedSize(),
+			(int)receive.m_file->getSize()));
+	}
+
+	delete receive.m_file;
+	m_receives.erase(i);
+
+	if (m_lastFileComplete) {
+		m_events->addEvent(Event(m_events->forFile().fileRecieveCompleted(),
+							m_eventTarget));
+	}
+	return m_lastFileComplete;
+}
+
+bool
+FileReceiver::startDrop()
+{
+	Lock lock(&m_mutex);
+	if (m_dropping || m_completed.empty()) {
+		return false;
+	}
+
+	m_dropping = true;
+	return true;
+}
+
+bool
+FileReceiver::takeCompleted(CompletedList& files)
+{
+	Lock lock(&m_mutex);
+	files.swap(m_completed);
+	m_completed.clear();
+	if (files.empty()) {
+		m_dropping = false;
+		return false;
+	}
+	return true;
+}
+
+bool
+FileReceiver::isLastFileComplete() const
+{
+	return m_lastFileComplete;
+}
+
+bool
+FileReceiver::isNameSafe(const String& name)
+{
+	if (name.empty() || name[0] == '/') {
+		return false;
+	}
+
+	// each part must be a plain file or directory name
+	size_t start = 0;
+	for (;;) {
+		size_t slash = name.find('/', start);
+		String part  = name.substr(start,
+							slash == String::npos ? String::npos : slash - start);
+		if (part.empty() || part == "." || part == ".." ||
+			part.find_first_of("\\:") != String::npos) {
+			return false;
+		}
+		if (slash == String::npos) {
+			return true;
+		}
+		start = slash + 1;
+	}
+}
@@ -0,0 +1,141 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mt/Mutex.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "common/stdmap.h"
+#include "common/stdvector.h"
+
+class DropFile;
+class IEventQueue;
+
+//! Receiver of queued files
+/*!
+This class receives the files a FileTransferQueue on another screen
+sends.  Each file is written to its own DropFile so the parts of
+different files can arrive interleaved.  A file that's incomplete
+when the connection drops is kept so the transfer can resume where it
+stopped when the sender offers it again.
+
+Complete files wait until the drop target is known.  Whoever moves
+them into place claims them with startDrop() and takeCompleted().
+*/
+class FileReceiver {
+public:
+	//! Complete file
+	class CompletedFile {
+	public:
+		//! Path relative to the drop target, with '/' separators
+		String			m_name;
+		//! Path of the temporary file holding the data
+		String			m_tempPath;
+	};
+	typedef std::vector<CompletedFile> CompletedList;
+
+	FileReceiver(IEventQueue* events, void* eventTarget);
+	~FileReceiver();
+
+	//! @name manipulators
+	//@{
+
+	//! Begin file
+	/*!
+	Begins transfer \c id from \c source, where \c info is the
+	"size,name" content of its kDataStart message, and saves the
+	offset to receive the file from in \c offset.  The offset is only
+	non-zero if an incomplete file with the same name and size is
+	resumed.  Returns false if the file is refused;  \c offset is
+	then the file's size so the sender skips the data.
+	*/
+	bool				begin(const String& source, UInt32 id,
+							const String& info, UInt64& offset);
+
+	//! Write file data
+	/*!
+	Appends \c size bytes to the file of transfer \c id from \c source.
+	Returns false if there's no such file or the write fails.
+	*/
+	bool				write(const String& source, UInt32 id,
+							const void* data, size_t size);
+
+	//! End file
+	/*!
+	Ends transfer \c id from \c source.  If the file is complete it's
+	kept for the drop and a \c fileRecieveCompleted event is sent to
+	the event target.  Returns true iff the file is complete.
+	*/
+	bool				end(const String& source, UInt32 id);
+
+	//! Start drop
+	/*!
+	Returns true if there are complete files and no drop is under way,
+	in which case the caller must take the files with takeCompleted()
+	until it returns false.
+	*/
+	bool				startDrop();
+
+	//! Take complete files
+	/*!
+	Moves the complete files into \c files and hands the responsibility
+	for their temporary files to the caller.  Returns false and ends
+	the drop if there are none.
+	*/
+	bool				takeCompleted(CompletedList& files);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Check last file
+	/*!
+	Returns true iff the last file that ended was complete.
+	*/
+	bool				isLastFileComplete() const;
+
+	//! Check file name
+	/*!
+	Returns true iff \c name is a relative path that stays inside the
+	directory it's relative to.
+	*/
+	static bool			isNameSafe(const String& name);
+
+	//@}
+
+private:
+	class Receive {
+	public:
+		String			m_name;
+		UInt64			m_size;
+		DropFile*		m_file;
+	};
+	typedef std::pair<String, UInt32> ReceiveKey;
+	typedef std::map<ReceiveKey, Receive> ReceiveMap;
+
+private:
+	IEventQueue*		m_events;
+	void*				m_eventTarget;
+	ReceiveMap			m_receives;
+	bool				m_lastFileComplete;
+
+	// complete files are taken by a thread waiting for the drop
+	Mutex				m_mutex;
+	CompletedList		m_completed;
+	bool				m_dropping;
+};
@@ -0,0 +1,392 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileTransferQueue.h"
+
+#include "synergy/FileChunk.h"
+#include "synergy/protocol_types.h"
+#include "arch/Arch.h"
+#include "mt/Lock.h"
+#include "mt/Thread.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/Metrics.h"
+#include "base/TMethodJob.h"
+#include "common/stdvector.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+// size of the data chunks, the number of files that may be open on the
+// receiving side at once, and how deep directories are followed
+static const size_t		kChunkSize     = 512 * 1024;
+static const size_t		kMaxActive     = 4;
+static const int		kMaxDepth      = 32;
+
+//
+// FileTransferQueue
+//
+
+FileTransferQueue::FileTransferQueue(IEventQueue* events, void* eventTarget) :
+	m_events(events),
+	m_eventTarget(eventTarget),
+	m_ready(&m_mutex, false),
+	m_nextId(1),
+	m_lastId(0),
+	m_thread(NULL),
+	m_threadRunning(false),
+	m_stopping(false)
+{
+	// do nothing
+}
+
+FileTransferQueue::~FileTransferQueue()
+{
+	{
+		Lock lock(&m_mutex);
+		m_stopping = true;
+		m_ready.broadcast();
+	}
+	m_window.stopSenders();
+
+	if (m_thread != NULL) {
+		m_thread->wait();
+		delete m_thread;
+	}
+}
+
+UInt32
+FileTransferQueue::add(const String& path, const String& destination)
+{
+	// the name on the other side starts at the last part of the path
+	String base = path;
+	while (base.size() > 1 &&
+			(base[base.size() - 1] == '/' || base[base.size() - 1] == '\\')) {
+		base.erase(base.size() - 1);
+	}
+	size_t separator = base.find_last_of("/\\");
+	String name = (separator == String::npos) ? base : base.substr(separator + 1);
+
+	UInt32 count;
+	Thread* finished = NULL;
+	{
+		Lock lock(&m_mutex);
+		count = addPath(base, name, destination, 0);
+		if (count == 0) {
+			LOG((CLOG_WARN "nothing to send in %s", path.c_str()));
+			return 0;
+		}
+
+		LOG((CLOG_DEBUG "queued %d file(s) from %s", count, path.c_str()));
+		if (!m_threadRunning) {
+			finished        = m_thread;
+			m_threadRunning = true;
+			m_thread = new Thread(new TMethodJob<FileTransferQueue>(
+								this, &FileTransferQueue::sendThread));
+		}
+		m_ready.broadcast();
+	}
+
+	// the previous thread ran out of transfers and is exiting.  join it
+	// without the lock so it can't hold up other callers.
+	if (finished != NULL) {
+		finished->wait();
+		delete finished;
+	}
+	return count;
+}
+
+void
+FileTransferQueue::accept(UInt32 id, UInt64 offset)
+{
+	Lock lock(&m_mutex);
+	TransferMap::iterator i = m_transfers.find(id);
+	if (i == m_transfers.end() || i->second.m_state != kOffered) {
+		return;
+	}
+
+	Transfer& transfer = i->second;
+	transfer.m_offset  = std::min(offset, transfer.m_size);
+	transfer.m_state   = kSending;
+	if (transfer.m_offset != 0) {
+		LOG((CLOG_DEBUG "resume sending %s at %d",
+			transfer.m_name.c_str(), (int)transfer.m_offset));
+	}
+	m_ready.broadcast();
+}
+
+void
+FileTransferQueue::connected(const String& destination)
+{
+	Lock lock(&m_mutex);
+	m_connected.insert(destination);
+	m_ready.broadcast();
+}
+
+void
+FileTransferQueue::disconnected(const String& destination)
+{
+	Lock lock(&m_mutex);
+	m_connected.erase(destination);
+	for (TransferMap::iterator i = m_transfers.begin();
+							i != m_transfers.end(); ++i) {
+		if (i->second.m_destination == destination) {
+			restart(i->second);
+		}
+	}
+}
+
+bool
+FileTransferQueue::relay(const FileChunk& chunk, String& destination)
+{
+	Lock lock(&m_mutex);
+	TransferMap::iterator i = m_transfers.find(chunk.m_transferId);
+	if (i == m_transfers.end() ||
+		i->second.m_attempt != chunk.m_transferAttempt) {
+		return false;
+	}
+
+	Transfer& transfer = i->second;
+	destination = transfer.m_destination;
+
+	UInt64 sent;
+	switch (chunk.m_chunk[0]) {
+	case kDataChunk:
+		sent = chunk.m_fileOffset + chunk.m_dataSize;
+		break;
+
+	case kDataEnd:
+		sent = transfer.m_size;
+		break;
+
+	default:
+		return true;
+	}
+
+	ProgressInfo* info = (ProgressInfo*)malloc(sizeof(ProgressInfo));
+	info->m_id   = i->first;
+	info->m_sent = sent;
+	info->m_size = transfer.m_size;
+	m_events->addEvent(Event(m_events->forFile().fileTransferProgress(),
+							m_eventTarget, info));
+
+	if (chunk.m_chunk[0] == kDataEnd) {
+		static MetricCounter* s_bytes = Metrics::getInstance().getCounter(
+							"synergy_file_sent_bytes_total",
+							"Bytes of dropped files sent.");
+		static MetricHistogram* s_time = Metrics::getInstance().getHistogram(
+							"synergy_file_send_seconds",
+							"Time from queueing a dropped file to sending its end.");
+		s_bytes->add(transfer.m_size);
+		s_time->add(static_cast<UInt64>(transfer.m_time.getTime() * 1.0e6));
+
+		LOG((CLOG_DEBUG "sent %s", transfer.m_name.c_str()));
+		m_transfers.erase(i);
+		m_ready.broadcast();
+	}
+	return true;
+}
+
+UInt32
+FileTransferQueue::addPath(const String& path, const String& name,
+				const String& destination, int depth)
+{
+	std::vector<std::string> entries;
+	if (ARCH->getDirectoryEntries(path, entries)) {
+		if (depth >= kMaxDepth) {
+			LOG((CLOG_WARN "not sending %s, directories too deep", path.c_str()));
+			return 0;
+		}
+
+		// send directories in a predictable order
+		std::sort(entries.begin(), entries.end());
+		UInt32 count = 0;
+		for (size_t i = 0; i < entries.size(); ++i) {
+			count += addPath(path +
+#ifdef SYSAPI_WIN32
+							"\\"
+#else
+							"/"
+#endif
+							+ entries[i], name + "/" + entries[i],
+							destination, depth + 1);
+		}
+		return count;
+	}
+
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if (!file.is_open()) {
+		LOG((CLOG_ERR "can not open %s for sending", path.c_str()));
+		return 0;
+	}
+	file.seekg(0, std::ios::end);
+	UInt64 size = static_cast<UInt64>(file.tellg());
+	file.close();
+
+	Transfer& transfer     = m_transfers[m_nextId++];
+	transfer.m_path        = path;
+	transfer.m_name        = name;
+	transfer.m_destination = destination;
+	transfer.m_size        = size;
+	transfer.m_offset      = 0;
+	transfer.m_attempt     = 0;
+	transfer.m_state       = kQueued;
+	return 1;
+}
+
+void
+FileTransferQueue::restart(Transfer& transfer)
+{
+	// the receiver says where to resume when the start is sent again
+	if (transfer.m_state != kQueued) {
+		transfer.m_state  = kQueued;
+		transfer.m_offset = 0;
+		++transfer.m_attempt;
+	}
+}
+
+FileTransferQueue::TransferMap::iterator
+FileTransferQueue::nextTransfer()
+{
+	size_t active = 0;
+	for (TransferMap::iterator i = m_transfers.begin();
+							i != m_transfers.end(); ++i) {
+		if (i->second.m_state != kQueued) {
+			++active;
+		}
+	}
+
+	// take turns, starting after the transfer that went last
+	TransferMap::iterator first = m_transfers.upper_bound(m_lastId);
+	for (size_t n = 0; n < m_transfers.size(); ++n, ++first) {
+		if (first == m_transfers.end()) {
+			first = m_transfers.begin();
+		}
+
+		const Transfer& transfer = first->second;
+		if (m_connected.count(transfer.m_destination) == 0) {
+			continue;
+		}
+		if (transfer.m_state == kSending ||
+			(transfer.m_state == kQueued && active < kMaxActive)) {
+			return first;
+		}
+	}
+	return m_transfers.end();
+}
+
+FileChunk*
+FileTransferQueue::nextChunk(UInt32& id, UInt32& attempt)
+{
+	String path;
+	UInt64 offset;
+	size_t size;
+	{
+		Lock lock(&m_mutex);
+		TransferMap::iterator i = nextTransfer();
+		while (i == m_transfers.end()) {
+			if (m_stopping || m_transfers.empty()) {
+				m_threadRunning = false;
+				return NULL;
+			}
+			m_ready.wait();
+			i = nextTransfer();
+		}
+
+		id              = i->first;
+		m_lastId        = id;
+		Transfer& transfer = i->second;
+		attempt         = transfer.m_attempt;
+
+		if (transfer.m_state == kQueued) {
+			transfer.m_state = kOffered;
+			return FileChunk::start(
+				synergy::string::sizeTypeToString(
+					static_cast<size_t>(transfer.m_size)) +
+				"," + transfer.m_name);
+		}
+
+		if (transfer.m_offset == transfer.m_size) {
+			transfer.m_state = kEnding;
+			return FileChunk::end();
+		}
+
+		path   = transfer.m_path;
+		offset = transfer.m_offset;
+		size   = static_cast<size_t>(std::min<UInt64>(kChunkSize,
+							transfer.m_size - offset));
+		transfer.m_offset += size;
+	}
+
+#if HAVE_SYS_SENDFILE_H
+	// the data is read when the chunk is sent
+	FileChunk* chunk = FileChunk::data(path, offset, size);
+#else
+	FileChunk* chunk = NULL;
+	std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+	if (file.is_open() && file.seekg(offset, std::ios::beg)) {
+		chunk = FileChunk::data(file, size);
+	}
+#endif
+	if (chunk == NULL) {
+		// ending early tells the receiver the file is incomplete
+		LOG((CLOG_ERR "failed to read %s", path.c_str()));
+		Lock lock(&m_mutex);
+		TransferMap::iterator i = m_transfers.find(id);
+		if (i != m_transfers.end() && i->second.m_attempt == attempt) {
+			i->second.m_state = kEnding;
+		}
+		return FileChunk::end();
+	}
+
+	chunk->m_fileOffset = offset;
+	return chunk;
+}
+
+void
+FileTransferQueue::sendThread(void*)
+{
+	LOG((CLOG_DEBUG "starting file transfer queue thread"));
+
+	for (;;) {
+		// wait for room before taking the next chunk so the transfers
+		// still take turns when the window is full
+		while (!m_window.wait(1.0)) {
+			Lock lock(&m_mutex);
+			if (m_stopping) {
+				m_threadRunning = false;
+				return;
+			}
+		}
+
+		UInt32 id      = 0;
+		UInt32 attempt = 0;
+		FileChunk* chunk = nextChunk(id, attempt);
+		if (chunk == NULL) {
+			break;
+		}
+
+		chunk->m_transferId      = id;
+		chunk->m_transferAttempt = attempt;
+		m_window.queued(*chunk);
+		m_events->addEvent(Event(m_events->forFile().fileChunkSending(),
+								m_eventTarget, chunk));
+	}
+
+	LOG((CLOG_DEBUG "file transfer queue thread finished"));
+}
@@ -0,0 +1,154 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/FileWindow.h"
+#include "mt/CondVar.h"
+#include "mt/Mutex.h"
+#include "base/String.h"
+#include "base/Stopwatch.h"
+#include "common/basic_types.h"
+#include "common/stdmap.h"
+#include "common/stdset.h"
+
+class FileChunk;
+class IEventQueue;
+class Thread;
+
+//! Queue of files to send
+/*!
+This class sends dragged files and directories to other screens.  A
+directory is sent as the files in it.  Every file is a transfer with
+its own id so the chunks of several files can be interleaved;  a
+sender thread takes one chunk from each active transfer in turn, so
+a small file doesn't wait for a big one to finish.
+
+The chunks are posted to the event target as \c fileChunkSending
+events, like the chunks of StreamChunker::sendFile().  The handler
+must pass each chunk to relay() to find out where it goes.  The queue
+reads no further ahead than its own FileWindow allows.
+
+A transfer that's cut off by a disconnect starts again when the
+destination reconnects, and the receiver answers the start of the
+file with the offset to resume from.
+*/
+class FileTransferQueue {
+public:
+	//! Transfer progress
+	/*!
+	Data of the \c fileTransferProgress event.
+	*/
+	class ProgressInfo {
+	public:
+		UInt32			m_id;
+		UInt64			m_sent;
+		UInt64			m_size;
+	};
+
+	FileTransferQueue(IEventQueue* events, void* eventTarget);
+	~FileTransferQueue();
+
+	//! @name manipulators
+	//@{
+
+	//! Queue file or directory
+	/*!
+	Queues the file or directory at \c path for sending to the screen
+	named \c destination.  Returns the number of files queued.
+	*/
+	UInt32				add(const String& path, const String& destination);
+
+	//! Accept transfer
+	/*!
+	Called when the receiver of transfer \c id answered its start.
+	The data is sent from \c offset on.
+	*/
+	void				accept(UInt32 id, UInt64 offset);
+
+	//! Note destination connected
+	/*!
+	Transfers to \c destination are sent from now on.
+	*/
+	void				connected(const String& destination);
+
+	//! Note destination disconnected
+	/*!
+	Transfers to \c destination stop until it reconnects.  Chunks
+	already posted for them are dropped by relay().
+	*/
+	void				disconnected(const String& destination);
+
+	//! Relay chunk
+	/*!
+	Called with a chunk from a \c fileChunkSending event before it's
+	sent.  Saves the screen the chunk goes to in \c destination and
+	sends a \c fileTransferProgress event.  Returns false if the chunk
+	must be dropped because its transfer has been cut off.
+	*/
+	bool				relay(const FileChunk& chunk, String& destination);
+
+	//@}
+
+private:
+	enum EState {
+		kQueued,	// start not sent yet
+		kOffered,	// start sent, waiting for accept
+		kSending,	// sending data
+		kEnding		// end sent
+	};
+
+	class Transfer {
+	public:
+		String			m_path;
+		String			m_name;
+		String			m_destination;
+		UInt64			m_size;
+		UInt64			m_offset;
+		UInt32			m_attempt;
+		EState			m_state;
+
+		// time since the file was queued
+		Stopwatch		m_time;
+	};
+	typedef std::map<UInt32, Transfer> TransferMap;
+
+	UInt32				addPath(const String& path, const String& name,
+							const String& destination, int depth);
+	void				restart(Transfer&);
+	TransferMap::iterator
+						nextTransfer();
+	FileChunk*			nextChunk(UInt32& id, UInt32& attempt);
+	void				sendThread(void*);
+
+private:
+	IEventQueue*		m_events;
+	void*				m_eventTarget;
+
+	Mutex				m_mutex;
+	CondVar<bool>		m_ready;
+	TransferMap			m_transfers;
+	std::set<String>	m_connected;
+	UInt32				m_nextId;
+	UInt32				m_lastId;
+
+	Thread*				m_thread;
+	bool				m_threadRunning;
+	bool				m_stopping;
+
+	FileWindow			m_window;
+};
@@ -0,0 +1,155 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileWindow.h"
+
+#include "synergy/FileChunk.h"
+#include "mt/Lock.h"
+#include "base/Stopwatch.h"
+
+#include <algorithm>
+
+// chunks a sender may have in flight
+static const UInt32		kWindowChunks = 4;
+
+//
+// FileWindow
+//
+
+FileWindow::FileWindow() :
+	m_changed(&m_mutex, false),
+	m_queued(0),
+	m_unflushed(0),
+	m_firstRunning(1),
+	m_nextSender(1)
+{
+	// do nothing
+}
+
+FileWindow::~FileWindow()
+{
+	// do nothing
+}
+
+UInt32
+FileWindow::startSender()
+{
+	Lock lock(&m_mutex);
+	m_firstRunning = m_nextSender;
+	m_changed.broadcast();
+	return m_nextSender++;
+}
+
+void
+FileWindow::stopSenders()
+{
+	Lock lock(&m_mutex);
+	m_firstRunning = m_nextSender;
+	m_changed.broadcast();
+}
+
+void
+FileWindow::queued(FileChunk& chunk)
+{
+	Lock lock(&m_mutex);
+	chunk.m_window = this;
+	++m_queued;
+}
+
+void
+FileWindow::relayed()
+{
+	Lock lock(&m_mutex);
+	if (m_queued > 0) {
+		--m_queued;
+	}
+	m_changed.broadcast();
+}
+
+void
+FileWindow::written()
+{
+	Lock lock(&m_mutex);
+	++m_unflushed;
+}
+
+void
+FileWindow::flushed(UInt32 count)
+{
+	Lock lock(&m_mutex);
+	m_unflushed -= std::min(count, m_unflushed);
+	m_changed.broadcast();
+}
+
+bool
+FileWindow::wait(double timeout)
+{
+	Lock lock(&m_mutex);
+
+	// chunks leave the window once the stream they were written to has
+	// sent them, so this waits for the socket rather than the disk.
+	const UInt32 firstRunning = m_firstRunning;
+	Stopwatch timer;
+	while (m_queued + m_unflushed >= kWindowChunks &&
+			m_firstRunning == firstRunning) {
+		if (!m_changed.wait(timer, timeout) &&
+			timer.getTime() >= timeout) {
+			return false;
+		}
+	}
+	return m_queued + m_unflushed < kWindowChunks;
+}
+
+bool
+FileWindow::isStopped(UInt32 sender) const
+{
+	Lock lock(&m_mutex);
+	return sender < m_firstRunning;
+}
+
+//
+// UnflushedFileChunks
+//
+
+UnflushedFileChunks::UnflushedFileChunks()
+{
+	// do nothing
+}
+
+UnflushedFileChunks::~UnflushedFileChunks()
+{
+	// the stream is going away so its chunks will never be sent
+	flushed();
+}
+
+void
+UnflushedFileChunks::written(const FileChunk& chunk)
+{
+	if (chunk.m_window != NULL) {
+		chunk.m_window->written();
+		++m_chunks[chunk.m_window];
+	}
+}
+
+void
+UnflushedFileChunks::flushed()
+{
+	for (WindowMap::iterator i = m_chunks.begin(); i != m_chunks.end(); ++i) {
+		i->first->flushed(i->second);
+	}
+	m_chunks.clear();
+}
@@ -0,0 +1,150 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "mt/CondVar.h"
+#include "mt/Mutex.h"
+#include "common/basic_types.h"
+#include "common/stdmap.h"
+
+class FileChunk;
+
+//! File chunk send window
+/*!
+Limits how far a file sender reads ahead of the connection it sends to.
+A chunk counts against the window from when it's queued until the
+stream it was written to has sent it, or until it's dropped.  Each
+sender owns its window so one connection's progress never opens the
+window of another.
+
+The sender thread queues chunks and waits for room;  the thread that
+handles the chunk events notes when they've been relayed, and the
+UnflushedFileChunks of the stream notes when they've been written and
+flushed.
+*/
+class FileWindow {
+public:
+	FileWindow();
+	~FileWindow();
+
+	//! @name manipulators
+	//@{
+
+	//! Start sender
+	/*!
+	Stops the senders started earlier and returns the id of a new one.
+	*/
+	UInt32				startSender();
+
+	//! Stop senders
+	/*!
+	Stops all senders started so far and wakes them if they're waiting.
+	*/
+	void				stopSenders();
+
+	//! Note chunk queued
+	/*!
+	Counts \c chunk against the window.  Called by the sender before it
+	adds the chunk's event to the event queue.
+	*/
+	void				queued(FileChunk& chunk);
+
+	//! Note chunk relayed
+	/*!
+	Called when a chunk's event has been taken off the event queue and
+	the chunk was written to a stream or dropped.
+	*/
+	void				relayed();
+
+	//! Note chunk written
+	/*!
+	Called when a chunk has been written to a stream.  It counts
+	against the window until flushed() is called for it.
+	*/
+	void				written();
+
+	//! Note chunks flushed
+	/*!
+	Called when a stream that \c count chunks were written to has sent
+	them, or has gone away.
+	*/
+	void				flushed(UInt32 count);
+
+	//! Wait for room
+	/*!
+	Waits up to \c timeout seconds for the window to have room for
+	another chunk.  Returns early if stopSenders() is called.  Returns
+	true iff there's room.
+	*/
+	bool				wait(double timeout);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Check sender stopped
+	/*!
+	Returns true iff the sender with id \c sender has been stopped.
+	*/
+	bool				isStopped(UInt32 sender) const;
+
+	//@}
+
+private:
+	Mutex				m_mutex;
+	CondVar<bool>		m_changed;
+
+	// chunks queued and not relayed yet, and chunks written to a stream
+	// that hasn't sent them yet
+	UInt32				m_queued;
+	UInt32				m_unflushed;
+
+	// senders with an id below this have been stopped
+	UInt32				m_firstRunning;
+	UInt32				m_nextSender;
+};
+
+//! File chunks written to a stream
+/*!
+Tracks the chunks written to one stream by the window they count
+against.  The stream's owner calls written() for each chunk it writes
+and flushed() when the stream has sent its buffered output.  Chunks
+still unflushed when this is destroyed are released, so the windows
+must outlive it.
+*/
+class UnflushedFileChunks {
+public:
+	UnflushedFileChunks();
+	~UnflushedFileChunks();
+
+	//! @name manipulators
+	//@{
+
+	//! Note chunk written
+	void				written(const FileChunk& chunk);
+
+	//! Note stream flushed
+	void				flushed();
+
+	//@}
+
+private:
+	typedef std::map<FileWindow*, UInt32> WindowMap;
+
+	WindowMap			m_chunks;
+};
@@ -17,6 +17,7 @@
  */
 
 #include "synergy/IKeyState.h"
+#include "synergy/LatencyTrace.h"
 #include "base/EventQueue.h"
 
 #include <cstring>
@@ -43,6 +44,7 @@ IKeyState::KeyInfo::alloc(KeyID id,
 	info->m_mask             = mask;
 	info->m_button           = button;
 	info->m_count            = count;
+	info->m_time             = LatencyTrace::getCaptureTime();
 	info->m_screens          = NULL;
 	info->m_screensBuffer[0] = '\0';
 	return info;
@@ -61,6 +63,7 @@ IKeyState::KeyInfo::alloc(KeyID id,
 	info->m_mask    = mask;
 	info->m_button  = button;
 	info->m_count   = count;
+	info->m_time    = LatencyTrace::getCaptureTime();
 	info->m_screens = info->m_screensBuffer;
 	strcpy(info->m_screensBuffer, screens.c_str());
 	return info;
@@ -75,6 +78,7 @@ IKeyState::KeyInfo::alloc(const KeyInfo& x)
 	info->m_mask    = x.m_mask;
 	info->m_button  = x.m_button;
 	info->m_count   = x.m_count;
+	info->m_time    = x.m_time;
 	info->m_screens = x.m_screens ? info->m_screensBuffer : NULL;
 	strcpy(info->m_screensBuffer, x.m_screensBuffer);
 	return info;
@@ -58,6 +58,7 @@ public:
 		KeyModifierMask	m_mask;
 		KeyButton		m_button;
 		SInt32			m_count;
+		UInt64			m_time;
 		char*			m_screens;
 		char			m_screensBuffer[1];
 	};
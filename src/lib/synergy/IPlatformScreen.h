@@ -20,14 +20,13 @@
 
 #include "synergy/DragInformation.h"
 #include "synergy/clipboard_types.h"
+#include "synergy/IClipboard.h"
 #include "synergy/IScreen.h"
 #include "synergy/IPrimaryScreen.h"
 #include "synergy/ISecondaryScreen.h"
 #include "synergy/IKeyState.h"
 #include "synergy/option_types.h"
 
-class IClipboard;
-
 //! Screen interface
 /*!
 This interface defines the methods common to all platform dependent
@@ -79,6 +78,28 @@ public:
 	*/
 	virtual bool		setClipboard(ClipboardID id, const IClipboard*) = 0;
 
+	//! Set clipboard with promised formats
+	/*!
+	Like setClipboard() but the clipboard also claims to have the
+	formats in \c promised, a bitmask of <tt>1 << format</tt>, whose
+	data is given later with fulfillClipboard().  When a program asks
+	for a promised format a \c clipboardFormatsRequested event is sent.
+	Returns false if the screen can't promise formats, in which case
+	the clipboard is unchanged.
+	*/
+	virtual bool		promiseClipboard(ClipboardID id,
+							const IClipboard*, UInt32 promised) = 0;
+
+	//! Fulfill promised clipboard format
+	/*!
+	Gives the \c data of \c format promised by promiseClipboard().
+	If \c data is NULL the data can't be had and requests for the
+	format fail.
+	*/
+	virtual void		fulfillClipboard(ClipboardID id,
+							IClipboard::EFormat format,
+							const String* data) = 0;
+
 	//! Check clipboard owner
 	/*!
 	Check ownership of all clipboards and post grab events for any that
@@ -151,6 +172,8 @@ public:
 	virtual void		getShape(SInt32& x, SInt32& y,
 							SInt32& width, SInt32& height) const = 0;
 	virtual void		getCursorPos(SInt32& x, SInt32& y) const = 0;
+	virtual const MonitorList&
+						getMonitors() const = 0;
 
 	// IPrimaryScreen overrides
 	virtual void		reconfigure(UInt32 activeSides) = 0;
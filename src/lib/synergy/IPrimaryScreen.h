@@ -51,6 +51,7 @@ public:
 	public:
 		SInt32			m_x;
 		SInt32			m_y;
+		UInt64			m_time;
 	};
 	//! Wheel motion event data
 	class WheelInfo {
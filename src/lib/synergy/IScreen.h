@@ -22,6 +22,7 @@
 #include "base/Event.h"
 #include "base/EventTypes.h"
 #include "common/IInterface.h"
+#include "common/stdvector.h"
 
 class IClipboard;
 
@@ -37,6 +38,31 @@ public:
 		UInt32			m_sequenceNumber;
 	};
 
+	//! Requested clipboard formats
+	/*!
+	\c m_formats has bit <tt>1 << format</tt> set for each requested
+	IClipboard::EFormat.
+	*/
+	struct ClipboardFormatInfo {
+	public:
+		ClipboardID		m_id;
+		UInt32			m_formats;
+	};
+
+	//! Monitor geometry
+	/*!
+	The position of the upper-left corner and the size of one monitor
+	making up a screen, in the same coordinates as \c getShape().
+	*/
+	struct MonitorInfo {
+	public:
+		SInt32			m_x;
+		SInt32			m_y;
+		SInt32			m_w;
+		SInt32			m_h;
+	};
+	typedef std::vector<MonitorInfo> MonitorList;
+
 	//! @name accessors
 	//@{
 
@@ -66,6 +92,16 @@ public:
 	Return the current position of the cursor in \c x and \c y.
 	*/
 	virtual void		getCursorPos(SInt32& x, SInt32& y) const = 0;
+
+	//! Get monitor geometry
+	/*!
+	Return the monitors making up the screen.  Screens that don't know
+	about their monitors return a single monitor covering the whole
+	screen shape.  The list is cached and only changes when the screen
+	shape changes, so this is cheap enough to call on every mouse motion.
+	*/
+	virtual const MonitorList&
+						getMonitors() const = 0;
 	
 	//@}
 };
@@ -26,6 +26,9 @@
 
 static const KeyButton kButtonMask = (KeyButton)(IKeyState::kNumButtons - 1);
 
+// number of layouts to keep finished key maps for
+static const size_t kMaxCachedKeyMaps = 8;
+
 static const KeyID s_decomposeTable[] = {
 	// spacing version of dead keys
 	0x0060, 0x0300, 0x0020, 0, // grave,        dead_grave,       space
@@ -387,6 +390,8 @@ KeyState::KeyState(IEventQueue* events) :
 	IKeyState(events),
 	m_keyMapPtr(new synergy::KeyMap()),
 	m_keyMap(*m_keyMapPtr),
+	m_keyMapSignature(0),
+	m_halfDuplexMask(0),
 	m_mask(0),
 	m_events(events)
 {
@@ -397,6 +402,8 @@ KeyState::KeyState(IEventQueue* events, synergy::KeyMap& keyMap) :
 	IKeyState(events),
 	m_keyMapPtr(0),
 	m_keyMap(keyMap),
+	m_keyMapSignature(0),
+	m_halfDuplexMask(0),
 	m_mask(0),
 	m_events(events)
 {
@@ -478,16 +485,46 @@ KeyState::sendKeyEvent(
 void
 KeyState::updateKeyMap()
 {
-	// get the current keyboard map
-	synergy::KeyMap keyMap;
-	getKeyMap(keyMap);
-	m_keyMap.swap(keyMap);
-	m_keyMap.finish();
+	// nothing to do if the layout hasn't changed
+	UInt64 signature = getKeyMapSignature();
+	if (signature != 0 && signature == m_keyMapSignature) {
+		LOG((CLOG_DEBUG1 "keyboard layout unchanged"));
+		return;
+	}
+
+	// keep the current key map in case we switch back to its layout
+	if (m_keyMapSignature != 0) {
+		stashKeyMap();
+	}
+	m_keyMapSignature = signature;
+
+	KeyMapCache::iterator i = m_keyMapCache.end();
+	if (signature != 0) {
+		i = m_keyMapCache.find(signature);
+	}
+	if (i != m_keyMapCache.end()) {
+		// reuse the key map we built last time we saw this layout
+		LOG((CLOG_DEBUG1 "using cached key map for layout %08x", (UInt32)signature));
+		m_keyMap.swap(i->second);
+		m_keyMapCache.erase(i);
+		m_keyMapCacheOrder.erase(std::find(m_keyMapCacheOrder.begin(),
+							m_keyMapCacheOrder.end(), signature));
+		restoreKeyMapState(signature);
+	}
+	else {
+		// get the current keyboard map
+		synergy::KeyMap keyMap;
+		getKeyMap(keyMap);
+		m_keyMap.swap(keyMap);
+		m_keyMap.finish();
 
-	// add special keys
-	addCombinationEntries();
-	addKeypadEntries();
-	addAliasEntries();
+		// add special keys
+		addCombinationEntries();
+		addKeypadEntries();
+		addAliasEntries();
+	}
+
+	setHalfDuplexMask(m_halfDuplexMask);
 }
 
 void
@@ -535,6 +572,7 @@ KeyState::addActiveModifierCB(KeyID, SInt32 group,
 void
 KeyState::setHalfDuplexMask(KeyModifierMask mask)
 {
+	m_halfDuplexMask = mask;
 	m_keyMap.clearHalfDuplexModifiers();
 	if ((mask & KeyModifierCapsLock) != 0) {
 		m_keyMap.addHalfDuplexModifier(kKeyCapsLock);
@@ -780,6 +818,47 @@ KeyState::getButton(KeyID id, SInt32 group) const
 	}
 }
 
+UInt64
+KeyState::getKeyMapSignature()
+{
+	return 0;
+}
+
+void
+KeyState::stashKeyMapState(UInt64)
+{
+	// do nothing
+}
+
+void
+KeyState::restoreKeyMapState(UInt64)
+{
+	// do nothing
+}
+
+void
+KeyState::discardKeyMapState(UInt64)
+{
+	// do nothing
+}
+
+void
+KeyState::stashKeyMap()
+{
+	// the current key map can't already be in the cache since it would
+	// have been removed when it was restored
+	m_keyMapCache[m_keyMapSignature].swap(m_keyMap);
+	m_keyMapCacheOrder.push_back(m_keyMapSignature);
+	stashKeyMapState(m_keyMapSignature);
+
+	if (m_keyMapCacheOrder.size() > kMaxCachedKeyMaps) {
+		UInt64 oldest = m_keyMapCacheOrder.front();
+		m_keyMapCacheOrder.pop_front();
+		m_keyMapCache.erase(oldest);
+		discardKeyMapState(oldest);
+	}
+}
+
 void
 KeyState::addAliasEntries()
 {
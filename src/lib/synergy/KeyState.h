@@ -20,6 +20,8 @@
 
 #include "synergy/IKeyState.h"
 #include "synergy/KeyMap.h"
+#include "common/stddeque.h"
+#include "common/stdmap.h"
 
 //! Core key state
 /*!
@@ -97,6 +99,41 @@ protected:
 	*/
 	virtual void		getKeyMap(synergy::KeyMap& keyMap) = 0;
 
+	//! Get the keyboard layout signature
+	/*!
+	Called at the start of every key map update.  Returns a value that
+	identifies the current keyboard layout or 0 if the layout can't be
+	identified.  Key maps are cached by signature so switching back to a
+	recently used layout doesn't call \c getKeyMap().  Subclasses that
+	return non-zero signatures must also implement \c stashKeyMapState(),
+	\c restoreKeyMapState() and \c discardKeyMapState() if \c getKeyMap()
+	derives any state of its own.  The default returns 0.
+	*/
+	virtual UInt64		getKeyMapSignature();
+
+	//! Stash layout state
+	/*!
+	Called when the key map for layout \p signature is put aside in the
+	layout cache.  Subclasses should put aside any state derived by
+	\c getKeyMap() under the same signature.  The default does nothing.
+	*/
+	virtual void		stashKeyMapState(UInt64 signature);
+
+	//! Restore layout state
+	/*!
+	Called instead of \c getKeyMap() when the key map for layout
+	\p signature is taken back out of the layout cache.  The default does
+	nothing.
+	*/
+	virtual void		restoreKeyMapState(UInt64 signature);
+
+	//! Discard layout state
+	/*!
+	Called when layout \p signature is evicted from the layout cache.
+	The default does nothing.
+	*/
+	virtual void		discardKeyMapState(UInt64 signature);
+
 	//! Fake a key event
 	/*!
 	Synthesize an event for \p keystroke.
@@ -140,6 +177,8 @@ protected:
 private:
 	typedef synergy::KeyMap::Keystrokes Keystrokes;
 	typedef synergy::KeyMap::ModifierToKeys ModifierToKeys;
+	typedef std::map<UInt64, synergy::KeyMap> KeyMapCache;
+	typedef std::deque<UInt64> KeyMapCacheOrder;
 public:
 	struct AddActiveModifierContext {
 	public:
@@ -185,6 +224,10 @@ private:
 	// dead keys)
 	void				addCombinationEntries();
 
+	// moves the key map into the layout cache, evicting the least
+	// recently used layout if the cache is full
+	void				stashKeyMap();
+
 	// synthesize key events.  synthesize auto-repeat events count times.
 	void				fakeKeys(const Keystrokes&, UInt32 count);
 
@@ -204,6 +247,18 @@ private:
 	// the keyboard map
 	synergy::KeyMap&			m_keyMap;
 
+	// signature of the layout m_keyMap was built for (0 if unknown)
+	UInt64				m_keyMapSignature;
+
+	// finished key maps for recently used layouts, by signature.  the
+	// order lists signatures from least to most recently stashed.
+	KeyMapCache			m_keyMapCache;
+	KeyMapCacheOrder	m_keyMapCacheOrder;
+
+	// half-duplex modifiers set by the user.  these aren't part of the
+	// layout so they're reapplied after every key map update.
+	KeyModifierMask		m_halfDuplexMask;
+
 	// current modifier state
 	KeyModifierMask		m_mask;
 
@@ -0,0 +1,114 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/LatencyHistogram.h"
+
+#include <cstring>
+
+//
+// LatencyHistogram
+//
+
+LatencyHistogram::LatencyHistogram() :
+	m_count(0)
+{
+	memset(m_counts, 0, sizeof(m_counts));
+}
+
+void
+LatencyHistogram::add(UInt64 us)
+{
+	++m_counts[getBucket(us)];
+	++m_count;
+}
+
+void
+LatencyHistogram::add(const LatencyHistogram& histogram)
+{
+	for (UInt32 i = 0; i < kNumBuckets; ++i) {
+		m_counts[i] += histogram.m_counts[i];
+	}
+	m_count += histogram.m_count;
+}
+
+bool
+LatencyHistogram::addToBucket(UInt32 bucket, UInt32 count)
+{
+	if (bucket >= kNumBuckets) {
+		return false;
+	}
+	m_counts[bucket] += count;
+	m_count          += count;
+	return true;
+}
+
+void
+LatencyHistogram::clear()
+{
+	memset(m_counts, 0, sizeof(m_counts));
+	m_count = 0;
+}
+
+UInt64
+LatencyHistogram::getCount() const
+{
+	return m_count;
+}
+
+UInt32
+LatencyHistogram::getBucketCount(UInt32 bucket) const
+{
+	return (bucket < kNumBuckets) ? m_counts[bucket] : 0;
+}
+
+UInt64
+LatencyHistogram::getPercentile(double percent) const
+{
+	if (m_count == 0) {
+		return 0;
+	}
+
+	// find the bucket holding the latency with the wanted rank
+	UInt64 rank = static_cast<UInt64>(percent / 100.0 *
+							static_cast<double>(m_count) + 0.5);
+	if (rank < 1) {
+		rank = 1;
+	}
+	else if (rank > m_count) {
+		rank = m_count;
+	}
+	UInt64 seen = 0;
+	for (UInt32 i = 0; i < kNumBuckets; ++i) {
+		seen += m_counts[i];
+		if (seen >= rank) {
+			return getBucketLimit(i);
+		}
+	}
+	return getBucketLimit(kNumBuckets - 1);
+}
+
+UInt32
+LatencyHistogram::getBucket(UInt64 us)
+{
+	return MetricHistogram::getBucket(us);
+}
+
+UInt64
+LatencyHistogram::getBucketLimit(UInt32 bucket)
+{
+	return MetricHistogram::getBucketLimit(bucket);
+}
@@ -0,0 +1,95 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/MetricTypes.h"
+#include "common/basic_types.h"
+
+//! Histogram of latencies
+/*!
+Counts latencies in microseconds in buckets whose width grows with the
+latency, so percentiles are within 1/8 of the true value from 16us up
+to over an hour while the histogram stays small and fixed in size.
+Latencies below 16us are counted exactly.  The buckets are those of
+MetricHistogram, so a histogram can be exported as a metric bucket by
+bucket.
+*/
+class LatencyHistogram {
+public:
+	enum {
+		//! Number of buckets
+		kNumBuckets = MetricHistogram::kNumBuckets
+	};
+
+	LatencyHistogram();
+
+	//! @name manipulators
+	//@{
+
+	//! Add a latency
+	/*!
+	Counts a latency of \c us microseconds.
+	*/
+	void				add(UInt64 us);
+
+	//! Add a histogram
+	/*!
+	Adds the counts of \c histogram to this one.
+	*/
+	void				add(const LatencyHistogram& histogram);
+
+	//! Add to a bucket
+	/*!
+	Adds \c count to bucket \c bucket.  Returns false if there's no
+	such bucket.
+	*/
+	bool				addToBucket(UInt32 bucket, UInt32 count);
+
+	//! Remove all counts
+	void				clear();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get number of latencies
+	UInt64				getCount() const;
+
+	//! Get count of a bucket
+	UInt32				getBucketCount(UInt32 bucket) const;
+
+	//! Get percentile
+	/*!
+	Returns the latency in microseconds that \c percent percent of the
+	counted latencies don't exceed, rounded up to the end of its
+	bucket.  Returns 0 if the histogram is empty.
+	*/
+	UInt64				getPercentile(double percent) const;
+
+	//! Get bucket of a latency
+	static UInt32		getBucket(UInt64 us);
+
+	//! Get highest latency of a bucket
+	static UInt64		getBucketLimit(UInt32 bucket);
+
+	//@}
+
+private:
+	UInt32				m_counts[kNumBuckets];
+	UInt64				m_count;
+};
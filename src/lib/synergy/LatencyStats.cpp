@@ -0,0 +1,137 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/LatencyStats.h"
+
+// each bucket is sent as the stage, the bucket and its count
+static const size_t		kFieldsPerBucket = 3;
+
+static const char*		s_stageNames[] = {
+	"queue",
+	"relay",
+	"network",
+	"inject",
+	"total"
+};
+
+//
+// LatencyStats
+//
+
+LatencyStats::LatencyStats()
+{
+	// do nothing
+}
+
+void
+LatencyStats::add(EStage stage, UInt64 us)
+{
+	m_stages[stage].add(us);
+}
+
+void
+LatencyStats::add(const LatencyStats& stats)
+{
+	for (int i = 0; i < kNumStages; ++i) {
+		m_stages[i].add(stats.m_stages[i]);
+	}
+}
+
+void
+LatencyStats::clear()
+{
+	for (int i = 0; i < kNumStages; ++i) {
+		m_stages[i].clear();
+	}
+}
+
+bool
+LatencyStats::unmarshall(const std::vector<UInt32>& data)
+{
+	clear();
+	if (data.size() % kFieldsPerBucket != 0) {
+		return false;
+	}
+
+	for (size_t i = 0; i < data.size(); i += kFieldsPerBucket) {
+		if (data[i] >= static_cast<UInt32>(kNumStages) ||
+			!m_stages[data[i]].addToBucket(data[i + 1], data[i + 2])) {
+			clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+const LatencyHistogram&
+LatencyStats::get(EStage stage) const
+{
+	return m_stages[stage];
+}
+
+bool
+LatencyStats::isEmpty() const
+{
+	for (int i = 0; i < kNumStages; ++i) {
+		if (m_stages[i].getCount() != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void
+LatencyStats::marshall(std::vector<UInt32>& data) const
+{
+	data.clear();
+	for (int i = 0; i < kNumStages; ++i) {
+		for (UInt32 j = 0; j < LatencyHistogram::kNumBuckets; ++j) {
+			UInt32 count = m_stages[i].getBucketCount(j);
+			if (count != 0) {
+				data.push_back(static_cast<UInt32>(i));
+				data.push_back(j);
+				data.push_back(count);
+			}
+		}
+	}
+}
+
+String
+LatencyStats::format() const
+{
+	String result;
+	for (int i = 0; i < kNumStages; ++i) {
+		const LatencyHistogram& histogram = m_stages[i];
+		if (histogram.getCount() == 0) {
+			continue;
+		}
+		if (!result.empty()) {
+			result += ", ";
+		}
+		result += synergy::string::sprintf("%s p50=%.2fms p99=%.2fms",
+							s_stageNames[i],
+							histogram.getPercentile(50.0) / 1000.0,
+							histogram.getPercentile(99.0) / 1000.0);
+	}
+	return result;
+}
+
+const char*
+LatencyStats::getStageName(EStage stage)
+{
+	return s_stageNames[stage];
+}
@@ -0,0 +1,99 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/LatencyHistogram.h"
+#include "base/String.h"
+#include "common/stdvector.h"
+
+//! Latencies of traced input events
+/*!
+Holds a LatencyHistogram for each step an input event takes from the
+primary screen to the secondary screen, and one for the whole way.
+*/
+class LatencyStats {
+public:
+	enum EStage {
+		kQueue,			//!< Captured to handled by the server
+		kRelay,			//!< Handled to sent to the client
+		kNetwork,		//!< Sent to received by the client
+		kInject,		//!< Received to injected by the client
+		kTotal,			//!< Captured to injected
+		kNumStages
+	};
+
+	LatencyStats();
+
+	//! @name manipulators
+	//@{
+
+	//! Add a latency
+	/*!
+	Counts a latency of \c us microseconds for \c stage.
+	*/
+	void				add(EStage stage, UInt64 us);
+
+	//! Add statistics
+	void				add(const LatencyStats& stats);
+
+	//! Remove all counts
+	void				clear();
+
+	//! Set from marshalled data
+	/*!
+	Replaces the counts with those from \c data, as made by
+	marshall().  Returns false and leaves the statistics empty if
+	\c data is invalid.
+	*/
+	bool				unmarshall(const std::vector<UInt32>& data);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get histogram of a stage
+	const LatencyHistogram&
+						get(EStage stage) const;
+
+	//! Test if empty
+	/*!
+	Returns true if no latencies were counted.
+	*/
+	bool				isEmpty() const;
+
+	//! Marshall statistics
+	/*!
+	Saves the statistics in \c data, as the stage, bucket and count of
+	each bucket that isn't empty, for a kMsgDLatency message.
+	*/
+	void				marshall(std::vector<UInt32>& data) const;
+
+	//! Format statistics
+	/*!
+	Returns the 50th and 99th percentile of each stage as text.
+	*/
+	String				format() const;
+
+	//! Get name of a stage
+	static const char*	getStageName(EStage stage);
+
+	//@}
+
+private:
+	LatencyHistogram	m_stages[kNumStages];
+};
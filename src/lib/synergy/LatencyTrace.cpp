@@ -0,0 +1,93 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/LatencyTrace.h"
+
+#include <assert.h>
+#include <chrono>
+
+//
+// LatencyTrace
+//
+
+std::atomic<int>		LatencyTrace::s_enabled(0);
+std::atomic<UInt64>		LatencyTrace::s_captureTime(0);
+std::atomic<UInt64>		LatencyTrace::s_injectTime(0);
+
+void
+LatencyTrace::setEnabled(bool enabled)
+{
+	if (enabled) {
+		++s_enabled;
+	}
+	else if (--s_enabled == 0) {
+		s_captureTime = 0;
+		s_injectTime  = 0;
+	}
+	assert(s_enabled >= 0);
+}
+
+void
+LatencyTrace::injected()
+{
+	if (s_enabled > 0) {
+		s_injectTime = now();
+	}
+}
+
+bool
+LatencyTrace::isEnabled()
+{
+	return s_enabled > 0;
+}
+
+UInt64
+LatencyTrace::now()
+{
+	using namespace std::chrono;
+	return static_cast<UInt64>(duration_cast<microseconds>(
+							steady_clock::now().time_since_epoch()).count());
+}
+
+UInt64
+LatencyTrace::getCaptureTime()
+{
+	return s_captureTime;
+}
+
+UInt64
+LatencyTrace::getInjectTime()
+{
+	return s_injectTime;
+}
+
+
+//
+// LatencyTrace::CaptureScope
+//
+
+LatencyTrace::CaptureScope::CaptureScope()
+{
+	if (s_enabled > 0) {
+		s_captureTime = now();
+	}
+}
+
+LatencyTrace::CaptureScope::~CaptureScope()
+{
+	s_captureTime = 0;
+}
@@ -0,0 +1,119 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "common/basic_types.h"
+
+#include <atomic>
+
+//! Input event times
+/*!
+The times an input event on the primary screen was captured by the
+platform screen and handled by the server, in LatencyTrace::now()
+microseconds.  Both are 0 if the event isn't traced.
+*/
+class InputTime {
+public:
+	InputTime() : m_captured(0), m_handled(0) { }
+
+public:
+	UInt64				m_captured;
+	UInt64				m_handled;
+};
+
+//! Input latency tracing
+/*!
+When latency tracing is enabled, input events are stamped with a
+monotonic clock as they're captured on the primary screen, relayed by
+the server, received by the client and injected on the secondary
+screen, so the latency of each step can be measured.  Tracing is off
+unless enabled with the \c latencyTrace option.
+
+The state is shared by the whole process and safe to use from any
+thread, but there's only one capture time and one inject time.  So
+only one primary screen and one secondary screen per process are
+traced reliably; with more, their times may mix.
+*/
+class LatencyTrace {
+public:
+	//! Capture scope
+	/*!
+	Platform screens create one of these while handling a system
+	event.  Input events allocated meanwhile carry the time the scope
+	was created as their capture time.
+	*/
+	class CaptureScope {
+	public:
+		CaptureScope();
+		~CaptureScope();
+	};
+
+	//! @name manipulators
+	//@{
+
+	//! Enable or disable tracing
+	/*!
+	Tracing is on while anything has it enabled, so a server and a
+	client in one process don't turn it off for each other.  Each call
+	enabling tracing must be matched by one disabling it.
+	*/
+	static void			setEnabled(bool enabled);
+
+	//! Note an injected event
+	/*!
+	Platform screens call this after synthesizing an input event.
+	*/
+	static void			injected();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Test if tracing is enabled
+	static bool			isEnabled();
+
+	//! Get the time
+	/*!
+	Returns the time of a monotonic clock in microseconds.  The
+	clock's epoch is arbitrary so only differences are meaningful,
+	and clocks of different computers must be compared using a
+	ClockOffset.
+	*/
+	static UInt64		now();
+
+	//! Get capture time
+	/*!
+	Returns the time the current CaptureScope was created or 0 if
+	there's none or tracing is disabled.
+	*/
+	static UInt64		getCaptureTime();
+
+	//! Get inject time
+	/*!
+	Returns the time of the last call to injected() while tracing was
+	enabled, or 0 if there was none.
+	*/
+	static UInt64		getInjectTime();
+
+	//@}
+
+private:
+	static std::atomic<int>		s_enabled;
+	static std::atomic<UInt64>	s_captureTime;
+	static std::atomic<UInt64>	s_injectTime;
+};
@@ -0,0 +1,174 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/MetricsServer.h"
+
+#include "net/IDataSocket.h"
+#include "net/TCPListenSocket.h"
+#include "base/IEventQueue.h"
+#include "base/Log.h"
+#include "base/Metrics.h"
+#include "base/TMethodEventJob.h"
+
+//
+// MetricsServer
+//
+
+MetricsServer::MetricsServer(IEventQueue* events,
+				SocketMultiplexer* socketMultiplexer, int port) :
+	m_events(events),
+	m_socket(new TCPListenSocket(events, socketMultiplexer)),
+	m_address(NetworkAddress("127.0.0.1", port))
+{
+	m_events->adoptHandler(m_events->forIListenSocket().connecting(),
+							m_socket,
+							new TMethodEventJob<MetricsServer>(this,
+								&MetricsServer::handleConnecting));
+}
+
+MetricsServer::~MetricsServer()
+{
+	m_events->removeHandler(m_events->forIListenSocket().connecting(),
+							m_socket);
+	while (!m_connections.empty()) {
+		removeConnection(*m_connections.begin());
+	}
+	delete m_socket;
+}
+
+void
+MetricsServer::listen()
+{
+	m_address.resolve();
+	m_socket->bind(m_address);
+	LOG((CLOG_NOTE "serving metrics on http://%s:%d/metrics",
+		m_address.getHostname().c_str(), m_address.getPort()));
+}
+
+void
+MetricsServer::handleConnecting(const Event&, void*)
+{
+	IDataSocket* socket = m_socket->accept();
+	if (socket == NULL) {
+		return;
+	}
+
+	Connection* connection  = new Connection;
+	connection->m_socket    = socket;
+	connection->m_responded = false;
+	m_connections.insert(connection);
+
+	void* target = socket->getEventTarget();
+	m_events->adoptHandler(m_events->forIStream().inputReady(), target,
+							new TMethodEventJob<MetricsServer>(this,
+								&MetricsServer::handleData, connection));
+	m_events->adoptHandler(m_events->forIStream().outputFlushed(), target,
+							new TMethodEventJob<MetricsServer>(this,
+								&MetricsServer::handleFlushed, connection));
+	m_events->adoptHandler(m_events->forIStream().inputShutdown(), target,
+							new TMethodEventJob<MetricsServer>(this,
+								&MetricsServer::handleDisconnected, connection));
+	m_events->adoptHandler(m_events->forIStream().outputError(), target,
+							new TMethodEventJob<MetricsServer>(this,
+								&MetricsServer::handleDisconnected, connection));
+	m_events->adoptHandler(m_events->forISocket().disconnected(), target,
+							new TMethodEventJob<MetricsServer>(this,
+								&MetricsServer::handleDisconnected, connection));
+}
+
+void
+MetricsServer::handleData(const Event&, void* vconnection)
+{
+	Connection* connection = static_cast<Connection*>(vconnection);
+
+	char buffer[1024];
+	UInt32 n = connection->m_socket->read(buffer, sizeof(buffer));
+	while (n > 0) {
+		if (!connection->m_responded) {
+			connection->m_request.append(buffer, n);
+		}
+		n = connection->m_socket->read(buffer, sizeof(buffer));
+	}
+	if (connection->m_responded) {
+		return;
+	}
+
+	// respond once the headers have arrived
+	if (connection->m_request.find("\r\n\r\n") != String::npos ||
+		connection->m_request.find("\n\n") != String::npos) {
+		respond(connection);
+	}
+	else if (connection->m_request.size() > kMaxRequestSize) {
+		LOG((CLOG_DEBUG "metrics request too long"));
+		removeConnection(connection);
+	}
+}
+
+void
+MetricsServer::handleFlushed(const Event&, void* vconnection)
+{
+	// the response is sent, let the other side close the connection
+	Connection* connection = static_cast<Connection*>(vconnection);
+	if (connection->m_responded) {
+		connection->m_socket->shutdownOutput();
+	}
+}
+
+void
+MetricsServer::handleDisconnected(const Event&, void* vconnection)
+{
+	removeConnection(static_cast<Connection*>(vconnection));
+}
+
+void
+MetricsServer::respond(Connection* connection)
+{
+	String status;
+	String body;
+	if (connection->m_request.compare(0, 4, "GET ") == 0) {
+		status = "200 OK";
+		body   = Metrics::getInstance().format();
+	}
+	else {
+		status = "405 Method Not Allowed";
+	}
+
+	String response = synergy::string::sprintf(
+							"HTTP/1.0 %s\r\n"
+							"Content-Type: text/plain; version=0.0.4\r\n"
+							"Content-Length: %u\r\n"
+							"Connection: close\r\n"
+							"\r\n",
+							status.c_str(),
+							static_cast<unsigned int>(body.size()));
+	response += body;
+
+	connection->m_responded = true;
+	connection->m_socket->write(response.data(),
+							static_cast<UInt32>(response.size()));
+}
+
+void
+MetricsServer::removeConnection(Connection* connection)
+{
+	if (m_connections.erase(connection) == 0) {
+		return;
+	}
+	m_events->removeHandlers(connection->m_socket->getEventTarget());
+	delete connection->m_socket;
+	delete connection;
+}
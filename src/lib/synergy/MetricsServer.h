@@ -0,0 +1,79 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "net/NetworkAddress.h"
+#include "base/String.h"
+#include "common/stdset.h"
+
+class Event;
+class IDataSocket;
+class IEventQueue;
+class IListenSocket;
+class SocketMultiplexer;
+
+//! Metrics HTTP server
+/*!
+Serves the metrics of Metrics::getInstance() to Prometheus over HTTP on
+a localhost port.  Every GET request gets the metrics, whatever its
+path, and the connection is closed after the response.
+*/
+class MetricsServer {
+public:
+	enum {
+		//! Longest request read before giving up on a connection
+		kMaxRequestSize = 8 * 1024
+	};
+
+	MetricsServer(IEventQueue* events, SocketMultiplexer* socketMultiplexer,
+							int port);
+	~MetricsServer();
+
+	//! @name manipulators
+	//@{
+
+	//! Start listening
+	/*!
+	Throws XSocket if the port can't be listened on.
+	*/
+	void				listen();
+
+	//@}
+
+private:
+	class Connection {
+	public:
+		IDataSocket*	m_socket;
+		String			m_request;
+		bool			m_responded;
+	};
+	typedef std::set<Connection*> ConnectionSet;
+
+	void				handleConnecting(const Event&, void*);
+	void				handleData(const Event&, void* vconnection);
+	void				handleFlushed(const Event&, void* vconnection);
+	void				handleDisconnected(const Event&, void* vconnection);
+	void				respond(Connection*);
+	void				removeConnection(Connection*);
+
+private:
+	IEventQueue*		m_events;
+	IListenSocket*		m_socket;
+	NetworkAddress		m_address;
+	ConnectionSet		m_connections;
+};
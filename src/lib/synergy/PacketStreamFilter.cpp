@@ -17,9 +17,12 @@
  */
 
 #include "synergy/PacketStreamFilter.h"
+#include "io/SharedBuffer.h"
 #include "base/IEventQueue.h"
+#include "base/Metrics.h"
 #include "mt/Lock.h"
 #include "base/TMethodEventJob.h"
+#include "common/stdvector.h"
 
 #include <cstring>
 #include <memory>
@@ -32,7 +35,12 @@ PacketStreamFilter::PacketStreamFilter(IEventQueue* events, synergy::IStream* st
 	StreamFilter(events, stream, adoptStream),
 	m_size(0),
 	m_inputShutdown(false),
-	m_events(events)
+	m_events(events),
+	m_counted(false),
+	m_bytesIn(NULL),
+	m_bytesOut(NULL),
+	m_packetsIn(NULL),
+	m_packetsOut(NULL)
 {
 	// do nothing
 }
@@ -42,6 +50,22 @@ PacketStreamFilter::~PacketStreamFilter()
 	// do nothing
 }
 
+void
+PacketStreamFilter::setPeerName(const String& name)
+{
+	Metrics& metrics = Metrics::getInstance();
+	String peer      = Metrics::label("peer", name);
+	m_bytesIn    = metrics.getCounter("synergy_peer_received_bytes_total",
+						"Bytes received from a peer, including framing.", peer);
+	m_bytesOut   = metrics.getCounter("synergy_peer_sent_bytes_total",
+						"Bytes sent to a peer, including framing.", peer);
+	m_packetsIn  = metrics.getCounter("synergy_peer_received_packets_total",
+						"Packets received from a peer.", peer);
+	m_packetsOut = metrics.getCounter("synergy_peer_sent_packets_total",
+						"Packets sent to a peer.", peer);
+	m_counted.store(true, std::memory_order_release);
+}
+
 void
 PacketStreamFilter::close()
 {
@@ -102,6 +126,46 @@ PacketStreamFilter::write(const void* buffer, UInt32 count)
 
 	// write the payload
 	getStream()->write(buffer, count);
+	countWrite(count);
+}
+
+bool
+PacketStreamFilter::writeFile(const void* header, UInt32 headerSize,
+				int fd, UInt64 offset, UInt32 n)
+{
+	// the length of the payload goes in front of the header
+	UInt32 count = headerSize + n;
+	std::vector<UInt8> packetHeader(4 + headerSize);
+	packetHeader[0] = (UInt8)((count >> 24) & 0xff);
+	packetHeader[1] = (UInt8)((count >> 16) & 0xff);
+	packetHeader[2] = (UInt8)((count >>  8) & 0xff);
+	packetHeader[3] = (UInt8)( count        & 0xff);
+	if (headerSize > 0) {
+		memcpy(&packetHeader[4], header, headerSize);
+	}
+
+	if (!getStream()->writeFile(&packetHeader[0],
+							(UInt32)packetHeader.size(), fd, offset, n)) {
+		return false;
+	}
+	countWrite(count);
+	return true;
+}
+
+void
+PacketStreamFilter::writeShared(SharedBuffer* buffer)
+{
+	// the length is per packet but the payload is shared as is
+	UInt32 count = buffer->getSize();
+	UInt8 length[4];
+	length[0] = (UInt8)((count >> 24) & 0xff);
+	length[1] = (UInt8)((count >> 16) & 0xff);
+	length[2] = (UInt8)((count >>  8) & 0xff);
+	length[3] = (UInt8)( count        & 0xff);
+	getStream()->write(length, sizeof(length));
+
+	getStream()->writeShared(buffer);
+	countWrite(count);
 }
 
 void
@@ -146,6 +210,7 @@ PacketStreamFilter::readPacketSize()
 				 ((UInt32)buffer[1] << 16) |
 				 ((UInt32)buffer[2] <<  8) |
 				  (UInt32)buffer[3];
+		countRead(m_size);
 	}
 }
 
@@ -175,6 +240,24 @@ PacketStreamFilter::readMore()
 	return (wasReady != isReady);
 }
 
+void
+PacketStreamFilter::countRead(UInt32 size)
+{
+	if (m_counted.load(std::memory_order_acquire)) {
+		m_packetsIn->add();
+		m_bytesIn->add(4 + static_cast<UInt64>(size));
+	}
+}
+
+void
+PacketStreamFilter::countWrite(UInt32 size)
+{
+	if (m_counted.load(std::memory_order_acquire)) {
+		m_packetsOut->add();
+		m_bytesOut->add(4 + static_cast<UInt64>(size));
+	}
+}
+
 void
 PacketStreamFilter::filterEvent(const Event& event)
 {
@@ -21,8 +21,12 @@
 #include "io/StreamFilter.h"
 #include "io/StreamBuffer.h"
 #include "mt/Mutex.h"
+#include "base/String.h"
+
+#include <atomic>
 
 class IEventQueue;
+class MetricCounter;
 
 //! Packetizing stream filter 
 /*!
@@ -33,10 +37,26 @@ public:
 	PacketStreamFilter(IEventQueue* events, synergy::IStream* stream, bool adoptStream = true);
 	~PacketStreamFilter();
 
+	//! @name manipulators
+	//@{
+
+	//! Set peer name
+	/*!
+	Starts counting the packets and bytes read and written in the
+	metrics of peer \c name.  Nothing is counted before this is called
+	and it must only be called once.
+	*/
+	void				setPeerName(const String& name);
+
+	//@}
+
 	// IStream overrides
 	virtual void		close();
 	virtual UInt32		read(void* buffer, UInt32 n);
 	virtual void		write(const void* buffer, UInt32 n);
+	virtual bool		writeFile(const void* header, UInt32 headerSize,
+							int fd, UInt64 offset, UInt32 n);
+	virtual void		writeShared(SharedBuffer* buffer);
 	virtual void		shutdownInput();
 	virtual bool		isReady() const;
 	virtual UInt32		getSize() const;
@@ -49,6 +69,8 @@ private:
 	bool				isReadyNoLock() const;
 	void				readPacketSize();
 	bool				readMore();
+	void				countRead(UInt32 size);
+	void				countWrite(UInt32 size);
 
 private:
 	Mutex				m_mutex;
@@ -56,4 +78,11 @@ private:
 	StreamBuffer		m_buffer;
 	bool				m_inputShutdown;
 	IEventQueue*		m_events;
+
+	// metrics of the peer, valid once m_counted is set
+	std::atomic<bool>	m_counted;
+	MetricCounter*		m_bytesIn;
+	MetricCounter*		m_bytesOut;
+	MetricCounter*		m_packetsIn;
+	MetricCounter*		m_packetsOut;
 };
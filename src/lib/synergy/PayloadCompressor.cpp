@@ -0,0 +1,254 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/PayloadCompressor.h"
+
+#include "synergy/protocol_types.h"
+#include "common/stdvector.h"
+
+#include <cstring>
+
+//
+// LZ4 block format.  a block is a list of sequences, each a token
+// byte holding the literal length and the match length less 4, the
+// literals, a 2 byte little endian offset back to the match and any
+// extra length bytes.  the last sequence has literals only and the
+// last kLastLiterals bytes are always literals.
+//
+
+static const size_t		kMinMatch      = 4;
+static const size_t		kLastLiterals  = 5;
+static const size_t		kMatchLimit    = 12;
+static const size_t		kMaxOffset     = 65535;
+static const int		kHashLog       = 12;
+
+static inline UInt32
+read32(const UInt8* p)
+{
+	UInt32 v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline UInt32
+hash32(UInt32 v)
+{
+	return (v * 2654435761U) >> (32 - kHashLog);
+}
+
+static void
+writeLength(String& out, size_t length)
+{
+	while (length >= 255) {
+		out.push_back(static_cast<char>(255));
+		length -= 255;
+	}
+	out.push_back(static_cast<char>(length));
+}
+
+static void
+writeSequence(String& out, const UInt8* literals, size_t literalLength,
+				size_t offset, size_t matchLength)
+{
+	size_t tokenPos = out.size();
+	out.push_back(0);
+
+	UInt8 token = static_cast<UInt8>(
+					(literalLength < 15 ? literalLength : 15) << 4);
+	if (literalLength >= 15) {
+		writeLength(out, literalLength - 15);
+	}
+	out.append(reinterpret_cast<const char*>(literals), literalLength);
+
+	if (matchLength != 0) {
+		out.push_back(static_cast<char>(offset & 0xff));
+		out.push_back(static_cast<char>((offset >> 8) & 0xff));
+
+		size_t length = matchLength - kMinMatch;
+		token |= static_cast<UInt8>(length < 15 ? length : 15);
+		if (length >= 15) {
+			writeLength(out, length - 15);
+		}
+	}
+
+	out[tokenPos] = static_cast<char>(token);
+}
+
+static void
+compressBlock(const UInt8* src, size_t size, String& out)
+{
+	size_t anchor = 0;
+	if (size > kMatchLimit) {
+		std::vector<UInt32> table(static_cast<size_t>(1) << kHashLog, 0);
+		const size_t matchStartLimit = size - kMatchLimit;
+		const size_t matchEndLimit   = size - kLastLiterals;
+
+		size_t ip = 0;
+		while (ip < matchStartLimit) {
+			UInt32 sequence  = read32(src + ip);
+			UInt32 h         = hash32(sequence);
+			size_t candidate = table[h];
+			table[h]         = static_cast<UInt32>(ip);
+
+			if (candidate >= ip || ip - candidate > kMaxOffset ||
+				read32(src + candidate) != sequence) {
+				// skip faster through data that doesn't match
+				ip += 1 + ((ip - anchor) >> 6);
+				continue;
+			}
+
+			size_t length = kMinMatch;
+			while (ip + length < matchEndLimit &&
+					src[candidate + length] == src[ip + length]) {
+				++length;
+			}
+
+			writeSequence(out, src + anchor, ip - anchor,
+							ip - candidate, length);
+			ip    += length;
+			anchor = ip;
+		}
+	}
+
+	writeSequence(out, src + anchor, size - anchor, 0, 0);
+}
+
+static bool
+readLength(const UInt8* src, size_t size, size_t& ip, size_t& length)
+{
+	UInt8 b;
+	do {
+		if (ip >= size) {
+			return false;
+		}
+		b       = src[ip++];
+		length += b;
+	} while (b == 255);
+	return true;
+}
+
+static bool
+decompressBlock(const UInt8* src, size_t size, char* dst, size_t dstSize)
+{
+	size_t ip = 0;
+	size_t op = 0;
+	while (ip < size) {
+		UInt8 token = src[ip++];
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15 && !readLength(src, size, ip, literalLength)) {
+			return false;
+		}
+		if (literalLength > size - ip || literalLength > dstSize - op) {
+			return false;
+		}
+		memcpy(dst + op, src + ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		// the last sequence has no match
+		if (ip == size) {
+			break;
+		}
+
+		if (size - ip < 2) {
+			return false;
+		}
+		size_t offset = src[ip] | (static_cast<size_t>(src[ip + 1]) << 8);
+		ip += 2;
+		if (offset == 0 || offset > op) {
+			return false;
+		}
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15 && !readLength(src, size, ip, matchLength)) {
+			return false;
+		}
+		matchLength += kMinMatch;
+		if (matchLength > dstSize - op) {
+			return false;
+		}
+
+		// matches may overlap the bytes they produce
+		const char* match = dst + op - offset;
+		for (size_t i = 0; i < matchLength; ++i) {
+			dst[op + i] = match[i];
+		}
+		op += matchLength;
+	}
+
+	return (op == dstSize);
+}
+
+//
+// PayloadCompressor
+//
+
+UInt32
+PayloadCompressor::getCodecs()
+{
+	return kCompressionLZ4;
+}
+
+bool
+PayloadCompressor::compress(const char* data, size_t size, String& compressed)
+{
+	compressed.clear();
+	if (size < kThreshold || size > kMaxSize) {
+		return false;
+	}
+
+	compressed.reserve(4 + size + size / 255 + 16);
+	compressed.push_back(static_cast<char>((size >> 24) & 0xff));
+	compressed.push_back(static_cast<char>((size >> 16) & 0xff));
+	compressed.push_back(static_cast<char>((size >>  8) & 0xff));
+	compressed.push_back(static_cast<char>( size        & 0xff));
+	compressBlock(reinterpret_cast<const UInt8*>(data), size, compressed);
+
+	// not worth the receiver's time unless it saves at least 1/16th
+	if (compressed.size() > size - size / 16) {
+		compressed.clear();
+		return false;
+	}
+	return true;
+}
+
+bool
+PayloadCompressor::decompress(const char* data, size_t size,
+				String& decompressed)
+{
+	decompressed.clear();
+	if (size < 4) {
+		return false;
+	}
+
+	const UInt8* src = reinterpret_cast<const UInt8*>(data);
+	size_t expected  = (static_cast<size_t>(src[0]) << 24) |
+					   (static_cast<size_t>(src[1]) << 16) |
+					   (static_cast<size_t>(src[2]) <<  8) |
+						static_cast<size_t>(src[3]);
+	if (expected == 0 || expected > kMaxSize) {
+		return false;
+	}
+
+	decompressed.resize(expected);
+	if (!decompressBlock(src + 4, size - 4, &decompressed[0], expected)) {
+		decompressed.clear();
+		return false;
+	}
+	return true;
+}
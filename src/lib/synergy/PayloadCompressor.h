@@ -0,0 +1,60 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/String.h"
+#include "common/basic_types.h"
+
+//! Compression of clipboard and file chunks
+/*!
+Compresses the data of a single chunk into an LZ4 block, so every
+chunk can be decompressed on its own as it arrives.  The block is
+preceded by the size of the data as a 4 byte big endian integer.
+*/
+class PayloadCompressor {
+public:
+	//! Smallest data worth compressing
+	static const size_t	kThreshold = 1024;
+
+	//! Largest data a compressed chunk may expand to
+	static const size_t	kMaxSize = 4 * 1024 * 1024;
+
+	//! Get codecs
+	/*!
+	Returns the kCompression* codecs this build can compress and
+	decompress, for announcing with kMsgDCompression.
+	*/
+	static UInt32		getCodecs();
+
+	//! Compress chunk data
+	/*!
+	Compresses the \c size bytes at \c data into \c compressed.  Returns
+	false, leaving \c compressed empty, if the data is smaller than
+	kThreshold or compressing doesn't make it noticeably smaller.
+	*/
+	static bool			compress(const char* data, size_t size,
+							String& compressed);
+
+	//! Decompress chunk data
+	/*!
+	Decompresses the \c size bytes at \c data into \c decompressed.  Returns
+	false if the data isn't a valid compressed chunk.
+	*/
+	static bool			decompress(const char* data, size_t size,
+							String& decompressed);
+};
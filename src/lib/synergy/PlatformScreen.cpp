@@ -32,6 +32,22 @@ PlatformScreen::~PlatformScreen()
 	// do nothing
 }
 
+const IScreen::MonitorList&
+PlatformScreen::getMonitors() const
+{
+	// subclasses that know about their monitors override this.  the
+	// rest have a single monitor covering the screen.
+	return m_monitors;
+}
+
+void
+PlatformScreen::updateMonitors()
+{
+	m_monitors.resize(1);
+	MonitorInfo& monitor = m_monitors[0];
+	getShape(monitor.m_x, monitor.m_y, monitor.m_w, monitor.m_h);
+}
+
 void
 PlatformScreen::updateKeyMap()
 {
@@ -113,6 +129,20 @@ PlatformScreen::pollPressedKeys(KeyButtonSet& pressedKeys) const
 	getKeyState()->pollPressedKeys(pressedKeys);
 }
 
+bool
+PlatformScreen::promiseClipboard(ClipboardID, const IClipboard*, UInt32)
+{
+	// most screens need the data when the clipboard is set
+	return false;
+}
+
+void
+PlatformScreen::fulfillClipboard(ClipboardID, IClipboard::EFormat,
+				const String*)
+{
+	// do nothing
+}
+
 bool
 PlatformScreen::isDraggingStarted()
 {
@@ -39,6 +39,8 @@ public:
 	virtual void		getShape(SInt32& x, SInt32& y,
 							SInt32& width, SInt32& height) const = 0;
 	virtual void		getCursorPos(SInt32& x, SInt32& y) const = 0;
+	virtual const MonitorList&
+						getMonitors() const;
 
 	// IPrimaryScreen overrides
 	virtual void		reconfigure(UInt32 activeSides) = 0;
@@ -89,6 +91,10 @@ public:
 	virtual void		enter() = 0;
 	virtual bool		leave() = 0;
 	virtual bool		setClipboard(ClipboardID, const IClipboard*) = 0;
+	virtual bool		promiseClipboard(ClipboardID,
+							const IClipboard*, UInt32 promised);
+	virtual void		fulfillClipboard(ClipboardID,
+							IClipboard::EFormat, const String* data);
 	virtual void		checkClipboards() = 0;
 	virtual void		openScreensaver(bool notify) = 0;
 	virtual void		closeScreensaver() = 0;
@@ -117,6 +123,15 @@ protected:
 	*/
 	virtual IKeyState*	getKeyState() const = 0;
 
+	//! Update monitors
+	/*!
+	Sets the list the default getMonitors() returns to a single monitor
+	covering the screen shape.  Subclasses that don't override
+	getMonitors() must call this from their constructor and whenever
+	their shape changes.
+	*/
+	void				updateMonitors();
+
 	// IPlatformScreen overrides
 	virtual void		handleSystemEvent(const Event& event, void*) = 0;
 
@@ -124,4 +139,8 @@ protected:
 	String				m_draggingFilename;
 	bool				m_draggingStarted;
 	bool				m_fakeDraggingStarted;
+
+private:
+	// the single monitor returned by the default getMonitors()
+	MonitorList			m_monitors;
 };
@@ -18,6 +18,7 @@
 
 #include "synergy/ProtocolUtil.h"
 #include "io/IStream.h"
+#include "io/SharedBuffer.h"
 #include "base/Log.h"
 #include "common/stdvector.h"
 
@@ -44,6 +45,32 @@ ProtocolUtil::writef(synergy::IStream* stream, const char* fmt, ...)
 	va_end(args);
 }
 
+SharedBuffer*
+ProtocolUtil::format(const char* fmt, ...)
+{
+	va_list args;
+	va_start(args, fmt);
+	SharedBuffer* buffer = vformat(fmt, args);
+	va_end(args);
+	return buffer;
+}
+
+SharedBuffer*
+ProtocolUtil::vformat(const char* fmt, va_list args)
+{
+	assert(fmt != NULL);
+	LOG((CLOG_DEBUG2 "format(%s)", fmt));
+
+	va_list lengthArgs;
+	va_copy(lengthArgs, args);
+	UInt32 size = getLength(fmt, lengthArgs);
+	va_end(lengthArgs);
+
+	SharedBuffer* buffer = new SharedBuffer(size);
+	writef(buffer->getData(), fmt, args);
+	return buffer;
+}
+
 bool
 ProtocolUtil::readf(synergy::IStream* stream, const char* fmt, ...)
 {
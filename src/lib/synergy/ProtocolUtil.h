@@ -24,6 +24,7 @@
 #include <stdarg.h>
 
 namespace synergy { class IStream; }
+class SharedBuffer;
 
 //! Synergy protocol utilities
 /*!
@@ -53,6 +54,21 @@ public:
 	static void			writef(synergy::IStream*,
 							const char* fmt, ...);
 
+	//! Format data into a shared buffer
+	/*!
+	Formats binary data like writef() but into a new SharedBuffer
+	instead of a stream, so one message can be written to many streams
+	with IStream::writeShared().  The caller owns the one reference to
+	the returned buffer.
+	*/
+	static SharedBuffer*	format(const char* fmt, ...);
+
+	//! Format data into a shared buffer
+	/*!
+	Like format() but taking the arguments as a \c va_list.
+	*/
+	static SharedBuffer*	vformat(const char* fmt, va_list);
+
 	//! Read formatted data
 	/*!
 	Read formatted binary data from a buffer.  This performs the
@@ -169,6 +169,20 @@ Screen::setClipboard(ClipboardID id, const IClipboard* clipboard)
 	m_screen->setClipboard(id, clipboard);
 }
 
+bool
+Screen::promiseClipboard(ClipboardID id, const IClipboard* clipboard,
+				UInt32 promised)
+{
+	return m_screen->promiseClipboard(id, clipboard, promised);
+}
+
+void
+Screen::fulfillClipboard(ClipboardID id, IClipboard::EFormat format,
+				const String* data)
+{
+	m_screen->fulfillClipboard(id, format, data);
+}
+
 void
 Screen::grabClipboard(ClipboardID id)
 {
@@ -490,6 +504,12 @@ Screen::getCursorPos(SInt32& x, SInt32& y) const
 	m_screen->getCursorPos(x, y);
 }
 
+const IScreen::MonitorList&
+Screen::getMonitors() const
+{
+	return m_screen->getMonitors();
+}
+
 void
 Screen::enablePrimary()
 {
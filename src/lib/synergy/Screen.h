@@ -20,13 +20,13 @@
 
 #include "synergy/DragInformation.h"
 #include "synergy/clipboard_types.h"
+#include "synergy/IClipboard.h"
 #include "synergy/IScreen.h"
 #include "synergy/key_types.h"
 #include "synergy/mouse_types.h"
 #include "synergy/option_types.h"
 #include "base/String.h"
 
-class IClipboard;
 class IPlatformScreen;
 class IEventQueue;
 
@@ -100,6 +100,23 @@ public:
 	*/
 	void				setClipboard(ClipboardID, const IClipboard*);
 
+	//! Set clipboard with promised formats
+	/*!
+	Sets the system's clipboard contents, promising the formats in
+	\c promised whose data isn't known yet.  Returns false if the
+	screen can't do that.  See IPlatformScreen::promiseClipboard().
+	*/
+	bool				promiseClipboard(ClipboardID,
+							const IClipboard*, UInt32 promised);
+
+	//! Fulfill promised clipboard format
+	/*!
+	Gives the data of a format promised by promiseClipboard(), or
+	NULL if it can't be had.
+	*/
+	void				fulfillClipboard(ClipboardID,
+							IClipboard::EFormat, const String* data);
+
 	//! Grab clipboard
 	/*!
 	Grabs (i.e. take ownership of) the system clipboard.
@@ -299,6 +316,8 @@ public:
 	virtual void		getShape(SInt32& x, SInt32& y,
 							SInt32& width, SInt32& height) const;
 	virtual void		getCursorPos(SInt32& x, SInt32& y) const;
+	virtual const MonitorList&
+						getMonitors() const;
 	
 	IPlatformScreen*	getPlatformScreen() { return m_screen; }
 
@@ -126,6 +126,7 @@ ServerApp::help()
 		"Usage: %s"
 		" [--address <address>]"
 		" [--config <pathname>]"
+		" [--record-input <pathname>]"
 		WINAPI_ARGS
 		HELP_SYS_ARGS
 		HELP_COMMON_ARGS
@@ -134,6 +135,10 @@ ServerApp::help()
 		"\n"
 		"  -a, --address <address>  listen for clients on the given address.\n"
 		"  -c, --config <pathname>  use the named configuration file instead.\n"
+		"      --record-input <pathname>\n"
+		"                           record the input the server handles to the\n"
+		"                             named file, for replaying.  the file has\n"
+		"                             every key typed.\n"
 		HELP_COMMON_INFO_1
 		WINAPI_INFO
 		HELP_SYS_INFO
@@ -168,9 +173,16 @@ void
 ServerApp::reloadConfig(const Event&, void*)
 {
 	LOG((CLOG_DEBUG "reload configuration"));
-	if (loadConfig(args().m_configFile)) {
-		if (m_server != NULL) {
-			m_server->setConfig(*args().m_config);
+
+	// read into a new configuration so the server can tell what changed
+	Config config(m_events);
+	if (loadConfig(args().m_configFile, config)) {
+		if (m_server == NULL) {
+			*args().m_config = config;
+		}
+		else if (!m_server->setConfig(config)) {
+			LOG((CLOG_ERR "cannot reload configuration: it doesn't include this screen"));
+			return;
 		}
 		LOG((CLOG_NOTE "reloaded configuration"));
 	}
@@ -201,6 +213,12 @@ ServerApp::loadConfig()
 
 bool
 ServerApp::loadConfig(const String& pathname)
+{
+	return loadConfig(pathname, *args().m_config);
+}
+
+bool
+ServerApp::loadConfig(const String& pathname, Config& config)
 {
 	try {
 		// load configuration
@@ -214,7 +232,7 @@ ServerApp::loadConfig(const String& pathname)
 				pathname.c_str()));
 			return false;
 		}
-		configStream >> *args().m_config;
+		configStream >> config;
 		LOG((CLOG_DEBUG "configuration read successfully"));
 		return true;
 	}
@@ -277,6 +295,7 @@ ServerApp::closeServer(Server* server)
 
 	// done with server
 	delete server;
+	m_inputTrace.close();
 }
 
 void
@@ -635,6 +654,17 @@ ServerApp::openServer(Config& config, PrimaryClient* primaryClient)
 			m_events->forServer().screenSwitched(), server,
 			new TMethodEventJob<ServerApp>(this, &ServerApp::handleScreenSwitched));
 
+		if (!args().m_inputTraceFile.empty()) {
+			if (m_inputTrace.open(args().m_inputTraceFile, config,
+							primaryClient->getName())) {
+				LOG((CLOG_NOTE "recording input to \"%s\"", args().m_inputTraceFile.c_str()));
+				server->setInputTrace(&m_inputTrace);
+			}
+			else {
+				LOG((CLOG_WARN "cannot record input to \"%s\"", args().m_inputTraceFile.c_str()));
+			}
+		}
+
 	} catch (std::bad_alloc &ba) {
 		delete server;
 		throw ba;
@@ -694,6 +724,9 @@ ServerApp::mainLoop()
 		initIpcClient();
 	}
 
+	// metrics are only served when asked for
+	initMetricsServer();
+
 	// handle hangup signal by reloading the server's configuration
 	ARCH->setSignalHandler(Arch::kHANGUP, &reloadSignalHandler, NULL);
 	m_events->adoptHandler(m_events->forServerApp().reloadConfig(),
@@ -749,6 +782,7 @@ ServerApp::mainLoop()
 	if (argsBase().m_enableIpc) {
 		cleanupIpcClient();
 	}
+	cleanupMetricsServer();
 
 	return kExitSuccess;
 }
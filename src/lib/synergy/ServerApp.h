@@ -22,6 +22,7 @@
 #include "synergy/App.h"
 #include "base/String.h"
 #include "server/Config.h"
+#include "server/InputTrace.h"
 #include "net/NetworkAddress.h"
 #include "arch/Arch.h"
 #include "arch/IArchMultithread.h"
@@ -71,6 +72,7 @@ public:
 	void reloadConfig(const Event&, void*);
 	void loadConfig();
 	bool loadConfig(const String& pathname);
+	bool loadConfig(const String& pathname, Config& config);
 	void forceReconnect(const Event&, void*);
 	void resetServer(const Event&, void*);
 	void handleClientConnected(const Event&, void* vlistener);
@@ -113,6 +115,7 @@ public:
 	ClientListener*		m_listener;
 	EventQueueTimer*	m_timer;
 	NetworkAddress*		m_synergyAddress;
+	InputTraceWriter	m_inputTrace;
 
 private:
 	void handleScreenSwitched(const Event&, void*  data);
@@ -17,17 +17,14 @@
 
 #include "synergy/StreamChunker.h"
 
-#include "mt/Lock.h"
-#include "mt/Mutex.h"
 #include "synergy/FileChunk.h"
-#include "synergy/ClipboardChunk.h"
+#include "synergy/FileWindow.h"
 #include "synergy/protocol_types.h"
 #include "base/EventTypes.h"
 #include "base/Event.h"
 #include "base/IEventQueue.h"
 #include "base/EventTypes.h"
 #include "base/Log.h"
-#include "base/Stopwatch.h"
 #include "base/String.h"
 #include "common/stdexcept.h"
 
@@ -37,19 +34,20 @@ using namespace std;
 
 static const size_t g_chunkSize = 512 * 1024; //512kb
 
-bool StreamChunker::s_isChunkingFile = false;
-bool StreamChunker::s_interruptFile = false;
-Mutex* StreamChunker::s_interruptMutex = NULL;
+// how long to wait for the window to open before giving up on the
+// transfer
+static const double g_fileStallTimeout = 30.0;
 
 void
 StreamChunker::sendFile(
 				char* filename,
 				IEventQueue* events,
-				void* eventTarget)
+				void* eventTarget,
+				FileWindow& window)
 {
-	s_isChunkingFile = true;
+	UInt32 sender = window.startSender();
 	
-	std::fstream file(static_cast<char*>(filename), std::ios::in | std::ios::binary);
+	std::ifstream file(static_cast<char*>(filename), std::ios::in | std::ios::binary);
 
 	if (!file.is_open()) {
 		throw runtime_error("failed to open file");
@@ -58,109 +56,61 @@ StreamChunker::sendFile(
 	// check file size
 	file.seekg (0, std::ios::end);
 	size_t size = (size_t)file.tellg();
+	file.seekg (0, std::ios::beg);
 
 	// send first message (file size)
 	String fileSize = synergy::string::sizeTypeToString(size);
 	FileChunk* sizeMessage = FileChunk::start(fileSize);
 
+	window.queued(*sizeMessage);
 	events->addEvent(Event(events->forFile().fileChunkSending(), eventTarget, sizeMessage));
 
-	// send chunk messages with a fixed chunk size
+	// send chunk messages with a fixed chunk size.  only read ahead
+	// as far as the send window allows so a file never has to fit in
+	// memory.
 	size_t sentLength = 0;
 	size_t chunkSize = g_chunkSize;
-	file.seekg (0, std::ios::beg);
 
-	while (true) {
-		if (s_interruptFile) {
-			s_interruptFile = false;
+	while (sentLength < size) {
+		bool room = window.wait(g_fileStallTimeout);
+
+		if (window.isStopped(sender)) {
 			LOG((CLOG_DEBUG "file transmission interrupted"));
 			break;
 		}
+		if (!room) {
+			throw runtime_error("file transfer stalled");
+		}
 		
 		events->addEvent(Event(events->forFile().keepAlive(), eventTarget));
 		
-		// make sure we don't read too much from the mock data.
+		// make sure we don't read past the end of the file
 		if (sentLength + chunkSize > size) {
 			chunkSize = size - sentLength;
 		}
 
-		char* chunkData = new char[chunkSize];
-		file.read(chunkData, chunkSize);
-		UInt8* data = reinterpret_cast<UInt8*>(chunkData);
-		FileChunk* fileChunk = FileChunk::data(data, chunkSize);
-		delete[] chunkData;
+#if HAVE_SYS_SENDFILE_H
+		// the data is read when the chunk is sent, straight from the
+		// file to the socket where possible
+		FileChunk* fileChunk = FileChunk::data(filename, sentLength, chunkSize);
+#else
+		FileChunk* fileChunk = FileChunk::data(file, chunkSize);
+#endif
+		if (fileChunk == NULL) {
+			throw runtime_error("failed to read file");
+		}
 
+		window.queued(*fileChunk);
 		events->addEvent(Event(events->forFile().fileChunkSending(), eventTarget, fileChunk));
 
 		sentLength += chunkSize;
-		file.seekg (sentLength, std::ios::beg);
-
-		if (sentLength == size) {
-			break;
-		}
 	}
 
 	// send last message
 	FileChunk* end = FileChunk::end();
 
+	window.queued(*end);
 	events->addEvent(Event(events->forFile().fileChunkSending(), eventTarget, end));
 
 	file.close();
-	
-	s_isChunkingFile = false;
-}
-
-void
-StreamChunker::sendClipboard(
-				String& data,
-				size_t size,
-				ClipboardID id,
-				UInt32 sequence,
-				IEventQueue* events,
-				void* eventTarget)
-{
-	// send first message (data size)
-	String dataSize = synergy::string::sizeTypeToString(size);
-	ClipboardChunk* sizeMessage = ClipboardChunk::start(id, sequence, dataSize);
-	
-	events->addEvent(Event(events->forClipboard().clipboardSending(), eventTarget, sizeMessage));
-
-	// send clipboard chunk with a fixed size
-	size_t sentLength = 0;
-	size_t chunkSize = g_chunkSize;
-	
-	while (true) {
-		events->addEvent(Event(events->forFile().keepAlive(), eventTarget));
-		
-		// make sure we don't read too much from the mock data.
-		if (sentLength + chunkSize > size) {
-			chunkSize = size - sentLength;
-		}
-
-		String chunk(data.substr(sentLength, chunkSize).c_str(), chunkSize);
-		ClipboardChunk* dataChunk = ClipboardChunk::data(id, sequence, chunk);
-		
-		events->addEvent(Event(events->forClipboard().clipboardSending(), eventTarget, dataChunk));
-
-		sentLength += chunkSize;
-		if (sentLength == size) {
-			break;
-		}
-	}
-
-	// send last message
-	ClipboardChunk* end = ClipboardChunk::end(id, sequence);
-
-	events->addEvent(Event(events->forClipboard().clipboardSending(), eventTarget, end));
-	
-	LOG((CLOG_DEBUG "sent clipboard size=%d", sentLength));
-}
-
-void
-StreamChunker::interruptFile()
-{
-	if (s_isChunkingFile) {
-		s_interruptFile = true;
-		LOG((CLOG_INFO "previous dragged file has become invalid"));
-	}
 }
@@ -17,29 +17,23 @@
 
 #pragma once
 
-#include "synergy/clipboard_types.h"
 #include "base/String.h"
 
 class IEventQueue;
-class Mutex;
+class FileWindow;
 
 class StreamChunker {
 public:
+	//! Send file
+	/*!
+	Posts the chunks of \c filename to \c eventTarget as
+	\c fileChunkSending events, reading no further ahead than \c window
+	allows.  Starting a send stops the sends started earlier with the
+	same window, as does FileWindow::stopSenders().
+	*/
 	static void			sendFile(
 							char* filename,
 							IEventQueue* events,
-							void* eventTarget);
-	static void			sendClipboard(
-							String& data,
-							size_t size,
-							ClipboardID id,
-							UInt32 sequence,
-							IEventQueue* events,
-							void* eventTarget);
-	static void			interruptFile();
-	
-private:
-	static bool			s_isChunkingFile;
-	static bool			s_interruptFile;
-	static Mutex*		s_interruptMutex;
+							void* eventTarget,
+							FileWindow& window);
 };
@@ -29,6 +29,7 @@ const char*				kMsgCScreenSaver 	= "CSEC%1i";
 const char*				kMsgCResetOptions	= "CROP";
 const char*				kMsgCInfoAck		= "CIAK";
 const char*				kMsgCKeepAlive		= "CALV";
+const char*				kMsgDInputTime		= "DITM%4i%4i%4i%4i";
 const char*				kMsgDKeyDown		= "DKDN%2i%2i%2i";
 const char*				kMsgDKeyDown1_0		= "DKDN%2i%2i";
 const char*				kMsgDKeyRepeat		= "DKRP%2i%2i%2i%2i";
@@ -42,11 +43,19 @@ const char*				kMsgDMouseRelMove	= "DMRM%2i%2i";
 const char*				kMsgDMouseWheel		= "DMWM%2i%2i";
 const char*				kMsgDMouseWheel1_0	= "DMWM%2i";
 const char*				kMsgDClipboard		= "DCLP%1i%4i%1i%s";
+const char*				kMsgDClipboardOffer	= "DCOF%1i%4i%4I";
 const char*				kMsgDInfo			= "DINF%2i%2i%2i%2i%2i%2i%2i";
 const char*				kMsgDSetOptions		= "DSOP%4I";
 const char*				kMsgDFileTransfer	= "DFTR%1i%s";
+const char*				kMsgDFileQueue		= "DFQU%4i%1i%s";
+const char*				kMsgDFileAccept		= "DFAC%4i%s";
+const char*				kMsgDCompression	= "DCMP%4i";
+const char*				kMsgDTime			= "DTIM%4i%4i%4i%4i";
+const char*				kMsgDLatency		= "DLAT%4I";
 const char*				kMsgDDragInfo		= "DDRG%2i%s";
 const char*				kMsgQInfo			= "QINF";
+const char*				kMsgQClipboard		= "QCLP%1i%4i%4i";
+const char*				kMsgQTime			= "QTIM%4i%4i";
 const char*				kMsgEIncompatible	= "EICV%2i%2i";
 const char*				kMsgEBusy 			= "EBSY";
 const char*				kMsgEUnknown		= "EUNK";
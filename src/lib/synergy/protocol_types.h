@@ -29,9 +29,12 @@
 // 1.4:  adds crypto support
 // 1.5:  adds file transfer and removes home brew crypto
 // 1.6:  adds clipboard streaming
+// 1.7:  adds file transfer queue, compressed clipboard and file data
+//       and clipboard offers
+// 1.8:  adds input latency tracing
 // NOTE: with new version, synergy minor version should increment
 static const SInt16		kProtocolMajorVersion = 1;
-static const SInt16		kProtocolMinorVersion = 6;
+static const SInt16		kProtocolMinorVersion = 8;
 
 // default contact port number
 static const UInt16		kDefaultPort = 24800;
@@ -74,7 +77,14 @@ enum EDirectionMask {
 enum EDataTransfer {
 	kDataStart = 1,
 	kDataChunk = 2,
-	kDataEnd = 3
+	kDataEnd = 3,
+	kDataCompressed = 4
+};
+
+// Compression codecs announced with kMsgDCompression
+enum ECompression {
+	kCompressionNone = 0,
+	kCompressionLZ4 = 1 << 0
 };
 
 // Data received constants
@@ -176,6 +186,15 @@ extern const char*		kMsgCKeepAlive;
 // data codes
 //
 
+// input time:  primary -> secondary
+// sent before a key or mouse motion message when latency tracing is
+// enabled.  $1, $2 = the high and low 32 bits of the time the event
+// was captured on the primary screen, $3 = microseconds from then
+// until the server handled it, $4 = microseconds from then until this
+// message was sent.  times are from the primary's monotonic clock in
+// microseconds.
+extern const char*		kMsgDInputTime;
+
 // key pressed:  primary -> secondary
 // $1 = KeyID, $2 = KeyModifierMask, $3 = KeyButton
 // the KeyButton identifies the physical key on the primary used to
@@ -234,11 +253,23 @@ extern const char*		kMsgDMouseWheel1_0;
 
 // clipboard data:  primary <-> secondary
 // $2 = sequence number, $3 = mark $4 = clipboard data.  the sequence number
-// is 0 when sent by the primary.  secondary screens should use the
-// sequence number from the most recent kMsgCEnter.  $1 = clipboard
-// identifier.
+// is 0 when sent by the primary, except in the answer to a
+// kMsgQClipboard where it's the sequence number of the offer.
+// secondary screens should use the sequence number from the most
+// recent kMsgCEnter.  $1 = clipboard identifier.
 extern const char*		kMsgDClipboard;
 
+// clipboard offer:  primary -> secondary
+// sent instead of kMsgDClipboard to say what's in the clipboard
+// without sending the data.  $1 = clipboard identifier.  $2 = offer
+// sequence number, never 0.  $3 = four integers for each format in
+// the clipboard:  the IClipboard::EFormat, the size of its data and
+// the high and low 32 bits of the data's ContentHash.  the secondary
+// gets the data of the formats it doesn't already have with
+// kMsgQClipboard, when a program on the secondary asks for it if
+// the screen supports that.
+extern const char*		kMsgDClipboardOffer;
+
 // client data:  secondary -> primary
 // $1 = coordinate of leftmost pixel on secondary screen,
 // $2 = coordinate of topmost pixel on secondary screen,
@@ -267,6 +298,44 @@ extern const char*		kMsgDSetOptions;
 // 2 means the file transfer is finished.
 extern const char*		kMsgDFileTransfer;
 
+// queued file data:  primary <-> secondary
+// transfer part of one of several queued files.  $1 = transfer id,
+// unique among the sender's transfers.  $2 = mark as for
+// kMsgDFileTransfer.  with kDataStart $3 is "size,name" where name is
+// the file's path relative to the dragged item with '/' separators,
+// and the receiver answers with kMsgDFileAccept before any data is
+// sent.  with kDataChunk $3 is file data and with kDataEnd it's empty.
+// the parts of different transfers may be interleaved.
+extern const char*		kMsgDFileQueue;
+
+// accept queued file:  primary <-> secondary
+// $1 = transfer id.  $2 = offset of the first byte of the file the
+// receiver wants, as a decimal string.  the offset is only non-zero
+// when a transfer restarts after a reconnect.
+extern const char*		kMsgDFileAccept;
+
+// compression codecs:  primary <-> secondary
+// $1 = kCompression* codecs the sender can decompress.  the primary
+// sends this right after the greeting handshake and the secondary
+// answers with its own.  either side may then send the data of a
+// kMsgDClipboard, kMsgDFileTransfer or kMsgDFileQueue chunk compressed,
+// with mark kDataCompressed instead of kDataChunk, if the other side
+// announced the codec.  compressed data starts with the size of the
+// data as a 4 byte big endian integer, followed by an LZ4 block.
+extern const char*		kMsgDCompression;
+
+// time:  primary -> secondary
+// answer to kMsgQTime.  $1, $2 = the time from the query, $3, $4 =
+// the high and low 32 bits of the primary's monotonic clock in
+// microseconds when it answered.
+extern const char*		kMsgDTime;
+
+// input latencies:  secondary -> primary
+// latencies of traced input events measured since the last
+// kMsgDLatency.  $1 = the stage, bucket and count of each bucket
+// that isn't empty, as marshalled by LatencyStats.
+extern const char*		kMsgDLatency;
+
 // drag infomation:  primary <-> secondary
 // transfer drag infomation. The first 2 bytes are used for storing
 // the number of dragging objects. Then the following string consists
@@ -281,6 +350,21 @@ extern const char*		kMsgDDragInfo;
 // client should reply with a kMsgDInfo.
 extern const char*		kMsgQInfo;
 
+// query clipboard format:  secondary -> primary
+// asks for the data of a format from a kMsgDClipboardOffer.  $1 =
+// clipboard identifier, $2 = sequence number of the offer, $3 =
+// format.  the primary answers with kMsgDClipboard using the offer's
+// sequence number, carrying a marshalled clipboard with only that
+// format, or with no formats if the offer is out of date.
+extern const char*		kMsgQClipboard;
+
+// query time:  secondary -> primary
+// sent by a secondary tracing latency after answering a
+// kMsgCKeepAlive, to estimate the offset between the clocks.  $1, $2
+// = the high and low 32 bits of the secondary's monotonic clock in
+// microseconds.  the primary answers with kMsgDTime.
+extern const char*		kMsgQTime;
+
 
 //
 // error codes
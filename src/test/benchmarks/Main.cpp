@@ -0,0 +1,66 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "arch/Arch.h"
+#include "base/Log.h"
+
+#if SYSAPI_WIN32
+#include "arch/win32/ArchMiscWindows.h"
+#endif
+
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <vector>
+
+int
+main(int argc, char **argv)
+{
+#if SYSAPI_WIN32
+	// HACK: shouldn't be needed, but logging fails without this.
+	ArchMiscWindows::setInstanceWin32(GetModuleHandle(NULL));
+#endif
+
+	Arch arch;
+	arch.init();
+
+	// notes and info go to stdout, which would spoil the results
+	Log log;
+	log.setFilter(kWARNING);
+
+	// results are written as JSON unless another format is asked for,
+	// so runs can be compared across releases
+	std::vector<char*> args(argv, argv + argc);
+	bool hasFormat = false;
+	for (int i = 1; i < argc; ++i) {
+		if (strncmp(argv[i], "--benchmark_format", 18) == 0) {
+			hasFormat = true;
+		}
+	}
+	char jsonFormat[] = "--benchmark_format=json";
+	if (!hasFormat) {
+		args.push_back(jsonFormat);
+	}
+	int numArgs = static_cast<int>(args.size());
+
+	benchmark::Initialize(&numArgs, &args[0]);
+	if (benchmark::ReportUnrecognizedArguments(numArgs, &args[0])) {
+		return 1;
+	}
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
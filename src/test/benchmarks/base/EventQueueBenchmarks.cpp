@@ -0,0 +1,56 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/EventQueue.h"
+#include "base/FunctionEventJob.h"
+
+#include <benchmark/benchmark.h>
+
+static void
+countEvent(const Event&, void* vcount)
+{
+	++*static_cast<UInt64*>(vcount);
+}
+
+static void
+EventQueueBenchmarks_addAndDispatch(benchmark::State& state)
+{
+	EventQueue events;
+	Event::Type type = Event::kUnknown;
+	events.registerTypeOnce(type, "EventQueueBenchmarks");
+	UInt64 count = 0;
+	int target;
+	events.adoptHandler(type, &target, new FunctionEventJob(&countEvent, &count));
+	const int batch = static_cast<int>(state.range(0));
+
+	for (auto _ : state) {
+		// queue a batch, like a burst of mouse motion, then run the
+		// queue until it gets to the quit event after it
+		for (int i = 0; i < batch; ++i) {
+			events.addEvent(Event(type, &target));
+		}
+		events.addEvent(Event(Event::kQuit));
+		events.loop();
+	}
+
+	events.removeHandler(type, &target);
+	if (count != static_cast<UInt64>(state.iterations() * batch)) {
+		state.SkipWithError("events were lost");
+	}
+	state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(EventQueueBenchmarks_addAndDispatch)->Arg(1)->Arg(64);
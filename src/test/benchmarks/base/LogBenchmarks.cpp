@@ -0,0 +1,36 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Log.h"
+
+#include <benchmark/benchmark.h>
+
+static void
+LogBenchmarks_disabledDebug2(benchmark::State& state)
+{
+	int filter = CLOG->getFilter();
+	CLOG->setFilter(kINFO);
+	int x = 10, y = 20;
+
+	for (auto _ : state) {
+		LOG((CLOG_DEBUG2 "mouse move %d,%d on %s", x, y, "screen"));
+		benchmark::ClobberMemory();
+	}
+
+	CLOG->setFilter(filter);
+}
+BENCHMARK(LogBenchmarks_disabledDebug2);
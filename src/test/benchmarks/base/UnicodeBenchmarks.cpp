@@ -0,0 +1,121 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Unicode.h"
+
+#include <benchmark/benchmark.h>
+#include <map>
+
+// mixed script text:  ASCII, Latin-1, CJK and emoji
+static const char*		kMixedText =
+	"The quick brown fox jumps over the lazy dog. "
+	"Caf\xc3\xa9 na\xc3\xafve r\xc3\xa9sum\xc3\xa9 \xc3\xbc\xc3\xb6\xc3\xa4\xc3\x9f. "
+	"\xe6\xbc\xa2\xe5\xad\x97\xe3\x81\x8b\xe3\x81\xaa\xe3\x82\xab\xe3\x83\x8a "
+	"\xed\x95\x9c\xea\xb8\x80 "
+	"\xf0\x9f\x98\x80\xf0\x9f\x9a\x80\xf0\x9f\x8e\x89\n";
+
+static const String&
+getMixedText(size_t size)
+{
+	static std::map<size_t, String> s_texts;
+	String& text = s_texts[size];
+	if (text.empty()) {
+		String pattern(kMixedText);
+		text.reserve(size + pattern.size());
+		while (text.size() < size) {
+			text += pattern;
+		}
+	}
+	return text;
+}
+
+static void
+UnicodeBenchmarks_UTF8ToUTF16(benchmark::State& state)
+{
+	const String& text = getMixedText(static_cast<size_t>(state.range(0)));
+
+	for (auto _ : state) {
+		String result = Unicode::UTF8ToUTF16(text);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(UnicodeBenchmarks_UTF8ToUTF16)
+	->Arg(1 << 20)->Arg(50 << 20)->Unit(benchmark::kMillisecond);
+
+static void
+UnicodeBenchmarks_UTF16ToUTF8(benchmark::State& state)
+{
+	String text = Unicode::UTF8ToUTF16(
+						getMixedText(static_cast<size_t>(state.range(0))));
+
+	for (auto _ : state) {
+		String result = Unicode::UTF16ToUTF8(text);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(UnicodeBenchmarks_UTF16ToUTF8)
+	->Arg(1 << 20)->Arg(50 << 20)->Unit(benchmark::kMillisecond);
+
+static void
+UnicodeBenchmarks_UTF8ToUCS4(benchmark::State& state)
+{
+	const String& text = getMixedText(static_cast<size_t>(state.range(0)));
+
+	for (auto _ : state) {
+		String result = Unicode::UTF8ToUCS4(text);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(UnicodeBenchmarks_UTF8ToUCS4)
+	->Arg(1 << 20)->Arg(50 << 20)->Unit(benchmark::kMillisecond);
+
+static void
+UnicodeBenchmarks_UCS4ToUTF8(benchmark::State& state)
+{
+	String text = Unicode::UTF8ToUCS4(
+						getMixedText(static_cast<size_t>(state.range(0))));
+
+	for (auto _ : state) {
+		String result = Unicode::UCS4ToUTF8(text);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(UnicodeBenchmarks_UCS4ToUTF8)
+	->Arg(1 << 20)->Arg(50 << 20)->Unit(benchmark::kMillisecond);
+
+static void
+UnicodeBenchmarks_isUTF8(benchmark::State& state)
+{
+	const String& text = getMixedText(static_cast<size_t>(state.range(0)));
+
+	for (auto _ : state) {
+		bool result = Unicode::isUTF8(text);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(UnicodeBenchmarks_isUTF8)
+	->Arg(1 << 20)->Arg(50 << 20)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,64 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "io/StreamBuffer.h"
+
+#include <benchmark/benchmark.h>
+#include <vector>
+
+static void
+StreamBufferBenchmarks_writePeekPop(benchmark::State& state)
+{
+	StreamBuffer buffer;
+	const UInt32 size = static_cast<UInt32>(state.range(0));
+	std::vector<UInt8> data(size, 0x55);
+
+	for (auto _ : state) {
+		// the reader takes whole messages while the next one arrives
+		buffer.write(&data[0], size);
+		buffer.write(&data[0], size);
+		benchmark::DoNotOptimize(buffer.peek(size));
+		buffer.pop(size);
+		benchmark::DoNotOptimize(buffer.peek(size));
+		buffer.pop(size);
+	}
+
+	state.SetBytesProcessed(state.iterations() * 2 * size);
+}
+BENCHMARK(StreamBufferBenchmarks_writePeekPop)
+	->Arg(16)->Arg(4096)->Arg(512 * 1024);
+
+static void
+StreamBufferBenchmarks_peekAcrossChunks(benchmark::State& state)
+{
+	StreamBuffer buffer;
+	const UInt32 size = static_cast<UInt32>(state.range(0));
+	std::vector<UInt8> data(size, 0x55);
+
+	for (auto _ : state) {
+		// a packet that arrived in small reads has to be joined to peek
+		for (UInt32 i = 0; i < size; i += 1024) {
+			buffer.write(&data[i], (size - i < 1024) ? size - i : 1024);
+		}
+		benchmark::DoNotOptimize(buffer.peek(size));
+		buffer.pop(size);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(StreamBufferBenchmarks_peekAcrossChunks)
+	->Arg(4096)->Arg(512 * 1024);
@@ -0,0 +1,350 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileChunk.h"
+#include "synergy/PacketStreamFilter.h"
+#include "net/NetworkAddress.h"
+#include "net/SocketMultiplexer.h"
+#include "net/TCPListenSocket.h"
+#include "net/TCPSocket.h"
+#include "base/EventQueue.h"
+#include "base/Stopwatch.h"
+#include "base/TMethodEventJob.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#define BENCHMARK_PORT 24810
+
+static const size_t		kTransferSize = 8 * 1024 * 1024;
+static const size_t		kChunkSize    = 512 * 1024;
+static const char*		kFilename     = "FileTransferBenchmarks.tmp";
+
+//! Loopback connection
+/*!
+A client socket connected to a socket accepted on 127.0.0.1, each
+with a PacketStreamFilter, like a client and the server.  Packets
+written to the sender are counted as they're read from the receiver.
+*/
+class Loopback {
+public:
+	Loopback(EventQueue* events, SocketMultiplexer* socketMultiplexer);
+	~Loopback();
+
+	//! Connect
+	/*!
+	Connects and waits for a first packet to make it across.  Returns
+	false if that takes more than \c timeout seconds.
+	*/
+	bool				connect(double timeout);
+
+	//! Wait for packets
+	/*!
+	Dispatches events until \c packets packets in all have been read
+	from the receiver.  Returns false if that takes more than \c timeout
+	seconds.
+	*/
+	bool				waitForPackets(UInt64 packets, double timeout);
+
+	//! Get sending stream
+	synergy::IStream*	getSender() const;
+
+private:
+	template <class Condition>
+	bool				dispatchUntil(Condition, double timeout);
+
+	void				handleConnecting(const Event&, void*);
+	void				handleConnected(const Event&, void*);
+	void				handleInputReady(const Event&, void*);
+
+private:
+	EventQueue*			m_events;
+	SocketMultiplexer*	m_socketMultiplexer;
+	TCPListenSocket*	m_listen;
+	TCPSocket*			m_client;
+	IDataSocket*		m_accepted;
+	bool				m_connected;
+	PacketStreamFilter*	m_sender;
+	PacketStreamFilter*	m_receiver;
+	UInt64				m_packets;
+	std::vector<UInt8>	m_buffer;
+};
+
+Loopback::Loopback(EventQueue* events, SocketMultiplexer* socketMultiplexer) :
+	m_events(events),
+	m_socketMultiplexer(socketMultiplexer),
+	m_listen(NULL),
+	m_client(NULL),
+	m_accepted(NULL),
+	m_connected(false),
+	m_sender(NULL),
+	m_receiver(NULL),
+	m_packets(0),
+	m_buffer(64 * 1024)
+{
+	// the socket threads send these, so register them before there
+	// are any
+	m_events->forIListenSocket().connecting();
+	m_events->forIDataSocket().connected();
+	m_events->forIDataSocket().connectionFailed();
+	m_events->forISocket().disconnected();
+	m_events->forIStream().inputReady();
+	m_events->forIStream().outputFlushed();
+	m_events->forIStream().outputError();
+	m_events->forIStream().inputShutdown();
+	m_events->forIStream().outputShutdown();
+}
+
+Loopback::~Loopback()
+{
+	if (m_receiver != NULL) {
+		m_events->removeHandler(m_events->forIStream().inputReady(),
+							m_receiver->getEventTarget());
+	}
+	if (m_listen != NULL) {
+		m_events->removeHandler(m_events->forIListenSocket().connecting(),
+							m_listen);
+	}
+	if (m_client != NULL) {
+		m_events->removeHandler(m_events->forIDataSocket().connected(),
+							m_client->getEventTarget());
+	}
+
+	// the filters own the sockets
+	if (m_sender != NULL) {
+		delete m_sender;
+	}
+	else {
+		delete m_client;
+	}
+	if (m_receiver != NULL) {
+		delete m_receiver;
+	}
+	else {
+		delete m_accepted;
+	}
+	delete m_listen;
+}
+
+bool
+Loopback::connect(double timeout)
+{
+	NetworkAddress address("127.0.0.1", BENCHMARK_PORT);
+	address.resolve();
+
+	m_listen = new TCPListenSocket(m_events, m_socketMultiplexer);
+	m_events->adoptHandler(m_events->forIListenSocket().connecting(),
+							m_listen,
+							new TMethodEventJob<Loopback>(this,
+								&Loopback::handleConnecting));
+	m_listen->bind(address);
+
+	m_client = new TCPSocket(m_events, m_socketMultiplexer);
+	m_events->adoptHandler(m_events->forIDataSocket().connected(),
+							m_client->getEventTarget(),
+							new TMethodEventJob<Loopback>(this,
+								&Loopback::handleConnected));
+	m_client->connect(address);
+
+	struct Connected {
+		const Loopback*	m_loopback;
+		bool operator()() const
+		{
+			return m_loopback->m_connected &&
+					m_loopback->m_accepted != NULL;
+		}
+	};
+	Connected connected = { this };
+	if (!dispatchUntil(connected, timeout)) {
+		return false;
+	}
+
+	m_sender   = new PacketStreamFilter(m_events, m_client);
+	m_receiver = new PacketStreamFilter(m_events, m_accepted);
+	m_events->adoptHandler(m_events->forIStream().inputReady(),
+							m_receiver->getEventTarget(),
+							new TMethodEventJob<Loopback>(this,
+								&Loopback::handleInputReady));
+
+	// make sure something gets through before measuring
+	m_sender->write("ping", 4);
+	return waitForPackets(1, timeout);
+}
+
+bool
+Loopback::waitForPackets(UInt64 packets, double timeout)
+{
+	struct Received {
+		const Loopback*	m_loopback;
+		UInt64			m_packets;
+		bool operator()() const
+		{
+			return m_loopback->m_packets >= m_packets;
+		}
+	};
+	Received received = { this, packets };
+	return dispatchUntil(received, timeout);
+}
+
+synergy::IStream*
+Loopback::getSender() const
+{
+	return m_sender;
+}
+
+template <class Condition>
+bool
+Loopback::dispatchUntil(Condition condition, double timeout)
+{
+	Stopwatch timer;
+	while (!condition()) {
+		if (timer.getTime() > timeout) {
+			return false;
+		}
+		Event event;
+		if (m_events->getEvent(event, 0.1)) {
+			m_events->dispatchEvent(event);
+			Event::deleteData(event);
+		}
+	}
+	return true;
+}
+
+void
+Loopback::handleConnecting(const Event&, void*)
+{
+	IDataSocket* socket = m_listen->accept();
+	if (socket != NULL && m_accepted == NULL) {
+		m_accepted = socket;
+	}
+	else {
+		delete socket;
+	}
+}
+
+void
+Loopback::handleConnected(const Event&, void*)
+{
+	m_connected = true;
+}
+
+void
+Loopback::handleInputReady(const Event&, void*)
+{
+	// take whole packets, like the protocol handlers do
+	while (m_receiver->isReady()) {
+		UInt32 size = m_receiver->getSize();
+		while (size > 0) {
+			UInt32 n = static_cast<UInt32>(m_buffer.size());
+			if (n > size) {
+				n = size;
+			}
+			size -= m_receiver->read(&m_buffer[0], n);
+		}
+		++m_packets;
+	}
+}
+
+static void
+makeFile()
+{
+	std::vector<char> data(kChunkSize, 'f');
+	std::ofstream file(kFilename, std::ios::out | std::ios::binary);
+	for (size_t i = 0; i < kTransferSize; i += kChunkSize) {
+		file.write(&data[0], data.size());
+	}
+}
+
+static void
+sendChunks(benchmark::State& state, const std::vector<FileChunk*>& chunks)
+{
+	EventQueue events;
+	SocketMultiplexer socketMultiplexer;
+
+	// the queue holds events back until it has run, so run it until
+	// it quits before sockets start sending events
+	events.addEvent(Event(Event::kQuit));
+	events.loop();
+
+	// try again if the port is still in use by the last connection
+	Loopback* loopback = NULL;
+	for (int attempt = 0; attempt < 5 && loopback == NULL; ++attempt) {
+		loopback = new Loopback(&events, &socketMultiplexer);
+		if (!loopback->connect(2.0)) {
+			delete loopback;
+			loopback = NULL;
+		}
+	}
+	if (loopback == NULL) {
+		state.SkipWithError("couldn't connect over loopback");
+		return;
+	}
+
+	UInt64 packets = 1;
+	for (auto _ : state) {
+		for (size_t i = 0; i < chunks.size(); ++i) {
+			FileChunk::send(loopback->getSender(), *chunks[i]);
+		}
+		packets += chunks.size();
+		if (!loopback->waitForPackets(packets, 30.0)) {
+			state.SkipWithError("transfer timed out");
+			break;
+		}
+	}
+
+	delete loopback;
+	state.SetBytesProcessed(state.iterations() * kTransferSize);
+}
+
+static void
+FileTransferBenchmarks_sendFromFile(benchmark::State& state)
+{
+	makeFile();
+	std::vector<FileChunk*> chunks;
+	for (size_t i = 0; i < kTransferSize; i += kChunkSize) {
+		chunks.push_back(FileChunk::data(kFilename, i, kChunkSize));
+	}
+
+	sendChunks(state, chunks);
+
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		delete chunks[i];
+	}
+	std::remove(kFilename);
+}
+BENCHMARK(FileTransferBenchmarks_sendFromFile)
+	->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void
+FileTransferBenchmarks_sendFromMemory(benchmark::State& state)
+{
+	std::vector<UInt8> data(kChunkSize, 'm');
+	std::vector<FileChunk*> chunks;
+	for (size_t i = 0; i < kTransferSize; i += kChunkSize) {
+		chunks.push_back(FileChunk::data(&data[0], kChunkSize));
+	}
+
+	sendChunks(state, chunks);
+
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		delete chunks[i];
+	}
+}
+BENCHMARK(FileTransferBenchmarks_sendFromMemory)
+	->UseRealTime()->Unit(benchmark::kMillisecond);
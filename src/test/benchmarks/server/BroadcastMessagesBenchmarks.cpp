@@ -0,0 +1,98 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/BroadcastMessages.h"
+#include "synergy/PacketStreamFilter.h"
+#include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_types.h"
+#include "base/EventQueue.h"
+#include "test/global/MemoryStream.h"
+#include "common/stdvector.h"
+
+#include <benchmark/benchmark.h>
+
+typedef std::vector<PacketStreamFilter*> StreamList;
+
+// one packet stream per client the key is broadcast to
+static void
+openTargets(IEventQueue* events, StreamList& targets, int numTargets)
+{
+	for (int i = 0; i < numTargets; ++i) {
+		targets.push_back(new PacketStreamFilter(events, new MemoryStream()));
+	}
+}
+
+static void
+clearTargets(StreamList& targets)
+{
+	for (size_t i = 0; i < targets.size(); ++i) {
+		targets[i]->getStream()->close();
+	}
+}
+
+static void
+closeTargets(StreamList& targets)
+{
+	for (size_t i = 0; i < targets.size(); ++i) {
+		delete targets[i];
+	}
+	targets.clear();
+}
+
+static void
+BroadcastMessagesBenchmarks_writefEach(benchmark::State& state)
+{
+	EventQueue events;
+	StreamList targets;
+	openTargets(&events, targets, static_cast<int>(state.range(0)));
+	UInt16 id = 'a', mask = 0, button = 38;
+
+	for (auto _ : state) {
+		for (size_t i = 0; i < targets.size(); ++i) {
+			ProtocolUtil::writef(targets[i], kMsgDKeyDown,
+							id, mask, button);
+		}
+		clearTargets(targets);
+	}
+	closeTargets(targets);
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BroadcastMessagesBenchmarks_writefEach)->Arg(4)->Arg(32);
+
+static void
+BroadcastMessagesBenchmarks_writeShared(benchmark::State& state)
+{
+	EventQueue events;
+	StreamList targets;
+	openTargets(&events, targets, static_cast<int>(state.range(0)));
+	BroadcastMessages messages;
+	UInt16 id = 'a', mask = 0, button = 38;
+
+	for (auto _ : state) {
+		for (size_t i = 0; i < targets.size(); ++i) {
+			messages.write(targets[i], kMsgDKeyDown,
+							id, mask, button);
+		}
+		messages.clear();
+		clearTargets(targets);
+	}
+	closeTargets(targets);
+
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BroadcastMessagesBenchmarks_writeShared)->Arg(4)->Arg(32);
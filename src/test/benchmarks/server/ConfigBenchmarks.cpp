@@ -0,0 +1,120 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/Config.h"
+#include "server/NeighborGraph.h"
+#include "test/mock/server/MockPrimaryClient.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+
+static const int		kColumns = 5;
+static const int		kRows    = 4;
+static const int		kScreens = kColumns * kRows;
+
+static String
+getScreenName(int index)
+{
+	char name[16];
+	sprintf(name, "screen%02d", index);
+	return name;
+}
+
+// a 5x4 grid of screens, each linked to the screens beside it
+static void
+makeConfig(Config& config)
+{
+	for (int i = 0; i < kScreens; ++i) {
+		config.addScreen(getScreenName(i));
+	}
+	for (int i = 0; i < kScreens; ++i) {
+		int column = i % kColumns;
+		int row    = i / kColumns;
+		String name = getScreenName(i);
+		if (column > 0) {
+			config.connect(name, kLeft, 0.0f, 1.0f,
+							getScreenName(i - 1), 0.0f, 1.0f);
+		}
+		if (column < kColumns - 1) {
+			config.connect(name, kRight, 0.0f, 1.0f,
+							getScreenName(i + 1), 0.0f, 1.0f);
+		}
+		if (row > 0) {
+			config.connect(name, kTop, 0.0f, 1.0f,
+							getScreenName(i - kColumns), 0.0f, 1.0f);
+		}
+		if (row < kRows - 1) {
+			config.connect(name, kBottom, 0.0f, 1.0f,
+							getScreenName(i + kColumns), 0.0f, 1.0f);
+		}
+	}
+}
+
+static void
+ConfigBenchmarks_getNeighbor(benchmark::State& state)
+{
+	Config config;
+	makeConfig(config);
+	int screen = 0;
+	int dir    = kFirstDirection;
+
+	for (auto _ : state) {
+		float t;
+		String neighbor = config.getNeighbor(getScreenName(screen),
+							static_cast<EDirection>(dir), 0.5f, &t);
+		benchmark::DoNotOptimize(neighbor);
+
+		if (++dir > kLastDirection) {
+			dir    = kFirstDirection;
+			screen = (screen + 1) % kScreens;
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ConfigBenchmarks_getNeighbor);
+
+static void
+NeighborGraphBenchmarks_getNeighbor(benchmark::State& state)
+{
+	Config config;
+	makeConfig(config);
+	MockPrimaryClient clients[kScreens];
+	NeighborGraph::ClientMap clientMap;
+	for (int i = 0; i < kScreens; ++i) {
+		clientMap[getScreenName(i)] = &clients[i];
+	}
+	NeighborGraph graph;
+	graph.compile(config, clientMap);
+	int screen = 0;
+	int dir    = kFirstDirection;
+
+	for (auto _ : state) {
+		float t;
+		BaseClientProxy* neighbor = graph.getNeighbor(&clients[screen],
+							static_cast<EDirection>(dir), 0.5f, t);
+		benchmark::DoNotOptimize(neighbor);
+
+		if (++dir > kLastDirection) {
+			dir    = kFirstDirection;
+			screen = (screen + 1) % kScreens;
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(NeighborGraphBenchmarks_getNeighbor);
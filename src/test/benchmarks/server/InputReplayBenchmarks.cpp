@@ -0,0 +1,133 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/global/InputTraceReplay.h"
+#include "server/Config.h"
+#include "base/AllocationTracker.h"
+#include "base/EventQueue.h"
+
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+static const int		kClients = 3;
+static const int		kMotions = 500;
+static const int		kKeys    = 50;
+
+static String
+getClientName(int index)
+{
+	char name[16];
+	sprintf(name, "client%d", index);
+	return name;
+}
+
+// the server and clients in a row, with the input of switching to each
+// client in turn, moving the mouse on it and typing
+static void
+makeTrace(String& configText, InputTraceReplay::RecordList& records)
+{
+	Config config;
+	config.addScreen("server");
+	String left = "server";
+	for (int i = 1; i <= kClients; ++i) {
+		String name = getClientName(i);
+		config.addScreen(name);
+		config.connect(left, kRight, 0.0f, 1.0f, name, 0.0f, 1.0f);
+		config.connect(name, kLeft, 0.0f, 1.0f, left, 0.0f, 1.0f);
+		left = name;
+	}
+	std::ostringstream configStream;
+	configStream << config;
+	configText = configStream.str();
+
+	records.clear();
+	InputTraceRecord record;
+	for (int i = 1; i <= kClients; ++i) {
+		record.m_type = InputTraceRecord::kSwitchToScreen;
+		record.m_name = getClientName(i);
+		records.push_back(record);
+
+		record.m_type = InputTraceRecord::kMotionOnSecondary;
+		for (int j = 0; j < kMotions; ++j) {
+			record.m_x = ((j & 1) != 0) ? 2 : -2;
+			record.m_y = ((j & 2) != 0) ? 1 : -1;
+			records.push_back(record);
+		}
+
+		record.m_name.clear();
+		record.m_mask   = 0;
+		record.m_count  = 1;
+		for (int j = 0; j < kKeys; ++j) {
+			record.m_id     = 'a' + j % 26;
+			record.m_button = static_cast<UInt32>(38 + j % 26);
+			record.m_type   = InputTraceRecord::kKeyDown;
+			records.push_back(record);
+			record.m_type   = InputTraceRecord::kKeyUp;
+			records.push_back(record);
+		}
+	}
+}
+
+// replays $SYNERGY_INPUT_TRACE, a trace recorded with --record-input,
+// or a made up trace if it isn't set
+static void
+InputReplayBenchmarks_replay(benchmark::State& state)
+{
+	EventQueue events;
+	InputTraceReplay replay(&events);
+	const char* filename = getenv("SYNERGY_INPUT_TRACE");
+	if (filename != NULL) {
+		if (!replay.load(filename)) {
+			state.SkipWithError("cannot read input trace");
+			return;
+		}
+	}
+	else {
+		String config;
+		InputTraceReplay::RecordList records;
+		makeTrace(config, records);
+		replay.load(config, "server", records);
+	}
+
+	for (auto _ : state) {
+		state.PauseTiming();
+		replay.start();
+		state.ResumeTiming();
+
+		replay.replay(0.0);
+
+		state.PauseTiming();
+		replay.stop();
+		state.ResumeTiming();
+	}
+
+	state.SetItemsProcessed(state.iterations() *
+							replay.getRecords().size());
+	if (AllocationTracker::isEnabled()) {
+		UInt64 allocations = 0;
+		for (int i = 0; i < InputTraceRecord::kNumTypes; ++i) {
+			allocations += replay.getNumAllocations(
+							static_cast<InputTraceRecord::EType>(i));
+		}
+		state.counters["allocations_per_item"] =
+							static_cast<double>(allocations) /
+							replay.getRecords().size();
+	}
+}
+BENCHMARK(InputReplayBenchmarks_replay)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,64 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/Clipboard.h"
+
+#include <benchmark/benchmark.h>
+
+static void
+fillClipboard(Clipboard& clipboard, size_t size)
+{
+	clipboard.open(0);
+	clipboard.empty();
+	clipboard.add(IClipboard::kText, String(size, 't'));
+	clipboard.add(IClipboard::kHTML,
+					"<p>" + String(size, 'h') + "</p>");
+	clipboard.close();
+}
+
+static void
+ClipboardBenchmarks_marshall(benchmark::State& state)
+{
+	Clipboard clipboard;
+	fillClipboard(clipboard, static_cast<size_t>(state.range(0)));
+	size_t size = 0;
+
+	for (auto _ : state) {
+		String data = IClipboard::marshall(&clipboard);
+		size = data.size();
+		benchmark::DoNotOptimize(data);
+	}
+
+	state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(ClipboardBenchmarks_marshall)->Arg(64)->Arg(1 << 20);
+
+static void
+ClipboardBenchmarks_unmarshall(benchmark::State& state)
+{
+	Clipboard source;
+	fillClipboard(source, static_cast<size_t>(state.range(0)));
+	String data = IClipboard::marshall(&source);
+	Clipboard clipboard;
+
+	for (auto _ : state) {
+		IClipboard::unmarshall(&clipboard, data, 0);
+	}
+
+	state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(ClipboardBenchmarks_unmarshall)->Arg(64)->Arg(1 << 20);
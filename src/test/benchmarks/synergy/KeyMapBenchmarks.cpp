@@ -0,0 +1,95 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/KeyMap.h"
+#include "synergy/key_types.h"
+
+#include <benchmark/benchmark.h>
+
+using synergy::KeyMap;
+
+static void
+addKey(KeyMap& keyMap, KeyID id, KeyButton button,
+				KeyModifierMask required, KeyModifierMask sensitive,
+				KeyModifierMask generates = 0, bool lock = false)
+{
+	KeyMap::KeyItem item;
+	item.m_id        = id;
+	item.m_group     = 0;
+	item.m_button    = button;
+	item.m_required  = required;
+	item.m_sensitive = sensitive;
+	item.m_generates = generates;
+	item.m_lock      = lock;
+	item.m_client    = 0;
+	keyMap.addKeyEntry(item);
+}
+
+// a US layout:  letters, digits and their shifted symbols, space and
+// the modifiers
+static void
+makeKeyMap(KeyMap& keyMap)
+{
+	static const char* kShifted = ")!@#$%^&*(";
+	const KeyModifierMask letter = KeyModifierShift | KeyModifierCapsLock;
+
+	KeyButton button = 10;
+	for (KeyID c = 'a'; c <= 'z'; ++c, ++button) {
+		addKey(keyMap, c, button, 0, letter);
+		addKey(keyMap, c - 'a' + 'A', button, KeyModifierShift, letter);
+	}
+	for (KeyID c = '0'; c <= '9'; ++c, ++button) {
+		addKey(keyMap, c, button, 0, KeyModifierShift);
+		addKey(keyMap, kShifted[c - '0'], button,
+						KeyModifierShift, KeyModifierShift);
+	}
+	addKey(keyMap, ' ', button++, 0, 0);
+	addKey(keyMap, kKeyShift_L, button++, 0, 0, KeyModifierShift);
+	addKey(keyMap, kKeyControl_L, button++, 0, 0, KeyModifierControl);
+	addKey(keyMap, kKeyAlt_L, button++, 0, 0, KeyModifierAlt);
+	addKey(keyMap, kKeyCapsLock, button++, 0, 0, KeyModifierCapsLock, true);
+	keyMap.finish();
+}
+
+static void
+KeyMapBenchmarks_mapKey(benchmark::State& state)
+{
+	KeyMap keyMap;
+	makeKeyMap(keyMap);
+	const char* kText = "Hello World 2016!";
+	const char* c = kText;
+	KeyMap::Keystrokes keys;
+	KeyMap::ModifierToKeys activeModifiers;
+
+	for (auto _ : state) {
+		// each key from no modifiers, so shifted keys press shift too
+		KeyModifierMask currentState = 0;
+		keys.clear();
+		activeModifiers.clear();
+		const KeyMap::KeyItem* item = keyMap.mapKey(keys,
+							static_cast<KeyID>(*c), 0, activeModifiers,
+							currentState, 0, false);
+		benchmark::DoNotOptimize(item);
+
+		if (*++c == '\0') {
+			c = kText;
+		}
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(KeyMapBenchmarks_mapKey);
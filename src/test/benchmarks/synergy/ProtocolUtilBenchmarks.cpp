@@ -0,0 +1,92 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_types.h"
+#include "test/global/MemoryStream.h"
+
+#include <benchmark/benchmark.h>
+
+static void
+ProtocolUtilBenchmarks_writefMouseMove(benchmark::State& state)
+{
+	MemoryStream stream;
+	SInt16 x = 0, y = 0;
+
+	for (auto _ : state) {
+		ProtocolUtil::writef(&stream, kMsgDMouseMove, ++x, ++y);
+		stream.close();
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ProtocolUtilBenchmarks_writefMouseMove);
+
+static void
+ProtocolUtilBenchmarks_writefReadfMouseMove(benchmark::State& state)
+{
+	MemoryStream stream;
+	SInt16 x = 0, y = 0;
+	SInt16 xIn, yIn;
+
+	for (auto _ : state) {
+		ProtocolUtil::writef(&stream, kMsgDMouseMove, ++x, ++y);
+		bool result = ProtocolUtil::readf(&stream, kMsgDMouseMove, &xIn, &yIn);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ProtocolUtilBenchmarks_writefReadfMouseMove);
+
+static void
+ProtocolUtilBenchmarks_writefReadfKeyDown(benchmark::State& state)
+{
+	MemoryStream stream;
+	UInt16 id = 'a', mask = 0, button = 38;
+	UInt16 idIn, maskIn, buttonIn;
+
+	for (auto _ : state) {
+		ProtocolUtil::writef(&stream, kMsgDKeyDown, id, mask, button);
+		bool result = ProtocolUtil::readf(&stream, kMsgDKeyDown,
+							&idIn, &maskIn, &buttonIn);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(ProtocolUtilBenchmarks_writefReadfKeyDown);
+
+static void
+ProtocolUtilBenchmarks_writefReadfString(benchmark::State& state)
+{
+	MemoryStream stream;
+	String data(static_cast<size_t>(state.range(0)), 'x');
+	String dataIn;
+
+	for (auto _ : state) {
+		ProtocolUtil::writef(&stream, kMsgDClipboard, 0, 1, 0, &data);
+		UInt8 id, mark;
+		UInt32 seq;
+		bool result = ProtocolUtil::readf(&stream, kMsgDClipboard,
+							&id, &seq, &mark, &dataIn);
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(ProtocolUtilBenchmarks_writefReadfString)->Arg(64)->Arg(4096);
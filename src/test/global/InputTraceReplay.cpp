@@ -0,0 +1,168 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/global/InputTraceReplay.h"
+
+#include "test/global/NullScreen.h"
+#include "server/Config.h"
+#include "server/PrimaryClient.h"
+#include "synergy/Clipboard.h"
+#include "base/AllocationTracker.h"
+#include "base/IEventQueue.h"
+#include "base/Stopwatch.h"
+
+#include <sstream>
+
+//
+// InputTraceReplay
+//
+
+InputTraceReplay::InputTraceReplay(IEventQueue* events) :
+	m_events(events),
+	m_config(NULL),
+	m_server(events)
+{
+	for (int i = 0; i < InputTraceRecord::kNumTypes; ++i) {
+		m_allocations[i] = 0;
+	}
+}
+
+InputTraceReplay::~InputTraceReplay()
+{
+	stop();
+	delete m_config;
+}
+
+bool
+InputTraceReplay::load(const String& filename)
+{
+	InputTraceReader reader;
+	if (!reader.open(filename)) {
+		return false;
+	}
+
+	RecordList records;
+	InputTraceRecord record;
+	while (reader.read(record)) {
+		records.push_back(record);
+	}
+	return load(reader.getConfig(), reader.getScreen(), records);
+}
+
+bool
+InputTraceReplay::load(const String& config, const String& screen,
+				const RecordList& records)
+{
+	assert(m_server.getServer() == NULL);
+
+	Config* newConfig = new Config(m_events);
+	try {
+		std::istringstream configStream(config);
+		configStream >> *newConfig;
+	}
+	catch (XConfigRead&) {
+		delete newConfig;
+		return false;
+	}
+	if (!newConfig->isScreen(screen)) {
+		delete newConfig;
+		return false;
+	}
+
+	delete m_config;
+	m_config     = newConfig;
+	m_screenName = newConfig->getCanonicalName(screen);
+	m_records    = records;
+	return true;
+}
+
+void
+InputTraceReplay::start()
+{
+	assert(m_config != NULL);
+
+	for (int i = 0; i < InputTraceRecord::kNumTypes; ++i) {
+		m_allocations[i] = 0;
+	}
+	m_server.start(*m_config, m_screenName);
+}
+
+void
+InputTraceReplay::replay(double speed)
+{
+	assert(m_server.getServer() != NULL);
+
+	void* primaryTarget = m_server.getPrimaryClient()->getEventTarget();
+	void* filterTarget  = m_config->getInputFilter();
+	Stopwatch time;
+	for (RecordList::const_iterator i = m_records.begin();
+							i != m_records.end(); ++i) {
+		if (speed > 0.0) {
+			double when = static_cast<double>(i->m_time) / 1000000.0 / speed;
+			for (double wait = when - time.getTime(); wait > 0.0;
+							wait = when - time.getTime()) {
+				m_server.dispatchEvents(wait);
+			}
+		}
+
+		if (i->m_type == InputTraceRecord::kClipboardChanged) {
+			// the trace has the size of the data, not the data.  make
+			// it different each time or the server ignores the change.
+			Clipboard clipboard;
+			clipboard.open(0);
+			clipboard.add(IClipboard::kText,
+							String(i->m_size, 'a' + i->m_count % 26));
+			clipboard.close();
+			m_server.getPlatformScreen()->setClipboard(
+							static_cast<ClipboardID>(i->m_id), &clipboard);
+		}
+
+		// events were drained so dispatching now keeps them in order.
+		// it also leaves the queue's overhead out of the timing.
+		Event event = i->makeEvent(m_events, primaryTarget, filterTarget);
+		UInt64 allocations = AllocationTracker::getThreadAllocations();
+		m_events->dispatchEvent(event);
+		m_server.dispatchEvents();
+		m_allocations[i->m_type] +=
+							AllocationTracker::getThreadAllocations() - allocations;
+		Event::deleteData(event);
+	}
+}
+
+void
+InputTraceReplay::stop()
+{
+	m_server.stop();
+}
+
+const InputTraceReplay::RecordList&
+InputTraceReplay::getRecords() const
+{
+	return m_records;
+}
+
+UInt64
+InputTraceReplay::getNumAllocations(InputTraceRecord::EType type) const
+{
+	return m_allocations[type];
+}
+
+const NullClientProxy*
+InputTraceReplay::getClient(const String& name) const
+{
+	return m_server.getClient(name);
+}
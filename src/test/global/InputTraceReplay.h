@@ -0,0 +1,114 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "test/global/NullServer.h"
+#include "server/InputTrace.h"
+#include "base/String.h"
+#include "common/stdvector.h"
+
+class Config;
+class IEventQueue;
+class NullClientProxy;
+
+//! Input trace replay
+/*!
+Replays an input trace, as recorded by a server with --record-input,
+to a server whose primary screen is a NullScreen and whose clients are
+NullClientProxy objects, so the server's handling of real input can be
+timed without a display or the network.  The events were recorded
+after the input filter so its rules aren't run again.
+*/
+class InputTraceReplay {
+public:
+	typedef std::vector<InputTraceRecord> RecordList;
+
+	InputTraceReplay(IEventQueue* events);
+	~InputTraceReplay();
+
+	//! @name manipulators
+	//@{
+
+	//! Load trace
+	/*!
+	Reads the trace in \c filename.  Returns false if it can't be read.
+	*/
+	bool				load(const String& filename);
+
+	//! Load records
+	/*!
+	Uses \c records for the server with configuration \c config, as
+	text, and screen \c screen.  Returns false if \c config is invalid.
+	*/
+	bool				load(const String& config, const String& screen,
+							const RecordList& records);
+
+	//! Start server
+	/*!
+	Creates the server and connects a client to it for each of the
+	other screens in the configuration.
+	*/
+	void				start();
+
+	//! Replay trace
+	/*!
+	Sends the records to the server at \c speed times the speed they
+	were recorded at, or as fast as the server handles them if \c speed
+	is 0.
+	*/
+	void				replay(double speed);
+
+	//! Stop server
+	/*!
+	Disconnects the clients and destroys the server.
+	*/
+	void				stop();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get records
+	const RecordList&	getRecords() const;
+
+	//! Get number of allocations
+	/*!
+	Returns the number of heap allocations the server made handling the
+	replayed records of type \c type, or 0 if allocations aren't
+	tracked (see AllocationTracker).
+	*/
+	UInt64				getNumAllocations(InputTraceRecord::EType type) const;
+
+	//! Get client
+	/*!
+	Returns the client for screen \c name, or NULL if there's no such
+	client or the server isn't started.
+	*/
+	const NullClientProxy*
+						getClient(const String& name) const;
+
+	//@}
+
+private:
+	IEventQueue*		m_events;
+	Config*				m_config;
+	String				m_screenName;
+	RecordList			m_records;
+	NullServer			m_server;
+	UInt64				m_allocations[InputTraceRecord::kNumTypes];
+};
@@ -0,0 +1,112 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/global/MemoryStream.h"
+
+#include "io/SharedBuffer.h"
+
+#include <cstring>
+
+//
+// MemoryStream
+//
+
+MemoryStream::MemoryStream()
+{
+	// do nothing
+}
+
+MemoryStream::~MemoryStream()
+{
+	// do nothing
+}
+
+void
+MemoryStream::close()
+{
+	m_buffer.pop(m_buffer.getSize());
+}
+
+UInt32
+MemoryStream::read(void* buffer, UInt32 n)
+{
+	if (n > m_buffer.getSize()) {
+		n = m_buffer.getSize();
+	}
+	if (n == 0) {
+		return 0;
+	}
+	if (buffer != NULL) {
+		memcpy(buffer, m_buffer.peek(n), n);
+	}
+	m_buffer.pop(n);
+	return n;
+}
+
+void
+MemoryStream::write(const void* buffer, UInt32 n)
+{
+	m_buffer.write(buffer, n);
+}
+
+bool
+MemoryStream::writeFile(const void*, UInt32, int, UInt64, UInt32)
+{
+	return false;
+}
+
+void
+MemoryStream::writeShared(SharedBuffer* buffer)
+{
+	m_buffer.write(buffer->getData(), buffer->getSize());
+}
+
+void
+MemoryStream::flush()
+{
+	// do nothing
+}
+
+void
+MemoryStream::shutdownInput()
+{
+	// do nothing
+}
+
+void
+MemoryStream::shutdownOutput()
+{
+	// do nothing
+}
+
+void*
+MemoryStream::getEventTarget() const
+{
+	return const_cast<void*>(static_cast<const void*>(this));
+}
+
+bool
+MemoryStream::isReady() const
+{
+	return m_buffer.getSize() > 0;
+}
+
+UInt32
+MemoryStream::getSize() const
+{
+	return m_buffer.getSize();
+}
@@ -0,0 +1,50 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "io/IStream.h"
+#include "io/StreamBuffer.h"
+
+//! In-memory stream
+/*!
+A stream that reads back what was written to it, so stream filters
+and protocol code can be measured without a socket.  Sending from a
+file isn't supported and shared buffers are copied.
+*/
+class MemoryStream : public synergy::IStream {
+public:
+	MemoryStream();
+	virtual ~MemoryStream();
+
+	// IStream overrides
+	virtual void		close();
+	virtual UInt32		read(void* buffer, UInt32 n);
+	virtual void		write(const void* buffer, UInt32 n);
+	virtual bool		writeFile(const void* header, UInt32 headerSize,
+							int fd, UInt64 offset, UInt32 n);
+	virtual void		writeShared(SharedBuffer* buffer);
+	virtual void		flush();
+	virtual void		shutdownInput();
+	virtual void		shutdownOutput();
+	virtual void*		getEventTarget() const;
+	virtual bool		isReady() const;
+	virtual UInt32		getSize() const;
+
+private:
+	StreamBuffer		m_buffer;
+};
@@ -0,0 +1,245 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/global/NullClientProxy.h"
+
+#include "test/global/MemoryStream.h"
+
+//
+// NullClientProxy
+//
+
+NullClientProxy::NullClientProxy(const String& name) :
+	ClientProxy(name, new MemoryStream()),
+	m_x(kWidth / 2),
+	m_y(kHeight / 2),
+	m_numEnters(0),
+	m_numMotions(0),
+	m_numButtons(0),
+	m_numKeystrokes(0),
+	m_numClipboardBytes(0),
+	m_numOptionResets(0)
+{
+	MonitorInfo monitor;
+	monitor.m_x = 0;
+	monitor.m_y = 0;
+	monitor.m_w = kWidth;
+	monitor.m_h = kHeight;
+	m_monitors.push_back(monitor);
+}
+
+NullClientProxy::~NullClientProxy()
+{
+	// do nothing
+}
+
+UInt64
+NullClientProxy::getNumEnters() const
+{
+	return m_numEnters;
+}
+
+UInt64
+NullClientProxy::getNumMotions() const
+{
+	return m_numMotions;
+}
+
+UInt64
+NullClientProxy::getNumButtons() const
+{
+	return m_numButtons;
+}
+
+UInt64
+NullClientProxy::getNumKeystrokes() const
+{
+	return m_numKeystrokes;
+}
+
+UInt64
+NullClientProxy::getNumClipboardBytes() const
+{
+	return m_numClipboardBytes;
+}
+
+UInt64
+NullClientProxy::getNumOptionResets() const
+{
+	return m_numOptionResets;
+}
+
+const OptionsList&
+NullClientProxy::getOptions() const
+{
+	return m_options;
+}
+
+bool
+NullClientProxy::getClipboard(ClipboardID id, IClipboard* clipboard) const
+{
+	return Clipboard::copy(clipboard, &m_clipboard[id]);
+}
+
+void
+NullClientProxy::getShape(SInt32& x, SInt32& y,
+				SInt32& width, SInt32& height) const
+{
+	x      = 0;
+	y      = 0;
+	width  = kWidth;
+	height = kHeight;
+}
+
+void
+NullClientProxy::getCursorPos(SInt32& x, SInt32& y) const
+{
+	x = m_x;
+	y = m_y;
+}
+
+const IScreen::MonitorList&
+NullClientProxy::getMonitors() const
+{
+	return m_monitors;
+}
+
+void
+NullClientProxy::enter(SInt32 xAbs, SInt32 yAbs,
+				UInt32, KeyModifierMask, bool)
+{
+	m_x = xAbs;
+	m_y = yAbs;
+	++m_numEnters;
+}
+
+bool
+NullClientProxy::leave()
+{
+	return true;
+}
+
+void
+NullClientProxy::setClipboard(ClipboardID id, const IClipboard* clipboard)
+{
+	Clipboard::copy(&m_clipboard[id], clipboard);
+	m_clipboard[id].open(0);
+	for (SInt32 format = 0; format < IClipboard::kNumFormats; ++format) {
+		IClipboard::EFormat f = static_cast<IClipboard::EFormat>(format);
+		if (m_clipboard[id].has(f)) {
+			m_numClipboardBytes += m_clipboard[id].get(f).size();
+		}
+	}
+	m_clipboard[id].close();
+}
+
+void
+NullClientProxy::grabClipboard(ClipboardID id)
+{
+	m_clipboard[id].open(0);
+	m_clipboard[id].empty();
+	m_clipboard[id].close();
+}
+
+void
+NullClientProxy::setClipboardDirty(ClipboardID, bool)
+{
+	// do nothing
+}
+
+void
+NullClientProxy::keyDown(KeyID, KeyModifierMask, KeyButton)
+{
+	++m_numKeystrokes;
+}
+
+void
+NullClientProxy::keyRepeat(KeyID, KeyModifierMask, SInt32, KeyButton)
+{
+	++m_numKeystrokes;
+}
+
+void
+NullClientProxy::keyUp(KeyID, KeyModifierMask, KeyButton)
+{
+	++m_numKeystrokes;
+}
+
+void
+NullClientProxy::mouseDown(ButtonID)
+{
+	++m_numButtons;
+}
+
+void
+NullClientProxy::mouseUp(ButtonID)
+{
+	++m_numButtons;
+}
+
+void
+NullClientProxy::mouseMove(SInt32 xAbs, SInt32 yAbs)
+{
+	m_x = xAbs;
+	m_y = yAbs;
+	++m_numMotions;
+}
+
+void
+NullClientProxy::mouseRelativeMove(SInt32 xRel, SInt32 yRel)
+{
+	m_x += xRel;
+	m_y += yRel;
+	++m_numMotions;
+}
+
+void
+NullClientProxy::mouseWheel(SInt32, SInt32)
+{
+	++m_numButtons;
+}
+
+void
+NullClientProxy::screensaver(bool)
+{
+	// do nothing
+}
+
+void
+NullClientProxy::resetOptions()
+{
+	++m_numOptionResets;
+	m_options.clear();
+}
+
+void
+NullClientProxy::setOptions(const OptionsList& options)
+{
+	m_options.insert(m_options.end(), options.begin(), options.end());
+}
+
+void
+NullClientProxy::sendDragInfo(UInt32, const char*, size_t)
+{
+	// do nothing
+}
+
+void
+NullClientProxy::fileChunkSending(const FileChunk&)
+{
+	// do nothing
+}
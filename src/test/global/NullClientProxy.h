@@ -0,0 +1,125 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "server/ClientProxy.h"
+#include "synergy/Clipboard.h"
+#include "synergy/clipboard_types.h"
+
+//! Client proxy without a client
+/*!
+A client proxy that counts the input the server sends it instead of
+sending it to a client, so a server can be run without the network.
+Closing it doesn't disconnect it; the owner must send the client
+proxy's disconnected event.
+*/
+class NullClientProxy : public ClientProxy {
+public:
+	enum {
+		kWidth  = 1920,
+		kHeight = 1080
+	};
+
+	NullClientProxy(const String& name);
+	virtual ~NullClientProxy();
+
+	//! @name accessors
+	//@{
+
+	//! Get number of enters
+	UInt64				getNumEnters() const;
+
+	//! Get number of mouse motions
+	/*!
+	Returns the number of absolute and relative mouse motions.
+	*/
+	UInt64				getNumMotions() const;
+
+	//! Get number of mouse button and wheel events
+	UInt64				getNumButtons() const;
+
+	//! Get number of keystrokes
+	/*!
+	Returns the number of key presses, repeats and releases.
+	*/
+	UInt64				getNumKeystrokes() const;
+
+	//! Get number of clipboard bytes
+	/*!
+	Returns the size of all clipboard data set so far.
+	*/
+	UInt64				getNumClipboardBytes() const;
+
+	//! Get number of option resets
+	UInt64				getNumOptionResets() const;
+
+	//! Get options
+	/*!
+	Returns the options sent since the last reset, in the order they
+	were sent.
+	*/
+	const OptionsList&	getOptions() const;
+
+	//@}
+
+	// IScreen
+	virtual bool		getClipboard(ClipboardID id, IClipboard*) const;
+	virtual void		getShape(SInt32& x, SInt32& y,
+							SInt32& width, SInt32& height) const;
+	virtual void		getCursorPos(SInt32& x, SInt32& y) const;
+	virtual const MonitorList&
+						getMonitors() const;
+
+	// IClient overrides
+	virtual void		enter(SInt32 xAbs, SInt32 yAbs,
+							UInt32 seqNum, KeyModifierMask mask,
+							bool forScreensaver);
+	virtual bool		leave();
+	virtual void		setClipboard(ClipboardID, const IClipboard*);
+	virtual void		grabClipboard(ClipboardID);
+	virtual void		setClipboardDirty(ClipboardID, bool);
+	virtual void		keyDown(KeyID, KeyModifierMask, KeyButton);
+	virtual void		keyRepeat(KeyID, KeyModifierMask,
+							SInt32 count, KeyButton);
+	virtual void		keyUp(KeyID, KeyModifierMask, KeyButton);
+	virtual void		mouseDown(ButtonID);
+	virtual void		mouseUp(ButtonID);
+	virtual void		mouseMove(SInt32 xAbs, SInt32 yAbs);
+	virtual void		mouseRelativeMove(SInt32 xRel, SInt32 yRel);
+	virtual void		mouseWheel(SInt32 xDelta, SInt32 yDelta);
+	virtual void		screensaver(bool activate);
+	virtual void		resetOptions();
+	virtual void		setOptions(const OptionsList& options);
+	virtual void		sendDragInfo(UInt32 fileCount, const char* info,
+							size_t size);
+	virtual void		fileChunkSending(const FileChunk& chunk);
+
+private:
+	SInt32				m_x, m_y;
+	MonitorList			m_monitors;
+	Clipboard			m_clipboard[kClipboardEnd];
+
+	// counts of the input sent
+	UInt64				m_numEnters;
+	UInt64				m_numMotions;
+	UInt64				m_numButtons;
+	UInt64				m_numKeystrokes;
+	UInt64				m_numClipboardBytes;
+	UInt64				m_numOptionResets;
+	OptionsList			m_options;
+};
@@ -0,0 +1,109 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/global/NullKeyState.h"
+
+#include "synergy/LatencyTrace.h"
+
+static void
+addKey(synergy::KeyMap& keyMap, KeyID id, KeyButton button,
+				KeyModifierMask required, KeyModifierMask sensitive,
+				KeyModifierMask generates = 0, bool lock = false)
+{
+	synergy::KeyMap::KeyItem item;
+	item.m_id        = id;
+	item.m_group     = 0;
+	item.m_button    = button;
+	item.m_required  = required;
+	item.m_sensitive = sensitive;
+	item.m_generates = generates;
+	item.m_lock      = lock;
+	item.m_client    = 0;
+	keyMap.addKeyEntry(item);
+}
+
+//
+// NullKeyState
+//
+
+NullKeyState::NullKeyState(IEventQueue* events) :
+	KeyState(events),
+	m_numKeystrokes(0)
+{
+	// do nothing
+}
+
+NullKeyState::~NullKeyState()
+{
+	// do nothing
+}
+
+UInt64
+NullKeyState::getNumKeystrokes() const
+{
+	return m_numKeystrokes;
+}
+
+bool
+NullKeyState::fakeCtrlAltDel()
+{
+	return false;
+}
+
+KeyModifierMask
+NullKeyState::pollActiveModifiers() const
+{
+	return 0;
+}
+
+SInt32
+NullKeyState::pollActiveGroup() const
+{
+	return 0;
+}
+
+void
+NullKeyState::pollPressedKeys(KeyButtonSet&) const
+{
+	// no key is ever really down
+}
+
+void
+NullKeyState::getKeyMap(synergy::KeyMap& keyMap)
+{
+	const KeyModifierMask letter = KeyModifierShift | KeyModifierCapsLock;
+
+	KeyButton button = 10;
+	for (KeyID c = 'a'; c <= 'z'; ++c, ++button) {
+		addKey(keyMap, c, button, 0, letter);
+		addKey(keyMap, c - 'a' + 'A', button, KeyModifierShift, letter);
+	}
+	addKey(keyMap, ' ', button++, 0, 0);
+	addKey(keyMap, kKeyShift_L, button++, 0, 0, KeyModifierShift);
+	addKey(keyMap, kKeyControl_L, button++, 0, 0, KeyModifierControl);
+	addKey(keyMap, kKeyAlt_L, button++, 0, 0, KeyModifierAlt);
+	addKey(keyMap, kKeyCapsLock, button++, 0, 0, KeyModifierCapsLock, true);
+}
+
+void
+NullKeyState::fakeKey(const Keystroke& keystroke)
+{
+	if (keystroke.m_type == Keystroke::kButton) {
+		++m_numKeystrokes;
+		LatencyTrace::injected();
+	}
+}
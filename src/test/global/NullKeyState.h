@@ -0,0 +1,57 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/KeyState.h"
+
+//! Key state of a NullScreen
+/*!
+Maps keys with a small US layout of letters, space and the modifiers
+and counts the keystrokes it would have synthesized.
+*/
+class NullKeyState : public KeyState {
+public:
+	NullKeyState(IEventQueue* events);
+	virtual ~NullKeyState();
+
+	//! @name accessors
+	//@{
+
+	//! Get number of keystrokes
+	/*!
+	Returns the number of key presses and releases synthesized so far.
+	*/
+	UInt64				getNumKeystrokes() const;
+
+	//@}
+
+	// IKeyState overrides
+	virtual bool		fakeCtrlAltDel();
+	virtual KeyModifierMask
+						pollActiveModifiers() const;
+	virtual SInt32		pollActiveGroup() const;
+	virtual void		pollPressedKeys(KeyButtonSet& pressedKeys) const;
+
+protected:
+	// KeyState overrides
+	virtual void		getKeyMap(synergy::KeyMap& keyMap);
+	virtual void		fakeKey(const Keystroke& keystroke);
+
+private:
+	UInt64				m_numKeystrokes;
+};
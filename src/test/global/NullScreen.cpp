@@ -0,0 +1,409 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/global/NullScreen.h"
+
+#include "test/global/NullKeyState.h"
+#include "synergy/LatencyTrace.h"
+#include "base/IEventQueue.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+//
+// NullScreen
+//
+
+NullScreen::NullScreen(IEventQueue* events, bool isPrimary) :
+	PlatformScreen(events),
+	m_events(events),
+	m_isPrimary(isPrimary),
+	m_isOnScreen(isPrimary),
+	m_x(kWidth / 2),
+	m_y(kHeight / 2),
+	m_w(kWidth),
+	m_h(kHeight),
+	m_sequenceNumber(0),
+	m_keyState(new NullKeyState(events)),
+	m_lastHotKeyID(0),
+	m_numMotions(0),
+	m_numClipboardBytes(0)
+{
+	updateMonitors();
+}
+
+NullScreen::~NullScreen()
+{
+	delete m_keyState;
+}
+
+void
+NullScreen::captureMouseMove(SInt32 dx, SInt32 dy)
+{
+	LatencyTrace::CaptureScope captureScope;
+	if (m_isOnScreen) {
+		m_x += dx;
+		m_y += dy;
+		sendEvent(m_events->forIPrimaryScreen().motionOnPrimary(),
+							MotionInfo::alloc(m_x, m_y));
+	}
+	else {
+		sendEvent(m_events->forIPrimaryScreen().motionOnSecondary(),
+							MotionInfo::alloc(dx, dy));
+	}
+}
+
+void
+NullScreen::captureKey(KeyID id, KeyModifierMask mask,
+				KeyButton button, bool press)
+{
+	LatencyTrace::CaptureScope captureScope;
+	HotKeyMap::const_iterator hotKey = m_hotKeys.find(std::make_pair(id, mask));
+	if (hotKey != m_hotKeys.end()) {
+		sendEvent(press ? m_events->forIPrimaryScreen().hotKeyDown() :
+							m_events->forIPrimaryScreen().hotKeyUp(),
+							HotKeyInfo::alloc(hotKey->second));
+		return;
+	}
+	sendEvent(press ? m_events->forIKeyState().keyDown() :
+							m_events->forIKeyState().keyUp(),
+							KeyInfo::alloc(id, mask, button, 1));
+}
+
+void
+NullScreen::captureButton(ButtonID id, KeyModifierMask mask, bool press)
+{
+	LatencyTrace::CaptureScope captureScope;
+	sendEvent(press ? m_events->forIPrimaryScreen().buttonDown() :
+							m_events->forIPrimaryScreen().buttonUp(),
+							ButtonInfo::alloc(id, mask));
+}
+
+void
+NullScreen::captureResize(SInt32 w, SInt32 h)
+{
+	m_w = w;
+	m_h = h;
+	m_monitors.clear();
+	updateMonitors();
+	sendEvent(m_events->forIScreen().shapeChanged());
+}
+
+void
+NullScreen::captureMonitors(const MonitorList& monitors)
+{
+	m_w = 0;
+	m_h = 0;
+	for (MonitorList::const_iterator i = monitors.begin();
+							i != monitors.end(); ++i) {
+		m_w = std::max(m_w, i->m_x + i->m_w);
+		m_h = std::max(m_h, i->m_y + i->m_h);
+	}
+	m_monitors = monitors;
+	updateMonitors();
+	sendEvent(m_events->forIScreen().shapeChanged());
+}
+
+void
+NullScreen::captureClipboard(ClipboardID id, const IClipboard* clipboard)
+{
+	Clipboard::copy(&m_clipboard[id], clipboard);
+	sendClipboardEvent(m_events->forClipboard().clipboardGrabbed(), id);
+	sendClipboardEvent(m_events->forClipboard().clipboardChanged(), id);
+}
+
+UInt64
+NullScreen::getNumMotions() const
+{
+	return m_numMotions;
+}
+
+UInt64
+NullScreen::getNumKeystrokes() const
+{
+	return m_keyState->getNumKeystrokes();
+}
+
+UInt64
+NullScreen::getNumClipboardBytes() const
+{
+	return m_numClipboardBytes;
+}
+
+void*
+NullScreen::getEventTarget() const
+{
+	return const_cast<NullScreen*>(this);
+}
+
+bool
+NullScreen::getClipboard(ClipboardID id, IClipboard* clipboard) const
+{
+	return Clipboard::copy(clipboard, &m_clipboard[id]);
+}
+
+void
+NullScreen::getShape(SInt32& x, SInt32& y, SInt32& w, SInt32& h) const
+{
+	x = 0;
+	y = 0;
+	w = m_w;
+	h = m_h;
+}
+
+const IScreen::MonitorList&
+NullScreen::getMonitors() const
+{
+	if (m_monitors.empty()) {
+		return PlatformScreen::getMonitors();
+	}
+	return m_monitors;
+}
+
+void
+NullScreen::getCursorPos(SInt32& x, SInt32& y) const
+{
+	x = m_x;
+	y = m_y;
+}
+
+void
+NullScreen::reconfigure(UInt32)
+{
+	// do nothing
+}
+
+void
+NullScreen::warpCursor(SInt32 x, SInt32 y)
+{
+	m_x = x;
+	m_y = y;
+}
+
+UInt32
+NullScreen::registerHotKey(KeyID key, KeyModifierMask mask)
+{
+	// registering a hotkey again takes it over, as on X11
+	m_hotKeys[std::make_pair(key, mask)] = ++m_lastHotKeyID;
+	return m_lastHotKeyID;
+}
+
+void
+NullScreen::unregisterHotKey(UInt32 id)
+{
+	for (HotKeyMap::iterator i = m_hotKeys.begin(); i != m_hotKeys.end(); ++i) {
+		if (i->second == id) {
+			m_hotKeys.erase(i);
+			return;
+		}
+	}
+}
+
+void
+NullScreen::fakeInputBegin()
+{
+	// do nothing
+}
+
+void
+NullScreen::fakeInputEnd()
+{
+	// do nothing
+}
+
+SInt32
+NullScreen::getJumpZoneSize() const
+{
+	return 1;
+}
+
+bool
+NullScreen::isAnyMouseButtonDown(UInt32& buttonID) const
+{
+	buttonID = kButtonNone;
+	return false;
+}
+
+void
+NullScreen::getCursorCenter(SInt32& x, SInt32& y) const
+{
+	x = m_w / 2;
+	y = m_h / 2;
+}
+
+void
+NullScreen::fakeMouseButton(ButtonID, bool)
+{
+	LatencyTrace::injected();
+}
+
+void
+NullScreen::fakeMouseMove(SInt32 x, SInt32 y)
+{
+	m_x = x;
+	m_y = y;
+	++m_numMotions;
+	LatencyTrace::injected();
+}
+
+void
+NullScreen::fakeMouseRelativeMove(SInt32, SInt32) const
+{
+	++m_numMotions;
+	LatencyTrace::injected();
+}
+
+void
+NullScreen::fakeMouseWheel(SInt32, SInt32) const
+{
+	LatencyTrace::injected();
+}
+
+void
+NullScreen::enable()
+{
+	// do nothing
+}
+
+void
+NullScreen::disable()
+{
+	// do nothing
+}
+
+void
+NullScreen::enter()
+{
+	m_isOnScreen = true;
+}
+
+bool
+NullScreen::leave()
+{
+	m_isOnScreen = false;
+	return true;
+}
+
+bool
+NullScreen::setClipboard(ClipboardID id, const IClipboard* clipboard)
+{
+	if (clipboard == NULL) {
+		// grab the clipboard, i.e. empty it
+		m_clipboard[id].open(0);
+		m_clipboard[id].empty();
+		m_clipboard[id].close();
+		return true;
+	}
+
+	Clipboard::copy(&m_clipboard[id], clipboard);
+	m_clipboard[id].open(0);
+	for (SInt32 format = 0; format < IClipboard::kNumFormats; ++format) {
+		IClipboard::EFormat f = static_cast<IClipboard::EFormat>(format);
+		if (m_clipboard[id].has(f)) {
+			m_numClipboardBytes += m_clipboard[id].get(f).size();
+		}
+	}
+	m_clipboard[id].close();
+	return true;
+}
+
+void
+NullScreen::checkClipboards()
+{
+	// do nothing
+}
+
+void
+NullScreen::openScreensaver(bool)
+{
+	// do nothing
+}
+
+void
+NullScreen::closeScreensaver()
+{
+	// do nothing
+}
+
+void
+NullScreen::screensaver(bool)
+{
+	// do nothing
+}
+
+void
+NullScreen::resetOptions()
+{
+	// do nothing
+}
+
+void
+NullScreen::setOptions(const OptionsList&)
+{
+	// do nothing
+}
+
+void
+NullScreen::setSequenceNumber(UInt32 seqNum)
+{
+	m_sequenceNumber = seqNum;
+}
+
+bool
+NullScreen::isPrimary() const
+{
+	return m_isPrimary;
+}
+
+bool
+NullScreen::isDraggingStarted()
+{
+	return false;
+}
+
+void
+NullScreen::handleSystemEvent(const Event&, void*)
+{
+	// there are no system events
+}
+
+void
+NullScreen::updateButtons()
+{
+	// do nothing
+}
+
+IKeyState*
+NullScreen::getKeyState() const
+{
+	return m_keyState;
+}
+
+void
+NullScreen::sendEvent(Event::Type type, void* data)
+{
+	m_events->addEvent(Event(type, getEventTarget(), data));
+}
+
+void
+NullScreen::sendClipboardEvent(Event::Type type, ClipboardID id)
+{
+	ClipboardInfo* info   = (ClipboardInfo*)malloc(sizeof(ClipboardInfo));
+	info->m_id             = id;
+	info->m_sequenceNumber = m_sequenceNumber;
+	sendEvent(type, info);
+}
@@ -0,0 +1,191 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "synergy/PlatformScreen.h"
+#include "synergy/Clipboard.h"
+#include "synergy/clipboard_types.h"
+#include "common/stdmap.h"
+
+class NullKeyState;
+
+//! Screen without a display
+/*!
+A platform screen that needs no windowing system, for running a server
+and clients where there's no display, e.g. to load test them.  As a
+secondary screen it counts the input it would have synthesized.  As a
+primary screen it reports the input it's given with the capture*()
+methods as if a user had made it.
+*/
+class NullScreen : public PlatformScreen {
+public:
+	enum {
+		kWidth  = 1920,
+		kHeight = 1080
+	};
+
+	NullScreen(IEventQueue* events, bool isPrimary);
+	virtual ~NullScreen();
+
+	//! @name manipulators
+	//@{
+
+	//! Capture mouse motion
+	/*!
+	Reports a mouse motion by \c dx,dy as a motion on the primary
+	screen while the cursor is on it and as a motion on a secondary
+	screen otherwise.
+	*/
+	void				captureMouseMove(SInt32 dx, SInt32 dy);
+
+	//! Capture key
+	/*!
+	Reports a key press or release, or a hotkey press or release if
+	\c id and \c mask were registered as a hotkey.
+	*/
+	void				captureKey(KeyID id, KeyModifierMask mask,
+							KeyButton button, bool press);
+
+	//! Capture mouse button
+	/*!
+	Reports a mouse button press or release with modifiers \c mask.
+	*/
+	void				captureButton(ButtonID id, KeyModifierMask mask,
+							bool press);
+
+	//! Capture resize
+	/*!
+	Makes the screen \c w by \c h and reports that its shape changed.
+	It starts out \c kWidth by \c kHeight.
+	*/
+	void				captureResize(SInt32 w, SInt32 h);
+
+	//! Capture monitor change
+	/*!
+	Makes the screen out of \c monitors, none of which may extend above
+	or left of 0,0, and reports that its shape changed.  The screen becomes the bounding box
+	of the monitors.  Until this is called, and after captureResize(),
+	the screen has a single monitor.
+	*/
+	void				captureMonitors(const MonitorList& monitors);
+
+	//! Capture clipboard change
+	/*!
+	Takes the contents of \c clipboard as clipboard \c id and reports
+	that the clipboard was grabbed and changed.
+	*/
+	void				captureClipboard(ClipboardID id,
+							const IClipboard* clipboard);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get number of mouse motions
+	/*!
+	Returns the number of mouse motions synthesized so far.
+	*/
+	UInt64				getNumMotions() const;
+
+	//! Get number of keystrokes
+	/*!
+	Returns the number of key presses and releases synthesized so far.
+	*/
+	UInt64				getNumKeystrokes() const;
+
+	//! Get number of clipboard bytes
+	/*!
+	Returns the size of all clipboard data set so far.
+	*/
+	UInt64				getNumClipboardBytes() const;
+
+	//@}
+
+	// IScreen overrides
+	virtual void*		getEventTarget() const;
+	virtual bool		getClipboard(ClipboardID id, IClipboard*) const;
+	virtual void		getShape(SInt32& x, SInt32& y,
+							SInt32& width, SInt32& height) const;
+	virtual void		getCursorPos(SInt32& x, SInt32& y) const;
+	virtual const MonitorList&
+						getMonitors() const;
+
+	// IPrimaryScreen overrides
+	virtual void		reconfigure(UInt32 activeSides);
+	virtual void		warpCursor(SInt32 x, SInt32 y);
+	virtual UInt32		registerHotKey(KeyID key, KeyModifierMask mask);
+	virtual void		unregisterHotKey(UInt32 id);
+	virtual void		fakeInputBegin();
+	virtual void		fakeInputEnd();
+	virtual SInt32		getJumpZoneSize() const;
+	virtual bool		isAnyMouseButtonDown(UInt32& buttonID) const;
+	virtual void		getCursorCenter(SInt32& x, SInt32& y) const;
+
+	// ISecondaryScreen overrides
+	virtual void		fakeMouseButton(ButtonID id, bool press);
+	virtual void		fakeMouseMove(SInt32 x, SInt32 y);
+	virtual void		fakeMouseRelativeMove(SInt32 dx, SInt32 dy) const;
+	virtual void		fakeMouseWheel(SInt32 xDelta, SInt32 yDelta) const;
+
+	// IPlatformScreen overrides
+	virtual void		enable();
+	virtual void		disable();
+	virtual void		enter();
+	virtual bool		leave();
+	virtual bool		setClipboard(ClipboardID, const IClipboard*);
+	virtual void		checkClipboards();
+	virtual void		openScreensaver(bool notify);
+	virtual void		closeScreensaver();
+	virtual void		screensaver(bool activate);
+	virtual void		resetOptions();
+	virtual void		setOptions(const OptionsList& options);
+	virtual void		setSequenceNumber(UInt32);
+	virtual bool		isPrimary() const;
+	virtual bool		isDraggingStarted();
+
+protected:
+	// IPlatformScreen overrides
+	virtual void		handleSystemEvent(const Event&, void*);
+
+	// PlatformScreen overrides
+	virtual void		updateButtons();
+	virtual IKeyState*	getKeyState() const;
+
+private:
+	typedef std::map<std::pair<KeyID, KeyModifierMask>, UInt32> HotKeyMap;
+
+	void				sendEvent(Event::Type, void* = NULL);
+	void				sendClipboardEvent(Event::Type, ClipboardID id);
+
+private:
+	IEventQueue*		m_events;
+	bool				m_isPrimary;
+	bool				m_isOnScreen;
+	SInt32				m_x, m_y;
+	SInt32				m_w, m_h;
+	MonitorList			m_monitors;
+	UInt32				m_sequenceNumber;
+	Clipboard			m_clipboard[kClipboardEnd];
+	NullKeyState*		m_keyState;
+	HotKeyMap			m_hotKeys;
+	UInt32				m_lastHotKeyID;
+
+	// counts of synthesized input
+	mutable UInt64		m_numMotions;
+	UInt64				m_numClipboardBytes;
+};
@@ -0,0 +1,147 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/global/NullServer.h"
+
+#include "test/global/NullClientProxy.h"
+#include "test/global/NullScreen.h"
+#include "server/Config.h"
+#include "server/PrimaryClient.h"
+#include "server/Server.h"
+#include "synergy/Screen.h"
+#include "synergy/ServerArgs.h"
+#include "base/IEventQueue.h"
+
+//
+// NullServer
+//
+
+NullServer::NullServer(IEventQueue* events) :
+	m_events(events),
+	m_platformScreen(NULL),
+	m_screen(NULL),
+	m_primaryClient(NULL),
+	m_server(NULL)
+{
+	// do nothing
+}
+
+NullServer::~NullServer()
+{
+	stop();
+}
+
+void
+NullServer::openScreen(const String& name)
+{
+	assert(m_screen == NULL);
+
+	m_platformScreen = new NullScreen(m_events, true);
+	m_screen         = new synergy::Screen(m_platformScreen, m_events);
+	m_primaryClient  = new PrimaryClient(name, m_screen);
+
+	// the queue holds events until it's looped once
+	m_events->addEvent(Event(Event::kQuit));
+	m_events->loop();
+}
+
+void
+NullServer::start(Config& config, const String& name)
+{
+	assert(m_server == NULL);
+
+	if (m_screen == NULL) {
+		openScreen(name);
+	}
+	m_server = new Server(config, m_primaryClient, m_screen,
+							m_events, ServerArgs());
+
+	for (Config::const_iterator i = config.begin(); i != config.end(); ++i) {
+		if (*i != name) {
+			NullClientProxy* client = new NullClientProxy(*i);
+			m_clients.push_back(client);
+			m_server->adoptClient(client);
+		}
+	}
+	dispatchEvents();
+}
+
+void
+NullServer::stop()
+{
+	if (m_server != NULL) {
+		// null clients never disconnect by themselves
+		m_server->disconnect();
+		for (ClientList::const_iterator i = m_clients.begin();
+								i != m_clients.end(); ++i) {
+			m_events->addEvent(Event(m_events->forClientProxy().disconnected(),
+								*i));
+		}
+		dispatchEvents();
+		m_clients.clear();
+
+		delete m_server;
+		m_server = NULL;
+	}
+
+	delete m_primaryClient;
+	delete m_screen;
+	m_primaryClient  = NULL;
+	m_screen         = NULL;
+	m_platformScreen = NULL;
+}
+
+void
+NullServer::dispatchEvents(double timeout)
+{
+	Event event;
+	while (m_events->getEvent(event, timeout)) {
+		m_events->dispatchEvent(event);
+		Event::deleteData(event);
+		timeout = 0.0;
+	}
+}
+
+NullScreen*
+NullServer::getPlatformScreen() const
+{
+	return m_platformScreen;
+}
+
+PrimaryClient*
+NullServer::getPrimaryClient() const
+{
+	return m_primaryClient;
+}
+
+Server*
+NullServer::getServer() const
+{
+	return m_server;
+}
+
+NullClientProxy*
+NullServer::getClient(const String& name) const
+{
+	for (ClientList::const_iterator i = m_clients.begin();
+							i != m_clients.end(); ++i) {
+		if ((*i)->getName() == name) {
+			return *i;
+		}
+	}
+	return NULL;
+}
@@ -0,0 +1,116 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "base/String.h"
+#include "common/stdvector.h"
+
+class Config;
+class IEventQueue;
+class NullClientProxy;
+class NullScreen;
+class PrimaryClient;
+class Server;
+namespace synergy { class Screen; }
+
+//! Server without a display or the network
+/*!
+Runs a server whose primary screen is a NullScreen and whose clients
+are NullClientProxy objects, one for each of the other screens in its
+configuration, so the server's handling of input can be tested and
+timed.  The primary screen can also be opened without a server, e.g.
+to test an input filter on its own.
+*/
+class NullServer {
+public:
+	NullServer(IEventQueue* events);
+	~NullServer();
+
+	//! @name manipulators
+	//@{
+
+	//! Open primary screen
+	/*!
+	Creates primary screen \c name without a server.
+	*/
+	void				openScreen(const String& name);
+
+	//! Start server
+	/*!
+	Creates a server with configuration \c config on primary screen
+	\c name, opening the screen if it isn't open, and connects a client
+	to it for each of the other screens in the configuration.  The
+	server uses \c config until it's stopped.
+	*/
+	void				start(Config& config, const String& name);
+
+	//! Stop server
+	/*!
+	Disconnects the clients and destroys the server and the primary
+	screen.  Does nothing if neither is open.
+	*/
+	void				stop();
+
+	//! Dispatch events
+	/*!
+	Dispatches events until there are none left, waiting up to
+	\c timeout seconds for the first one.
+	*/
+	void				dispatchEvents(double timeout = 0.0);
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Get primary screen
+	/*!
+	Returns the primary screen, or NULL if it isn't open.
+	*/
+	NullScreen*			getPlatformScreen() const;
+
+	//! Get primary client
+	/*!
+	Returns the primary client, or NULL if the screen isn't open.
+	*/
+	PrimaryClient*		getPrimaryClient() const;
+
+	//! Get server
+	/*!
+	Returns the server, or NULL if it isn't started.
+	*/
+	Server*				getServer() const;
+
+	//! Get client
+	/*!
+	Returns the client for screen \c name, or NULL if there's no such
+	client or the server isn't started.
+	*/
+	NullClientProxy*	getClient(const String& name) const;
+
+	//@}
+
+private:
+	typedef std::vector<NullClientProxy*> ClientList;
+
+	IEventQueue*		m_events;
+	NullScreen*			m_platformScreen;
+	synergy::Screen*	m_screen;
+	PrimaryClient*		m_primaryClient;
+	Server*				m_server;
+	ClientList			m_clients;
+};
@@ -191,7 +191,9 @@ IpcTests::sendMessageToClient_serverHandleClientConnected(const Event& e, void*)
 	IpcMessage* m = static_cast<IpcMessage*>(e.getDataObject());
 	if (m->type() == kIpcHello) {
 		LOG((CLOG_DEBUG "client said hello, sending test to client"));
-		IpcLogLineMessage m("test");
+		IpcLogBatchMessage::RecordList records(1);
+		records[0].m_message = "test";
+		IpcLogBatchMessage m(0, 0, records);
 		m_sendMessageToClient_server->send(m, kIpcClientNode);
 	}
 }
@@ -200,10 +202,11 @@ void
 IpcTests::sendMessageToClient_clientHandleMessageReceived(const Event& e, void*)
 {
 	IpcMessage* m = static_cast<IpcMessage*>(e.getDataObject());
-	if (m->type() == kIpcLogLine) {
-		IpcLogLineMessage* llm = static_cast<IpcLogLineMessage*>(m);
-		LOG((CLOG_DEBUG "got ipc log message, %d", llm->logLine().c_str()));
-		m_sendMessageToClient_receivedString = llm->logLine();
+	if (m->type() == kIpcLogBatch) {
+		IpcLogBatchMessage* lbm = static_cast<IpcLogBatchMessage*>(m);
+		const String& message = lbm->records().front().m_message;
+		LOG((CLOG_DEBUG "got ipc log message, %s", message.c_str()));
+		m_sendMessageToClient_receivedString = message;
 		m_events.raiseQuitEvent();
 	}
 }
@@ -0,0 +1,151 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/mock/net/MockSocket.h"
+#include "net/SocketMultiplexer.h"
+#include "net/ISocketMultiplexerJob.h"
+#include "mt/Lock.h"
+#include "mt/Mutex.h"
+#include "arch/Arch.h"
+#include "base/Stopwatch.h"
+
+#include <gtest/gtest.h>
+
+#define TEST_PORT 24804
+#define TEST_HOST "127.0.0.1"
+
+static const double kTimeout = 5.0;
+
+// counts the bytes read by a job, which the multiplexer owns
+class ReadCount {
+public:
+	ReadCount() : m_bytes(0) { }
+
+	void				add(size_t n)
+	{
+		Lock lock(&m_mutex);
+		m_bytes += n;
+	}
+
+	bool				waitFor(size_t bytes)
+	{
+		Stopwatch timer;
+		while (timer.getTime() < kTimeout) {
+			{
+				Lock lock(&m_mutex);
+				if (m_bytes >= bytes) {
+					return true;
+				}
+			}
+			ARCH->sleep(0.01);
+		}
+		return false;
+	}
+
+private:
+	Mutex				m_mutex;
+	size_t				m_bytes;
+};
+
+// reads whatever is available and keeps servicing the socket
+class ReadingJob : public ISocketMultiplexerJob {
+public:
+	ReadingJob(ArchSocket socket, ReadCount* count) :
+		m_socket(socket), m_count(count) { }
+
+	virtual ISocketMultiplexerJob*
+						run(bool readable, bool, bool)
+	{
+		if (readable) {
+			char buffer[16];
+			m_count->add(ARCH->readSocket(m_socket, buffer, sizeof(buffer)));
+		}
+		return this;
+	}
+
+	virtual ArchSocket	getSocket() const { return m_socket; }
+	virtual bool		isReadable() const { return true; }
+	virtual bool		isWritable() const { return false; }
+
+private:
+	ArchSocket			m_socket;
+	ReadCount*			m_count;
+};
+
+class SocketMultiplexerTests : public ::testing::Test {
+public:
+	SocketMultiplexerTests() : m_listen(NULL), m_client(NULL), m_server(NULL) { }
+
+	virtual void		SetUp()
+	{
+		ArchNetAddress address = ARCH->nameToAddr(TEST_HOST);
+		ARCH->setAddrPort(address, TEST_PORT);
+
+		m_listen = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kSTREAM);
+		ARCH->setReuseAddrOnSocket(m_listen, true);
+		ARCH->bindSocket(m_listen, address);
+		ARCH->listenOnSocket(m_listen);
+
+		m_client = ARCH->newSocket(IArchNetwork::kINET, IArchNetwork::kSTREAM);
+		ARCH->connectSocket(m_client, address);
+		ARCH->closeAddr(address);
+
+		IArchNetwork::PollEntry entry = { m_listen, IArchNetwork::kPOLLIN, 0 };
+		ARCH->pollSocket(&entry, 1, kTimeout);
+		m_server = ARCH->acceptSocket(m_listen, NULL);
+		ASSERT_TRUE(m_server != NULL);
+	}
+
+	virtual void		TearDown()
+	{
+		if (m_server != NULL) {
+			ARCH->closeSocket(m_server);
+		}
+		ARCH->closeSocket(m_client);
+		ARCH->closeSocket(m_listen);
+	}
+
+	void				send()
+	{
+		// the connect may still be in progress
+		IArchNetwork::PollEntry entry = { m_client, IArchNetwork::kPOLLOUT, 0 };
+		ARCH->pollSocket(&entry, 1, kTimeout);
+		ASSERT_EQ(1U, ARCH->writeSocket(m_client, "x", 1));
+	}
+
+	ArchSocket			m_listen;
+	ArchSocket			m_client;
+	ArchSocket			m_server;
+};
+
+TEST_F(SocketMultiplexerTests, serviceThread_jobUnchanged_keepsPolling)
+{
+	MockSocket socket;
+	ReadCount count;
+	SocketMultiplexer multiplexer;
+	multiplexer.addSocket(&socket, new ReadingJob(m_server, &count));
+
+	send();
+	EXPECT_TRUE(count.waitFor(1));
+
+	// the job returned itself so nothing changed but the socket must
+	// still be polled
+	send();
+	EXPECT_TRUE(count.waitFor(2));
+
+	multiplexer.removeSocket(&socket);
+}
@@ -0,0 +1,688 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/loadtests/LoadTest.h"
+
+#include "test/global/NullScreen.h"
+#include "server/Server.h"
+#include "server/ClientListener.h"
+#include "server/ClientProxy.h"
+#include "server/PrimaryClient.h"
+#include "server/Config.h"
+#include "client/Client.h"
+#include "synergy/Screen.h"
+#include "synergy/Clipboard.h"
+#include "synergy/LatencyStats.h"
+#include "synergy/ServerArgs.h"
+#include "synergy/ClientArgs.h"
+#include "synergy/option_types.h"
+#include "net/NetworkAddress.h"
+#include "net/TCPSocketFactory.h"
+#include "net/XSocket.h"
+#include "base/IEventQueue.h"
+#include "base/TMethodEventJob.h"
+#include "base/Metrics.h"
+#include "base/MetricTypes.h"
+#include "base/Log.h"
+#include "arch/Arch.h"
+#include "arch/XArch.h"
+
+#if SYSAPI_UNIX
+#include <sys/resource.h>
+#endif
+
+static const char*		kServerName        = "server";
+
+// how often input is made.  each tick makes the input that's due, so
+// the rates hold even when the timer is late.
+static const double		kTickInterval      = 0.001;
+
+// client processes may be started after the server
+static const double		kConnectTimeout    = 30.0;
+
+// clients report latencies with each keep alive so run with frequent
+// keep alives and wait for two of them after the load
+static const SInt32		kHeartbeat         = 1000;
+static const double		kDrainTime         = 2.5;
+
+// the clients measure their clock offset with the first keep alive and
+// can't measure network latency until then
+static const double		kWarmUpTime        = 1.5;
+
+static const double		kDisconnectTimeout = 3.0;
+
+// the mouse goes around a small square so it never leaves a screen
+static const SInt32		kMotionX[]         = { 4, 0, -4, 0 };
+static const SInt32		kMotionY[]         = { 0, 4, 0, -4 };
+
+//
+// LoadTest::Options
+//
+
+LoadTest::Options::Options() :
+	m_role(kServerAndClients),
+	// not the default port, so a running server doesn't get in the way
+	m_address("127.0.0.1:24810"),
+	m_numClients(4),
+	m_firstClient(1),
+	m_duration(10.0),
+	m_mouseRate(1000.0),
+	m_keyRate(20.0),
+	m_clipboardSize(64 * 1024),
+	m_clipboardInterval(1.0),
+	m_switchInterval(1.0),
+	m_enableCrypto(false),
+	m_numBadClients(0)
+{
+	// do nothing
+}
+
+//
+// LoadTest
+//
+
+LoadTest::LoadTest(IEventQueue* events, const Options& options) :
+	m_events(events),
+	m_options(options),
+	m_state(kConnecting),
+	m_stateTimer(NULL),
+	m_tickTimer(NULL),
+	m_failed(false),
+	m_config(NULL),
+	m_serverScreen(NULL),
+	m_screen(NULL),
+	m_primaryClient(NULL),
+	m_listener(NULL),
+	m_server(NULL),
+	m_numAdopted(0),
+	m_numConnected(0),
+	m_numDisconnected(0),
+	m_numBadClientsDropped(0),
+	m_loadDuration(0.0),
+	m_nextSwitch(0.0),
+	m_nextClipboard(0.0),
+	m_activeClient(0),
+	m_numMotionsSent(0),
+	m_numKeysSent(0),
+	m_numClipboardsSent(0),
+	m_numClipboardBytesSent(0),
+	m_userTime(0.0),
+	m_systemTime(0.0)
+{
+	// do nothing
+}
+
+LoadTest::~LoadTest()
+{
+	closeBadClients();
+	closeClients();
+	closeServer();
+}
+
+bool
+LoadTest::run()
+{
+	try {
+		if (m_options.m_role != kClients) {
+			openServer();
+		}
+		if (m_options.m_role != kServer) {
+			openBadClients();
+			openClients();
+		}
+	}
+	catch (XBase& e) {
+		LOG((CLOG_ERR "cannot start: %s", e.what()));
+		return false;
+	}
+	catch (XArchNetwork& e) {
+		LOG((CLOG_ERR "cannot start: %s", e.what()));
+		return false;
+	}
+
+	setStateTimer(kConnecting, kConnectTimeout);
+	m_events->loop();
+
+	if (m_stateTimer != NULL) {
+		m_events->removeHandler(Event::kTimer, m_stateTimer);
+		m_events->deleteTimer(m_stateTimer);
+		m_stateTimer = NULL;
+	}
+	if (m_tickTimer != NULL) {
+		m_events->removeHandler(Event::kTimer, m_tickTimer);
+		m_events->deleteTimer(m_tickTimer);
+		m_tickTimer = NULL;
+	}
+
+	// the server's still running so it must have dropped them by now
+	m_numBadClientsDropped = closeBadClients();
+	if (m_numBadClientsDropped < m_options.m_numBadClients) {
+		LOG((CLOG_ERR "server didn't drop %d of %d bad clients", m_options.m_numBadClients - m_numBadClientsDropped, m_options.m_numBadClients));
+		m_failed = true;
+	}
+	return !m_failed;
+}
+
+String
+LoadTest::format() const
+{
+	static const char* kRoles[] = { "both", "server", "clients" };
+
+	String result = synergy::string::sprintf(
+							"{\n  \"role\": \"%s\",\n  \"clients\": %d,\n"
+							"  \"duration\": %.3f,\n",
+							kRoles[m_options.m_role],
+							m_options.m_numClients, m_loadDuration);
+
+	double duration = (m_loadDuration > 0.0) ? m_loadDuration : 1.0;
+	if (m_options.m_role != kClients) {
+		result += synergy::string::sprintf(
+							"  \"sent\": { \"motions\": %llu, "
+							"\"motions_per_second\": %.1f, "
+							"\"keystrokes\": %llu, \"clipboards\": %llu, "
+							"\"clipboard_bytes\": %llu },\n",
+							m_numMotionsSent, m_numMotionsSent / duration,
+							m_numKeysSent, m_numClipboardsSent,
+							m_numClipboardBytesSent);
+		result += formatLatency();
+	}
+	if (m_options.m_role != kServer) {
+		UInt64 motions = 0, keys = 0, clipboardBytes = 0;
+		for (size_t i = 0; i < m_clientScreens.size(); ++i) {
+			motions        += m_clientScreens[i]->getNumMotions();
+			keys           += m_clientScreens[i]->getNumKeystrokes();
+			clipboardBytes += m_clientScreens[i]->getNumClipboardBytes();
+		}
+		result += synergy::string::sprintf(
+							"  \"injected\": { \"motions\": %llu, "
+							"\"motions_per_second\": %.1f, "
+							"\"keystrokes\": %llu, \"clipboard_bytes\": %llu },\n",
+							motions, motions / duration, keys, clipboardBytes);
+		if (m_options.m_numBadClients > 0) {
+			result += synergy::string::sprintf(
+							"  \"bad_clients\": { \"connected\": %d, "
+							"\"dropped\": %d },\n",
+							m_options.m_numBadClients,
+							m_numBadClientsDropped);
+		}
+	}
+	result += synergy::string::sprintf(
+							"  \"cpu\": { \"user\": %.3f, \"system\": %.3f, "
+							"\"percent\": %.1f }\n}\n",
+							m_userTime, m_systemTime,
+							100.0 * (m_userTime + m_systemTime) / duration);
+	return result;
+}
+
+String
+LoadTest::getClientName(int index)
+{
+	return synergy::string::sprintf("client%d", index);
+}
+
+void
+LoadTest::openServer()
+{
+	// the screens are in a row, the server's on the left
+	m_config = new Config(m_events);
+	m_config->addScreen(kServerName);
+	String left = kServerName;
+	for (int i = 1; i <= m_options.m_numClients; ++i) {
+		String name = getClientName(i);
+		m_config->addScreen(name);
+		m_config->connect(left, kRight, 0.0f, 1.0f, name, 0.0f, 1.0f);
+		m_config->connect(name, kLeft, 0.0f, 1.0f, left, 0.0f, 1.0f);
+		left = name;
+	}
+	m_config->addOption("", kOptionLatencyTrace, 1);
+	m_config->addOption("", kOptionHeartbeat, kHeartbeat);
+
+	m_serverScreen  = new NullScreen(m_events, true);
+	m_screen        = new synergy::Screen(m_serverScreen, m_events);
+	m_primaryClient = new PrimaryClient(kServerName, m_screen);
+
+	NetworkAddress address(m_options.m_address, kDefaultPort);
+	address.resolve();
+	m_listener = new ClientListener(address,
+							new TCPSocketFactory(m_events, &m_multiplexer),
+							m_events, m_options.m_enableCrypto);
+	m_events->adoptHandler(m_events->forClientListener().connected(),
+							m_listener,
+							new TMethodEventJob<LoadTest>(this,
+								&LoadTest::handleClientConnected));
+
+	ServerArgs args;
+	args.m_enableCrypto = m_options.m_enableCrypto;
+	m_server = new Server(*m_config, m_primaryClient, m_screen, m_events, args);
+	m_events->adoptHandler(m_events->forServer().disconnected(), m_server,
+							new TMethodEventJob<LoadTest>(this,
+								&LoadTest::handleServerDisconnected));
+	m_listener->setServer(m_server);
+	m_server->setListener(m_listener);
+	LOG((CLOG_NOTE "waiting for %d clients on %s", m_options.m_numClients, m_options.m_address.c_str()));
+}
+
+void
+LoadTest::closeServer()
+{
+	if (m_server != NULL) {
+		m_events->removeHandler(m_events->forServer().disconnected(), m_server);
+		delete m_server;
+		m_server = NULL;
+	}
+	if (m_listener != NULL) {
+		m_events->removeHandler(m_events->forClientListener().connected(),
+							m_listener);
+		delete m_listener;
+		m_listener = NULL;
+	}
+	delete m_primaryClient;
+	delete m_screen;
+	delete m_config;
+	m_primaryClient = NULL;
+	m_screen        = NULL;
+	m_serverScreen  = NULL;
+	m_config        = NULL;
+}
+
+void
+LoadTest::openClients()
+{
+	NetworkAddress address(m_options.m_address, kDefaultPort);
+	address.resolve();
+
+	ClientArgs args;
+	args.m_enableCrypto = m_options.m_enableCrypto;
+	for (int i = 0; i < m_options.m_numClients; ++i) {
+		NullScreen* platformScreen  = new NullScreen(m_events, false);
+		synergy::Screen* screen     = new synergy::Screen(platformScreen, m_events);
+		Client* client = new Client(m_events,
+							getClientName(m_options.m_firstClient + i),
+							address,
+							new TCPSocketFactory(m_events, &m_multiplexer),
+							screen, args);
+		m_clientScreens.push_back(platformScreen);
+		m_screens.push_back(screen);
+		m_clients.push_back(client);
+
+		m_events->adoptHandler(m_events->forClient().connected(),
+							client->getEventTarget(),
+							new TMethodEventJob<LoadTest>(this,
+								&LoadTest::handleConnected));
+		m_events->adoptHandler(m_events->forClient().connectionFailed(),
+							client->getEventTarget(),
+							new TMethodEventJob<LoadTest>(this,
+								&LoadTest::handleConnectionFailed));
+		m_events->adoptHandler(m_events->forClient().disconnected(),
+							client->getEventTarget(),
+							new TMethodEventJob<LoadTest>(this,
+								&LoadTest::handleDisconnected));
+		client->connect();
+	}
+}
+
+void
+LoadTest::closeClients()
+{
+	for (size_t i = 0; i < m_clients.size(); ++i) {
+		Client* client = m_clients[i];
+		m_events->removeHandler(m_events->forClient().connected(),
+							client->getEventTarget());
+		m_events->removeHandler(m_events->forClient().connectionFailed(),
+							client->getEventTarget());
+		m_events->removeHandler(m_events->forClient().disconnected(),
+							client->getEventTarget());
+		delete client;
+		delete m_screens[i];
+	}
+	m_clients.clear();
+	m_screens.clear();
+	m_clientScreens.clear();
+}
+
+void
+LoadTest::openBadClients()
+{
+	// a packet that isn't a hello, or something that isn't a TLS
+	// client hello
+	static const char kJunk[]    = "\0\0\0\4junk";
+	static const char kTLSJunk[] = "GET / HTTP/1.0\r\n\r\n";
+
+	NetworkAddress address(m_options.m_address, kDefaultPort);
+	address.resolve();
+	for (int i = 0; i < m_options.m_numBadClients; ++i) {
+		ArchSocket socket = ARCH->newSocket(
+							ARCH->getAddrFamily(address.getAddress()),
+							IArchNetwork::kSTREAM);
+		m_badClients.push_back(socket);
+		ARCH->connectSocket(socket, address.getAddress());
+
+		// a TLS client speaks first but otherwise the server says hello
+		// first and ignores anything sent before that
+		const char* junk = kTLSJunk;
+		size_t size      = sizeof(kTLSJunk) - 1;
+		if (!m_options.m_enableCrypto) {
+			IArchNetwork::PollEntry entry = { socket, IArchNetwork::kPOLLIN, 0 };
+			ARCH->pollSocket(&entry, 1, kConnectTimeout);
+			junk = kJunk;
+			size = sizeof(kJunk) - 1;
+		}
+
+		// the socket doesn't block so wait until it's connected
+		IArchNetwork::PollEntry entry = { socket, IArchNetwork::kPOLLOUT, 0 };
+		while (size > 0 && ARCH->pollSocket(&entry, 1, kConnectTimeout) > 0) {
+			size_t n = ARCH->writeSocket(socket, junk, size);
+			junk += n;
+			size -= n;
+		}
+	}
+}
+
+int
+LoadTest::closeBadClients()
+{
+	int dropped = 0;
+	for (size_t i = 0; i < m_badClients.size(); ++i) {
+		ArchSocket socket = m_badClients[i];
+
+		// the server may write (a TLS alert) before closing
+		bool closed = false;
+		try {
+			char buffer[256];
+			IArchNetwork::PollEntry entry = { socket, IArchNetwork::kPOLLIN, 0 };
+			while (!closed && ARCH->pollSocket(&entry, 1, 0.0) > 0) {
+				closed = (ARCH->readSocket(socket, buffer, sizeof(buffer)) == 0);
+			}
+		}
+		catch (XArchNetwork&) {
+			// reset by the server
+			closed = true;
+		}
+		if (closed) {
+			++dropped;
+		}
+		ARCH->closeSocket(socket);
+	}
+	m_badClients.clear();
+	return dropped;
+}
+
+void
+LoadTest::startLoad()
+{
+	LOG((CLOG_NOTE "starting load"));
+	m_loadTime.reset();
+	getCPUTime(m_userTime, m_systemTime);
+	if (m_options.m_role == kClients) {
+		// the server makes the load and disconnects when it's done
+		setStateTimer(kLoading,
+							m_options.m_duration + kDrainTime + kConnectTimeout);
+		return;
+	}
+
+	m_activeClient  = 0;
+	m_nextSwitch    = m_options.m_switchInterval;
+	m_nextClipboard = 0.0;
+	switchToScreen(getClientName(1));
+
+	m_tickTimer = m_events->newTimer(kTickInterval, NULL);
+	m_events->adoptHandler(Event::kTimer, m_tickTimer,
+							new TMethodEventJob<LoadTest>(this,
+								&LoadTest::handleTick));
+	setStateTimer(kLoading, m_options.m_duration);
+}
+
+void
+LoadTest::stopLoad()
+{
+	m_loadDuration = m_loadTime.getTime();
+	double user, system;
+	getCPUTime(user, system);
+	m_userTime   = user - m_userTime;
+	m_systemTime = system - m_systemTime;
+
+	if (m_tickTimer != NULL) {
+		m_events->removeHandler(Event::kTimer, m_tickTimer);
+		m_events->deleteTimer(m_tickTimer);
+		m_tickTimer = NULL;
+	}
+	if (m_server != NULL) {
+		switchToScreen(kServerName);
+	}
+}
+
+void
+LoadTest::sendLoad(double time)
+{
+	UInt64 motionsDue = static_cast<UInt64>(time * m_options.m_mouseRate);
+	while (m_numMotionsSent < motionsDue) {
+		int step = static_cast<int>(m_numMotionsSent % 4);
+		m_serverScreen->captureMouseMove(kMotionX[step], kMotionY[step]);
+		++m_numMotionsSent;
+	}
+
+	// a key is pressed and released, so two keystrokes
+	UInt64 keysDue = 2 * static_cast<UInt64>(time * m_options.m_keyRate);
+	while (m_numKeysSent < keysDue) {
+		KeyID id         = static_cast<KeyID>('a' + (m_numKeysSent / 2) % 26);
+		KeyButton button = static_cast<KeyButton>(id - 'a' + 10);
+		m_serverScreen->captureKey(id, 0, button, m_numKeysSent % 2 == 0);
+		++m_numKeysSent;
+	}
+
+	if (m_options.m_clipboardInterval > 0.0 && m_options.m_clipboardSize > 0) {
+		while (time >= m_nextClipboard) {
+			// the data must change or the server ignores it
+			String data(m_options.m_clipboardSize, 'x');
+			String count = synergy::string::sprintf("%llu ",
+							m_numClipboardsSent);
+			data.replace(0, count.size(), count);
+			data.resize(m_options.m_clipboardSize);
+
+			Clipboard clipboard;
+			clipboard.open(0);
+			clipboard.add(IClipboard::kText, data);
+			clipboard.close();
+			m_serverScreen->captureClipboard(kClipboardClipboard, &clipboard);
+			++m_numClipboardsSent;
+			m_numClipboardBytesSent += data.size();
+			m_nextClipboard += m_options.m_clipboardInterval;
+		}
+	}
+
+	if (m_options.m_switchInterval > 0.0 && m_options.m_numClients > 1) {
+		while (time >= m_nextSwitch) {
+			m_activeClient = (m_activeClient + 1) % m_options.m_numClients;
+			switchToScreen(getClientName(m_activeClient + 1));
+			m_nextSwitch += m_options.m_switchInterval;
+		}
+	}
+}
+
+void
+LoadTest::switchToScreen(const String& name)
+{
+	m_events->addEvent(Event(m_events->forServer().switchToScreen(),
+							m_config->getInputFilter(),
+							Server::SwitchToScreenInfo::alloc(name)));
+}
+
+void
+LoadTest::setStateTimer(EState state, double timeout)
+{
+	if (m_stateTimer != NULL) {
+		m_events->removeHandler(Event::kTimer, m_stateTimer);
+		m_events->deleteTimer(m_stateTimer);
+	}
+	m_state      = state;
+	m_stateTimer = m_events->newOneShotTimer(timeout, NULL);
+	m_events->adoptHandler(Event::kTimer, m_stateTimer,
+							new TMethodEventJob<LoadTest>(this,
+								&LoadTest::handleStateTimer));
+}
+
+void
+LoadTest::quit(bool failed)
+{
+	m_failed = m_failed || failed;
+	m_events->addEvent(Event(Event::kQuit));
+}
+
+String
+LoadTest::formatLatency() const
+{
+	// sum the latencies all clients reported
+	MetricHistogram stages[LatencyStats::kNumStages];
+	for (int i = 1; i <= m_options.m_numClients; ++i) {
+		String client = Metrics::label("client", getClientName(i));
+		for (int j = 0; j < LatencyStats::kNumStages; ++j) {
+			LatencyStats::EStage stage = static_cast<LatencyStats::EStage>(j);
+			const MetricHistogram* histogram =
+				Metrics::getInstance().getHistogram(
+							"synergy_input_latency_seconds",
+							"Input latency to a client by stage, measured by the client.",
+							client + "," +
+							Metrics::label("stage", LatencyStats::getStageName(stage)));
+			for (UInt32 bucket = 0; bucket < MetricHistogram::kNumBuckets; ++bucket) {
+				UInt32 count = histogram->getBucketCount(bucket);
+				if (count != 0) {
+					stages[j].addToBucket(bucket, count);
+				}
+			}
+		}
+	}
+
+	String result = "  \"latency_us\": {";
+	for (int j = 0; j < LatencyStats::kNumStages; ++j) {
+		LatencyStats::EStage stage = static_cast<LatencyStats::EStage>(j);
+		result += synergy::string::sprintf(
+							"%s\n    \"%s\": { \"count\": %llu, "
+							"\"p50\": %llu, \"p99\": %llu }",
+							(j == 0) ? "" : ",",
+							LatencyStats::getStageName(stage),
+							stages[j].getCount(),
+							stages[j].getPercentile(50.0),
+							stages[j].getPercentile(99.0));
+	}
+	result += "\n  },\n";
+	return result;
+}
+
+void
+LoadTest::handleClientConnected(const Event&, void*)
+{
+	ClientProxy* client = m_listener->getNextClient();
+	if (client == NULL) {
+		return;
+	}
+	m_server->adoptClient(client);
+	if (++m_numAdopted == m_options.m_numClients && m_state == kConnecting) {
+		LOG((CLOG_NOTE "all clients connected"));
+		setStateTimer(kWarmingUp, kWarmUpTime);
+	}
+}
+
+void
+LoadTest::handleServerDisconnected(const Event&, void*)
+{
+	if (m_state == kDisconnecting) {
+		quit(false);
+	}
+}
+
+void
+LoadTest::handleConnected(const Event&, void*)
+{
+	if (++m_numConnected == m_options.m_numClients &&
+		m_options.m_role == kClients) {
+		startLoad();
+	}
+}
+
+void
+LoadTest::handleConnectionFailed(const Event& event, void*)
+{
+	Client::FailInfo* info = static_cast<Client::FailInfo*>(event.getData());
+	LOG((CLOG_ERR "client cannot connect: %s", info->m_what.c_str()));
+	quit(true);
+}
+
+void
+LoadTest::handleDisconnected(const Event&, void*)
+{
+	if (++m_numDisconnected == m_options.m_numClients &&
+		m_options.m_role == kClients) {
+		stopLoad();
+		quit(m_state == kConnecting);
+	}
+}
+
+void
+LoadTest::handleTick(const Event&, void*)
+{
+	sendLoad(m_loadTime.getTime());
+}
+
+void
+LoadTest::handleStateTimer(const Event&, void*)
+{
+	switch (m_state) {
+	case kConnecting:
+		LOG((CLOG_ERR "only %d of %d clients connected", (m_options.m_role == kClients) ? m_numConnected : m_numAdopted, m_options.m_numClients));
+		quit(true);
+		break;
+
+	case kWarmingUp:
+		startLoad();
+		break;
+
+	case kLoading:
+		if (m_options.m_role == kClients) {
+			LOG((CLOG_ERR "server didn't disconnect"));
+			stopLoad();
+			quit(true);
+			break;
+		}
+		stopLoad();
+		setStateTimer(kDraining, kDrainTime);
+		break;
+
+	case kDraining:
+		m_server->disconnect();
+		setStateTimer(kDisconnecting, kDisconnectTimeout);
+		break;
+
+	case kDisconnecting:
+		quit(false);
+		break;
+	}
+}
+
+void
+LoadTest::getCPUTime(double& user, double& system)
+{
+#if SYSAPI_UNIX
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	user   = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1000000.0;
+	system = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1000000.0;
+#else
+	// not measured
+	user   = 0.0;
+	system = 0.0;
+#endif
+}
@@ -0,0 +1,182 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "net/SocketMultiplexer.h"
+#include "arch/IArchNetwork.h"
+#include "base/Stopwatch.h"
+#include "base/String.h"
+#include "common/basic_types.h"
+#include "common/stdvector.h"
+
+class Event;
+class EventQueueTimer;
+class IEventQueue;
+class Config;
+class NullScreen;
+class PrimaryClient;
+class ClientListener;
+class Server;
+class Client;
+namespace synergy { class Screen; }
+
+//! Loopback load test
+/*!
+Runs a server and clients on screens without a display, connected over
+TCP or TLS, and has the server's screen make input at set rates:  mouse
+motion, key presses, clipboard changes and switches between the
+clients.  The server and the clients may run in one process or in
+different processes, so several client processes can load one server.
+The results are the input sent and injected, the latency of each step
+as reported by the clients and the CPU time used.  Bad clients, which
+send junk instead of a handshake, check that the server drops the
+connections it can't accept.
+*/
+class LoadTest {
+public:
+	enum ERole {
+		kServerAndClients,	//!< Run the server and the clients
+		kServer,			//!< Run the server only
+		kClients			//!< Run the clients only
+	};
+
+	//! Load test options
+	class Options {
+	public:
+		Options();
+
+	public:
+		ERole			m_role;
+		String			m_address;
+		int				m_numClients;
+		int				m_firstClient;
+		double			m_duration;
+		double			m_mouseRate;
+		double			m_keyRate;
+		UInt32			m_clipboardSize;
+		double			m_clipboardInterval;
+		double			m_switchInterval;
+		bool			m_enableCrypto;
+		int				m_numBadClients;
+	};
+
+	LoadTest(IEventQueue* events, const Options& options);
+	~LoadTest();
+
+	//! @name manipulators
+	//@{
+
+	//! Run test
+	/*!
+	Runs until the input has been sent, the clients have reported the
+	latencies and the server has disconnected them.  Returns false if
+	the clients didn't all connect or the server didn't drop all the
+	bad clients.
+	*/
+	bool				run();
+
+	//@}
+	//! @name accessors
+	//@{
+
+	//! Format results
+	/*!
+	Returns the results of run() as a JSON object.
+	*/
+	String				format() const;
+
+	//! Get client name
+	static String		getClientName(int index);
+
+	//@}
+
+private:
+	enum EState {
+		kConnecting,
+		kWarmingUp,
+		kLoading,
+		kDraining,
+		kDisconnecting
+	};
+
+	void				openServer();
+	void				closeServer();
+	void				openClients();
+	void				closeClients();
+	void				openBadClients();
+	int					closeBadClients();
+
+	void				startLoad();
+	void				stopLoad();
+	void				sendLoad(double time);
+	void				switchToScreen(const String& name);
+	void				setStateTimer(EState state, double timeout);
+	void				quit(bool failed);
+
+	String				formatLatency() const;
+
+	void				handleClientConnected(const Event&, void*);
+	void				handleServerDisconnected(const Event&, void*);
+	void				handleConnected(const Event&, void*);
+	void				handleConnectionFailed(const Event&, void*);
+	void				handleDisconnected(const Event&, void*);
+	void				handleTick(const Event&, void*);
+	void				handleStateTimer(const Event&, void*);
+
+	static void			getCPUTime(double& user, double& system);
+
+private:
+	IEventQueue*		m_events;
+	Options				m_options;
+	SocketMultiplexer	m_multiplexer;
+	EState				m_state;
+	EventQueueTimer*	m_stateTimer;
+	EventQueueTimer*	m_tickTimer;
+	bool				m_failed;
+
+	// the server
+	Config*				m_config;
+	NullScreen*			m_serverScreen;
+	synergy::Screen*	m_screen;
+	PrimaryClient*		m_primaryClient;
+	ClientListener*		m_listener;
+	Server*				m_server;
+	int					m_numAdopted;
+
+	// the clients
+	std::vector<NullScreen*>		m_clientScreens;
+	std::vector<synergy::Screen*>	m_screens;
+	std::vector<Client*>			m_clients;
+	int					m_numConnected;
+	int					m_numDisconnected;
+	std::vector<ArchSocket>			m_badClients;
+	int					m_numBadClientsDropped;
+
+	// the load
+	Stopwatch			m_loadTime;
+	double				m_loadDuration;
+	double				m_nextSwitch;
+	double				m_nextClipboard;
+	int					m_activeClient;
+	UInt64				m_numMotionsSent;
+	UInt64				m_numKeysSent;
+	UInt64				m_numClipboardsSent;
+	UInt64				m_numClipboardBytesSent;
+	double				m_userTime;
+	double				m_systemTime;
+};
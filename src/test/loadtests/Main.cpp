@@ -0,0 +1,159 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/loadtests/LoadTest.h"
+#include "base/EventQueue.h"
+#include "base/Log.h"
+#include "arch/Arch.h"
+
+#if SYSAPI_WIN32
+#include "arch/win32/ArchMiscWindows.h"
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char* kUsage =
+"usage: loadtests [options]\n"
+"\n"
+"Runs a server and clients without a display, connected over loopback,\n"
+"makes input on the server's screen and prints the results as JSON.\n"
+"\n"
+"  --role both|server|clients  run the server, the clients or both (both)\n"
+"  --address host[:port]       server address (127.0.0.1:24810)\n"
+"  --clients n                 number of clients (4)\n"
+"  --first-client n            number of the first client, so clients can\n"
+"                              be run in several processes (1)\n"
+"  --duration s                seconds of load (10)\n"
+"  --mouse-rate n              mouse motions per second (1000)\n"
+"  --key-rate n                key presses per second (20)\n"
+"  --clipboard-size n          bytes per clipboard change (65536)\n"
+"  --clipboard-interval s      seconds between clipboard changes, 0 for\n"
+"                              none (1)\n"
+"  --switch-interval s         seconds between switching clients (1)\n"
+"  --enable-crypto             use TLS with the certificate the server uses\n"
+"  --bad-clients n             connections that send junk instead of a\n"
+"                              handshake, which the server must drop (0)\n"
+"  --debug level               log level (WARNING)\n";
+
+static bool
+parseArgs(int argc, char** argv, LoadTest::Options& options,
+				const char*& logFilter)
+{
+	for (int i = 1; i < argc; ++i) {
+		const char* arg = argv[i];
+		if (strcmp(arg, "--enable-crypto") == 0) {
+			options.m_enableCrypto = true;
+			continue;
+		}
+		if (i + 1 == argc) {
+			return false;
+		}
+
+		const char* value = argv[++i];
+		if (strcmp(arg, "--role") == 0) {
+			if (strcmp(value, "both") == 0) {
+				options.m_role = LoadTest::kServerAndClients;
+			}
+			else if (strcmp(value, "server") == 0) {
+				options.m_role = LoadTest::kServer;
+			}
+			else if (strcmp(value, "clients") == 0) {
+				options.m_role = LoadTest::kClients;
+			}
+			else {
+				return false;
+			}
+		}
+		else if (strcmp(arg, "--address") == 0) {
+			options.m_address = value;
+		}
+		else if (strcmp(arg, "--clients") == 0) {
+			options.m_numClients = atoi(value);
+		}
+		else if (strcmp(arg, "--first-client") == 0) {
+			options.m_firstClient = atoi(value);
+		}
+		else if (strcmp(arg, "--duration") == 0) {
+			options.m_duration = atof(value);
+		}
+		else if (strcmp(arg, "--mouse-rate") == 0) {
+			options.m_mouseRate = atof(value);
+		}
+		else if (strcmp(arg, "--key-rate") == 0) {
+			options.m_keyRate = atof(value);
+		}
+		else if (strcmp(arg, "--clipboard-size") == 0) {
+			options.m_clipboardSize = static_cast<UInt32>(atoi(value));
+		}
+		else if (strcmp(arg, "--clipboard-interval") == 0) {
+			options.m_clipboardInterval = atof(value);
+		}
+		else if (strcmp(arg, "--switch-interval") == 0) {
+			options.m_switchInterval = atof(value);
+		}
+		else if (strcmp(arg, "--bad-clients") == 0) {
+			options.m_numBadClients = atoi(value);
+		}
+		else if (strcmp(arg, "--debug") == 0) {
+			logFilter = value;
+		}
+		else {
+			return false;
+		}
+	}
+	return (options.m_numClients > 0 && options.m_firstClient > 0 &&
+			options.m_duration > 0.0 && options.m_numBadClients >= 0);
+}
+
+int
+main(int argc, char** argv)
+{
+#if SYSAPI_WIN32
+	// HACK: shouldn't be needed, but logging fails without this.
+	ArchMiscWindows::setInstanceWin32(GetModuleHandle(NULL));
+#endif
+
+	Arch arch;
+	arch.init();
+
+	LoadTest::Options options;
+	const char* logFilter = "WARNING";
+	if (!parseArgs(argc, argv, options, logFilter)) {
+		fputs(kUsage, stderr);
+		return 2;
+	}
+
+	// notes and info go to stdout, which would spoil the results
+	Log log;
+	if (!log.setFilter(logFilter)) {
+		fputs(kUsage, stderr);
+		return 2;
+	}
+
+	EventQueue events;
+	bool passed;
+	String results;
+	{
+		LoadTest test(&events, options);
+		passed  = test.run();
+		results = test.format();
+	}
+	fputs(results.c_str(), stdout);
+	return passed ? 0 : 1;
+}
@@ -44,6 +44,7 @@ public:
 	MOCK_CONST_METHOD0(pollActiveModifiers, KeyModifierMask());
 	MOCK_METHOD0(fakeCtrlAltDel, bool());
 	MOCK_METHOD1(getKeyMap, void(synergy::KeyMap&));
+	MOCK_METHOD0(getKeyMapSignature, UInt64());
 	MOCK_METHOD1(fakeKey, void(const Keystroke&));
 	MOCK_METHOD1(fakeMediaKey, bool(KeyID));
 	MOCK_CONST_METHOD1(pollPressedKeys, void(KeyButtonSet&));
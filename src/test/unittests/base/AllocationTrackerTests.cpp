@@ -0,0 +1,72 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/AllocationTracker.h"
+
+#include <gtest/gtest.h>
+
+#if SYNERGY_TRACK_ALLOCATIONS
+
+// keeps the compiler from leaving allocations out
+static int* volatile	s_allocated;
+
+TEST(AllocationTrackerTests, getThreadAllocations_newAndDelete_countsOne)
+{
+	UInt64 before     = AllocationTracker::getThreadAllocations();
+	UInt64 liveBefore = AllocationTracker::getNumLive();
+	s_allocated = new int(1);
+	delete s_allocated;
+	UInt64 after      = AllocationTracker::getThreadAllocations();
+	UInt64 liveAfter  = AllocationTracker::getNumLive();
+
+	EXPECT_EQ(1u, after - before);
+	EXPECT_LE(liveAfter, liveBefore);
+}
+
+TEST(AllocationTrackerTests, getCallSites_newArray_callSiteCounted)
+{
+	AllocationTracker::CallSiteList before;
+	AllocationTracker::getCallSites(before);
+	s_allocated = new int[4];
+	delete[] s_allocated;
+	AllocationTracker::CallSiteList after;
+	AllocationTracker::getCallSites(after);
+
+	UInt64 countBefore = 0, countAfter = 0;
+	for (size_t i = 0; i < before.size(); ++i) {
+		countBefore += before[i].m_count;
+	}
+	for (size_t i = 0; i < after.size(); ++i) {
+		countAfter += after[i].m_count;
+	}
+	EXPECT_LT(countBefore, countAfter);
+	EXPECT_EQ(0u, AllocationTracker::format().find("allocations: "));
+}
+
+#else
+
+TEST(AllocationTrackerTests, getNumAllocations_notBuiltIn_returnsZero)
+{
+	int* allocated = new int(1);
+	delete allocated;
+
+	EXPECT_FALSE(AllocationTracker::isEnabled());
+	EXPECT_EQ(0u, AllocationTracker::getNumAllocations());
+	EXPECT_EQ(0u, AllocationTracker::getThreadAllocations());
+}
+
+#endif
@@ -0,0 +1,134 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/log_outputters.h"
+
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+static const char* kLogFile = "FileLogOutputterTests.log";
+static const char* kOldLogFile = "FileLogOutputterTests.log.1";
+
+static String
+readFile(const char* filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	std::stringstream content;
+	content << file.rdbuf();
+	return content.str();
+}
+
+class FileLogOutputterTests : public ::testing::Test {
+protected:
+	virtual void SetUp()
+	{
+		remove(kLogFile);
+		remove(kOldLogFile);
+	}
+
+	virtual void TearDown()
+	{
+		remove(kLogFile);
+		remove(kOldLogFile);
+	}
+};
+
+TEST_F(FileLogOutputterTests, write_threadingEnabled_linesWrittenAfterFlush)
+{
+	FileLogOutputter outputter(kLogFile);
+
+	outputter.write(kNOTE, "mock 1");
+	outputter.write(kNOTE, "mock 2");
+	outputter.flush();
+
+	EXPECT_EQ("mock 1\nmock 2\n", readFile(kLogFile));
+}
+
+TEST_F(FileLogOutputterTests, write_threadingEnabled_linesWrittenOnDestruction)
+{
+	{
+		FileLogOutputter outputter(kLogFile);
+		for (int i = 0; i < 100; ++i) {
+			outputter.write(kNOTE, "mock");
+		}
+	}
+
+	EXPECT_EQ(500, readFile(kLogFile).size());
+}
+
+TEST_F(FileLogOutputterTests, write_dropPolicyQueueFull_lineDroppedAndReported)
+{
+	FileLogOutputter outputter(kLogFile, false);
+	outputter.setOverloadPolicy(FileLogOutputter::kDrop);
+	outputter.setMaxQueuedLines(2);
+
+	outputter.write(kNOTE, "mock 1");
+	outputter.write(kNOTE, "mock 2");
+	outputter.write(kNOTE, "mock 3");
+	outputter.flush();
+
+	EXPECT_EQ(1, outputter.getDroppedLines());
+	EXPECT_EQ("mock 1\nmock 2\n1 log lines dropped\n", readFile(kLogFile));
+}
+
+TEST_F(FileLogOutputterTests, write_blockPolicyQueueFull_queueWrittenFirst)
+{
+	FileLogOutputter outputter(kLogFile, false);
+	outputter.setMaxQueuedLines(2);
+
+	outputter.write(kNOTE, "mock 1");
+	outputter.write(kNOTE, "mock 2");
+	outputter.write(kNOTE, "mock 3");
+
+	EXPECT_EQ("mock 1\nmock 2\n", readFile(kLogFile));
+	outputter.flush();
+
+	EXPECT_EQ(0, outputter.getDroppedLines());
+	EXPECT_EQ("mock 1\nmock 2\nmock 3\n", readFile(kLogFile));
+}
+
+TEST_F(FileLogOutputterTests, write_samplePolicyQueueHalfFull_someLinesKept)
+{
+	FileLogOutputter outputter(kLogFile, false);
+	outputter.setOverloadPolicy(FileLogOutputter::kSample);
+	outputter.setMaxQueuedLines(100);
+
+	for (int i = 0; i < 100; ++i) {
+		outputter.write(kNOTE, "mock");
+	}
+
+	// the first half is kept, then one in ten of the rest
+	EXPECT_EQ(45, outputter.getDroppedLines());
+}
+
+TEST_F(FileLogOutputterTests, write_overSizeLimit_fileMoved)
+{
+	String line(1023, 'x');
+	{
+		FileLogOutputter outputter(kLogFile, false);
+		for (int i = 0; i < 1025; ++i) {
+			outputter.write(kNOTE, line.c_str());
+		}
+		outputter.flush();
+		outputter.write(kNOTE, "mock");
+	}
+
+	EXPECT_EQ(1025 * 1024, readFile(kOldLogFile).size());
+	EXPECT_EQ("mock\n", readFile(kLogFile));
+}
@@ -0,0 +1,113 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Log.h"
+#include "base/ILogOutputter.h"
+#include "base/String.h"
+
+#include <gtest/gtest.h>
+
+static int s_evaluated = 0;
+
+static int
+evaluate()
+{
+	return ++s_evaluated;
+}
+
+class CaptureLogOutputter : public ILogOutputter {
+public:
+	virtual void open(const char*) { }
+	virtual void close() { }
+	virtual void show(bool) { }
+	virtual bool write(ELevel level, const char* message)
+	{
+		m_level = level;
+		m_message = message;
+
+		// don't pass it on to the console
+		return false;
+	}
+
+	ELevel m_level;
+	String m_message;
+};
+
+TEST(LogTests, print_priority_prefixedWithTimeAndPriority)
+{
+	CaptureLogOutputter outputter;
+	CLOG->insert(&outputter);
+
+	LOG((CLOG_NOTE "mock %d", 1));
+
+	CLOG->remove(&outputter);
+	EXPECT_EQ(kNOTE, outputter.m_level);
+	EXPECT_EQ('[', outputter.m_message[0]);
+	EXPECT_EQ(20, outputter.m_message.find("] NOTE: mock 1"));
+}
+
+TEST(LogTests, print_longMessage_wholeMessageOutput)
+{
+	CaptureLogOutputter outputter;
+	CLOG->insert(&outputter);
+	String message(5000, 'x');
+
+	LOG((CLOG_PRINT "%s", message.c_str()));
+
+	CLOG->remove(&outputter);
+	EXPECT_EQ(kPRINT, outputter.m_level);
+	EXPECT_EQ(message, outputter.m_message);
+}
+
+TEST(LogTests, log_priorityFiltered_argumentsNotEvaluated)
+{
+	int filter = CLOG->getFilter();
+	CLOG->setFilter(kINFO);
+	s_evaluated = 0;
+
+	LOG((CLOG_DEBUG2 "mock %d", evaluate()));
+
+	CLOG->setFilter(filter);
+	EXPECT_EQ(0, s_evaluated);
+}
+
+TEST(LogTests, log_priorityNotFiltered_argumentsEvaluated)
+{
+	int filter = CLOG->getFilter();
+	CLOG->setFilter(kDEBUG2);
+	s_evaluated = 0;
+
+	LOG((CLOG_DEBUG2 "mock %d", evaluate()));
+
+	CLOG->setFilter(filter);
+	EXPECT_EQ(1, s_evaluated);
+}
+
+TEST(LogTests, isEnabled_priorities_comparedWithFilter)
+{
+	int filter = CLOG->getFilter();
+	CLOG->setFilter(kINFO);
+
+	bool print = Log::isEnabled(kPRINT);
+	bool info = Log::isEnabled(kINFO);
+	bool debug = Log::isEnabled(kDEBUG);
+
+	CLOG->setFilter(filter);
+	EXPECT_TRUE(print);
+	EXPECT_TRUE(info);
+	EXPECT_FALSE(debug);
+}
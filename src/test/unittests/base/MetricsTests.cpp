@@ -0,0 +1,97 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Metrics.h"
+
+#include <gtest/gtest.h>
+
+TEST(MetricsTests, getCounter_sameNameAndLabels_sameCounter)
+{
+	Metrics metrics;
+	MetricCounter* a = metrics.getCounter("test_total", "help",
+							Metrics::label("peer", "a"));
+	MetricCounter* b = metrics.getCounter("test_total", "help",
+							Metrics::label("peer", "b"));
+
+	EXPECT_EQ(a, metrics.getCounter("test_total", "help",
+							Metrics::label("peer", "a")));
+	EXPECT_NE(a, b);
+}
+
+TEST(MetricsTests, format_counterAndGauge_prometheusText)
+{
+	Metrics metrics;
+	metrics.getCounter("test_total", "Things done.",
+							Metrics::label("peer", "a"))->add(3);
+	metrics.getGauge("test_depth", "Things waiting.")->set(-2);
+
+	EXPECT_EQ(
+		"# HELP test_depth Things waiting.\n"
+		"# TYPE test_depth gauge\n"
+		"test_depth -2\n"
+		"# HELP test_total Things done.\n"
+		"# TYPE test_total counter\n"
+		"test_total{peer=\"a\"} 3\n",
+		metrics.format());
+}
+
+TEST(MetricsTests, format_histogram_cumulativeBucketsInSeconds)
+{
+	Metrics metrics;
+	MetricHistogram* histogram = metrics.getHistogram("test_seconds", "help");
+	histogram->add(10);
+	histogram->add(20);
+	histogram->add(3000000);
+
+	String text = metrics.format();
+	EXPECT_NE(String::npos, text.find("# TYPE test_seconds histogram\n"));
+	EXPECT_NE(String::npos, text.find("test_seconds_bucket{le=\"1.6e-05\"} 1\n"));
+	EXPECT_NE(String::npos, text.find("test_seconds_bucket{le=\"3.2e-05\"} 2\n"));
+	EXPECT_NE(String::npos, text.find("test_seconds_bucket{le=\"2.097152\"} 2\n"));
+	EXPECT_NE(String::npos, text.find("test_seconds_bucket{le=\"4.194304\"} 3\n"));
+	EXPECT_NE(String::npos, text.find("test_seconds_bucket{le=\"+Inf\"} 3\n"));
+	EXPECT_NE(String::npos, text.find("test_seconds_sum 3.00003\n"));
+	EXPECT_NE(String::npos, text.find("test_seconds_count 3\n"));
+}
+
+TEST(MetricsTests, label_specialCharacters_escaped)
+{
+	EXPECT_EQ("client=\"a\\\"b\\\\c\\nd\"",
+				Metrics::label("client", "a\"b\\c\nd"));
+}
+
+TEST(MetricsTests, add_counter_sumsStripes)
+{
+	MetricCounter counter;
+	counter.add();
+	counter.add(41);
+
+	EXPECT_EQ(42, counter.getValue());
+}
+
+TEST(MetricsTests, addToBucket_histogram_countsAtBucketLimit)
+{
+	MetricHistogram histogram;
+	UInt32 bucket = MetricHistogram::getBucket(1000);
+
+	EXPECT_TRUE(histogram.addToBucket(bucket, 4));
+	EXPECT_FALSE(histogram.addToBucket(MetricHistogram::kNumBuckets, 1));
+	EXPECT_EQ(4, histogram.getCount());
+	EXPECT_EQ(4 * MetricHistogram::getBucketLimit(bucket), histogram.getSum());
+	EXPECT_EQ(MetricHistogram::getBucketLimit(bucket),
+				histogram.getPercentile(50.0));
+}
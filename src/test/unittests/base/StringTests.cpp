@@ -175,3 +175,21 @@ TEST(StringTests, splitString_headAndTailSeparators_returnTwoParts)
 	EXPECT_EQ("stub1", results[0]);
 	EXPECT_EQ("stub2", results[1]);
 }
+
+TEST(StringTests, linefeedToCRLF_linefeeds_carriageReturnsInserted)
+{
+	String string = "\nstub1\n\nstub2\r\n";
+
+	String result = string::linefeedToCRLF(string);
+
+	EXPECT_EQ("\r\nstub1\r\n\r\nstub2\r\r\n", result);
+}
+
+TEST(StringTests, crlfToLinefeed_crlfPairs_carriageReturnsRemoved)
+{
+	String string = "stub1\r\n\r\nstub2\rstub3\n\r";
+
+	String result = string::crlfToLinefeed(string);
+
+	EXPECT_EQ("stub1\n\nstub2\rstub3\n\r", result);
+}
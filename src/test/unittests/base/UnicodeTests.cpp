@@ -0,0 +1,82 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "base/Unicode.h"
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+static String
+toUTF16(const UInt16* data, size_t n)
+{
+	String utf16(2 * n, '\0');
+	memcpy(&utf16[0], data, 2 * n);
+	return utf16;
+}
+
+TEST(UnicodeTests, UTF8ToUTF16_fourByteCharacter_surrogatePair)
+{
+	const UInt16 expected[] = { 0xd83d, 0xde00 };
+	bool errors;
+
+	String result = Unicode::UTF8ToUTF16("\xf0\x9f\x98\x80", &errors);
+
+	EXPECT_EQ(toUTF16(expected, 2), result);
+	EXPECT_FALSE(errors);
+}
+
+TEST(UnicodeTests, UTF16ToUTF8_surrogatePair_fourByteCharacter)
+{
+	const UInt16 data[] = { 0xd83d, 0xde00 };
+	bool errors;
+
+	String result = Unicode::UTF16ToUTF8(toUTF16(data, 2), &errors);
+
+	EXPECT_EQ("\xf0\x9f\x98\x80", result);
+	EXPECT_FALSE(errors);
+}
+
+TEST(UnicodeTests, UTF8ToUTF16_mixedText_roundTrips)
+{
+	String text = String(40, 'a') + "\xc3\xa9" + String(20, 'b') +
+					"\xe4\xb8\xad" + String(3, 'c');
+
+	String utf16 = Unicode::UTF8ToUTF16(text);
+
+	EXPECT_EQ(2U * 65, utf16.size());
+	EXPECT_EQ(text, Unicode::UTF16ToUTF8(utf16));
+}
+
+TEST(UnicodeTests, UTF8ToUCS4_mixedText_roundTrips)
+{
+	String text = String(33, 'a') + "\xf0\x9f\x98\x80" + String(17, 'b');
+
+	String ucs4 = Unicode::UTF8ToUCS4(text);
+
+	EXPECT_EQ(4U * 51, ucs4.size());
+	EXPECT_EQ(text, Unicode::UCS4ToUTF8(ucs4));
+}
+
+TEST(UnicodeTests, isUTF8_invalidAfterASCII_false)
+{
+	String valid = String(32, 'a') + "\xc3\xa9";
+	String invalid = String(32, 'a') + "\xc3(";
+
+	EXPECT_TRUE(Unicode::isUTF8(valid));
+	EXPECT_FALSE(Unicode::isUTF8(invalid));
+}
@@ -0,0 +1,69 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ipc/IpcMessage.h"
+
+#include <gtest/gtest.h>
+
+TEST(IpcMessageTests, marshall_records_sameRecordsUnmarshalled)
+{
+	IpcLogBatchMessage::RecordList records(2);
+	records[0].m_level = kDEBUG2;
+	records[0].m_time = 1500000000;
+	records[0].m_threadId = 7;
+	records[0].m_file = "mock.cpp";
+	records[0].m_line = 42;
+	records[0].m_message = "mock 1";
+	records[1].m_level = kPRINT;
+	records[1].m_message = String("mock\0 2", 7);
+	IpcLogBatchMessage sent(3, 1, records);
+
+	String data;
+	sent.marshall(data);
+	IpcLogBatchMessage received;
+	bool result = received.unmarshall(3, 1, data);
+
+	EXPECT_TRUE(result);
+	EXPECT_EQ(3, received.sequence());
+	EXPECT_EQ(1, received.dropped());
+	ASSERT_EQ(2, received.records().size());
+	const IpcLogRecord& first = received.records()[0];
+	EXPECT_EQ(kDEBUG2, first.m_level);
+	EXPECT_EQ(1500000000, first.m_time);
+	EXPECT_EQ(7, first.m_threadId);
+	EXPECT_EQ("mock.cpp", first.m_file);
+	EXPECT_EQ(42, first.m_line);
+	EXPECT_EQ("mock 1", first.m_message);
+	EXPECT_EQ(kPRINT, received.records()[1].m_level);
+	EXPECT_EQ(String("mock\0 2", 7), received.records()[1].m_message);
+}
+
+TEST(IpcMessageTests, unmarshall_truncatedRecord_error)
+{
+	IpcLogBatchMessage::RecordList records(1);
+	records[0].m_message = "mock";
+	IpcLogBatchMessage sent(0, 0, records);
+
+	String data;
+	sent.marshall(data);
+	data.resize(data.size() - 1);
+	IpcLogBatchMessage received;
+	bool result = received.unmarshall(0, 0, data);
+
+	EXPECT_FALSE(result);
+	EXPECT_TRUE(received.records().empty());
+}
@@ -0,0 +1,90 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/BroadcastMessages.h"
+#include "synergy/ProtocolUtil.h"
+#include "synergy/protocol_types.h"
+#include "io/SharedBuffer.h"
+#include "test/global/MemoryStream.h"
+#include "test/mock/io/MockStream.h"
+
+#include "common/stdvector.h"
+
+#include <gtest/gtest.h>
+
+using ::testing::_;
+using ::testing::SaveArg;
+
+static std::vector<UInt8>
+readAll(MemoryStream& stream)
+{
+	std::vector<UInt8> data(stream.getSize());
+	if (!data.empty()) {
+		stream.read(&data[0], (UInt32)data.size());
+	}
+	return data;
+}
+
+TEST(BroadcastMessagesTests, write_sameFormatTwice_sharesBuffer)
+{
+	MockStream stream1;
+	MockStream stream2;
+	SharedBuffer* buffer1 = NULL;
+	SharedBuffer* buffer2 = NULL;
+	EXPECT_CALL(stream1, writeShared(_)).WillOnce(SaveArg<0>(&buffer1));
+	EXPECT_CALL(stream2, writeShared(_)).WillOnce(SaveArg<0>(&buffer2));
+	BroadcastMessages messages;
+
+	messages.write(&stream1, kMsgDKeyDown, 'a', 0, 38);
+	messages.write(&stream2, kMsgDKeyDown, 'a', 0, 38);
+
+	ASSERT_TRUE(buffer1 != NULL);
+	EXPECT_EQ(buffer1, buffer2);
+}
+
+TEST(BroadcastMessagesTests, write_differentFormats_separateBuffers)
+{
+	MockStream stream1;
+	MockStream stream2;
+	SharedBuffer* buffer1 = NULL;
+	SharedBuffer* buffer2 = NULL;
+	EXPECT_CALL(stream1, writeShared(_)).WillOnce(SaveArg<0>(&buffer1));
+	EXPECT_CALL(stream2, writeShared(_)).WillOnce(SaveArg<0>(&buffer2));
+	BroadcastMessages messages;
+
+	messages.write(&stream1, kMsgDKeyDown, 'a', 0, 38);
+	messages.write(&stream2, kMsgDKeyDown1_0, 'a', 0);
+
+	EXPECT_NE(buffer1, buffer2);
+	EXPECT_EQ(10u, buffer1->getSize());
+	EXPECT_EQ(8u, buffer2->getSize());
+}
+
+TEST(BroadcastMessagesTests, write_afterClear_formatsAgain)
+{
+	MemoryStream stream;
+	BroadcastMessages messages;
+
+	messages.write(&stream, kMsgDKeyDown, 'a', 0, 38);
+	messages.clear();
+	messages.write(&stream, kMsgDKeyDown, 'b', 0, 56);
+
+	MemoryStream expected;
+	ProtocolUtil::writef(&expected, kMsgDKeyDown, 'a', 0, 38);
+	ProtocolUtil::writef(&expected, kMsgDKeyDown, 'b', 0, 56);
+	EXPECT_EQ(readAll(expected), readAll(stream));
+}
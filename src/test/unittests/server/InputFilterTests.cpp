@@ -0,0 +1,177 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/InputFilter.h"
+#include "server/Server.h"
+#include "base/TMethodEventJob.h"
+#include "test/global/NullScreen.h"
+#include "test/global/NullServer.h"
+#include "test/global/TestEventQueue.h"
+
+#include <gtest/gtest.h>
+
+//! Input filter on a primary screen without a display
+/*!
+Records the screens the filter's rules switch to and the key and
+button presses that no rule took.
+*/
+class FilterHarness {
+public:
+	FilterHarness();
+	~FilterHarness();
+
+	void				addButtonRule(ButtonID, KeyModifierMask,
+							const String& screen);
+	void				addKeyRule(KeyID, KeyModifierMask,
+							const String& screen);
+
+	void				handleSwitch(const Event&, void*);
+	void				handlePassed(const Event&, void*);
+
+public:
+	TestEventQueue		m_events;
+	NullServer			m_server;
+	InputFilter			m_filter;
+	std::vector<String>	m_switches;
+	int					m_passed;
+};
+
+FilterHarness::FilterHarness() :
+	m_server(&m_events),
+	m_filter(&m_events),
+	m_passed(0)
+{
+	// just the primary screen.  a server would handle the filter's
+	// events itself.
+	m_server.openScreen("server");
+	m_filter.setPrimaryClient(m_server.getPrimaryClient());
+	m_events.adoptHandler(m_events.forServer().switchToScreen(), &m_filter,
+							new TMethodEventJob<FilterHarness>(this,
+								&FilterHarness::handleSwitch));
+	m_events.adoptHandler(m_events.forIKeyState().keyDown(), &m_filter,
+							new TMethodEventJob<FilterHarness>(this,
+								&FilterHarness::handlePassed));
+	m_events.adoptHandler(m_events.forIPrimaryScreen().buttonDown(), &m_filter,
+							new TMethodEventJob<FilterHarness>(this,
+								&FilterHarness::handlePassed));
+}
+
+FilterHarness::~FilterHarness()
+{
+	m_events.removeHandlers(&m_filter);
+	m_filter.setPrimaryClient(NULL);
+}
+
+void
+FilterHarness::addButtonRule(ButtonID button, KeyModifierMask mask,
+				const String& screen)
+{
+	InputFilter::Rule rule(new InputFilter::MouseButtonCondition(
+							&m_events, button, mask));
+	rule.adoptAction(new InputFilter::SwitchToScreenAction(
+							&m_events, screen), true);
+	m_filter.addFilterRule(rule);
+}
+
+void
+FilterHarness::addKeyRule(KeyID key, KeyModifierMask mask,
+				const String& screen)
+{
+	InputFilter::Rule rule(new InputFilter::KeystrokeCondition(
+							&m_events, key, mask));
+	rule.adoptAction(new InputFilter::SwitchToScreenAction(
+							&m_events, screen), true);
+	m_filter.addFilterRule(rule);
+}
+
+void
+FilterHarness::handleSwitch(const Event& event, void*)
+{
+	Server::SwitchToScreenInfo* info =
+		static_cast<Server::SwitchToScreenInfo*>(event.getData());
+	m_switches.push_back(info->m_screen);
+}
+
+void
+FilterHarness::handlePassed(const Event&, void*)
+{
+	++m_passed;
+}
+
+TEST(InputFilterTests, handleEvent_buttonWithTwoRules_firstRuleWins)
+{
+	FilterHarness harness;
+	NullScreen* screen = harness.m_server.getPlatformScreen();
+	harness.addButtonRule(kButtonLeft, 0, "first");
+	harness.addButtonRule(kButtonLeft, 0, "second");
+
+	screen->captureButton(kButtonLeft, KeyModifierCapsLock, true);
+	harness.m_server.dispatchEvents();
+
+	ASSERT_EQ(1u, harness.m_switches.size());
+	EXPECT_EQ("first", harness.m_switches[0]);
+	EXPECT_EQ(0, harness.m_passed);
+}
+
+TEST(InputFilterTests, handleEvent_buttonWithOtherModifiers_passesThrough)
+{
+	FilterHarness harness;
+	NullScreen* screen = harness.m_server.getPlatformScreen();
+	harness.addButtonRule(kButtonLeft, 0, "first");
+
+	screen->captureButton(kButtonLeft, KeyModifierShift, true);
+	harness.m_server.dispatchEvents();
+
+	EXPECT_TRUE(harness.m_switches.empty());
+	EXPECT_EQ(1, harness.m_passed);
+}
+
+TEST(InputFilterTests, handleEvent_hotKeyAmongManyRules_runsItsRule)
+{
+	FilterHarness harness;
+	NullScreen* screen = harness.m_server.getPlatformScreen();
+	for (int i = 0; i < 200; ++i) {
+		harness.addKeyRule(0x100 + i, KeyModifierControl,
+							synergy::string::sprintf("screen%d", i));
+	}
+
+	screen->captureKey(0x100 + 150, KeyModifierControl, 1, true);
+	screen->captureKey(0x100 + 150, 0, 1, true);
+	harness.m_server.dispatchEvents();
+
+	ASSERT_EQ(1u, harness.m_switches.size());
+	EXPECT_EQ("screen150", harness.m_switches[0]);
+	EXPECT_EQ(1, harness.m_passed);
+}
+
+TEST(InputFilterTests, handleEvent_afterRuleRemoved_nextRuleWins)
+{
+	FilterHarness harness;
+	NullScreen* screen = harness.m_server.getPlatformScreen();
+	harness.addButtonRule(kButtonLeft, 0, "first");
+	harness.addButtonRule(kButtonLeft, 0, "second");
+	screen->captureButton(kButtonLeft, 0, true);
+	harness.m_server.dispatchEvents();
+
+	harness.m_filter.removeFilterRule(0);
+	screen->captureButton(kButtonLeft, 0, true);
+	harness.m_server.dispatchEvents();
+
+	ASSERT_EQ(2u, harness.m_switches.size());
+	EXPECT_EQ("first", harness.m_switches[0]);
+	EXPECT_EQ("second", harness.m_switches[1]);
+}
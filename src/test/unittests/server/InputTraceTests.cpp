@@ -0,0 +1,349 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/InputTrace.h"
+#include "server/Config.h"
+#include "server/Server.h"
+#include "synergy/IKeyState.h"
+#include "synergy/IPrimaryScreen.h"
+#include "base/Log.h"
+#include "test/global/InputTraceReplay.h"
+#include "test/global/NullClientProxy.h"
+#include "test/global/TestEventQueue.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+static InputTraceRecord
+makeRecord(InputTraceRecord::EType type)
+{
+	InputTraceRecord record;
+	record.m_type = type;
+	return record;
+}
+
+static String
+makeConfig()
+{
+	Config config;
+	config.addScreen("server");
+	config.addScreen("client");
+	config.connect("server", kRight, 0.0f, 1.0f, "client", 0.0f, 1.0f);
+	config.connect("client", kLeft, 0.0f, 1.0f, "server", 0.0f, 1.0f);
+	std::ostringstream configText;
+	configText << config;
+	return configText.str();
+}
+
+static void
+replaceEnd(const String& path, size_t size, const String& end)
+{
+	String data;
+	{
+		std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+		std::ostringstream text;
+		text << file.rdbuf();
+		data = text.str();
+	}
+	data.resize(data.size() - size);
+	data += end;
+	std::ofstream file(path.c_str(), std::ios::out | std::ios::binary);
+	file << data;
+}
+
+TEST(InputTraceTests, read_writtenRecords_sameRecords)
+{
+	String path("InputTraceTests.tmp");
+	Config config;
+	config.addScreen("server");
+	InputTraceRecord motion = makeRecord(InputTraceRecord::kMotionOnSecondary);
+	motion.m_x = -3;
+	motion.m_y = 70000;
+	InputTraceRecord key = makeRecord(InputTraceRecord::kKeyDown);
+	key.m_id     = 0xefe1;
+	key.m_mask   = 0x0002;
+	key.m_button = 50;
+	key.m_count  = 1;
+	key.m_name   = ":client:";
+	InputTraceRecord clipboard = makeRecord(InputTraceRecord::kClipboardChanged);
+	clipboard.m_id    = 1;
+	clipboard.m_count = 7;
+	clipboard.m_size  = 65536;
+	InputTraceWriter writer;
+	ASSERT_TRUE(writer.open(path, config, "server"));
+	writer.write(motion);
+	writer.write(key);
+	writer.write(clipboard);
+	writer.close();
+
+	InputTraceReader reader;
+	ASSERT_TRUE(reader.open(path));
+	InputTraceRecord actual[4];
+	bool read[4];
+	for (int i = 0; i < 4; ++i) {
+		read[i] = reader.read(actual[i]);
+	}
+	reader.close();
+	std::remove(path.c_str());
+
+	EXPECT_EQ("server", reader.getScreen());
+	EXPECT_NE(String::npos, reader.getConfig().find("server:"));
+	EXPECT_TRUE(read[0]);
+	EXPECT_EQ(InputTraceRecord::kMotionOnSecondary, actual[0].m_type);
+	EXPECT_EQ(-3, actual[0].m_x);
+	EXPECT_EQ(70000, actual[0].m_y);
+	EXPECT_TRUE(read[1]);
+	EXPECT_EQ(InputTraceRecord::kKeyDown, actual[1].m_type);
+	EXPECT_EQ(0xefe1u, actual[1].m_id);
+	EXPECT_EQ(0x0002u, actual[1].m_mask);
+	EXPECT_EQ(50u, actual[1].m_button);
+	EXPECT_EQ(1u, actual[1].m_count);
+	EXPECT_EQ(":client:", actual[1].m_name);
+	EXPECT_LE(actual[0].m_time, actual[1].m_time);
+	EXPECT_TRUE(read[2]);
+	EXPECT_EQ(InputTraceRecord::kClipboardChanged, actual[2].m_type);
+	EXPECT_EQ(7u, actual[2].m_count);
+	EXPECT_EQ(65536u, actual[2].m_size);
+	EXPECT_FALSE(read[3]);
+}
+
+TEST(InputTraceTests, open_notATrace_returnsFalse)
+{
+	String path("InputTraceTests.tmp");
+	std::ofstream file(path.c_str(), std::ios::out | std::ios::binary);
+	file << "section: screens\nend\n";
+	file.close();
+
+	InputTraceReader reader;
+	bool result = reader.open(path);
+	std::remove(path.c_str());
+
+	EXPECT_FALSE(result);
+}
+
+TEST(InputTraceTests, open_screenNameLongerThanFile_returnsFalse)
+{
+	String path("InputTraceTests.tmp");
+	Config config;
+	config.addScreen("server");
+	InputTraceWriter writer;
+	ASSERT_TRUE(writer.open(path, config, "server"));
+	writer.close();
+
+	// replace the screen name with a 4 GB one that isn't there
+	replaceEnd(path, 7, String("\xff\xff\xff\xff\x0f", 5));
+
+	InputTraceReader reader;
+	bool result = reader.open(path);
+	std::remove(path.c_str());
+
+	EXPECT_FALSE(result);
+	EXPECT_TRUE(reader.getScreen().empty());
+}
+
+TEST(InputTraceTests, read_nameLongerThanFile_returnsFalse)
+{
+	String path("InputTraceTests.tmp");
+	Config config;
+	config.addScreen("server");
+	InputTraceRecord key = makeRecord(InputTraceRecord::kKeyDown);
+	key.m_name = "x";
+	InputTraceWriter writer;
+	ASSERT_TRUE(writer.open(path, config, "server"));
+	writer.write(key);
+	writer.close();
+
+	// replace the one byte name with a 4 GB one that isn't there
+	replaceEnd(path, 2, String("\xff\xff\xff\xff\x0f", 5));
+
+	InputTraceReader reader;
+	ASSERT_TRUE(reader.open(path));
+	InputTraceRecord record;
+	bool result = reader.read(record);
+	reader.close();
+	std::remove(path.c_str());
+
+	EXPECT_FALSE(result);
+	EXPECT_TRUE(record.m_name.empty());
+}
+
+TEST(InputTraceTests, makeEvent_setFromKeyEvent_sameKeyEvent)
+{
+	TestEventQueue events;
+	int target;
+	Event event(events.forIKeyState().keyDown(), &target,
+							IKeyState::KeyInfo::alloc('a', 0x0001, 38, 1));
+
+	InputTraceRecord record;
+	bool recorded = record.set(&events, event);
+	Event actual = record.makeEvent(&events, NULL, &target);
+
+	ASSERT_TRUE(recorded);
+	EXPECT_EQ(events.forIKeyState().keyDown(), actual.getType());
+	EXPECT_EQ(&target, actual.getTarget());
+	IKeyState::KeyInfo* info =
+		static_cast<IKeyState::KeyInfo*>(actual.getData());
+	EXPECT_EQ('a', info->m_key);
+	EXPECT_EQ(0x0001u, info->m_mask);
+	EXPECT_EQ(38, info->m_button);
+	EXPECT_EQ(1, info->m_count);
+	EXPECT_TRUE(IKeyState::KeyInfo::isDefault(info->m_screens));
+	Event::deleteData(event);
+	Event::deleteData(actual);
+}
+
+TEST(InputTraceTests, set_screensaverEvent_returnsFalse)
+{
+	TestEventQueue events;
+	Event event(events.forIPrimaryScreen().screensaverActivated(), NULL);
+
+	InputTraceRecord record;
+	bool result = record.set(&events, event);
+
+	EXPECT_FALSE(result);
+}
+
+TEST(InputTraceTests, replay_inputAfterSwitch_sentToClient)
+{
+	InputTraceReplay::RecordList records;
+	InputTraceRecord switchToClient = makeRecord(InputTraceRecord::kSwitchToScreen);
+	switchToClient.m_name = "client";
+	records.push_back(switchToClient);
+	InputTraceRecord motion = makeRecord(InputTraceRecord::kMotionOnSecondary);
+	motion.m_x = 5;
+	records.push_back(motion);
+	InputTraceRecord keyDown = makeRecord(InputTraceRecord::kKeyDown);
+	keyDown.m_id    = 'a';
+	keyDown.m_count = 1;
+	records.push_back(keyDown);
+	InputTraceRecord keyUp = keyDown;
+	keyUp.m_type = InputTraceRecord::kKeyUp;
+	records.push_back(keyUp);
+	InputTraceRecord grab = makeRecord(InputTraceRecord::kClipboardGrabbed);
+	grab.m_count = 1;
+	records.push_back(grab);
+	InputTraceRecord change = makeRecord(InputTraceRecord::kClipboardChanged);
+	change.m_count = 1;
+	change.m_size  = 100;
+	records.push_back(change);
+	TestEventQueue events;
+	InputTraceReplay replay(&events);
+	ASSERT_TRUE(replay.load(makeConfig(), "server", records));
+
+	replay.start();
+	replay.replay(0.0);
+	const NullClientProxy* client = replay.getClient("client");
+	ASSERT_TRUE(client != NULL);
+	UInt64 enters        = client->getNumEnters();
+	UInt64 motions       = client->getNumMotions();
+	UInt64 keystrokes    = client->getNumKeystrokes();
+	UInt64 clipboardSize = client->getNumClipboardBytes();
+	replay.stop();
+
+	EXPECT_EQ(1u, enters);
+	EXPECT_EQ(1u, motions);
+	EXPECT_EQ(2u, keystrokes);
+	EXPECT_LE(100u, clipboardSize);
+}
+
+TEST(InputTraceTests, replay_keysWhileBroadcasting_sentToBroadcastScreens)
+{
+	Config config;
+	config.addScreen("server");
+	config.addScreen("client");
+	config.addScreen("other");
+	config.connect("server", kRight, 0.0f, 1.0f, "client", 0.0f, 1.0f);
+	config.connect("client", kLeft, 0.0f, 1.0f, "server", 0.0f, 1.0f);
+	config.connect("client", kRight, 0.0f, 1.0f, "other", 0.0f, 1.0f);
+	config.connect("other", kLeft, 0.0f, 1.0f, "client", 0.0f, 1.0f);
+	std::ostringstream configText;
+	configText << config;
+	InputTraceReplay::RecordList records;
+	InputTraceRecord keyDown = makeRecord(InputTraceRecord::kKeyDown);
+	keyDown.m_id    = 'a';
+	keyDown.m_count = 1;
+	InputTraceRecord keyUp = keyDown;
+	keyUp.m_type = InputTraceRecord::kKeyUp;
+	InputTraceRecord broadcast = makeRecord(InputTraceRecord::kKeyboardBroadcast);
+	broadcast.m_id   = Server::KeyboardBroadcastInfo::kOn;
+	broadcast.m_name = ":other:";
+	records.push_back(broadcast);
+	records.push_back(keyDown);
+	records.push_back(keyUp);
+	broadcast.m_name = "";
+	records.push_back(broadcast);
+	records.push_back(keyDown);
+	records.push_back(keyUp);
+	broadcast.m_id = Server::KeyboardBroadcastInfo::kOff;
+	records.push_back(broadcast);
+	records.push_back(keyDown);
+	records.push_back(keyUp);
+	TestEventQueue events;
+	InputTraceReplay replay(&events);
+	ASSERT_TRUE(replay.load(configText.str(), "server", records));
+
+	replay.start();
+	replay.replay(0.0);
+	UInt64 clientKeystrokes = replay.getClient("client")->getNumKeystrokes();
+	UInt64 otherKeystrokes  = replay.getClient("other")->getNumKeystrokes();
+	replay.stop();
+
+	EXPECT_EQ(2u, clientKeystrokes);
+	EXPECT_EQ(4u, otherKeystrokes);
+}
+
+#if SYNERGY_TRACK_ALLOCATIONS
+TEST(InputTraceTests, replay_motionAndKeysOnClient_noAllocations)
+{
+	InputTraceReplay::RecordList records;
+	InputTraceRecord switchToClient = makeRecord(InputTraceRecord::kSwitchToScreen);
+	switchToClient.m_name = "client";
+	records.push_back(switchToClient);
+	InputTraceRecord motion = makeRecord(InputTraceRecord::kMotionOnSecondary);
+	InputTraceRecord keyDown = makeRecord(InputTraceRecord::kKeyDown);
+	keyDown.m_count = 1;
+	InputTraceRecord keyUp = keyDown;
+	keyUp.m_type = InputTraceRecord::kKeyUp;
+	for (int i = 0; i < 100; ++i) {
+		motion.m_x = ((i & 1) != 0) ? 3 : -3;
+		records.push_back(motion);
+		keyDown.m_id = keyUp.m_id = 'a' + i % 26;
+		records.push_back(keyDown);
+		records.push_back(keyUp);
+	}
+	TestEventQueue events;
+	InputTraceReplay replay(&events);
+	ASSERT_TRUE(replay.load(makeConfig(), "server", records));
+
+	// logging allocates when it prints
+	int filter = CLOG->getFilter();
+	CLOG->setFilter(kWARNING);
+	replay.start();
+	replay.replay(0.0);
+	replay.stop();
+	CLOG->setFilter(filter);
+
+	// switching screens posts events so it does allocate
+	EXPECT_LT(0u, replay.getNumAllocations(InputTraceRecord::kSwitchToScreen));
+	EXPECT_EQ(0u, replay.getNumAllocations(InputTraceRecord::kMotionOnSecondary));
+	EXPECT_EQ(0u, replay.getNumAllocations(InputTraceRecord::kKeyDown));
+	EXPECT_EQ(0u, replay.getNumAllocations(InputTraceRecord::kKeyUp));
+}
+#endif
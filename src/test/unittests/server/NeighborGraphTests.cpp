@@ -0,0 +1,109 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/NeighborGraph.h"
+#include "server/Config.h"
+#include "synergy/option_types.h"
+#include "test/mock/server/MockPrimaryClient.h"
+
+#include <gtest/gtest.h>
+
+TEST(NeighborGraphTests, getNeighbor_connectedNeighbor_returnsClientAndPosition)
+{
+	Config config;
+	config.addScreen("left");
+	config.addScreen("right");
+	config.connect("left", kRight, 0.0f, 1.0f, "right", 0.5f, 1.0f);
+	MockPrimaryClient left, right;
+	NeighborGraph::ClientMap clients;
+	clients["left"] = &left;
+	clients["right"] = &right;
+	NeighborGraph graph;
+	graph.compile(config, clients);
+
+	float t = 0.0f;
+	BaseClientProxy* actual = graph.getNeighbor(&left, kRight, 0.5f, t);
+
+	EXPECT_EQ(&right, actual);
+	EXPECT_FLOAT_EQ(0.75f, t);
+}
+
+TEST(NeighborGraphTests, getNeighbor_unconnectedScreenBetween_skipsOverScreen)
+{
+	Config config;
+	config.addScreen("left");
+	config.addScreen("middle");
+	config.addScreen("right");
+	config.connect("left", kRight, 0.0f, 1.0f, "middle", 0.0f, 1.0f);
+	config.connect("middle", kRight, 0.0f, 1.0f, "right", 0.0f, 1.0f);
+	MockPrimaryClient left, right;
+	NeighborGraph::ClientMap clients;
+	clients["left"] = &left;
+	clients["right"] = &right;
+	NeighborGraph graph;
+	graph.compile(config, clients);
+
+	float t = 0.0f;
+	BaseClientProxy* actual = graph.getNeighbor(&left, kRight, 0.25f, t);
+
+	EXPECT_EQ(&right, actual);
+	EXPECT_FLOAT_EQ(0.25f, t);
+}
+
+TEST(NeighborGraphTests, getNeighbor_positionOutsideLink_returnsNull)
+{
+	Config config;
+	config.addScreen("left");
+	config.addScreen("right");
+	config.connect("left", kRight, 0.0f, 0.5f, "right", 0.0f, 1.0f);
+	MockPrimaryClient left, right;
+	NeighborGraph::ClientMap clients;
+	clients["left"] = &left;
+	clients["right"] = &right;
+	NeighborGraph graph;
+	graph.compile(config, clients);
+
+	float t = 0.0f;
+	BaseClientProxy* actual = graph.getNeighbor(&left, kRight, 0.5f, t);
+
+	EXPECT_TRUE(actual == NULL);
+	EXPECT_TRUE(graph.hasLink(&left, kRight, 0.25f));
+	EXPECT_FALSE(graph.hasLink(&left, kRight, 0.75f));
+	EXPECT_TRUE(graph.hasAnyLink(&left, kRight));
+	EXPECT_FALSE(graph.hasAnyLink(&left, kLeft));
+}
+
+TEST(NeighborGraphTests, getSwitchCorners_globalOptionOnly_usesGlobalOption)
+{
+	Config config;
+	config.addScreen("left");
+	config.addOption("", kOptionScreenSwitchCorners, kTopLeftMask);
+	config.addOption("", kOptionScreenSwitchCornerSize, 8);
+	MockPrimaryClient left;
+	NeighborGraph::ClientMap clients;
+	clients["left"] = &left;
+	NeighborGraph graph;
+	graph.compile(config, clients);
+
+	UInt32 corners;
+	SInt32 size;
+	graph.getSwitchCorners(&left, corners, size);
+
+	EXPECT_EQ(static_cast<UInt32>(kTopLeftMask), corners);
+	EXPECT_EQ(8, size);
+	EXPECT_EQ("left", graph.getName(&left));
+}
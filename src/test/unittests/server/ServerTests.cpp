@@ -0,0 +1,286 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "server/Server.h"
+#include "server/Config.h"
+#include "synergy/option_types.h"
+#include "test/global/NullClientProxy.h"
+#include "test/global/NullScreen.h"
+#include "test/global/NullServer.h"
+#include "test/global/TestEventQueue.h"
+
+#include <sstream>
+#include <gtest/gtest.h>
+
+static const char s_config[] =
+	"section: screens\n"
+	"	server:\n"
+	"	a:\n"
+	"		halfDuplexCapsLock = true\n"
+	"	b:\n"
+	"end\n"
+	"section: links\n"
+	"	server:\n"
+	"		right = a\n"
+	"	a:\n"
+	"		left = server\n"
+	"		right = b\n"
+	"	b:\n"
+	"		left = a\n"
+	"end\n";
+
+//! Server on a primary screen without a display
+/*!
+Runs a NullServer with a configuration that can be reloaded.
+*/
+class ServerHarness {
+public:
+	ServerHarness(const String& config);
+
+	bool				reload(const String& config);
+
+	UInt32				getLockToScreenHotKey() const;
+
+public:
+	TestEventQueue		m_events;
+	Config				m_config;
+	NullServer			m_server;
+};
+
+ServerHarness::ServerHarness(const String& config) :
+	m_config(&m_events),
+	m_server(&m_events)
+{
+	std::istringstream in(config);
+	in >> m_config;
+	m_server.start(m_config, "server");
+}
+
+bool
+ServerHarness::reload(const String& config)
+{
+	Config newConfig(&m_events);
+	std::istringstream in(config);
+	in >> newConfig;
+	bool result = m_server.getServer()->setConfig(newConfig);
+	m_server.dispatchEvents();
+	return result;
+}
+
+UInt32
+ServerHarness::getLockToScreenHotKey() const
+{
+	// the server adds the ScrollLock rule after the configured ones
+	InputFilter* filter = const_cast<Config&>(m_config).getInputFilter();
+	const InputFilter::KeystrokeCondition* condition =
+		dynamic_cast<const InputFilter::KeystrokeCondition*>(
+			filter->getRule(filter->getNumRules() - 1).getCondition());
+	return (condition != NULL) ? condition->getID() : 0;
+}
+
+TEST(ServerTests, setConfig_screenOptionChanged_sentOnlyThatOption)
+{
+	ServerHarness harness(s_config);
+	String config(s_config);
+	config.insert(config.find("\tb:\n") + 4, "\t\tswitchCorners = left\n");
+
+	EXPECT_TRUE(harness.reload(config));
+
+	const NullClientProxy* a = harness.m_server.getClient("a");
+	const NullClientProxy* b = harness.m_server.getClient("b");
+	EXPECT_EQ(1u, a->getNumOptionResets());
+	EXPECT_EQ(2u, a->getOptions().size());
+	EXPECT_EQ(1u, b->getNumOptionResets());
+	ASSERT_EQ(2u, b->getOptions().size());
+	EXPECT_EQ(kOptionScreenSwitchCorners, b->getOptions()[0]);
+	EXPECT_EQ(static_cast<UInt32>(kTopLeftMask | kBottomLeftMask),
+							b->getOptions()[1]);
+}
+
+TEST(ServerTests, setConfig_screenOptionRemoved_optionsReset)
+{
+	ServerHarness harness(s_config);
+	String config(s_config);
+	config.erase(config.find("\t\thalfDuplexCapsLock"),
+							sizeof("\t\thalfDuplexCapsLock = true\n") - 1);
+
+	EXPECT_TRUE(harness.reload(config));
+
+	const NullClientProxy* a = harness.m_server.getClient("a");
+	EXPECT_EQ(2u, a->getNumOptionResets());
+	EXPECT_TRUE(a->getOptions().empty());
+	EXPECT_EQ(1u, harness.m_server.getClient("b")->getNumOptionResets());
+}
+
+TEST(ServerTests, setConfig_linksChanged_hotKeysKept)
+{
+	ServerHarness harness(s_config);
+	UInt32 hotKey = harness.getLockToScreenHotKey();
+	String config(s_config);
+	config.replace(config.find("right = b"), 9, "down = b");
+	config.replace(config.find("left = a"), 8, "up = a");
+
+	EXPECT_TRUE(harness.reload(config));
+
+	EXPECT_NE(0u, hotKey);
+	EXPECT_EQ(hotKey, harness.getLockToScreenHotKey());
+	EXPECT_TRUE(harness.m_config.hasNeighbor("a", kBottom));
+	EXPECT_EQ(1u, harness.m_server.getClient("b")->getNumOptionResets());
+	EXPECT_TRUE(harness.m_server.getClient("b")->getOptions().empty());
+}
+
+TEST(ServerTests, setConfig_filterChanged_rulesReplaced)
+{
+	ServerHarness harness(s_config);
+	String config(s_config);
+	config += "section: options\n"
+		"	keystroke(F1) = switchToScreen(b)\n"
+		"end\n";
+
+	EXPECT_TRUE(harness.reload(config));
+
+	EXPECT_EQ(2u, harness.m_config.getInputFilter()->getNumRules());
+	EXPECT_NE(0u, harness.getLockToScreenHotKey());
+}
+
+TEST(ServerTests, setConfig_screenRemoved_onlyThatClientClosed)
+{
+	ServerHarness harness(s_config);
+	String config =
+		"section: screens\n"
+		"	server:\n"
+		"	a:\n"
+		"		halfDuplexCapsLock = true\n"
+		"end\n"
+		"section: links\n"
+		"	server:\n"
+		"		right = a\n"
+		"	a:\n"
+		"		left = server\n"
+		"end\n";
+
+	EXPECT_TRUE(harness.reload(config));
+
+	std::vector<String> clients;
+	harness.m_server.getServer()->getClients(clients);
+	ASSERT_EQ(2u, clients.size());
+	EXPECT_EQ(1u, harness.m_server.getClient("a")->getNumOptionResets());
+}
+
+TEST(ServerTests, onMouseMovePrimary_primaryResized_newEdgeUsed)
+{
+	ServerHarness harness(s_config);
+	NullScreen* screen = harness.m_server.getPlatformScreen();
+
+	// the server caches the primary screen's shape on the first motion
+	screen->captureMouseMove(1, 0);
+	harness.m_server.dispatchEvents();
+	screen->captureResize(1000, NullScreen::kHeight);
+	harness.m_server.dispatchEvents();
+	screen->captureMouseMove(999 - NullScreen::kWidth / 2 - 1, 0);
+	harness.m_server.dispatchEvents();
+
+	EXPECT_EQ(1u, harness.m_server.getClient("a")->getNumEnters());
+}
+
+static const char s_configBelow[] =
+	"section: screens\n"
+	"	server:\n"
+	"	a:\n"
+	"end\n"
+	"section: links\n"
+	"	server:\n"
+	"		left = a\n"
+	"		down = a\n"
+	"	a:\n"
+	"		right = server\n"
+	"		up = server\n"
+	"end\n";
+
+// a tall monitor at 0,0 and a short one to its right
+static void
+captureTwoMonitors(NullScreen* screen)
+{
+	IScreen::MonitorList monitors(2);
+	monitors[0].m_x = 0;
+	monitors[0].m_y = 0;
+	monitors[0].m_w = 1000;
+	monitors[0].m_h = 800;
+	monitors[1].m_x = 1000;
+	monitors[1].m_y = 0;
+	monitors[1].m_w = 600;
+	monitors[1].m_h = 400;
+	screen->captureMonitors(monitors);
+}
+
+static void
+captureMouseMoveTo(NullScreen* screen, SInt32 x, SInt32 y)
+{
+	SInt32 xOld, yOld;
+	screen->getCursorPos(xOld, yOld);
+	screen->captureMouseMove(x - xOld, y - yOld);
+}
+
+TEST(ServerTests, onMouseMovePrimary_shortMonitorBottom_switches)
+{
+	ServerHarness harness(s_configBelow);
+	NullScreen* screen = harness.m_server.getPlatformScreen();
+	captureTwoMonitors(screen);
+	harness.m_server.dispatchEvents();
+
+	// the bottom of the short monitor is above the bottom of the screen
+	captureMouseMoveTo(screen, 1300, 390);
+	harness.m_server.dispatchEvents();
+	EXPECT_EQ(0u, harness.m_server.getClient("a")->getNumEnters());
+	captureMouseMoveTo(screen, 1300, 399);
+	harness.m_server.dispatchEvents();
+
+	EXPECT_EQ(1u, harness.m_server.getClient("a")->getNumEnters());
+}
+
+TEST(ServerTests, onMouseMovePrimary_edgeBetweenMonitors_noSwitch)
+{
+	ServerHarness harness(s_configBelow);
+	NullScreen* screen = harness.m_server.getPlatformScreen();
+	captureTwoMonitors(screen);
+	harness.m_server.dispatchEvents();
+
+	// the left side of the short monitor continues onto the tall one
+	captureMouseMoveTo(screen, 1010, 100);
+	harness.m_server.dispatchEvents();
+	captureMouseMoveTo(screen, 1000, 100);
+	harness.m_server.dispatchEvents();
+	captureMouseMoveTo(screen, 999, 100);
+	harness.m_server.dispatchEvents();
+
+	EXPECT_EQ(0u, harness.m_server.getClient("a")->getNumEnters());
+}
+
+TEST(ServerTests, getScreenLabel_aliasOrUnconfiguredName_sharedLabel)
+{
+	ServerHarness harness(String(s_config) +
+		"section: aliases\n"
+		"	a:\n"
+		"		alpha\n"
+		"end\n");
+	Server* server = harness.m_server.getServer();
+
+	EXPECT_EQ("a", server->getScreenLabel("alpha"));
+	EXPECT_EQ("a", server->getScreenLabel("A"));
+	EXPECT_EQ("unknown", server->getScreenLabel("c"));
+	EXPECT_EQ("unknown", server->getScreenLabel("d"));
+}
@@ -0,0 +1,74 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ClipboardCache.h"
+#include "synergy/Clipboard.h"
+
+#include <gtest/gtest.h>
+
+TEST(ClipboardCacheTests, get_added_returnsData)
+{
+	ClipboardCache cache;
+	cache.add(IClipboard::kText, 1, "synergy rocks!");
+
+	String data;
+	bool result = cache.get(IClipboard::kText, 1, data);
+
+	EXPECT_TRUE(result);
+	EXPECT_EQ("synergy rocks!", data);
+	EXPECT_FALSE(cache.get(IClipboard::kText, 2, data));
+	EXPECT_FALSE(cache.get(IClipboard::kHTML, 1, data));
+}
+
+TEST(ClipboardCacheTests, add_clipboard_cachesByFormatHash)
+{
+	Clipboard clipboard;
+	clipboard.open(0);
+	clipboard.add(IClipboard::kText, "synergy");
+	clipboard.add(IClipboard::kHTML, "<b>synergy</b>");
+	clipboard.close();
+	ClipboardCache cache;
+
+	cache.add(clipboard);
+
+	String data;
+	EXPECT_TRUE(cache.get(IClipboard::kHTML,
+					clipboard.getHash(IClipboard::kHTML), data));
+	EXPECT_EQ("<b>synergy</b>", data);
+	EXPECT_EQ(21, cache.getSize());
+}
+
+TEST(ClipboardCacheTests, add_overMaxSize_dropsLeastRecentlyUsed)
+{
+	ClipboardCache cache(10);
+	cache.add(IClipboard::kText, 1, "aaaa");
+	cache.add(IClipboard::kText, 2, "bbbb");
+	String data;
+	cache.get(IClipboard::kText, 1, data);
+
+	cache.add(IClipboard::kText, 3, "cccc");
+
+	EXPECT_TRUE(cache.get(IClipboard::kText, 1, data));
+	EXPECT_FALSE(cache.get(IClipboard::kText, 2, data));
+	EXPECT_TRUE(cache.get(IClipboard::kText, 3, data));
+	EXPECT_EQ(8, cache.getSize());
+
+	// too big to cache at all
+	cache.add(IClipboard::kText, 4, String(11, 'd'));
+	EXPECT_FALSE(cache.get(IClipboard::kText, 4, data));
+	EXPECT_EQ(8, cache.getSize());
+}
@@ -17,8 +17,28 @@
 
 #include "synergy/ClipboardChunk.h"
 #include "synergy/protocol_types.h"
+#include "test/mock/io/MockStream.h"
+
+#include <cstring>
 
 #include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::Invoke;
+
+static String s_message;
+
+static UInt32
+readMessage(void* buffer, UInt32 n)
+{
+	if (n > s_message.size()) {
+		n = static_cast<UInt32>(s_message.size());
+	}
+	memcpy(buffer, s_message.data(), n);
+	s_message.erase(0, n);
+	return n;
+}
 
 TEST(ClipboardChunkTests, start_formatStartChunk)
 {
@@ -74,3 +94,19 @@ TEST(ClipboardChunkTests, end_formatDataChunk)
 
 	delete chunk;
 }
+
+TEST(ClipboardChunkTests, assemble_moreThanExpectedSize_error)
+{
+	MockStream stream;
+	String dataCached("mock");
+	size_t expectedSize = 4;
+	ClipboardID id;
+	UInt32 sequence;
+	s_message = String("\0\0\0\0\0\x02\0\0\0\x01" "x", 11);
+
+	EXPECT_CALL(stream, read(_, _)).WillRepeatedly(Invoke(readMessage));
+
+	EXPECT_EQ(kError, ClipboardChunk::assemble(&stream, dataCached,
+							expectedSize, id, sequence));
+	EXPECT_EQ(String("mock"), dataCached);
+}
@@ -0,0 +1,81 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ClipboardOffer.h"
+#include "synergy/Clipboard.h"
+#include "synergy/ContentHash.h"
+
+#include <gtest/gtest.h>
+
+TEST(ClipboardOfferTests, set_clipboard_describesEachFormat)
+{
+	Clipboard clipboard;
+	clipboard.open(0);
+	clipboard.add(IClipboard::kText, "synergy rocks!");
+	clipboard.add(IClipboard::kHTML, "<b>synergy</b>");
+	clipboard.close();
+
+	ClipboardOffer offer;
+	offer.set(clipboard);
+
+	ASSERT_EQ(2, offer.getFormats().size());
+	const ClipboardOffer::Format* text = offer.find(IClipboard::kText);
+	ASSERT_TRUE(text != NULL);
+	EXPECT_EQ(14, text->m_size);
+	EXPECT_EQ(ContentHash::hash("synergy rocks!", 14), text->m_hash);
+	EXPECT_TRUE(offer.find(IClipboard::kHTML) != NULL);
+	EXPECT_TRUE(offer.find(IClipboard::kBitmap) == NULL);
+}
+
+TEST(ClipboardOfferTests, unmarshall_marshalledOffer_sameFormats)
+{
+	Clipboard clipboard;
+	clipboard.open(0);
+	clipboard.add(IClipboard::kBitmap, String(1000, 'x'));
+	clipboard.close();
+	ClipboardOffer offer;
+	offer.set(clipboard);
+
+	std::vector<UInt32> data;
+	offer.marshall(data);
+	ClipboardOffer actual;
+	bool result = actual.unmarshall(data);
+
+	EXPECT_TRUE(result);
+	ASSERT_EQ(1, actual.getFormats().size());
+	EXPECT_EQ(IClipboard::kBitmap, actual.getFormats()[0].m_format);
+	EXPECT_EQ(1000, actual.getFormats()[0].m_size);
+	EXPECT_EQ(clipboard.getHash(IClipboard::kBitmap),
+				actual.getFormats()[0].m_hash);
+}
+
+TEST(ClipboardOfferTests, unmarshall_malformed_returnsFalse)
+{
+	ClipboardOffer offer;
+	std::vector<UInt32> data(3, 0);
+	EXPECT_FALSE(offer.unmarshall(data));
+
+	// unknown format
+	data.assign(4, 0);
+	data[0] = IClipboard::kNumFormats;
+	EXPECT_FALSE(offer.unmarshall(data));
+
+	// format offered twice
+	data.assign(8, 0);
+	EXPECT_FALSE(offer.unmarshall(data));
+	EXPECT_TRUE(offer.getFormats().empty());
+}
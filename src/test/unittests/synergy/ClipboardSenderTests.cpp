@@ -0,0 +1,75 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ClipboardSender.h"
+#include "synergy/protocol_types.h"
+#include "test/mock/io/MockStream.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::Invoke;
+
+static String s_written;
+static int s_writes;
+
+static void
+recordWrite(const void* buffer, UInt32 n)
+{
+	s_written.append(static_cast<const char*>(buffer), n);
+	++s_writes;
+}
+
+TEST(ClipboardSenderTests, send_smallClipboard_startDataAndEndWritten)
+{
+	MockStream stream;
+	ClipboardSender sender(&stream);
+	String data("mock");
+	s_written.clear();
+
+	EXPECT_CALL(stream, write(_, _)).WillRepeatedly(Invoke(recordWrite));
+
+	sender.send(1, 2, data, false);
+
+	EXPECT_EQ(String(
+		"DCLP\x01\0\0\0\x02\x01\0\0\0\x01" "4"
+		"DCLP\x01\0\0\0\x02\x02\0\0\0\x04" "mock"
+		"DCLP\x01\0\0\0\x02\x03\0\0\0\0", 47), s_written);
+	EXPECT_TRUE(data.empty());
+	EXPECT_FALSE(sender.isSending());
+}
+
+TEST(ClipboardSenderTests, send_bigClipboard_restWrittenWhenFlushed)
+{
+	MockStream stream;
+	ClipboardSender sender(&stream);
+	String data(ClipboardSender::kChunkSize * (ClipboardSender::kChunksAhead + 1), 'x');
+	s_writes = 0;
+
+	EXPECT_CALL(stream, write(_, _)).WillRepeatedly(Invoke(recordWrite));
+
+	// start and the chunks that fit ahead of the stream
+	sender.send(0, 0, data, false);
+	EXPECT_EQ(1 + ClipboardSender::kChunksAhead, s_writes);
+	EXPECT_TRUE(sender.isSending());
+
+	// last chunk and end
+	sender.flushed();
+	EXPECT_EQ(3 + ClipboardSender::kChunksAhead, s_writes);
+	EXPECT_FALSE(sender.isSending());
+}
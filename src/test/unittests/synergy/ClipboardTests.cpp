@@ -402,3 +402,46 @@ TEST(ClipboardTests, copy_withSingleText_clipboardsAreEqual)
 	String actual = clipboard2.get(Clipboard::kText);
 	EXPECT_EQ("synergy rocks!", actual);
 }
+
+TEST(ClipboardTests, getHash_sameData_hashesAreEqual)
+{
+	Clipboard clipboard1;
+	clipboard1.open(0);
+	clipboard1.add(Clipboard::kText, "synergy rocks!");
+	clipboard1.close();
+	Clipboard clipboard2;
+	clipboard2.open(1);
+	clipboard2.add(Clipboard::kText, "synergy rocks!");
+	clipboard2.close();
+
+	EXPECT_EQ(clipboard1.getHash(), clipboard2.getHash());
+}
+
+TEST(ClipboardTests, getHash_differentFormat_hashesDiffer)
+{
+	Clipboard clipboard1;
+	clipboard1.open(0);
+	clipboard1.add(Clipboard::kText, "synergy rocks!");
+	clipboard1.close();
+	Clipboard clipboard2;
+	clipboard2.open(0);
+	clipboard2.add(Clipboard::kHTML, "synergy rocks!");
+	clipboard2.close();
+
+	EXPECT_NE(clipboard1.getHash(), clipboard2.getHash());
+}
+
+TEST(ClipboardTests, getHash_knownData_matchesOnEveryByteOrder)
+{
+	Clipboard clipboard;
+	clipboard.open(0);
+	clipboard.add(Clipboard::kText, "synergy rocks!");
+	clipboard.add(Clipboard::kHTML, "<b>synergy rocks!</b>");
+	clipboard.close();
+
+	// other machines compare these, so they're pinned to the XXH64 of
+	// the little endian format and data hash of each format
+	EXPECT_EQ(0x70812BCD2C304073ULL, clipboard.getHash(Clipboard::kText));
+	EXPECT_EQ(0x4AC8BB21C450DFF5ULL, clipboard.getHash(Clipboard::kHTML));
+	EXPECT_EQ(0x99ED7F01B1BA0641ULL, clipboard.getHash());
+}
@@ -0,0 +1,67 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ClockOffset.h"
+
+#include <gtest/gtest.h>
+
+TEST(ClockOffsetTests, addSample_symmetricTrip_exactOffset)
+{
+	ClockOffset offset;
+	EXPECT_FALSE(offset.isValid());
+
+	// remote clock is 1000us behind, 200us each way
+	offset.addSample(5000, 4200, 5400);
+
+	EXPECT_TRUE(offset.isValid());
+	EXPECT_EQ(1000, offset.getOffset());
+	EXPECT_EQ(400, offset.getRoundTrip());
+	EXPECT_EQ(6000, offset.toLocal(5000));
+}
+
+TEST(ClockOffsetTests, addSample_queuedQuery_shortestTripUsed)
+{
+	ClockOffset offset;
+	offset.addSample(5000, 4200, 5400);
+
+	// answer delayed 3000us on the way back
+	offset.addSample(10000, 9200, 13400);
+
+	EXPECT_EQ(1000, offset.getOffset());
+	EXPECT_EQ(400, offset.getRoundTrip());
+}
+
+TEST(ClockOffsetTests, addSample_oldQueries_forgotten)
+{
+	ClockOffset offset;
+	offset.addSample(0, 0, 10);
+	for (UInt64 i = 1; i <= ClockOffset::kMaxSamples; ++i) {
+		offset.addSample(i * 1000, i * 1000 + 500, i * 1000 + 100);
+	}
+
+	// the fast first query was pushed out
+	EXPECT_EQ(100, offset.getRoundTrip());
+	EXPECT_EQ(-450, offset.getOffset());
+}
+
+TEST(ClockOffsetTests, addSample_receivedBeforeSent_ignored)
+{
+	ClockOffset offset;
+	offset.addSample(5000, 0, 4000);
+
+	EXPECT_FALSE(offset.isValid());
+}
@@ -0,0 +1,47 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/ContentHash.h"
+
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+TEST(ContentHashTests, hash_knownInput_matchesXXH64)
+{
+	const char* text = "Nobody inspects the spammish repetition";
+
+	EXPECT_EQ(0xEF46DB3751D8E999ULL, ContentHash::hash("", 0));
+	EXPECT_EQ(0xD24EC4F1A98C6E5BULL, ContentHash::hash("a", 1));
+	EXPECT_EQ(0xFBCEA83C8A378BF1ULL, ContentHash::hash(text, strlen(text)));
+}
+
+TEST(ContentHashTests, update_dataInPieces_sameAsWhole)
+{
+	char data[200];
+	for (int i = 0; i < 200; ++i) {
+		data[i] = static_cast<char>(i * 7);
+	}
+	ContentHash hash;
+
+	hash.update(data, 3);
+	hash.update(data + 3, 40);
+	hash.update(data + 43, 0);
+	hash.update(data + 43, 157);
+
+	EXPECT_EQ(ContentHash::hash(data, sizeof(data)), hash.digest());
+}
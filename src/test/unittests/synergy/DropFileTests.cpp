@@ -0,0 +1,71 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/DropFile.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+TEST(DropFileTests, end_allDataWritten_fileComplete)
+{
+	DropFile file;
+	file.begin(10);
+	file.write("mock ", 5);
+	file.write("data!", 5);
+
+	EXPECT_TRUE(file.end());
+	EXPECT_TRUE(file.isComplete());
+
+	String path = file.detach();
+	std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+	std::stringstream content;
+	content << in.rdbuf();
+	in.close();
+	std::remove(path.c_str());
+
+	EXPECT_EQ("mock data!", content.str());
+}
+
+TEST(DropFileTests, end_dataMissing_fileNotComplete)
+{
+	DropFile file;
+	file.begin(10);
+	file.write("mock ", 5);
+
+	EXPECT_FALSE(file.end());
+	EXPECT_FALSE(file.isComplete());
+	EXPECT_EQ("", file.detach());
+}
+
+TEST(DropFileTests, discard_fileDetached_fileKept)
+{
+	DropFile file;
+	file.begin(4);
+	file.write("mock", 4);
+	file.end();
+	String path = file.detach();
+
+	file.discard();
+
+	std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+	EXPECT_TRUE(in.is_open());
+	in.close();
+	std::remove(path.c_str());
+}
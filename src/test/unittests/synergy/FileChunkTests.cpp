@@ -0,0 +1,78 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileChunk.h"
+#include "synergy/protocol_types.h"
+#include "test/mock/io/MockStream.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::Return;
+
+static String s_written;
+
+static void
+recordWrite(const void* buffer, UInt32 n)
+{
+	s_written.append(static_cast<const char*>(buffer), n);
+}
+
+TEST(FileChunkTests, send_dataChunk_headerAndDataInOneWrite)
+{
+	MockStream stream;
+	UInt8 data[] = { 'm', 'o', 'c', 'k' };
+	FileChunk* chunk = FileChunk::data(data, sizeof(data));
+	s_written.clear();
+
+	EXPECT_CALL(stream, write(_, 13)).WillOnce(Invoke(recordWrite));
+
+	FileChunk::send(&stream, *chunk);
+
+	EXPECT_EQ(String("DFTR\x02\0\0\0\x04mock", 13), s_written);
+
+	delete chunk;
+}
+
+#if HAVE_SYS_SENDFILE_H
+TEST(FileChunkTests, send_fileChunkStreamCantSendFile_dataReadFromFile)
+{
+	String path("FileChunkTests.tmp");
+	std::ofstream file(path.c_str(), std::ios::out | std::ios::binary);
+	file << "skip mock data";
+	file.close();
+
+	MockStream stream;
+	FileChunk* chunk = FileChunk::data(path, 5, 4);
+	s_written.clear();
+
+	EXPECT_CALL(stream, writeFile(_, 9, _, 5, 4)).WillOnce(Return(false));
+	EXPECT_CALL(stream, write(_, 13)).WillOnce(Invoke(recordWrite));
+
+	FileChunk::send(&stream, *chunk);
+
+	EXPECT_EQ(String("DFTR\x02\0\0\0\x04mock", 13), s_written);
+
+	delete chunk;
+	std::remove(path.c_str());
+}
+#endif
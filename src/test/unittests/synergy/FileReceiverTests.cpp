@@ -0,0 +1,80 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileReceiver.h"
+#include "test/mock/synergy/MockEventQueue.h"
+#include "base/EventTypes.h"
+
+#include <cstdio>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::ReturnRef;
+
+TEST(FileReceiverTests, end_allDataWritten_fileCompleted)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	FileEvents fileEvents;
+	fileEvents.setEvents(&eventQueue);
+	ON_CALL(eventQueue, forFile()).WillByDefault(ReturnRef(fileEvents));
+	FileReceiver receiver(&eventQueue, NULL);
+	UInt64 offset = 1;
+
+	EXPECT_CALL(eventQueue, addEvent(_)).Times(1);
+
+	EXPECT_TRUE(receiver.begin("mock", 1, "4,dir/mock", offset));
+	EXPECT_EQ(0, offset);
+	receiver.write("mock", 1, "mock", 4);
+	EXPECT_TRUE(receiver.end("mock", 1));
+
+	FileReceiver::CompletedList files;
+	EXPECT_TRUE(receiver.startDrop());
+	EXPECT_TRUE(receiver.takeCompleted(files));
+	ASSERT_EQ(1, files.size());
+	EXPECT_EQ("dir/mock", files[0].m_name);
+	std::remove(files[0].m_tempPath.c_str());
+	EXPECT_FALSE(receiver.takeCompleted(files));
+}
+
+TEST(FileReceiverTests, begin_partialFileOfferedAgain_resumedAtSize)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	FileReceiver receiver(&eventQueue, NULL);
+	UInt64 offset = 0;
+	receiver.begin("mock", 1, "8,mock", offset);
+	receiver.write("mock", 1, "mock", 4);
+
+	EXPECT_TRUE(receiver.begin("mock", 1, "8,mock", offset));
+
+	EXPECT_EQ(4, offset);
+}
+
+TEST(FileReceiverTests, begin_nameLeavesDirectory_refusedWithOffsetAtEnd)
+{
+	NiceMock<MockEventQueue> eventQueue;
+	FileReceiver receiver(&eventQueue, NULL);
+	UInt64 offset = 0;
+
+	EXPECT_FALSE(receiver.begin("mock", 1, "8,dir/../../mock", offset));
+
+	EXPECT_EQ(8, offset);
+	EXPECT_FALSE(FileReceiver::isNameSafe("/mock"));
+	EXPECT_TRUE(FileReceiver::isNameSafe("dir/mock"));
+}
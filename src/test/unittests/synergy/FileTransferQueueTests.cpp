@@ -0,0 +1,95 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileTransferQueue.h"
+#include "synergy/FileChunk.h"
+#include "synergy/protocol_types.h"
+#include "arch/Arch.h"
+#include "base/EventQueue.h"
+#include "base/Stopwatch.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+static const char* s_path = "FileTransferQueueTests.tmp";
+
+static void
+writeFile(size_t size)
+{
+	std::ofstream file(s_path, std::ios::out | std::ios::binary);
+	file << String(size, 'x');
+}
+
+// passes the queue's chunks on the way the server does, without
+// writing them anywhere, until \c files files have ended.  returns the
+// number of files that ended.
+static int
+relayChunks(EventQueue& events, FileTransferQueue& queue, int files)
+{
+	int ended = 0;
+	Stopwatch timer;
+	while (ended < files && timer.getTime() < 5.0) {
+		Event event;
+		if (!events.getEvent(event, 0.1)) {
+			continue;
+		}
+		if (event.getType() != events.forFile().fileChunkSending()) {
+			Event::deleteData(event);
+			continue;
+		}
+
+		FileChunk* chunk = static_cast<FileChunk*>(event.getData());
+		String destination;
+		if (queue.relay(*chunk, destination)) {
+			EXPECT_EQ("a", destination);
+			if (chunk->m_chunk[0] == kDataStart) {
+				queue.accept(chunk->m_transferId, 0);
+			}
+			else if (chunk->m_chunk[0] == kDataEnd) {
+				++ended;
+			}
+		}
+		chunk->m_window->relayed();
+		delete chunk;
+	}
+	return ended;
+}
+
+TEST(FileTransferQueueTests, add_previousThreadFinished_sendsNewFile)
+{
+	EventQueue events;
+	events.addEvent(Event(Event::kQuit));
+	events.loop();
+
+	// more chunks than fit in the window
+	writeFile(3 * 1024 * 1024);
+	{
+		FileTransferQueue queue(&events, &events);
+		queue.connected("a");
+
+		EXPECT_EQ(1u, queue.add(s_path, "a"));
+		EXPECT_EQ(1, relayChunks(events, queue, 1));
+
+		// give the sender thread time to run out of transfers and exit
+		ARCH->sleep(0.1);
+		EXPECT_EQ(1u, queue.add(s_path, "a"));
+		EXPECT_EQ(1, relayChunks(events, queue, 1));
+	}
+	std::remove(s_path);
+}
@@ -0,0 +1,92 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/FileWindow.h"
+#include "synergy/FileChunk.h"
+
+#include <gtest/gtest.h>
+
+// fills the window with chunks that were relayed and written to a
+// stream tracked by unflushed
+static void
+fillWindow(FileWindow& window, UnflushedFileChunks& unflushed)
+{
+	while (window.wait(0.0)) {
+		FileChunk* chunk = FileChunk::end();
+		window.queued(*chunk);
+		unflushed.written(*chunk);
+		window.relayed();
+		delete chunk;
+	}
+}
+
+TEST(FileWindowTests, wait_chunksQueued_full)
+{
+	FileWindow window;
+	FileChunk* chunks[4];
+	for (int i = 0; i < 4; ++i) {
+		chunks[i] = FileChunk::end();
+		window.queued(*chunks[i]);
+		EXPECT_EQ(&window, chunks[i]->m_window);
+	}
+
+	EXPECT_FALSE(window.wait(0.01));
+	window.relayed();
+	EXPECT_TRUE(window.wait(0.0));
+
+	for (int i = 0; i < 4; ++i) {
+		delete chunks[i];
+	}
+}
+
+TEST(FileWindowTests, flushed_otherStream_windowStaysFull)
+{
+	FileWindow windowA, windowB;
+	UnflushedFileChunks streamA, streamB;
+	fillWindow(windowA, streamA);
+	fillWindow(windowB, streamB);
+
+	streamB.flushed();
+
+	EXPECT_FALSE(windowA.wait(0.01));
+	EXPECT_TRUE(windowB.wait(0.0));
+}
+
+TEST(FileWindowTests, unflushedDestroyed_streamGone_windowOpens)
+{
+	FileWindow window;
+	{
+		UnflushedFileChunks stream;
+		fillWindow(window, stream);
+		EXPECT_FALSE(window.wait(0.0));
+	}
+
+	EXPECT_TRUE(window.wait(0.0));
+}
+
+TEST(FileWindowTests, startSender_earlierSender_stopped)
+{
+	FileWindow window;
+	UInt32 first  = window.startSender();
+	UInt32 second = window.startSender();
+
+	EXPECT_TRUE(window.isStopped(first));
+	EXPECT_FALSE(window.isStopped(second));
+
+	window.stopSenders();
+	EXPECT_TRUE(window.isStopped(second));
+}
@@ -166,6 +166,49 @@ TEST(KeyStateTests, updateKeyMap_mockKeyMap_keyMapGotMock)
 	keyState.updateKeyMap();
 }
 
+TEST(KeyStateTests, updateKeyMap_sameLayoutSignature_keyMapNotRebuilt)
+{
+	NiceMock<MockKeyMap> keyMap;
+	MockEventQueue eventQueue;
+	KeyStateImpl keyState(eventQueue, keyMap);
+	ON_CALL(keyState, getKeyMapSignature()).WillByDefault(Return(1));
+
+	EXPECT_CALL(keyState, getKeyMap(_)).Times(1);
+
+	keyState.updateKeyMap();
+	keyState.updateKeyMap();
+}
+
+TEST(KeyStateTests, updateKeyMap_previousLayoutSignature_keyMapFromCache)
+{
+	NiceMock<MockKeyMap> keyMap;
+	MockEventQueue eventQueue;
+	KeyStateImpl keyState(eventQueue, keyMap);
+	EXPECT_CALL(keyState, getKeyMapSignature())
+		.WillOnce(Return(1))
+		.WillOnce(Return(2))
+		.WillOnce(Return(1));
+
+	// only the first two layouts are built, the third is cached
+	EXPECT_CALL(keyState, getKeyMap(_)).Times(2);
+
+	keyState.updateKeyMap();
+	keyState.updateKeyMap();
+	keyState.updateKeyMap();
+}
+
+TEST(KeyStateTests, updateKeyMap_noLayoutSignature_keyMapAlwaysRebuilt)
+{
+	NiceMock<MockKeyMap> keyMap;
+	MockEventQueue eventQueue;
+	KeyStateImpl keyState(eventQueue, keyMap);
+
+	EXPECT_CALL(keyState, getKeyMap(_)).Times(2);
+
+	keyState.updateKeyMap();
+	keyState.updateKeyMap();
+}
+
 TEST(KeyStateTests, updateKeyState_pollInsertsSingleKey_keyIsDown)
 {
 	NiceMock<MockKeyMap> keyMap;
@@ -0,0 +1,80 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/LatencyHistogram.h"
+
+#include <gtest/gtest.h>
+
+TEST(LatencyHistogramTests, getBucket_smallLatency_exact)
+{
+	for (UInt64 us = 0; us < 16; ++us) {
+		EXPECT_EQ(us, LatencyHistogram::getBucketLimit(
+							LatencyHistogram::getBucket(us)));
+	}
+}
+
+TEST(LatencyHistogramTests, getBucket_largeLatency_withinOneEighth)
+{
+	for (UInt64 us = 16; us < 100000000; us = us * 3 / 2 + 1) {
+		UInt64 limit = LatencyHistogram::getBucketLimit(
+							LatencyHistogram::getBucket(us));
+		EXPECT_GE(limit, us);
+		EXPECT_LE(limit - us, us / 8);
+	}
+}
+
+TEST(LatencyHistogramTests, getBucket_hugeLatency_lastBucket)
+{
+	EXPECT_EQ(LatencyHistogram::kNumBuckets - 1,
+				LatencyHistogram::getBucket(0xffffffffffffULL));
+}
+
+TEST(LatencyHistogramTests, getPercentile_uniformLatencies_percentile)
+{
+	LatencyHistogram histogram;
+	for (UInt64 us = 1; us <= 1000; ++us) {
+		histogram.add(us * 100);
+	}
+
+	EXPECT_EQ(1000, histogram.getCount());
+	UInt64 p50 = histogram.getPercentile(50.0);
+	UInt64 p99 = histogram.getPercentile(99.0);
+	EXPECT_GE(p50, 50000);
+	EXPECT_LE(p50, 50000 + 50000 / 8);
+	EXPECT_GE(p99, 99000);
+	EXPECT_LE(p99, 99000 + 99000 / 8);
+}
+
+TEST(LatencyHistogramTests, getPercentile_empty_zero)
+{
+	LatencyHistogram histogram;
+	EXPECT_EQ(0, histogram.getPercentile(99.0));
+}
+
+TEST(LatencyHistogramTests, add_histogram_countsAdded)
+{
+	LatencyHistogram a, b;
+	a.add(10);
+	b.add(10);
+	b.add(5000);
+
+	a.add(b);
+
+	EXPECT_EQ(3, a.getCount());
+	EXPECT_EQ(2, a.getBucketCount(LatencyHistogram::getBucket(10)));
+	EXPECT_EQ(1, a.getBucketCount(LatencyHistogram::getBucket(5000)));
+}
@@ -0,0 +1,67 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/LatencyStats.h"
+
+#include <gtest/gtest.h>
+
+TEST(LatencyStatsTests, unmarshall_marshalledStats_sameCounts)
+{
+	LatencyStats stats;
+	stats.add(LatencyStats::kNetwork, 300);
+	stats.add(LatencyStats::kNetwork, 300);
+	stats.add(LatencyStats::kTotal, 2500);
+
+	std::vector<UInt32> data;
+	stats.marshall(data);
+	LatencyStats actual;
+	bool result = actual.unmarshall(data);
+
+	EXPECT_TRUE(result);
+	EXPECT_EQ(6, data.size());
+	EXPECT_EQ(0, actual.get(LatencyStats::kQueue).getCount());
+	EXPECT_EQ(2, actual.get(LatencyStats::kNetwork).getCount());
+	EXPECT_EQ(1, actual.get(LatencyStats::kTotal).getCount());
+	EXPECT_EQ(stats.get(LatencyStats::kTotal).getPercentile(50.0),
+				actual.get(LatencyStats::kTotal).getPercentile(50.0));
+}
+
+TEST(LatencyStatsTests, unmarshall_malformed_returnsFalse)
+{
+	LatencyStats stats;
+	std::vector<UInt32> data(2, 0);
+	EXPECT_FALSE(stats.unmarshall(data));
+
+	// unknown stage
+	data.assign(3, 1);
+	data[0] = LatencyStats::kNumStages;
+	EXPECT_FALSE(stats.unmarshall(data));
+
+	// unknown bucket
+	data[0] = LatencyStats::kTotal;
+	data[1] = LatencyHistogram::kNumBuckets;
+	EXPECT_FALSE(stats.unmarshall(data));
+	EXPECT_TRUE(stats.isEmpty());
+}
+
+TEST(LatencyStatsTests, format_stats_percentilesOfCountedStages)
+{
+	LatencyStats stats;
+	stats.add(LatencyStats::kTotal, 10);
+
+	EXPECT_EQ("total p50=0.01ms p99=0.01ms", stats.format());
+}
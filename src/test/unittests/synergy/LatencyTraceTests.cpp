@@ -0,0 +1,58 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/LatencyTrace.h"
+
+#include <gtest/gtest.h>
+
+TEST(LatencyTraceTests, setEnabled_oneOfTwoDisables_staysEnabled)
+{
+	LatencyTrace::setEnabled(true);
+	LatencyTrace::setEnabled(true);
+	LatencyTrace::setEnabled(false);
+
+	EXPECT_TRUE(LatencyTrace::isEnabled());
+
+	LatencyTrace::setEnabled(false);
+
+	EXPECT_FALSE(LatencyTrace::isEnabled());
+}
+
+TEST(LatencyTraceTests, setEnabled_lastDisables_clearsTimes)
+{
+	LatencyTrace::setEnabled(true);
+	LatencyTrace::injected();
+
+	EXPECT_NE(0u, LatencyTrace::getInjectTime());
+
+	LatencyTrace::setEnabled(false);
+
+	EXPECT_EQ(0u, LatencyTrace::getInjectTime());
+}
+
+TEST(LatencyTraceTests, captureScope_enabled_setsCaptureTimeInScope)
+{
+	LatencyTrace::setEnabled(true);
+	{
+		LatencyTrace::CaptureScope scope;
+
+		EXPECT_NE(0u, LatencyTrace::getCaptureTime());
+	}
+
+	EXPECT_EQ(0u, LatencyTrace::getCaptureTime());
+	LatencyTrace::setEnabled(false);
+}
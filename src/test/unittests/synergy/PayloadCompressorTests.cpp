@@ -0,0 +1,127 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "synergy/PayloadCompressor.h"
+
+#include <gtest/gtest.h>
+
+TEST(PayloadCompressorTests, compress_repetitiveData_decompressesToSameData)
+{
+	String data;
+	for (int i = 0; i < 200; ++i) {
+		data += "<p class=\"mock\">mock data ";
+		data += static_cast<char>('a' + i % 26);
+		data += "</p>\n";
+	}
+	data.append(300, 'x');
+	String compressed;
+	String decompressed;
+
+	EXPECT_TRUE(PayloadCompressor::compress(data.data(), data.size(), compressed));
+	EXPECT_LT(compressed.size(), data.size() / 4);
+	EXPECT_TRUE(PayloadCompressor::decompress(compressed.data(), compressed.size(), decompressed));
+
+	EXPECT_EQ(data, decompressed);
+}
+
+TEST(PayloadCompressorTests, compress_incompressibleData_notCompressed)
+{
+	String data;
+	UInt32 seed = 1;
+	for (int i = 0; i < 4096; ++i) {
+		seed = seed * 1103515245 + 12345;
+		data += static_cast<char>(seed >> 24);
+	}
+	String compressed;
+
+	EXPECT_FALSE(PayloadCompressor::compress(data.data(), data.size(), compressed));
+	EXPECT_TRUE(compressed.empty());
+}
+
+TEST(PayloadCompressorTests, compress_belowThreshold_notCompressed)
+{
+	String data(PayloadCompressor::kThreshold - 1, 'x');
+	String compressed;
+
+	EXPECT_FALSE(PayloadCompressor::compress(data.data(), data.size(), compressed));
+}
+
+TEST(PayloadCompressorTests, decompress_truncatedData_rejected)
+{
+	String data(4096, 'x');
+	String compressed;
+	String decompressed;
+	PayloadCompressor::compress(data.data(), data.size(), compressed);
+
+	EXPECT_FALSE(PayloadCompressor::decompress(compressed.data(), compressed.size() - 1, decompressed));
+	EXPECT_TRUE(decompressed.empty());
+}
+
+// blocks made by the reference liblz4 (LZ4_compress_default, 1.9.4),
+// behind the big-endian uncompressed size
+static const char kReferenceRun[] =
+	"\x00\x00\x08\x00"
+	"\x1f\x78\x01\x00\xff\xff\xff\xff\xff\xff\xff\xee\x50\x78\x78\x78"
+	"\x78\x78";
+
+static const char kReferenceMarkup[] =
+	"\x00\x00\x02\xf8"
+	"\xf9\x04\x3c\x70\x3e\x6d\x6f\x63\x6b\x20\x64\x61\x74\x61\x20\x61"
+	"\x3c\x2f\x70\x3e\x0a\x13\x00\x1e\x62\x13\x00\x1e\x63\x13\x00\x1e"
+	"\x64\x13\x00\x1e\x65\x13\x00\x1e\x66\x13\x00\x1e\x67\x13\x00\x1e"
+	"\x68\x13\x00\x1e\x69\x13\x00\x1e\x6a\x13\x00\x1e\x6b\x13\x00\x1e"
+	"\x6c\x13\x00\x1e\x6d\x13\x00\x1e\x6e\x13\x00\x1e\x6f\x13\x00\x1e"
+	"\x70\x13\x00\x1e\x71\x13\x00\x1e\x72\x13\x00\x1e\x73\x13\x00\x1e"
+	"\x74\x13\x00\x1e\x75\x13\x00\x1e\x76\x13\x00\x1e\x77\x13\x00\x1e"
+	"\x78\x13\x00\x1e\x79\x13\x00\x1e\x7a\x13\x00\x0f\xee\x01\xe5\x50"
+	"\x3c\x2f\x70\x3e\x0a";
+
+TEST(PayloadCompressorTests, decompress_referenceRun_decompressesToRun)
+{
+	String decompressed;
+
+	EXPECT_TRUE(PayloadCompressor::decompress(kReferenceRun,
+					sizeof(kReferenceRun) - 1, decompressed));
+
+	EXPECT_EQ(String(2048, 'x'), decompressed);
+}
+
+TEST(PayloadCompressorTests, decompress_referenceMarkup_decompressesToMarkup)
+{
+	String data;
+	for (int i = 0; i < 40; ++i) {
+		data += "<p>mock data ";
+		data += static_cast<char>('a' + i % 26);
+		data += "</p>\n";
+	}
+	String decompressed;
+
+	EXPECT_TRUE(PayloadCompressor::decompress(kReferenceMarkup,
+					sizeof(kReferenceMarkup) - 1, decompressed));
+
+	EXPECT_EQ(data, decompressed);
+}
+
+TEST(PayloadCompressorTests, decompress_referenceRunWrongSize_rejected)
+{
+	String data(kReferenceRun, sizeof(kReferenceRun) - 1);
+	data[2] = '\x09';
+	String decompressed;
+
+	EXPECT_FALSE(PayloadCompressor::decompress(data.data(), data.size(), decompressed));
+	EXPECT_TRUE(decompressed.empty());
+}
@@ -0,0 +1,49 @@
+/*
+ * synergy -- mouse and keyboard sharing utility
+ * Copyright (C) 2016 Symless Ltd.
+ *
+ * This package is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * found in the file LICENSE that should have accompanied this file.
+ *
+ * This package is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test/global/NullScreen.h"
+#include "test/global/TestEventQueue.h"
+
+#include <gtest/gtest.h>
+
+TEST(PlatformScreenTests, getMonitors_default_oneMonitorCoveringScreen)
+{
+	TestEventQueue events;
+	NullScreen screen(&events, true);
+
+	const IScreen::MonitorList& monitors = screen.getMonitors();
+
+	ASSERT_EQ(1u, monitors.size());
+	EXPECT_EQ(0, monitors[0].m_x);
+	EXPECT_EQ(0, monitors[0].m_y);
+	EXPECT_EQ(NullScreen::kWidth, monitors[0].m_w);
+	EXPECT_EQ(NullScreen::kHeight, monitors[0].m_h);
+}
+
+TEST(PlatformScreenTests, getMonitors_resized_followsShape)
+{
+	TestEventQueue events;
+	NullScreen screen(&events, true);
+	screen.getMonitors();
+
+	screen.captureResize(1280, 720);
+	const IScreen::MonitorList& monitors = screen.getMonitors();
+
+	ASSERT_EQ(1u, monitors.size());
+	EXPECT_EQ(1280, monitors[0].m_w);
+	EXPECT_EQ(720, monitors[0].m_h);
+}
@@ -64,3 +64,17 @@ TEST(ServerArgsParsingTests, parseServerArgs_configArg_setConfigFile)
 
 	EXPECT_EQ("mock_configFile", serverArgs.m_configFile);
 }
+
+TEST(ServerArgsParsingTests, parseServerArgs_recordInputArg_setInputTraceFile)
+{
+	NiceMock<MockArgParser> argParser;
+	ON_CALL(argParser, parseGenericArgs(_, _, _)).WillByDefault(Invoke(server_stubParseGenericArgs));
+	ON_CALL(argParser, checkUnexpectedArgs()).WillByDefault(Invoke(server_stubCheckUnexpectedArgs));
+	ServerArgs serverArgs;
+	const int argc = 3;
+	const char* kRecordInputCmd[argc] = { "stub", "--record-input", "mock_traceFile" };
+
+	argParser.parseServerArgs(serverArgs, argc, kRecordInputCmd);
+
+	EXPECT_EQ("mock_traceFile", serverArgs.m_inputTraceFile);
+}